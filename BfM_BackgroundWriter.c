@@ -0,0 +1,653 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_BackgroundWriter.c
+ *
+ * Description:
+ *  Write dirty buffers back to disk ahead of their replacement so that a
+ *  buffer miss rarely has to write a dirty victim before reading its page.
+ *
+ *  The writer trickles dirty, unfixed buffers lying just ahead of the
+ *  replacement clock hand ('nextVictim'), i.e. the buffers that are going
+ *  to be the next victims. The buffers of a run are sorted in the physical
+ *  order of their pages, and physically adjacent pages are gathered and
+ *  written by one RDsM_WriteTrains() call instead of one write per page.
+ *  If an asynchronous I/O handle is attached to the volume(see
+ *  RDsM_AttachAsyncIO()), the runs are submitted to it instead and all of
+ *  them are in flight at once.
+ *  Periodically the writer also takes a fuzzy checkpoint: every
+ *  dirty buffer which is not fixed at the moment is written, without waiting
+ *  for the fixed ones.
+ *
+ *  The buffer manager and the raw disk manager in cosmos.o are not thread
+ *  safe, so the writer does not run on a thread of its own. It runs between
+ *  operations: the object manager polls it after each update, and an
+ *  application can call BfM_RunWriter() from its idle loop.
+ *
+ * Exports:
+ *  Four BfM_SetWriterParams(BfM_WriterParams*)
+ *  Four BfM_GetWriterParams(BfM_WriterParams*)
+ *  Four BfM_GetWriterStats(BfM_WriterStats*)
+ *  Four BfM_RunWriter(Boolean)
+ *  Four BfM_PollWriter(void)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+#include "RDsM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+/* maximum number of trains written by one request */
+#define BFM_MAX_WRITE_RUN	64
+
+/* the number of completions reaped at a time */
+#define BFM_WRITER_REAP_BATCH	16
+
+
+/*@
+ * Type Definitions
+ */
+/* a buffer to be written by the writer */
+typedef struct {
+    TrainID	trainId;	/* train held in the buffer */
+    Two		idx;		/* index of the buffer frame */
+    Four	nTrains;	/* trains of the run starting here, while it is written asynchronously */
+} bfm_WriterCandidate;
+
+
+/*@
+ * Global Variables
+ */
+static BfM_WriterParams bfm_writerParams = {
+    BFM_DEFAULT_TRICKLE_INTERVAL,
+    BFM_DEFAULT_TRICKLE_PAGES,
+    BFM_DEFAULT_CHECKPOINT_INTERVAL
+};
+static BfM_WriterStats bfm_writerStats;
+
+static Boolean bfm_writerStarted = FALSE;	/* has the writer been polled? */
+static struct timespec bfm_writerEpoch;		/* time of the first poll */
+static Four bfm_lastTrickle;			/* time of the last trickle in msec */
+static Four bfm_lastCheckpoint;			/* time of the last checkpoint in msec */
+
+/* trains cleaned by the writer; NIL pageNo if the entry is not used */
+static BfMHashKey *bfm_cleanedKey = NULL;
+
+/* staging area where a run of buffers is gathered before it is written */
+static char *bfm_staging = NULL;
+static Four bfm_stagingSize = 0;
+
+
+/* Macro: BFM_WRITER_MSEC(_ts)
+ * Description: return the milliseconds elapsed from the first poll to the given time
+ * Returns: (Four) milliseconds
+ */
+#define BFM_WRITER_MSEC(_ts) \
+    ((Four)(((_ts).tv_sec - bfm_writerEpoch.tv_sec)*1000 + \
+            ((_ts).tv_nsec - bfm_writerEpoch.tv_nsec)/1000000))
+
+
+
+/*@================================
+ * bfm_CompareWriterCandidate()
+ *================================*/
+/*
+ * Function: int bfm_CompareWriterCandidate(const void*, const void*)
+ *
+ * Description:
+ *  Compare two candidates by the physical position of their trains.
+ *
+ * Returns:
+ *  negative, zero, or positive as qsort() expects
+ */
+static int bfm_CompareWriterCandidate(
+    const void	*a,		/* IN candidate */
+    const void	*b)		/* IN candidate */
+{
+    const TrainID *x = &((const bfm_WriterCandidate *)a)->trainId;
+    const TrainID *y = &((const bfm_WriterCandidate *)b)->trainId;
+
+
+    if (x->volNo != y->volNo) return(x->volNo - y->volNo);
+
+    return((x->pageNo > y->pageNo) - (x->pageNo < y->pageNo));
+
+} /* bfm_CompareWriterCandidate() */
+
+
+
+/*@================================
+ * bfm_CountAvoidedStalls()
+ *================================*/
+/*
+ * Function: void bfm_CountAvoidedStalls(Four)
+ *
+ * Description:
+ *  Check the buffers cleaned by the previous runs. A buffer which now holds
+ *  another train was replaced, and its victim did not have to be written at
+ *  replacement time. A buffer which became dirty again is not followed any
+ *  more. The count is approximate: a buffer dirtied again and replaced
+ *  between two runs is also counted.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_CountAvoidedStalls(
+    Four	type)		/* IN buffer type */
+{
+    Two		i;		/* index variable */
+
+
+    for (i = 0; i < BI_NBUFS(type); i++) {
+        if (bfm_cleanedKey[i].pageNo == NIL) continue;
+
+        if (!EQUAL_BFMHASHKEY(BI_KEY(type, i), bfm_cleanedKey[i])) {
+            bfm_writerStats.stallsAvoided++;
+            bfm_cleanedKey[i].pageNo = NIL;
+        }
+        else if (BI_BITS(type, i) & DIRTY) {
+            bfm_cleanedKey[i].pageNo = NIL;
+        }
+    }
+
+} /* bfm_CountAvoidedStalls() */
+
+
+
+/*@================================
+ * bfm_ClearDirty()
+ *================================*/
+/*
+ * Function: void bfm_ClearDirty(Four, bfm_WriterCandidate*, Four)
+ *
+ * Description:
+ *  Mark the buffers of a run written, as bfm_FlushTrain() does.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_ClearDirty(
+    Four	type,		/* IN buffer type */
+    bfm_WriterCandidate *run,	/* IN buffers written */
+    Four	n)		/* IN the number of buffers */
+{
+    Four	k;		/* index variable */
+
+
+    for (k = 0; k < n; k++) BI_BITS(type, run[k].idx) &= ~(DIRTY | NEW_TRAIN);
+
+} /* bfm_ClearDirty() */
+
+
+
+/*@================================
+ * bfm_ReapWrites()
+ *================================*/
+/*
+ * Function: Four bfm_ReapWrites(RDsM_AsyncIO*, Four, Four, Four*)
+ *
+ * Description:
+ *  Wait for at least 'minComplete' runs in flight and mark their buffers
+ *  written. The buffers of a run whose write failed stay dirty, and the
+ *  error is kept in 'firstError' if it is the first one.
+ *
+ * Returns:
+ *  the number of runs reaped (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bfm_ReapWrites(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    Four	minComplete,	/* IN the number of runs to wait for */
+    Four	type,		/* IN buffer type */
+    Four	*firstError)	/* INOUT the first error of a write */
+{
+    Four	n;		/* the number of completions */
+    Four	k;		/* index variable */
+    bfm_WriterCandidate *run;	/* run completed */
+    RDsM_AsyncIOCompletion done[BFM_WRITER_REAP_BATCH]; /* completions */
+
+
+    n = RDsM_WaitAsyncIO(aio, MIN(minComplete, BFM_WRITER_REAP_BATCH), done, BFM_WRITER_REAP_BATCH);
+    if (n < 0) ERR(n);
+
+    for (k = 0; k < n; k++) {
+        run = (bfm_WriterCandidate *)done[k].userData;
+
+        if (done[k].result == eNOERROR)
+            bfm_ClearDirty(type, run, run->nTrains);
+        else if (*firstError == eNOERROR)
+            *firstError = done[k].result;
+    }
+
+    return(n);
+
+} /* bfm_ReapWrites() */
+
+
+
+/*@================================
+ * bfm_WriteRun()
+ *================================*/
+/*
+ * Function: Four bfm_WriteRun(Four, RDsM_AsyncIO*, bfm_WriterCandidate*, Four, char*, Four*, Four*)
+ *
+ * Description:
+ *  Write 'n' buffers holding physically adjacent trains. The frames are
+ *  gathered into 'area' and written by one request: submitted to 'aio' if
+ *  it is given, otherwise by RDsM_WriteTrains(). A single train, and every
+ *  train while a written train must be saved for rollback first, goes
+ *  through bfm_FlushTrain() which does the saving. A run holding a page
+ *  stored compressed, or a page of a file given compressed pages, is
+ *  written synchronously, as the asynchronous I/O does not go through the
+ *  compression(see RDsM_Compression.c).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bfm_WriteRun(
+    Four	type,		/* IN buffer type */
+    RDsM_AsyncIO *aio,		/* IN handle attached to the volume, or NULL */
+    bfm_WriterCandidate *run,	/* IN buffers of adjacent trains in physical order */
+    Four	n,		/* IN the number of buffers */
+    char	*area,		/* IN staging area of the run */
+    Four	*nInFlight,	/* INOUT the number of runs in flight */
+    Four	*firstError)	/* INOUT the first error of an asynchronous write */
+{
+    Four	e;		/* error number */
+    Four	k;		/* index variable */
+    Four	trainBytes;	/* size of a train in bytes */
+
+
+    if (n == 1 || RM_RollbackRequiredFlag != 0) {
+        for (k = 0; k < n; k++) {
+            e = bfm_FlushTrain(&run[k].trainId, type);
+            if (e < 0) ERR(e);
+        }
+
+        return(eNOERROR);
+    }
+
+    trainBytes = BI_BUFSIZE(type)*PAGESIZE;
+
+    for (k = 0; k < n; k++)
+        memcpy(area + k*trainBytes, BI_BUFFER(type, run[k].idx), trainBytes);
+
+    if (aio != NULL && !rdsm_IsCompressedTrain(&run[0].trainId, n*BI_BUFSIZE(type)) &&
+        !rdsm_HoldsCompressedFilePage(area, n*BI_BUFSIZE(type))) {
+        run[0].nTrains = n;
+
+        while ((e = RDsM_SubmitWriteTrain(aio, area, &run[0].trainId, n*BI_BUFSIZE(type),
+                                          &run[0])) == eASYNCIOQUEUEFULL_RDSM) {
+            e = bfm_ReapWrites(aio, 1, type, firstError);
+            if (e < 0) ERR(e);
+            *nInFlight -= e;
+        }
+        if (e < 0) ERR(e);
+
+        (*nInFlight)++;
+        bfm_writerStats.asyncRuns++;
+
+        return(eNOERROR);
+    }
+
+    e = RDsM_WriteTrains(area, &run[0].trainId, n, BI_BUFSIZE(type));
+    if (e < 0) ERR(e);
+
+    bfm_ClearDirty(type, run, n);
+
+    return(eNOERROR);
+
+} /* bfm_WriteRun() */
+
+
+
+/*@================================
+ * bfm_WriteBuffers()
+ *================================*/
+/*
+ * Function: Four bfm_WriteBuffers(Four, Two, Four)
+ *
+ * Description:
+ *  Write up to 'maxPages' dirty and unfixed buffers, scanning the buffer
+ *  table from 'first' in the order of the replacement clock. The buffers
+ *  are sorted in the physical order of their trains, and each run of
+ *  physically adjacent trains, up to BFM_MAX_WRITE_RUN of them, is written
+ *  by one request. The asynchronous writes are waited for before returning.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bfm_WriteBuffers(
+    Four	type,		/* IN buffer type */
+    Two		first,		/* IN where the scan starts */
+    Four	maxPages)	/* IN maximum number of buffers to write */
+{
+    Four	e;		/* error number */
+    Two		i, k;		/* index variables */
+    Four	n;		/* the number of candidates */
+    Four	start;		/* first candidate of the current run */
+    Four	trainBytes;	/* size of a train in bytes */
+    Four	nInFlight;	/* the number of runs in flight */
+    Four	firstError;	/* the first error of an asynchronous write */
+    void	*area;		/* newly allocated staging area */
+    RDsM_AsyncIO *aio;		/* handle attached to the volume of the run */
+    bfm_WriterCandidate *cand;	/* buffers to write */
+
+
+    cand = (bfm_WriterCandidate *)malloc(sizeof(bfm_WriterCandidate) * BI_NBUFS(type));
+    if (cand == NULL) ERR(eMEMORYALLOCERR);
+
+    for (k = 0, n = 0; k < BI_NBUFS(type) && n < maxPages; k++) {
+        i = (first + k) % BI_NBUFS(type);
+
+        if (BI_KEY(type, i).pageNo == NIL) continue;
+        if (BI_FIXED(type, i) > 0 || !(BI_BITS(type, i) & DIRTY)) continue;
+
+        MAKE_PAGEID(cand[n].trainId, BI_KEY(type, i).volNo, BI_KEY(type, i).pageNo);
+        cand[n].idx = i;
+        cand[n].nTrains = 0;
+        n++;
+    }
+
+    qsort(cand, n, sizeof(bfm_WriterCandidate), bfm_CompareWriterCandidate);
+
+    /* every run has its place in the staging area while the runs are in flight;
+     * aligned to a page so that the volume may be opened for direct I/O */
+    trainBytes = BI_BUFSIZE(type)*PAGESIZE;
+    if (bfm_stagingSize < n*trainBytes) {
+        if (posix_memalign(&area, PAGESIZE, n*trainBytes) != 0) {
+            free(cand);
+            ERR(eMEMORYALLOCERR);
+        }
+
+        free(bfm_staging);
+        bfm_staging = (char *)area;
+        bfm_stagingSize = n*trainBytes;
+    }
+
+    nInFlight = 0;
+    firstError = eNOERROR;
+    aio = NULL;
+
+    for (start = 0, k = 0; k < n; k++) {
+        bfm_writerStats.pagesWritten++;
+        bfm_cleanedKey[cand[k].idx] = BI_KEY(type, cand[k].idx);
+
+        /* the run ends unless the next train follows this one */
+        if (k+1 < n && k+1 - start < BFM_MAX_WRITE_RUN &&
+            cand[k+1].trainId.volNo == cand[k].trainId.volNo &&
+            cand[k+1].trainId.pageNo == cand[k].trainId.pageNo + BI_BUFSIZE(type))
+            continue;
+
+        /* drain the writes of the previous volume before going on */
+        if (start == 0 || cand[start].trainId.volNo != cand[start-1].trainId.volNo) {
+            while (nInFlight > 0) {
+                e = bfm_ReapWrites(aio, nInFlight, type, &firstError);
+                if (e < 0) goto failed;
+                nInFlight -= e;
+            }
+            aio = RDsM_GetAttachedAsyncIO(cand[start].trainId.volNo);
+        }
+
+        e = bfm_WriteRun(type, aio, &cand[start], k+1 - start, bfm_staging + start*trainBytes,
+                         &nInFlight, &firstError);
+        if (e < 0) goto failed;
+
+        bfm_writerStats.writeRuns++;
+        start = k+1;
+    }
+
+    while (nInFlight > 0) {
+        e = bfm_ReapWrites(aio, nInFlight, type, &firstError);
+        if (e < 0) goto failed;
+        nInFlight -= e;
+    }
+
+    free(cand);
+
+    if (firstError < 0) ERR(firstError);
+
+    return(eNOERROR);
+
+failed:
+    /* the staging area may not be reused while writes are in flight */
+    while (nInFlight > 0) {
+        n = bfm_ReapWrites(aio, nInFlight, type, &firstError);
+        if (n < 0) break;
+        nInFlight -= n;
+    }
+
+    free(cand);
+
+    ERR(e);
+
+} /* bfm_WriteBuffers() */
+
+
+
+/*@================================
+ * BfM_SetWriterParams()
+ *================================*/
+/*
+ * Function: Four BfM_SetWriterParams(BfM_WriterParams*)
+ *
+ * Description:
+ *  Set the tunables of the writer. An interval of 0 disables the trickle
+ *  or the checkpoint respectively.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_SetWriterParams(
+    BfM_WriterParams *params)	/* IN new tunables */
+{
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    if (params->trickleInterval < 0 || params->tricklePages < 0 ||
+        params->checkpointInterval < 0) ERR(eBADPARAMETER);
+
+    bfm_writerParams = *params;
+
+    return(eNOERROR);
+
+} /* BfM_SetWriterParams() */
+
+
+
+/*@================================
+ * BfM_GetWriterParams()
+ *================================*/
+/*
+ * Function: Four BfM_GetWriterParams(BfM_WriterParams*)
+ *
+ * Description:
+ *  Get the tunables of the writer.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_GetWriterParams(
+    BfM_WriterParams *params)	/* OUT current tunables */
+{
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    *params = bfm_writerParams;
+
+    return(eNOERROR);
+
+} /* BfM_GetWriterParams() */
+
+
+
+/*@================================
+ * BfM_GetWriterStats()
+ *================================*/
+/*
+ * Function: Four BfM_GetWriterStats(BfM_WriterStats*)
+ *
+ * Description:
+ *  Get the counters of the writer.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_GetWriterStats(
+    BfM_WriterStats *stats)	/* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    *stats = bfm_writerStats;
+
+    return(eNOERROR);
+
+} /* BfM_GetWriterStats() */
+
+
+
+/*@================================
+ * BfM_RunWriter()
+ *================================*/
+/*
+ * Function: Four BfM_RunWriter(Boolean)
+ *
+ * Description:
+ *  Trickle the dirty buffers which are the next victims of the page buffer.
+ *  If 'checkpoint' is TRUE, take a fuzzy checkpoint instead, writing every
+ *  dirty buffer which is not fixed and saving the warm restart lists(see
+ *  BfM_SetWarmStartFile()).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_RunWriter(
+    Boolean	checkpoint)	/* IN take a fuzzy checkpoint? */
+{
+    Four	e;		/* error number */
+    Two		i;		/* index variable */
+
+
+    /* the buffer manager is not initialized yet */
+    if (BI_NBUFS(PAGE_BUF) <= 0 || bufInfo[PAGE_BUF].bufTable == NULL) return(eNOERROR);
+
+    if (bfm_cleanedKey == NULL) {
+        bfm_cleanedKey = (BfMHashKey *)malloc(sizeof(BfMHashKey) * BI_NBUFS(PAGE_BUF));
+        if (bfm_cleanedKey == NULL) ERR(eMEMORYALLOCERR);
+
+        for (i = 0; i < BI_NBUFS(PAGE_BUF); i++) bfm_cleanedKey[i].pageNo = NIL;
+    }
+
+    bfm_CountAvoidedStalls(PAGE_BUF);
+
+    if (checkpoint) {
+        e = bfm_WriteBuffers(PAGE_BUF, 0, BI_NBUFS(PAGE_BUF));
+        if (e < 0) ERR(e);
+
+        /* keep the warm restart lists recent */
+        e = bfm_SaveWarmStartFiles();
+        if (e < 0) ERR(e);
+
+        bfm_writerStats.checkpoints++;
+    }
+    else {
+        e = bfm_WriteBuffers(PAGE_BUF, BI_NEXTVICTIM(PAGE_BUF), bfm_writerParams.tricklePages);
+        if (e < 0) ERR(e);
+
+        bfm_writerStats.trickles++;
+    }
+
+    return(eNOERROR);
+
+} /* BfM_RunWriter() */
+
+
+
+/*@================================
+ * BfM_PollWriter()
+ *================================*/
+/*
+ * Function: Four BfM_PollWriter(void)
+ *
+ * Description:
+ *  Run the writer if a trickle or a checkpoint is due. This is called after
+ *  the operations which dirty buffers and costs one clock read otherwise.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four BfM_PollWriter(void)
+{
+    Four	e;		/* error number */
+    Four	now;		/* current time in msec */
+    struct timespec ts;		/* current time */
+
+
+    if (bfm_writerParams.trickleInterval == 0 && bfm_writerParams.checkpointInterval == 0)
+        return(eNOERROR);
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    if (!bfm_writerStarted) {
+        bfm_writerEpoch = ts;
+        bfm_lastTrickle = bfm_lastCheckpoint = 0;
+        bfm_writerStarted = TRUE;
+    }
+
+    now = BFM_WRITER_MSEC(ts);
+
+    if (bfm_writerParams.checkpointInterval > 0 &&
+        now - bfm_lastCheckpoint >= bfm_writerParams.checkpointInterval) {
+        bfm_lastCheckpoint = bfm_lastTrickle = now;
+
+        e = BfM_RunWriter(TRUE);
+        if (e < 0) ERR(e);
+    }
+    else if (bfm_writerParams.trickleInterval > 0 &&
+             now - bfm_lastTrickle >= bfm_writerParams.trickleInterval) {
+        bfm_lastTrickle = now;
+
+        e = BfM_RunWriter(FALSE);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* BfM_PollWriter() */
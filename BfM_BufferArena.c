@@ -0,0 +1,471 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_BufferArena.c
+ *
+ * Description:
+ *  Place the buffer pools in memory suited to the buffer frames. The buffer
+ *  manager in cosmos.o allocates its buffer pools with malloc(); they are
+ *  neither aligned to PAGESIZE nor backed by huge pages.
+ *   - Unaligned frames make the raw disk manager read every train into an
+ *     aligned buffer of its own and copy it, and the reverse for every
+ *     write; aligned frames are read and written in place, which is also
+ *     what direct I/O(see RDsM_SetDirectIO()) needs.
+ *   - A large buffer pool on 4 KB pages takes a TLB miss on almost every
+ *     random access; on 2 MB huge pages one TLB entry covers 512 frames.
+ *
+ *  The buffer pools can be moved into
+ *   - BFM_ARENA_HUGETLB: one contiguous arena of explicit huge pages
+ *     (hugetlbfs; the pages must have been reserved by the administrator),
+ *   - BFM_ARENA_THP: memory aligned to the huge page size and advised to
+ *     use transparent huge pages, or
+ *   - BFM_ARENA_HEAP: memory aligned to PAGESIZE.
+ *  A mode which is not available falls back to the next one.
+ *
+ *  The buffer manager frees the buffer pools with free() when the system is
+ *  finalized(BfM_Final()), which memory of BFM_ARENA_HUGETLB cannot take.
+ *  The calls of free() in cosmos.o go through __wrap_free(), which leaves a
+ *  buffer pool in the arena alone and unmaps the arena once every buffer
+ *  pool has been freed, so BfM_ReleaseBufferArena() need not be called
+ *  before; the mode is BFM_ARENA_MALLOC again after the finalization.
+ *
+ * Exports:
+ *  Four BfM_SetUpBufferArena(Four)
+ *  Four BfM_ReleaseBufferArena(void)
+ *  Four BfM_GetBufferArenaStats(BfM_ArenaStats*)
+ *  Four BfM_AlignBufferPools(void)
+ *
+ * Internal:
+ *  void __wrap_free(void*)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+
+
+
+/*@
+ * Macro Definitions
+ */
+/* round up to a multiple of the huge page size */
+#define BFM_HUGE_PAGE_ROUNDUP(size) \
+    (((size) + BFM_HUGE_PAGE_SIZE - 1) & ~((size_t)BFM_HUGE_PAGE_SIZE - 1))
+
+/* size of the buffer pool of the given type */
+#define BFM_POOL_SIZE(type) \
+    ((size_t)BI_NBUFS(type) * BI_BUFSIZE(type) * PAGESIZE)
+
+
+/*@
+ * Global Variables
+ */
+static Four bfm_arenaMode = BFM_ARENA_MALLOC;	/* where the buffer pools are */
+static char *bfm_hugetlbArena = NULL;		/* arena of BFM_ARENA_HUGETLB */
+static size_t bfm_hugetlbArenaSize = 0;
+static UFour bfm_arenaFallbacks = 0;		/* the number of fallbacks to the next mode */
+static Four bfm_poolsFreed = 0;			/* buffer pools freed by the finalization */
+
+
+/* the real function in the C library */
+void __real_free(void *);
+
+
+
+/*@================================
+ * bfm_CheckNoFixedBuffers()
+ *================================*/
+/*
+ * Function: Four bfm_CheckNoFixedBuffers(void)
+ *
+ * Description:
+ *  Check that no train is fixed. The fixers hold pointers into the buffer
+ *  pool, so the buffer pool cannot be moved while a train is fixed.
+ *
+ * Returns:
+ *  error code
+ *    eFIXEDBUFFERS_BFM
+ */
+static Four bfm_CheckNoFixedBuffers(void)
+{
+    Four	type;		/* buffer type */
+    Four	i;		/* index variable */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        for (i = 0; i < BI_NBUFS(type); i++)
+            if (BI_FIXED(type, i) > 0) ERR(eFIXEDBUFFERS_BFM);
+
+    return(eNOERROR);
+
+} /* bfm_CheckNoFixedBuffers() */
+
+
+
+/*@================================
+ * bfm_MoveBufferPool()
+ *================================*/
+/*
+ * Function: void bfm_MoveBufferPool(Four, char*)
+ *
+ * Description:
+ *  Move the buffer pool to the given memory with the trains in it. The old
+ *  memory is freed unless it belongs to the huge page arena.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_MoveBufferPool(
+    Four	type,		/* IN buffer type */
+    char	*pool)		/* IN new memory of the buffer pool */
+{
+    char	*old = BI_BUFFERPOOL(type);
+
+
+    memcpy(pool, old, BFM_POOL_SIZE(type));
+
+    /* moved first, so that __wrap_free() does not take it for the finalization */
+    BI_BUFFERPOOL(type) = pool;
+
+    if (old < bfm_hugetlbArena || old >= bfm_hugetlbArena + bfm_hugetlbArenaSize) free(old);
+
+} /* bfm_MoveBufferPool() */
+
+
+
+/*@================================
+ * bfm_SetUpMallocedPools()
+ *================================*/
+/*
+ * Function: Four bfm_SetUpMallocedPools(Four)
+ *
+ * Description:
+ *  Move each buffer pool into memory allocated by posix_memalign(). For
+ *  BFM_ARENA_THP the memory is aligned to the huge page size and advised to
+ *  use transparent huge pages; if the advice is refused, the memory stays
+ *  and the mode falls back to BFM_ARENA_HEAP.
+ *
+ * Returns:
+ *  mode set up (BFM_ARENA_THP or BFM_ARENA_HEAP)
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four bfm_SetUpMallocedPools(
+    Four	mode)		/* IN BFM_ARENA_THP or BFM_ARENA_HEAP */
+{
+    Four	type;		/* buffer type */
+    size_t	size;		/* size of the memory allocated */
+    void	*pool;		/* new memory of a buffer pool */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++) {
+        if (mode == BFM_ARENA_THP) {
+            size = BFM_HUGE_PAGE_ROUNDUP(BFM_POOL_SIZE(type));
+            if (posix_memalign(&pool, BFM_HUGE_PAGE_SIZE, size) != 0) ERR(eMEMORYALLOCERR);
+
+            if (madvise(pool, size, MADV_HUGEPAGE) < 0) {
+                /* transparent huge pages are disabled */
+                bfm_arenaFallbacks++;
+                mode = BFM_ARENA_HEAP;
+            }
+        }
+        else {
+            if (posix_memalign(&pool, PAGESIZE, BFM_POOL_SIZE(type)) != 0) ERR(eMEMORYALLOCERR);
+        }
+
+        bfm_MoveBufferPool(type, (char *)pool);
+    }
+
+    return(mode);
+
+} /* bfm_SetUpMallocedPools() */
+
+
+
+/*@================================
+ * bfm_SetUpHugetlbArena()
+ *================================*/
+/*
+ * Function: Four bfm_SetUpHugetlbArena(void)
+ *
+ * Description:
+ *  Move all the buffer pools into one arena of explicit huge pages, each
+ *  buffer pool starting on a huge page boundary.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four bfm_SetUpHugetlbArena(void)
+{
+    Four	type;		/* buffer type */
+    size_t	size;		/* size of the arena */
+    size_t	offset;		/* offset of a buffer pool in the arena */
+    char	*arena;		/* new arena */
+
+
+    for (type = 0, size = 0; type < NUM_BUF_TYPES; type++)
+        size += BFM_HUGE_PAGE_ROUNDUP(BFM_POOL_SIZE(type));
+
+    arena = (char *)mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB, -1, 0);
+    if (arena == (char *)MAP_FAILED) return(eMEMORYALLOCERR);
+
+    for (type = 0, offset = 0; type < NUM_BUF_TYPES; type++) {
+        bfm_MoveBufferPool(type, arena + offset);
+        offset += BFM_HUGE_PAGE_ROUNDUP(BFM_POOL_SIZE(type));
+    }
+
+    bfm_hugetlbArena = arena;
+    bfm_hugetlbArenaSize = size;
+
+    return(eNOERROR);
+
+} /* bfm_SetUpHugetlbArena() */
+
+
+
+/*@================================
+ * BfM_SetUpBufferArena()
+ *================================*/
+/*
+ * Function: Four BfM_SetUpBufferArena(Four)
+ *
+ * Description:
+ *  Move the buffer pools, with the trains in them, into memory of the given
+ *  mode or of the first available mode after it. No train may be fixed; the
+ *  function is meant to be called right after the system is initialized.
+ *
+ * Returns:
+ *  mode set up (BFM_ARENA_HUGETLB, BFM_ARENA_THP, or BFM_ARENA_HEAP)
+ *  error code
+ *    eBADPARAMETER
+ *    eFIXEDBUFFERS_BFM
+ *    eMEMORYALLOCERR
+ *
+ * Side effects:
+ *  the buffer pools are reallocated
+ */
+Four BfM_SetUpBufferArena(
+    Four	mode)		/* IN BFM_ARENA_HUGETLB, BFM_ARENA_THP, or BFM_ARENA_HEAP */
+{
+    Four	e;		/* error number */
+    char	*oldArena;	/* arena of explicit huge pages in use */
+    size_t	oldArenaSize;
+
+
+    if (mode != BFM_ARENA_HUGETLB && mode != BFM_ARENA_THP && mode != BFM_ARENA_HEAP) ERR(eBADPARAMETER);
+
+    e = bfm_CheckNoFixedBuffers();
+    if (e < 0) ERR(e);
+
+    oldArena = bfm_hugetlbArena;
+    oldArenaSize = bfm_hugetlbArenaSize;
+
+    if (mode == BFM_ARENA_HUGETLB) {
+        if (bfm_SetUpHugetlbArena() == eNOERROR) {
+            if (oldArena != NULL) munmap(oldArena, oldArenaSize);
+            bfm_arenaMode = BFM_ARENA_HUGETLB;
+            return(bfm_arenaMode);
+        }
+
+        /* no huge pages are reserved */
+        bfm_arenaFallbacks++;
+        mode = BFM_ARENA_THP;
+    }
+
+    e = bfm_SetUpMallocedPools(mode);
+    if (e < 0) ERR(e);
+
+    if (oldArena != NULL) {
+        munmap(oldArena, oldArenaSize);
+        bfm_hugetlbArena = NULL;
+        bfm_hugetlbArenaSize = 0;
+    }
+    bfm_arenaMode = e;
+
+    return(bfm_arenaMode);
+
+} /* BfM_SetUpBufferArena() */
+
+
+
+/*@================================
+ * BfM_ReleaseBufferArena()
+ *================================*/
+/*
+ * Function: Four BfM_ReleaseBufferArena(void)
+ *
+ * Description:
+ *  Move the buffer pools out of the arena of explicit huge pages into memory
+ *  which the buffer manager can free, giving the huge pages back while the
+ *  system runs; the finalization does it by itself(see __wrap_free()). It
+ *  does nothing in the other modes.
+ *
+ * Returns:
+ *  error code
+ *    eFIXEDBUFFERS_BFM
+ *    eMEMORYALLOCERR
+ */
+Four BfM_ReleaseBufferArena(void)
+{
+    Four	e;		/* error number */
+
+
+    if (bfm_hugetlbArena == NULL) return(eNOERROR);
+
+    e = BfM_SetUpBufferArena(BFM_ARENA_THP);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_ReleaseBufferArena() */
+
+
+
+/*@================================
+ * BfM_GetBufferArenaStats()
+ *================================*/
+/*
+ * Function: Four BfM_GetBufferArenaStats(BfM_ArenaStats*)
+ *
+ * Description:
+ *  Return where the buffer pools are and how they map onto huge pages.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_GetBufferArenaStats(
+    BfM_ArenaStats *stats)	/* OUT statistics */
+{
+    Four	type;		/* buffer type */
+
+
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    stats->mode = bfm_arenaMode;
+    stats->fallbacks = bfm_arenaFallbacks;
+    stats->hugePages = 0;
+
+    if (bfm_arenaMode == BFM_ARENA_HUGETLB || bfm_arenaMode == BFM_ARENA_THP)
+        for (type = 0; type < NUM_BUF_TYPES; type++)
+            stats->hugePages += BFM_HUGE_PAGE_ROUNDUP(BFM_POOL_SIZE(type)) / BFM_HUGE_PAGE_SIZE;
+
+    /* frames of PAGE_BUF covered by one TLB entry */
+    if (bfm_arenaMode == BFM_ARENA_HUGETLB || bfm_arenaMode == BFM_ARENA_THP)
+        stats->framesPerHugePage = BFM_HUGE_PAGE_SIZE / (BI_BUFSIZE(PAGE_BUF) * PAGESIZE);
+    else
+        stats->framesPerHugePage = 1;
+
+    return(eNOERROR);
+
+} /* BfM_GetBufferArenaStats() */
+
+
+
+/*@================================
+ * BfM_AlignBufferPools()
+ *================================*/
+/*
+ * Function: Four BfM_AlignBufferPools(void)
+ *
+ * Description:
+ *  Align the buffer frames to PAGESIZE without asking for huge pages; the
+ *  buffer pools which are aligned already are not moved.
+ *
+ * Returns:
+ *  error code
+ *    eFIXEDBUFFERS_BFM
+ *    eMEMORYALLOCERR
+ *
+ * Side effects:
+ *  the buffer pools may be reallocated
+ */
+Four BfM_AlignBufferPools(void)
+{
+    Four	e;		/* error number */
+    Four	type;		/* buffer type */
+
+
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        if (((unsigned long)BI_BUFFERPOOL(type) & (PAGESIZE - 1)) != 0) break;
+
+    if (type == NUM_BUF_TYPES) return(eNOERROR);
+
+    e = BfM_SetUpBufferArena(BFM_ARENA_HEAP);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_AlignBufferPools() */
+
+
+
+/*@================================
+ * __wrap_free()
+ *================================*/
+/*
+ * Function: void __wrap_free(void*)
+ *
+ * Description:
+ *  free() of cosmos.o. A buffer pool freed is being finalized: memory of
+ *  the huge page arena is not passed to free(), and the arena is unmapped
+ *  once every buffer pool has been freed, as BfM_ReleaseBufferArena() would
+ *  have done. Any other memory is freed as it is.
+ *
+ * Returns:
+ *  None
+ */
+void __wrap_free(
+    void	*ptr)		/* IN memory to free */
+{
+    Four	type;		/* buffer type */
+    Boolean	inArena;	/* is the memory in the arena of explicit huge pages? */
+
+
+    if (ptr == NULL || bfm_arenaMode == BFM_ARENA_MALLOC) {
+        __real_free(ptr);
+        return;
+    }
+
+    for (type = 0; type < NUM_BUF_TYPES; type++)
+        if (BI_BUFFERPOOL(type) == (char *)ptr) break;
+
+    inArena = ((char *)ptr >= bfm_hugetlbArena && (char *)ptr < bfm_hugetlbArena + bfm_hugetlbArenaSize);
+    if (!inArena) __real_free(ptr);
+
+    if (type == NUM_BUF_TYPES || ++bfm_poolsFreed < NUM_BUF_TYPES) return;
+
+    /* the buffer manager is finalized; it allocates its pools again with malloc() */
+    if (bfm_hugetlbArena != NULL) munmap(bfm_hugetlbArena, bfm_hugetlbArenaSize);
+    bfm_hugetlbArena = NULL;
+    bfm_hugetlbArenaSize = 0;
+    bfm_poolsFreed = 0;
+    bfm_arenaMode = BFM_ARENA_MALLOC;
+
+} /* __wrap_free() */
@@ -0,0 +1,281 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_FrameVersion.c
+ *
+ * Description:
+ *  Maintain a seqlock style version counter per buffer frame so that a small
+ *  read can be done optimistically: the reader copies the data straight out
+ *  of the frame without fixing it, and then validates that no writer touched
+ *  the frame meanwhile. The version is odd while a writer is modifying the
+ *  frame and is increased by two for each completed write.
+ *
+ *  Writers must have the train fixed between BfM_BeginFrameWrite() and
+ *  BfM_EndFrameWrite(). The buffer manager in cosmos.o does not know about
+ *  the versions, so the wrappers of BfM_GetTrain() and BfM_GetNewTrain()
+ *  increase the version of the frame a miss replaced by two(see
+ *  bfm_ReplaceFrameVersion()); a reader which looked up the frame before the
+ *  replacement fails its validation even if the same train is read back
+ *  into the frame. A reader also checks that the frame still holds the same
+ *  train, which catches the replacements done inside cosmos.o.
+ *
+ * Exports:
+ *  Four BfM_BeginFrameWrite(TrainID*, Four)
+ *  Four BfM_EndFrameWrite(TrainID*, Four)
+ *  char *BfM_LookUpFrame(TrainID*, Four, UFour*)
+ *  Boolean BfM_ValidateFrame(TrainID*, Four, char*, UFour)
+ *
+ * Internal:
+ *  void bfm_ReplaceFrameVersion(TrainID*, Four)
+ */
+
+
+#include <stdlib.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* version counters indexed by the buffer frame; allocated on the first write */
+static UFour *bfm_frameVersion[NUM_BUF_TYPES] = { NULL, NULL };
+
+
+/* Macro: BFM_FRAME_VERSION(type, idx)
+ * Description: return the version counter of the buffer frame
+ * Returns: (UFour) the version counter; 0 if the frame has never been written
+ */
+#define BFM_FRAME_VERSION(type, idx) \
+    ((bfm_frameVersion[type] == NULL) ? 0 : \
+     __atomic_load_n(&bfm_frameVersion[type][idx], __ATOMIC_ACQUIRE))
+
+
+
+/*@================================
+ * bfm_BumpFrameVersion()
+ *================================*/
+/*
+ * Function: Four bfm_BumpFrameVersion(TrainID*, Four, UFour)
+ *
+ * Description:
+ *  Increase the version counter of the frame holding the given train by
+ *  'delta'.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    eNOTFOUND_BFM
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bfm_BumpFrameVersion(
+    TrainID	*trainId,	/* IN train being modified */
+    Four	type,		/* IN buffer type */
+    UFour	delta)		/* IN 1 for a write, 2 for a replacement */
+{
+    Four	idx;		/* index of the buffer frame */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) ERR(eBADBUFFERTYPE_BFM);
+
+    /* bfm_LookUp() returns an error as well for a bad train ID */
+    idx = bfm_LookUp((BfMHashKey *)trainId, type);
+    if (idx == NOTFOUND_IN_HTABLE) ERR(eNOTFOUND_BFM);
+    if (idx < 0) ERR(idx);
+
+    if (bfm_frameVersion[type] == NULL) {
+        bfm_frameVersion[type] = (UFour *)calloc(BI_NBUFS(type), sizeof(UFour));
+        if (bfm_frameVersion[type] == NULL) ERR(eMEMORYALLOCERR);
+    }
+
+    __atomic_fetch_add(&bfm_frameVersion[type][idx], delta, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return(eNOERROR);
+
+} /* bfm_BumpFrameVersion() */
+
+
+
+/*@================================
+ * BfM_BeginFrameWrite()
+ *================================*/
+/*
+ * Function: Four BfM_BeginFrameWrite(TrainID*, Four)
+ *
+ * Description:
+ *  Announce that the fixed train is about to be modified. The optimistic
+ *  readers of the frame retry until BfM_EndFrameWrite() is called.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    eNOTFOUND_BFM
+ *    eMEMORYALLOCERR
+ */
+Four BfM_BeginFrameWrite(
+    TrainID	*trainId,	/* IN train to modify */
+    Four	type)		/* IN buffer type */
+{
+    return(bfm_BumpFrameVersion(trainId, type, 1));
+
+} /* BfM_BeginFrameWrite() */
+
+
+
+/*@================================
+ * BfM_EndFrameWrite()
+ *================================*/
+/*
+ * Function: Four BfM_EndFrameWrite(TrainID*, Four)
+ *
+ * Description:
+ *  Announce that the modification started by BfM_BeginFrameWrite() is done.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    eNOTFOUND_BFM
+ */
+Four BfM_EndFrameWrite(
+    TrainID	*trainId,	/* IN train modified */
+    Four	type)		/* IN buffer type */
+{
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return(bfm_BumpFrameVersion(trainId, type, 1));
+
+} /* BfM_EndFrameWrite() */
+
+
+
+/*@================================
+ * BfM_LookUpFrame()
+ *================================*/
+/*
+ * Function: char *BfM_LookUpFrame(TrainID*, Four, UFour*)
+ *
+ * Description:
+ *  Return the buffer frame holding the given train without fixing it, together
+ *  with the version to be validated by BfM_ValidateFrame() after the reader
+ *  has copied what it needs. Nothing shared is written. If the version is odd,
+ *  a writer is modifying the frame and the reader should retry.
+ *
+ * Returns:
+ *  pointer to the buffer frame
+ *  NULL if the train is not in the buffer pool or the train ID is bad
+ *
+ * Side effects:
+ *  1) parameter version
+ *     version is set to the version of the frame
+ */
+char *BfM_LookUpFrame(
+    TrainID	*trainId,	/* IN train to read */
+    Four	type,		/* IN buffer type */
+    UFour	*version)	/* OUT version of the frame */
+{
+    Four	idx;		/* index of the buffer frame */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) return(NULL);
+
+    /* not found, or an error for a bad train ID */
+    idx = bfm_LookUp((BfMHashKey *)trainId, type);
+    if (idx < 0) return(NULL);
+
+    *version = BFM_FRAME_VERSION(type, idx);
+
+    return(BI_BUFFER(type, idx));
+
+} /* BfM_LookUpFrame() */
+
+
+
+/*@================================
+ * BfM_ValidateFrame()
+ *================================*/
+/*
+ * Function: Boolean BfM_ValidateFrame(TrainID*, Four, char*, UFour)
+ *
+ * Description:
+ *  Check that the frame returned by BfM_LookUpFrame() still holds the train
+ *  and has not been modified since then. A read found consistent is counted
+ *  as a hit of the buffer pool.
+ *
+ * Returns:
+ *  TRUE if the data read from the frame is consistent
+ *  FALSE otherwise; the reader should retry
+ */
+Boolean BfM_ValidateFrame(
+    TrainID	*trainId,	/* IN train read */
+    Four	type,		/* IN buffer type */
+    char	*frame,		/* IN frame returned by BfM_LookUpFrame() */
+    UFour	version)	/* IN version returned by BfM_LookUpFrame() */
+{
+    Four	idx;		/* index of the buffer frame */
+
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    idx = (frame - BI_BUFFERPOOL(type)) / (BI_BUFSIZE(type)*PAGESIZE);
+
+    if (!EQUAL_BFMHASHKEY(BI_KEY(type, idx), *trainId)) return(FALSE);
+    if (BFM_FRAME_VERSION(type, idx) != version) return(FALSE);
+
+    /* the read is a hit of the buffer pool(see BfM_Stats.c) */
+    bfm_CountOptimisticHit(type);
+
+    return(TRUE);
+
+} /* BfM_ValidateFrame() */
+
+
+
+/*@================================
+ * bfm_ReplaceFrameVersion()
+ *================================*/
+/*
+ * Function: void bfm_ReplaceFrameVersion(TrainID*, Four)
+ *
+ * Description:
+ *  Increase the version of the frame into which a miss has just read the
+ *  train by two, keeping it even, so that the optimistic readers of the
+ *  train replaced fail their validation. Nothing is done until the first
+ *  write allocates the versions, as no reader holds a version then.
+ *
+ * Returns:
+ *  None
+ */
+void bfm_ReplaceFrameVersion(
+    TrainID	*trainId,	/* IN train read into the frame */
+    Four	type)		/* IN buffer type */
+{
+    if (type < 0 || type >= NUM_BUF_TYPES || bfm_frameVersion[type] == NULL) return;
+
+    (void) bfm_BumpFrameVersion(trainId, type, 2);
+
+} /* bfm_ReplaceFrameVersion() */
@@ -0,0 +1,129 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_MappedTrain.c
+ *
+ * Description:
+ *  Fix trains for reading. A train of a memory-mapped volume(see
+ *  RDsM_MapVolume()) which is not in the buffer pool is returned in place
+ *  from the mapping: no buffer frame is allocated and nothing is copied.
+ *  Any other train is fixed in the buffer pool as BfM_GetTrain() does.
+ *
+ *  A train returned from the mapping must not be modified.
+ *
+ * Exports:
+ *  Four BfM_GetTrainForRead(TrainID*, char**, Four)
+ *  Four BfM_FreeTrainForRead(TrainID*, char*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM_Internal.h"
+
+
+
+/*@================================
+ * BfM_GetTrainForRead()
+ *================================*/
+/*
+ * Function: Four BfM_GetTrainForRead(TrainID*, char**, Four)
+ *
+ * Description:
+ *  Return a pointer to the train for reading. The train is read from the
+ *  buffer pool if it is there, as the buffer may be newer than the device;
+ *  otherwise from the mapping of its volume if the volume is mapped.
+ *  Every call must be paired with BfM_FreeTrainForRead().
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_GetTrainForRead(
+    TrainID	*trainId,	/* IN train to read */
+    char	**retBuf,	/* OUT pointer to the train */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    BfMHashKey	key;		/* hash key of the train */
+    char	*mapped;	/* train in the mapping */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) ERR(eBADBUFFERTYPE_BFM);
+
+    key.volNo = trainId->volNo;
+    key.pageNo = trainId->pageNo;
+
+    if (bfm_LookUp(&key, type) == NOTFOUND_IN_HTABLE) {
+        mapped = RDsM_GetMappedTrain((PageID *)trainId, BI_BUFSIZE(type));
+        if (mapped != NULL) {
+            *retBuf = mapped;
+            return(eNOERROR);
+        }
+    }
+
+    e = BfM_GetTrain(trainId, retBuf, type);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_GetTrainForRead() */
+
+
+
+/*@================================
+ * BfM_FreeTrainForRead()
+ *================================*/
+/*
+ * Function: Four BfM_FreeTrainForRead(TrainID*, char*, Four)
+ *
+ * Description:
+ *  Release a train returned by BfM_GetTrainForRead(). Only a train in the
+ *  buffer pool has to be freed.
+ *
+ * Returns:
+ *  error code
+ *    eBADBUFFERTYPE_BFM
+ *    some errors caused by function calls
+ */
+Four BfM_FreeTrainForRead(
+    TrainID	*trainId,	/* IN train to release */
+    char	*buf,		/* IN pointer returned by BfM_GetTrainForRead() */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) ERR(eBADBUFFERTYPE_BFM);
+
+    if (buf < BI_BUFFERPOOL(type) || buf >= BI_BUFFER(type, BI_NBUFS(type))) return(eNOERROR);
+
+    e = BfM_FreeTrain(trainId, type);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* BfM_FreeTrainForRead() */
@@ -0,0 +1,448 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_NumaPartition.c
+ *
+ * Description:
+ *  Partition the PAGE_BUF buffer pool over the NUMA nodes of the machine.
+ *  Each partition is a contiguous range of buffer frames whose memory is
+ *  placed on one node, and has a replacement clock of its own. Frames for
+ *  trains read on a miss of BfM_GetTrain()(through the wrapper in
+ *  BfM_Stats.c) and by the batched reads(see BfM_Prefetch.c) are taken from
+ *  the partition of the node the calling thread runs on, so that the thread
+ *  touches node-local memory; if the node is not known the partition is
+ *  chosen by hashing the TrainID. On a single node machine there is one
+ *  partition and nothing changes.
+ *
+ *  The buffer table and the hash table belong to the buffer manager in
+ *  cosmos.o and are shared by the partitions; only the choice of the frame
+ *  is partitioned. BfM_GetNewTrain() and the buffer manager's internal
+ *  reads still take the frame chosen by the clock of cosmos.o.
+ *
+ * Exports:
+ *  Four BfM_SetUpNumaPartitions(Four)
+ *  Four BfM_GetNumPartitions(void)
+ *  Four BfM_GetPartitionStats(Four, BfM_PartitionStats*)
+ *
+ * Internal:
+ *  Four bfm_AllocPartitionTrain(TrainID*, Four)
+ *  Four bfm_ReadPartitionTrain(TrainID*, Four)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define BFM_NODE_ONLINE_FILE    "/sys/devices/system/node/online"
+
+
+/*@
+ * Type Definitions
+ */
+/* a partition of the buffer pool */
+typedef struct {
+    Four	node;		/* NUMA node holding the memory of the partition */
+    Four	firstFrame;	/* first buffer frame of the partition */
+    Four	nFrames;	/* the number of buffer frames */
+    Four	nextVictim;	/* where the next victim search starts */
+    UFour	localAllocs;	/* frames allocated in the partition */
+    UFour	fallbacks;	/* allocations passed to the buffer manager */
+} bfm_Partition;
+
+
+/*@
+ * Global Variables
+ */
+static bfm_Partition bfm_partition[BFM_MAX_PARTITIONS];
+static Four bfm_nPartitions = 1;
+static Boolean bfm_partitioned = FALSE;	/* TRUE after BfM_SetUpNumaPartitions() */
+
+
+
+/*@================================
+ * bfm_GetOnlineNodes()
+ *================================*/
+/*
+ * Function: Four bfm_GetOnlineNodes(Four*, Four)
+ *
+ * Description:
+ *  Read the online NUMA nodes, e.g. "0-1,3", from sysfs.
+ *
+ * Returns:
+ *  the number of nodes (1 if they cannot be read)
+ */
+static Four bfm_GetOnlineNodes(
+    Four	*nodes,		/* OUT node numbers */
+    Four	maxNodes)	/* IN size of 'nodes' */
+{
+    FILE	*fp;		/* the sysfs file */
+    char	line[256];	/* contents of the file */
+    char	*p;		/* current position in 'line' */
+    long	from, to;	/* range of nodes */
+    Four	n;		/* the number of nodes */
+
+
+    n = 0;
+
+    fp = fopen(BFM_NODE_ONLINE_FILE, "r");
+    if (fp != NULL) {
+        if (fgets(line, sizeof(line), fp) != NULL) {
+            for (p = line; *p != '\0' && *p != '\n' && n < maxNodes; ) {
+                from = to = strtol(p, &p, 10);
+                if (*p == '-') to = strtol(p + 1, &p, 10);
+                for ( ; from <= to && n < maxNodes; from++) nodes[n++] = from;
+                if (*p == ',') p++;
+                else break;
+            }
+        }
+        fclose(fp);
+    }
+
+    if (n == 0) nodes[n++] = 0;
+
+    return(n);
+
+} /* bfm_GetOnlineNodes() */
+
+
+
+/*@================================
+ * BfM_SetUpNumaPartitions()
+ *================================*/
+/*
+ * Function: Four BfM_SetUpNumaPartitions(Four)
+ *
+ * Description:
+ *  Split the PAGE_BUF frames into partitions and place the memory of each
+ *  partition on a node. With 'nPartitions' 0 there is one partition per
+ *  online node; with more partitions than nodes, the partitions are given
+ *  to the nodes in turn. The buffer pool should be aligned to PAGESIZE
+ *  (see BfM_SetUpBufferArena()) so that no memory page straddles two
+ *  partitions.
+ *
+ * Returns:
+ *  the number of partitions
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_SetUpNumaPartitions(
+    Four	nPartitions)	/* IN the number of partitions; 0 for one per node */
+{
+    Four	nodes[BFM_MAX_PARTITIONS];	/* online nodes */
+    Four	nNodes;		/* the number of online nodes */
+    Four	p;		/* index of a partition */
+    unsigned long nodeMask;	/* node of a partition as a mask */
+    char	*start;		/* memory of a partition */
+
+
+    if (nPartitions < 0 || nPartitions > BFM_MAX_PARTITIONS) ERR(eBADPARAMETER);
+
+    nNodes = bfm_GetOnlineNodes(nodes, BFM_MAX_PARTITIONS);
+    if (nPartitions == 0) nPartitions = nNodes;
+    if (nPartitions > BI_NBUFS(PAGE_BUF)) nPartitions = BI_NBUFS(PAGE_BUF);
+
+    for (p = 0; p < nPartitions; p++) {
+        bfm_partition[p].node = nodes[p % nNodes];
+        bfm_partition[p].firstFrame = (Four)((long)BI_NBUFS(PAGE_BUF) * p / nPartitions);
+        bfm_partition[p].nFrames = (Four)((long)BI_NBUFS(PAGE_BUF) * (p + 1) / nPartitions) - bfm_partition[p].firstFrame;
+        bfm_partition[p].nextVictim = 0;
+        bfm_partition[p].localAllocs = 0;
+        bfm_partition[p].fallbacks = 0;
+
+        /* placing memory only matters if there are several nodes */
+        if (nNodes > 1 && bfm_partition[p].node < (Four)(8 * sizeof(nodeMask))) {
+            nodeMask = 1UL << bfm_partition[p].node;
+            start = BI_BUFFER(PAGE_BUF, bfm_partition[p].firstFrame);
+            (void)syscall(__NR_mbind, start, (unsigned long)bfm_partition[p].nFrames * BI_BUFSIZE(PAGE_BUF) * PAGESIZE,
+                          MPOL_PREFERRED, &nodeMask, 8 * sizeof(nodeMask), MPOL_MF_MOVE);
+        }
+    }
+
+    bfm_nPartitions = nPartitions;
+    bfm_partitioned = TRUE;
+
+    return(bfm_nPartitions);
+
+} /* BfM_SetUpNumaPartitions() */
+
+
+
+/*@================================
+ * BfM_GetNumPartitions()
+ *================================*/
+/*
+ * Function: Four BfM_GetNumPartitions(void)
+ *
+ * Description:
+ *  Return the number of partitions of the PAGE_BUF buffer pool.
+ *
+ * Returns:
+ *  the number of partitions
+ */
+Four BfM_GetNumPartitions(void)
+{
+    return(bfm_nPartitions);
+
+} /* BfM_GetNumPartitions() */
+
+
+
+/*@================================
+ * bfm_ChoosePartition()
+ *================================*/
+/*
+ * Function: Four bfm_ChoosePartition(TrainID*)
+ *
+ * Description:
+ *  Choose the partition for a train read by the calling thread: the first
+ *  partition on the thread's node, or by hashing the TrainID.
+ *
+ * Returns:
+ *  index of the partition
+ */
+static Four bfm_ChoosePartition(
+    TrainID	*trainId)	/* IN train to be read */
+{
+    unsigned	cpu, node;	/* where the calling thread runs */
+    Four	p;		/* index of a partition */
+    Four	first = NIL;	/* first partition on the node */
+    Four	n = 0;		/* the number of partitions on the node */
+    UFour	hash;		/* hash value of the train */
+
+
+    hash = (UFour)trainId->pageNo * 2654435761U + (UFour)trainId->volNo;
+
+    if (syscall(__NR_getcpu, &cpu, &node, NULL) == 0) {
+        for (p = 0; p < bfm_nPartitions; p++) {
+            if (bfm_partition[p].node != (Four)node) continue;
+            if (first == NIL) first = p;
+            n++;
+        }
+    }
+
+    if (first == NIL) return(hash % bfm_nPartitions);
+
+    /* several partitions on the node: spread the trains over them */
+    for (p = first, hash %= n; ; p++)
+        if (bfm_partition[p].node == (Four)node && hash-- == 0) return(p);
+
+} /* bfm_ChoosePartition() */
+
+
+
+/*@================================
+ * bfm_AllocPartitionTrain()
+ *================================*/
+/*
+ * Function: Four bfm_AllocPartitionTrain(TrainID*, Four)
+ *
+ * Description:
+ *  Allocate a buffer frame for the train, preferring a frame of the
+ *  partition chosen for the calling thread. The victim is chosen by the
+ *  second chance algorithm within the partition; a dirty victim is written
+ *  first. If the partition has no unfixed frame, or the buffer pool is not
+ *  partitioned, the buffer manager allocates the frame.
+ *
+ * Returns:
+ *  index of the buffer frame allocated
+ *  error code
+ *    some errors caused by function calls
+ */
+Four bfm_AllocPartitionTrain(
+    TrainID	*trainId,	/* IN train to be read into the frame */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    Four	p;		/* index of the partition */
+    Four	i;		/* the number of frames visited */
+    Four	idx;		/* index of the frame visited */
+    bfm_Partition *part;	/* the partition */
+    TrainID	victim;		/* train in the victim frame */
+
+
+    if (type != PAGE_BUF || !bfm_partitioned || bfm_nPartitions == 1) {
+        idx = bfm_AllocTrain(type);
+        if (idx < 0) ERR(idx);
+        return(idx);
+    }
+
+    p = bfm_ChoosePartition(trainId);
+    part = &bfm_partition[p];
+
+    /* two rounds: the first may only clear the REFER bits */
+    for (i = 0; i < 2 * part->nFrames; i++) {
+        idx = part->firstFrame + part->nextVictim;
+        part->nextVictim = (part->nextVictim + 1) % part->nFrames;
+
+        if (BI_FIXED(type, idx) > 0) continue;
+
+        if (BI_BITS(type, idx) & REFER) {
+            BI_BITS(type, idx) &= ~REFER;
+            continue;
+        }
+
+        if (IS_VALID_FRAME(type, idx)) {
+            victim.volNo = BI_KEY(type, idx).volNo;
+            victim.pageNo = BI_KEY(type, idx).pageNo;
+
+            if (BI_BITS(type, idx) & DIRTY) {
+                e = bfm_FlushTrain(&victim, type);
+                if (e < 0) ERR(e);
+            }
+
+            e = bfm_Delete(&BI_KEY(type, idx), type);
+            if (e < 0) ERR(e);
+        }
+
+        BI_BITS(type, idx) = 0;
+        part->localAllocs++;
+
+        return(idx);
+    }
+
+    part->fallbacks++;
+
+    idx = bfm_AllocTrain(type);
+    if (idx < 0) ERR(idx);
+
+    return(idx);
+
+} /* bfm_AllocPartitionTrain() */
+
+
+
+/*@================================
+ * bfm_ReadPartitionTrain()
+ *================================*/
+/*
+ * Function: Four bfm_ReadPartitionTrain(TrainID*, Four)
+ *
+ * Description:
+ *  Read a train which is not in the buffer pool into a frame allocated by
+ *  bfm_AllocPartitionTrain() and enter it in the hash table, so that the
+ *  BfM_GetTrain() which follows finds it there. Nothing is done unless the
+ *  PAGE_BUF buffer pool is partitioned; BfM_GetTrain() then reads the train
+ *  into the frame chosen by the buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four bfm_ReadPartitionTrain(
+    TrainID	*trainId,	/* IN train to be read */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    Four	idx;		/* index of the frame allocated */
+
+
+    if (type != PAGE_BUF || !bfm_partitioned || bfm_nPartitions == 1) return(eNOERROR);
+
+    idx = bfm_AllocPartitionTrain(trainId, type);
+    if (idx < 0) ERR(idx);
+
+    BI_KEY(type, idx).pageNo = NIL;
+    BI_BITS(type, idx) = 0;
+
+    e = bfm_ReadTrain(trainId, BI_BUFFER(type, idx), type);
+    if (e < 0) ERR(e);
+
+    BI_KEY(type, idx).volNo = trainId->volNo;
+    BI_KEY(type, idx).pageNo = trainId->pageNo;
+
+    e = bfm_Insert(&BI_KEY(type, idx), idx, type);
+    if (e < 0) {
+        BI_KEY(type, idx).pageNo = NIL;
+        ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bfm_ReadPartitionTrain() */
+
+
+
+/*@================================
+ * BfM_GetPartitionStats()
+ *================================*/
+/*
+ * Function: Four BfM_GetPartitionStats(Four, BfM_PartitionStats*)
+ *
+ * Description:
+ *  Return the statistics of a partition of the PAGE_BUF buffer pool.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_GetPartitionStats(
+    Four	p,		/* IN index of the partition */
+    BfM_PartitionStats *stats)	/* OUT statistics */
+{
+    Four	idx;		/* index of a frame */
+    Four	first, n;	/* frames of the partition */
+
+
+    if (p < 0 || p >= bfm_nPartitions || stats == NULL) ERR(eBADPARAMETER);
+
+    if (bfm_partitioned) {
+        first = bfm_partition[p].firstFrame;
+        n = bfm_partition[p].nFrames;
+        stats->node = bfm_partition[p].node;
+        stats->localAllocs = bfm_partition[p].localAllocs;
+        stats->fallbacks = bfm_partition[p].fallbacks;
+    }
+    else {
+        first = 0;
+        n = BI_NBUFS(PAGE_BUF);
+        stats->node = 0;
+        stats->localAllocs = 0;
+        stats->fallbacks = 0;
+    }
+
+    stats->nFrames = n;
+    stats->nValid = stats->nDirty = stats->nFixed = 0;
+
+    for (idx = first; idx < first + n; idx++) {
+        if (IS_VALID_FRAME(PAGE_BUF, idx)) stats->nValid++;
+        if (BI_BITS(PAGE_BUF, idx) & DIRTY) stats->nDirty++;
+        if (BI_FIXED(PAGE_BUF, idx) > 0) stats->nFixed++;
+    }
+
+    return(eNOERROR);
+
+} /* BfM_GetPartitionStats() */
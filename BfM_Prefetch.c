@@ -0,0 +1,309 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_Prefetch.c
+ *
+ * Description:
+ *  Read a set of trains into the buffer pool ahead of their use. The trains
+ *  are read in their physical order, and if an asynchronous I/O handle is
+ *  attached to the volume(see RDsM_AttachAsyncIO()) as many of them as the
+ *  handle allows are read at the same time instead of one after another.
+ *  Trains already in the buffer pool are skipped. A train with a page stored
+ *  compressed(see RDsM_Compression.c) is read synchronously, because the
+ *  handle reads the device as it is.
+ *
+ *  A prefetched train is left unfixed, so it is a candidate for replacement
+ *  as any other buffer which has been referenced once. Its frame is taken
+ *  from the NUMA partition of the calling thread(see BfM_NumaPartition.c).
+ *
+ * Exports:
+ *  Four BfM_PrefetchTrains(TrainID*, Four, Four)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM_Internal.h"
+#include "BfM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+/* maximum number of completions reaped at a time */
+#define BFM_PREFETCH_REAP_BATCH 16
+
+
+/*@
+ * Type Definitions
+ */
+/* a train to be prefetched */
+typedef struct {
+    TrainID	trainId;	/* train to read */
+    Two		idx;		/* buffer frame the train is read into */
+} bfm_PrefetchRequest;
+
+
+
+/*@================================
+ * bfm_ComparePrefetchRequest()
+ *================================*/
+/*
+ * Function: int bfm_ComparePrefetchRequest(const void*, const void*)
+ *
+ * Description:
+ *  Compare two requests by the physical position of their trains.
+ *
+ * Returns:
+ *  negative, zero, or positive as qsort() expects
+ */
+static int bfm_ComparePrefetchRequest(
+    const void	*a,		/* IN request */
+    const void	*b)		/* IN request */
+{
+    const TrainID *x = &((const bfm_PrefetchRequest *)a)->trainId;
+    const TrainID *y = &((const bfm_PrefetchRequest *)b)->trainId;
+
+
+    if (x->volNo != y->volNo) return(x->volNo - y->volNo);
+
+    return((x->pageNo > y->pageNo) - (x->pageNo < y->pageNo));
+
+} /* bfm_ComparePrefetchRequest() */
+
+
+
+/*@================================
+ * bfm_ReapPrefetch()
+ *================================*/
+/*
+ * Function: Four bfm_ReapPrefetch(RDsM_AsyncIO*, Four, Four, Four*, Four*)
+ *
+ * Description:
+ *  Wait for at least 'minComplete' reads in flight and install the trains
+ *  read into the buffer pool. A frame whose read failed is given back empty
+ *  and the error is kept in 'firstError' if it is the first one.
+ *
+ * Returns:
+ *  the number of reads reaped (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bfm_ReapPrefetch(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    Four	minComplete,	/* IN the number of reads to wait for */
+    Four	type,		/* IN buffer type */
+    Four	*nRead,		/* INOUT the number of trains installed */
+    Four	*firstError)	/* INOUT the first error of a read */
+{
+    Four	e;		/* error number */
+    Four	n;		/* the number of completions */
+    Four	k;		/* index variable */
+    bfm_PrefetchRequest *req;	/* request completed */
+    RDsM_AsyncIOCompletion done[BFM_PREFETCH_REAP_BATCH]; /* completions */
+
+
+    n = RDsM_WaitAsyncIO(aio, MIN(minComplete, BFM_PREFETCH_REAP_BATCH), done, BFM_PREFETCH_REAP_BATCH);
+    if (n < 0) ERR(n);
+
+    for (k = 0; k < n; k++) {
+        req = (bfm_PrefetchRequest *)done[k].userData;
+
+        e = done[k].result;
+        if (e == eNOERROR) {
+            BI_KEY(type, req->idx).volNo = req->trainId.volNo;
+            BI_KEY(type, req->idx).pageNo = req->trainId.pageNo;
+            BI_BITS(type, req->idx) = REFER;
+
+            e = bfm_Insert(&BI_KEY(type, req->idx), req->idx, type);
+        }
+
+        if (e < 0) {
+            if (*firstError == eNOERROR) *firstError = e;
+            BI_KEY(type, req->idx).pageNo = NIL;
+            BI_BITS(type, req->idx) = 0;
+        }
+        else
+            (*nRead)++;
+
+        BI_FIXED(type, req->idx) = 0;
+    }
+
+    return(n);
+
+} /* bfm_ReapPrefetch() */
+
+
+
+/*@================================
+ * BfM_PrefetchTrains()
+ *================================*/
+/*
+ * Function: Four BfM_PrefetchTrains(TrainID*, Four, Four)
+ *
+ * Description:
+ *  Read the given trains into the buffer pool, in their physical order and,
+ *  for volumes with an attached asynchronous I/O handle, in batches. Trains
+ *  in the buffer pool and duplicates are skipped. The buffer manager may
+ *  replace other unfixed buffers to make room, so prefetching more trains
+ *  than the buffer pool holds is useless.
+ *
+ * Returns:
+ *  the number of trains read (values greater than or equal to 0)
+ *  error code
+ *    eBADPARAMETER
+ *    eBADBUFFERTYPE_BFM
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ *
+ * Side effects:
+ *  unfixed buffers may be replaced
+ */
+Four BfM_PrefetchTrains(
+    TrainID	*trainIds,	/* IN trains to read */
+    Four	nTrains,	/* IN the number of trains */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    Four	i, j;		/* index variables */
+    Four	n;		/* the number of trains to read */
+    Four	nRead;		/* the number of trains read */
+    Four	nInFlight;	/* the number of reads in flight */
+    Four	firstError;	/* the first error of an asynchronous read */
+    Four	idx;		/* buffer frame allocated */
+    char	*buf;		/* pointer to the buffer frame */
+    bfm_PrefetchRequest *req;	/* trains to read */
+    RDsM_AsyncIO *aio;		/* asynchronous I/O handle of the volume */
+    BfMHashKey	key;		/* hash key of a train */
+
+
+    /*@ check parameters */
+    if (trainIds == NULL || nTrains < 0) ERR(eBADPARAMETER);
+
+    if (type < 0 || type >= NUM_BUF_TYPES) ERR(eBADBUFFERTYPE_BFM);
+
+    if (nTrains == 0) return(0);
+
+    req = (bfm_PrefetchRequest *)malloc(nTrains * sizeof(bfm_PrefetchRequest));
+    if (req == NULL) ERR(eMEMORYALLOCERR);
+
+    /* drop the trains in the buffer pool */
+    for (i = 0, n = 0; i < nTrains; i++) {
+        key.volNo = trainIds[i].volNo;
+        key.pageNo = trainIds[i].pageNo;
+        if (bfm_LookUp(&key, type) != NOTFOUND_IN_HTABLE) continue;
+
+        req[n].trainId = trainIds[i];
+        req[n].idx = NIL;
+        n++;
+    }
+
+    /* sort into the physical order and drop the duplicates */
+    qsort(req, n, sizeof(bfm_PrefetchRequest), bfm_ComparePrefetchRequest);
+
+    for (i = 0, j = 0; i < n; i++)
+        if (j == 0 || !EQUAL_BFMHASHKEY(req[j-1].trainId, req[i].trainId)) req[j++] = req[i];
+    n = j;
+
+    nRead = 0;
+    nInFlight = 0;
+    firstError = eNOERROR;
+    aio = NULL;
+
+    for (i = 0; i < n; i++) {
+
+        /* drain the reads of the previous volume before going on */
+        if (i == 0 || req[i].trainId.volNo != req[i-1].trainId.volNo) {
+            while (nInFlight > 0) {
+                e = bfm_ReapPrefetch(aio, nInFlight, type, &nRead, &firstError);
+                if (e < 0) goto failed;
+                nInFlight -= e;
+            }
+            if (firstError < 0) { e = firstError; goto failed; }
+            aio = RDsM_GetAttachedAsyncIO(req[i].trainId.volNo);
+        }
+
+        if (aio == NULL || rdsm_IsCompressedTrain((PageID *)&req[i].trainId, BI_BUFSIZE(type))) {
+            /* no asynchronous I/O, or the train has to be decompressed; read synchronously */
+            e = BfM_GetTrain(&req[i].trainId, &buf, type);
+            if (e < 0) goto failed;
+
+            e = BfM_FreeTrain(&req[i].trainId, type);
+            if (e < 0) goto failed;
+
+            nRead++;
+            continue;
+        }
+
+        idx = bfm_AllocPartitionTrain(&req[i].trainId, type);
+        if (idx < 0) { e = idx; goto failed; }
+
+        /* keep the frame from being chosen as a victim while it is read */
+        req[i].idx = idx;
+        BI_KEY(type, idx).pageNo = NIL;
+        BI_BITS(type, idx) = 0;
+        BI_FIXED(type, idx) = 1;
+
+        while ((e = RDsM_SubmitReadTrain(aio, &req[i].trainId, BI_BUFFER(type, idx),
+                                         BI_BUFSIZE(type), &req[i])) == eASYNCIOQUEUEFULL_RDSM) {
+            e = bfm_ReapPrefetch(aio, 1, type, &nRead, &firstError);
+            if (e < 0) break;
+            nInFlight -= e;
+        }
+        if (e < 0) {
+            BI_FIXED(type, idx) = 0;
+            goto failed;
+        }
+
+        nInFlight++;
+    }
+
+    while (nInFlight > 0) {
+        e = bfm_ReapPrefetch(aio, nInFlight, type, &nRead, &firstError);
+        if (e < 0) goto failed;
+        nInFlight -= e;
+    }
+
+    free(req);
+
+    if (firstError < 0) ERR(firstError);
+
+    return(nRead);
+
+failed:
+    /* do not leave frames fixed by the reads in flight */
+    while (nInFlight > 0) {
+        n = bfm_ReapPrefetch(aio, nInFlight, type, &nRead, &firstError);
+        if (n < 0) break;
+        nInFlight -= n;
+    }
+
+    free(req);
+
+    ERR(e);
+
+} /* BfM_PrefetchTrains() */
@@ -0,0 +1,697 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_Stats.c
+ *
+ * Description:
+ *  Instrumentation of the buffer manager. BfM_GetTrain(), BfM_GetNewTrain(),
+ *  BfM_FreeTrain() and BfM_SetDirty() called from this tree are linked to
+ *  the wrappers below(see 'ld --wrap' in the Makefile), which count, per
+ *  caller, the hits, the misses, the frames fixed and freed and the calls
+ *  of BfM_SetDirty(). An optimistic read which finds the train in the
+ *  buffer pool without fixing its frame(see BfM_ValidateFrame()) is counted
+ *  as a hit as well. The caller is the operation of the object manager in
+ *  progress(see BfM_SetCaller()). The calls made inside cosmos.o are not
+ *  counted. The misses also fire the bfm:get_train_miss probe(see
+ *  EduOM_Trace.h).
+ *
+ *  If BFM_STATS_DETAIL is defined(see the Makefile), the wrappers also
+ *  count the evictions and the dirty victims written, which fire the
+ *  bfm:evict probe, and how long the frames stay fixed. These cost more
+ *  than a counter, so they are compiled out by default: the buffer manager
+ *  in cosmos.o does not tell which frame it replaced, so on a miss the
+ *  victim is predicted by running its clock(second chance from
+ *  'nextVictim', skipping the fixed frames) without changing anything,
+ *  which may visit every frame, and checked against the frame the train
+ *  landed in afterwards; a miss whose victim was not predicted is counted
+ *  in 'unpredicted'. A pin is timed with clock_gettime() at the first fix
+ *  and the last unfix of the frame.
+ *
+ * Exports:
+ *  Four BfM_SetCaller(Four)
+ *  Four BfM_GetStats(BfM_Stats*)
+ *  Four BfM_ResetStats(void)
+ *  Four BfM_DumpStats(FILE*)
+ *  Four BfM_SetStatsDump(FILE*, Four)
+ *
+ * Internal:
+ *  void bfm_CountOptimisticHit(Four)
+ *  Four __wrap_BfM_GetTrain(TrainID*, char**, Four)
+ *  Four __wrap_BfM_GetNewTrain(TrainID*, char**, Four)
+ *  Four __wrap_BfM_FreeTrain(TrainID*, Four)
+ *  Four __wrap_BfM_SetDirty(TrainID*, Four)
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+#include "EduOM_Trace.h"
+
+
+
+/*@
+ * Type Definitions
+ */
+/* a frame which is going to be replaced */
+typedef struct {
+    Four	idx;		/* index of the frame; NIL if not predicted */
+    BfMHashKey	key;		/* train held in the frame */
+    One		bits;		/* bits of the frame */
+} bfm_Victim;
+
+/* pin of a frame */
+typedef struct {
+    struct timespec start;	/* when the frame was fixed; tv_sec of 0 if not fixed */
+    Four	caller;		/* caller which fixed the frame */
+} bfm_Pin;
+
+
+/*@
+ * Global Variables
+ */
+static Four bfm_caller = BFM_CALLER_OTHER;	/* operation in progress */
+static BfM_Stats bfm_stats;
+
+/* pins of the frames; allocated at the first fix */
+static bfm_Pin *bfm_pin[NUM_BUF_TYPES] = { NULL, NULL };
+
+/* periodic dump */
+static FILE *bfm_dumpFile = NULL;		/* NULL if not dumped */
+static Four bfm_dumpInterval;			/* msec between two dumps */
+static struct timespec bfm_lastDump;		/* time of the last dump */
+
+static char *bfm_callerName[BFM_NUM_CALLERS] = {
+    "other", "create", "destroy", "read", "scan", "compact"
+};
+
+
+/* the real functions in cosmos.o */
+Four __real_BfM_GetTrain(TrainID *, char **, Four);
+Four __real_BfM_GetNewTrain(TrainID *, char **, Four);
+Four __real_BfM_FreeTrain(TrainID *, Four);
+Four __real_BfM_SetDirty(TrainID *, Four);
+
+
+/* Macro: BFM_ELAPSED_USEC(_from, _to)
+ * Description: return the microseconds elapsed between two times
+ * Returns: (double) microseconds
+ */
+#define BFM_ELAPSED_USEC(_from, _to) \
+    (((_to).tv_sec - (_from).tv_sec)*1e6 + ((_to).tv_nsec - (_from).tv_nsec)/1e3)
+
+
+
+/*@================================
+ * bfm_PredictVictim()
+ *================================*/
+/*
+ * Function: void bfm_PredictVictim(Four, bfm_Victim*)
+ *
+ * Description:
+ *  Find the frame the buffer manager is going to replace on the next miss:
+ *  the first frame from 'nextVictim' which is neither fixed nor referenced,
+ *  or, if every unfixed frame is referenced, the first unfixed one. Without
+ *  BFM_STATS_DETAIL the victim is not predicted.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_PredictVictim(
+    Four	type,		/* IN buffer type */
+    bfm_Victim	*victim)	/* OUT frame to be replaced */
+{
+#ifdef BFM_STATS_DETAIL
+    Four	i;		/* index of a frame */
+    Four	n;		/* the number of frames visited */
+    Four	firstUnfixed;	/* first unfixed frame visited */
+#endif
+
+
+    victim->idx = NIL;
+
+#ifdef BFM_STATS_DETAIL
+    firstUnfixed = NIL;
+
+    for (n = 0, i = BI_NEXTVICTIM(type); n < BI_NBUFS(type); n++, i = (i + 1) % BI_NBUFS(type)) {
+        if (BI_FIXED(type, i) > 0) continue;
+        if (firstUnfixed == NIL) firstUnfixed = i;
+        if (!(BI_BITS(type, i) & REFER)) {
+            victim->idx = i;
+            break;
+        }
+    }
+    if (victim->idx == NIL) victim->idx = firstUnfixed;
+
+    if (victim->idx != NIL) {
+        victim->key = BI_KEY(type, victim->idx);
+        victim->bits = BI_BITS(type, victim->idx);
+    }
+#endif
+
+} /* bfm_PredictVictim() */
+
+
+
+/*@================================
+ * bfm_CountVictim()
+ *================================*/
+/*
+ * Function: void bfm_CountVictim(Four, BfMHashKey*, bfm_Victim*)
+ *
+ * Description:
+ *  Count the replacement done by a miss, given the predicted victim, if
+ *  BFM_STATS_DETAIL is defined.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_CountVictim(
+    Four	type,		/* IN buffer type */
+    BfMHashKey	*key,		/* IN train read by the miss */
+    bfm_Victim	*victim)	/* IN predicted victim */
+{
+    BfM_CallerStats *s = &bfm_stats.caller[bfm_caller];
+
+
+#ifndef BFM_STATS_DETAIL
+    return;
+#endif
+
+    if (victim->idx == NIL || bfm_LookUp(key, type) != victim->idx) {
+        bfm_stats.unpredicted++;
+        return;
+    }
+
+    if (victim->key.pageNo != NIL) {
+        s->evictions++;
+        EDUOM_PROBE3(bfm, evict, victim->key.volNo, victim->key.pageNo, (victim->bits & DIRTY) ? 1 : 0);
+    }
+    if (victim->bits & DIRTY) s->dirtyWrites++;
+
+} /* bfm_CountVictim() */
+
+
+
+/*@================================
+ * bfm_CountFix()
+ *================================*/
+/*
+ * Function: void bfm_CountFix(Four, BfMHashKey*)
+ *
+ * Description:
+ *  Start timing the pin of the frame holding the train if it has just been
+ *  fixed for the first time and BFM_STATS_DETAIL is defined.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_CountFix(
+    Four	type,		/* IN buffer type */
+    BfMHashKey	*key)		/* IN train fixed */
+{
+    Four	idx;		/* index of the frame */
+
+
+#ifndef BFM_STATS_DETAIL
+    return;
+#endif
+
+    if (bfm_pin[type] == NULL) {
+        bfm_pin[type] = (bfm_Pin *)calloc(BI_NBUFS(type), sizeof(bfm_Pin));
+        if (bfm_pin[type] == NULL) return;
+    }
+
+    idx = bfm_LookUp(key, type);
+    if (idx < 0 || BI_FIXED(type, idx) != 1) return;
+
+    /* a pin left open by an unfix inside cosmos.o is not counted again */
+    if (bfm_pin[type][idx].start.tv_sec == 0) bfm_stats.nPinned++;
+
+    clock_gettime(CLOCK_MONOTONIC, &bfm_pin[type][idx].start);
+    bfm_pin[type][idx].caller = bfm_caller;
+
+    if (bfm_stats.nPinned > bfm_stats.maxPinned) bfm_stats.maxPinned = bfm_stats.nPinned;
+
+} /* bfm_CountFix() */
+
+
+
+/*@================================
+ * bfm_CountUnfix()
+ *================================*/
+/*
+ * Function: void bfm_CountUnfix(Four, Four)
+ *
+ * Description:
+ *  Account the pin of the frame if it has just been unfixed for the last
+ *  time and was timed, and dump the statistics if a dump is due.
+ *
+ * Returns:
+ *  None
+ */
+static void bfm_CountUnfix(
+    Four	type,		/* IN buffer type */
+    Four	idx)		/* IN index of the frame */
+{
+    struct timespec now;	/* current time */
+    bfm_Pin	*pin;		/* pin of the frame */
+    BfM_CallerStats *s;		/* statistics of the caller which fixed the frame */
+    double	usec;		/* time the frame was fixed */
+    Four	bucket;		/* bucket of the histogram */
+    Boolean	timed;		/* TRUE if 'now' was read */
+
+
+    if (BI_FIXED(type, idx) != 0) return;
+
+    /* the pins are timed only with BFM_STATS_DETAIL(see bfm_CountFix()) */
+    pin = (bfm_pin[type] != NULL) ? &bfm_pin[type][idx] : NULL;
+    timed = FALSE;
+
+    if (pin != NULL && pin->start.tv_sec != 0) {	/* not fixed inside cosmos.o */
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        timed = TRUE;
+
+        usec = BFM_ELAPSED_USEC(pin->start, now);
+        s = &bfm_stats.caller[pin->caller];
+        s->pins++;
+        s->pinTime += usec;
+        if (usec > s->maxPinTime) s->maxPinTime = (UFour)usec;
+
+        for (bucket = 0; bucket < BFM_PIN_HIST_BUCKETS - 1 && usec >= (double)(1 << bucket); bucket++);
+        s->pinHist[bucket]++;
+
+        pin->start.tv_sec = 0;
+        bfm_stats.nPinned--;
+    }
+
+    if (bfm_dumpFile == NULL) return;
+
+    if (!timed) clock_gettime(CLOCK_MONOTONIC, &now);
+    if (BFM_ELAPSED_USEC(bfm_lastDump, now) >= bfm_dumpInterval*1e3) {
+        bfm_lastDump = now;
+        BfM_DumpStats(bfm_dumpFile);
+    }
+
+} /* bfm_CountUnfix() */
+
+
+
+/*@================================
+ * bfm_CountOptimisticHit()
+ *================================*/
+/*
+ * Function: void bfm_CountOptimisticHit(Four)
+ *
+ * Description:
+ *  Count a read of a train found in the buffer pool without fixing its
+ *  frame(see BfM_ValidateFrame()) as a hit.
+ *
+ * Returns:
+ *  None
+ */
+void bfm_CountOptimisticHit(
+    Four	type)		/* IN buffer type */
+{
+    BfM_CallerStats *s = &bfm_stats.caller[bfm_caller];
+
+
+    s->gets++;
+    s->hits++;
+    s->optimisticHits++;
+
+} /* bfm_CountOptimisticHit() */
+
+
+
+/*@================================
+ * __wrap_BfM_GetTrain()
+ *================================*/
+/*
+ * Function: Four __wrap_BfM_GetTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  BfM_GetTrain() counting the hit or the miss. A miss replaces a frame of
+ *  a partition if the buffer pool is partitioned, which is counted as an
+ *  unpredicted victim. The version of the frame a miss replaced is
+ *  advanced for the optimistic readers(see BfM_FrameVersion.c).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_BfM_GetTrain(
+    TrainID	*trainId,	/* IN train to be used */
+    char	**retBuf,	/* OUT pointer to the returned buffer */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    Four	idx;		/* index of the frame holding the train */
+    BfMHashKey	key;		/* hash key of the train */
+    Boolean	hit;		/* TRUE if the train is in the buffer pool */
+    bfm_Victim	victim;		/* frame to be replaced on a miss */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) return(__real_BfM_GetTrain(trainId, retBuf, type));
+
+    key.volNo = trainId->volNo;
+    key.pageNo = trainId->pageNo;
+
+    idx = bfm_LookUp(&key, type);
+    hit = (idx >= 0);
+    if (!hit) bfm_PredictVictim(type, &victim);
+
+    /* with the buffer pool partitioned, a miss is read into a frame of the
+     * partition of the calling thread(see BfM_NumaPartition.c) */
+    if (idx == NOTFOUND_IN_HTABLE) {
+        e = bfm_ReadPartitionTrain(trainId, type);
+        if (e < 0) ERR(e);
+    }
+
+    e = __real_BfM_GetTrain(trainId, retBuf, type);
+    if (e < 0) ERR(e);
+
+    bfm_stats.caller[bfm_caller].gets++;
+    if (hit)
+        bfm_stats.caller[bfm_caller].hits++;
+    else {
+        bfm_stats.caller[bfm_caller].misses++;
+        bfm_CountVictim(type, &key, &victim);
+        bfm_ReplaceFrameVersion(trainId, type);
+        EDUOM_PROBE3(bfm, get_train_miss, key.volNo, key.pageNo, type);
+    }
+
+    bfm_CountFix(type, &key);
+
+    return(eNOERROR);
+
+} /* __wrap_BfM_GetTrain() */
+
+
+
+/*@================================
+ * __wrap_BfM_GetNewTrain()
+ *================================*/
+/*
+ * Function: Four __wrap_BfM_GetNewTrain(TrainID*, char**, Four)
+ *
+ * Description:
+ *  BfM_GetNewTrain() counting the frame allocated, whose version is
+ *  advanced as for a miss of BfM_GetTrain().
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_BfM_GetNewTrain(
+    TrainID	*trainId,	/* IN train to be allocated */
+    char	**retBuf,	/* OUT pointer to the returned buffer */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    BfMHashKey	key;		/* hash key of the train */
+    bfm_Victim	victim;		/* frame to be replaced */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) return(__real_BfM_GetNewTrain(trainId, retBuf, type));
+
+    key.volNo = trainId->volNo;
+    key.pageNo = trainId->pageNo;
+
+    bfm_PredictVictim(type, &victim);
+
+    e = __real_BfM_GetNewTrain(trainId, retBuf, type);
+    if (e < 0) ERR(e);
+
+    bfm_stats.caller[bfm_caller].newTrains++;
+    bfm_CountVictim(type, &key, &victim);
+    bfm_ReplaceFrameVersion(trainId, type);
+
+    bfm_CountFix(type, &key);
+
+    return(eNOERROR);
+
+} /* __wrap_BfM_GetNewTrain() */
+
+
+
+/*@================================
+ * __wrap_BfM_FreeTrain()
+ *================================*/
+/*
+ * Function: Four __wrap_BfM_FreeTrain(TrainID*, Four)
+ *
+ * Description:
+ *  BfM_FreeTrain() accounting the time the frame was fixed.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_BfM_FreeTrain(
+    TrainID	*trainId,	/* IN train to be freed */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+    Four	idx;		/* index of the frame */
+    BfMHashKey	key;		/* hash key of the train */
+
+
+    if (type < 0 || type >= NUM_BUF_TYPES) return(__real_BfM_FreeTrain(trainId, type));
+
+    key.volNo = trainId->volNo;
+    key.pageNo = trainId->pageNo;
+
+    idx = bfm_LookUp(&key, type);
+
+    e = __real_BfM_FreeTrain(trainId, type);
+    if (e < 0) ERR(e);
+
+    bfm_stats.caller[bfm_caller].frees++;
+    if (idx >= 0) bfm_CountUnfix(type, idx);
+
+    return(eNOERROR);
+
+} /* __wrap_BfM_FreeTrain() */
+
+
+
+/*@================================
+ * __wrap_BfM_SetDirty()
+ *================================*/
+/*
+ * Function: Four __wrap_BfM_SetDirty(TrainID*, Four)
+ *
+ * Description:
+ *  BfM_SetDirty() counting the call.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_BfM_SetDirty(
+    TrainID	*trainId,	/* IN train to be set dirty */
+    Four	type)		/* IN buffer type */
+{
+    Four	e;		/* error number */
+
+
+    e = __real_BfM_SetDirty(trainId, type);
+    if (e < 0) ERR(e);
+
+    bfm_stats.caller[bfm_caller].setDirties++;
+
+    return(eNOERROR);
+
+} /* __wrap_BfM_SetDirty() */
+
+
+
+/*@================================
+ * BfM_SetCaller()
+ *================================*/
+/*
+ * Function: Four BfM_SetCaller(Four)
+ *
+ * Description:
+ *  Set the operation in progress, to which the following calls are
+ *  charged.
+ *
+ * Returns:
+ *  the previous caller(BFM_CALLER_XXX)
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_SetCaller(
+    Four	caller)		/* IN BFM_CALLER_XXX */
+{
+    Four	old;		/* previous caller */
+
+
+    if (caller < 0 || caller >= BFM_NUM_CALLERS) ERR(eBADPARAMETER);
+
+    old = bfm_caller;
+    bfm_caller = caller;
+
+    return(old);
+
+} /* BfM_SetCaller() */
+
+
+
+/*@================================
+ * BfM_GetStats()
+ *================================*/
+/*
+ * Function: Four BfM_GetStats(BfM_Stats*)
+ *
+ * Description:
+ *  Return the statistics of the buffer manager.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_GetStats(
+    BfM_Stats	*stats)		/* OUT statistics */
+{
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    *stats = bfm_stats;
+
+    return(eNOERROR);
+
+} /* BfM_GetStats() */
+
+
+
+/*@================================
+ * BfM_ResetStats()
+ *================================*/
+/*
+ * Function: Four BfM_ResetStats(void)
+ *
+ * Description:
+ *  Zero the counters. The frames fixed at the moment stay counted in
+ *  'nPinned'.
+ *
+ * Returns:
+ *  error code
+ */
+Four BfM_ResetStats(void)
+{
+    Four	nPinned;	/* frames fixed at the moment */
+
+
+    nPinned = bfm_stats.nPinned;
+    memset(&bfm_stats, 0, sizeof(bfm_stats));
+    bfm_stats.nPinned = bfm_stats.maxPinned = nPinned;
+
+    return(eNOERROR);
+
+} /* BfM_ResetStats() */
+
+
+
+/*@================================
+ * BfM_DumpStats()
+ *================================*/
+/*
+ * Function: Four BfM_DumpStats(FILE*)
+ *
+ * Description:
+ *  Print the statistics as text, one line per caller which used the buffer
+ *  manager and one line for the whole buffer pool. The pin histogram lists
+ *  the pins shorter than 1, 2, 4, ... usec.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_DumpStats(
+    FILE	*fp)		/* IN file to print to */
+{
+    Four	i;		/* index of a caller */
+    Four	b;		/* index of a bucket */
+    BfM_CallerStats *s;		/* statistics of a caller */
+
+
+    if (fp == NULL) ERR(eBADPARAMETER);
+
+    for (i = 0; i < BFM_NUM_CALLERS; i++) {
+        s = &bfm_stats.caller[i];
+        if (s->gets == 0 && s->newTrains == 0 && s->frees == 0) continue;
+
+        fprintf(fp, "bfm caller=%s gets=%u hits=%u optimistic=%u misses=%u new=%u frees=%u dirty=%u "
+                "evictions=%u dirtywrites=%u pins=%u avgpin_us=%.1f maxpin_us=%u pinhist=",
+                bfm_callerName[i], s->gets, s->hits, s->optimisticHits, s->misses, s->newTrains, s->frees,
+                s->setDirties, s->evictions, s->dirtyWrites, s->pins,
+                (s->pins > 0) ? s->pinTime/s->pins : 0.0, s->maxPinTime);
+        for (b = 0; b < BFM_PIN_HIST_BUCKETS; b++)
+            fprintf(fp, (b == 0) ? "%u":",%u", s->pinHist[b]);
+        fprintf(fp, "\n");
+    }
+
+    fprintf(fp, "bfm pinned=%d maxpinned=%d unpredicted=%u\n",
+            bfm_stats.nPinned, bfm_stats.maxPinned, bfm_stats.unpredicted);
+    fflush(fp);
+
+    return(eNOERROR);
+
+} /* BfM_DumpStats() */
+
+
+
+/*@================================
+ * BfM_SetStatsDump()
+ *================================*/
+/*
+ * Function: Four BfM_SetStatsDump(FILE*, Four)
+ *
+ * Description:
+ *  Dump the statistics to the file every 'interval' msec. The dump is done
+ *  when a frame is unfixed, so an idle buffer manager dumps nothing. A NULL
+ *  'fp' stops the dumps.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four BfM_SetStatsDump(
+    FILE	*fp,		/* IN file to print to; NULL to stop */
+    Four	interval)	/* IN msec between two dumps */
+{
+    if (fp != NULL && interval <= 0) ERR(eBADPARAMETER);
+
+    bfm_dumpFile = fp;
+    bfm_dumpInterval = interval;
+    clock_gettime(CLOCK_MONOTONIC, &bfm_lastDump);
+
+    return(eNOERROR);
+
+} /* BfM_SetStatsDump() */
@@ -0,0 +1,374 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: BfM_WarmStart.c
+ *
+ * Description:
+ *  Warm restart of the buffer pool. The trains resident in the buffer pool
+ *  are saved, with their heat, in a small file; after the volume is mounted
+ *  again, possibly by another process, the hottest of them are read back in
+ *  their physical order with batched reads(see BfM_PrefetchTrains()) instead
+ *  of one miss at a time.
+ *
+ *  The list is saved by BfM_SaveResidentTrains(), which should be called
+ *  before the volume is dismounted, and at every fuzzy checkpoint of the
+ *  writer for the volumes registered with BfM_SetWarmStartFile(), so that a
+ *  recent list survives a crash.
+ *
+ *  File format (native byte order):
+ *    header:  "EDUOMHOT", version, the number of entries
+ *    entries: PageNo, VolNo, heat
+ *
+ * Exports:
+ *  Four BfM_SaveResidentTrains(VolNo, char*)
+ *  Four BfM_LoadResidentTrains(VolNo, char*, Four)
+ *  Four BfM_SetWarmStartFile(VolNo, char*)
+ *
+ * Internal:
+ *  Four bfm_SaveWarmStartFiles(void)
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define BFM_HOT_MAGIC           "EDUOMHOT"
+#define BFM_HOT_VERSION         1
+#define BFM_MAX_WARM_START_VOLS 20      /* volumes which can be registered */
+#define BFM_MAX_FILE_NAME       256
+
+
+/*@
+ * Type Definitions
+ */
+/* header of the file */
+typedef struct {
+    char	magic[8];	/* BFM_HOT_MAGIC */
+    Four	version;	/* BFM_HOT_VERSION */
+    Four	nEntries;	/* the number of entries which follow */
+} bfm_HotFileHeader;
+
+/* an entry of the file; a resident train */
+typedef struct {
+    PageNo	pageNo;		/* train */
+    VolNo	volNo;
+    Two		heat;		/* 1(cold) .. 3(hot) */
+} bfm_HotTrain;
+
+/* a volume whose list is saved at every checkpoint */
+typedef struct {
+    VolNo	volNo;		/* NIL if the entry is not used */
+    char	fileName[BFM_MAX_FILE_NAME];
+} bfm_WarmStartFile;
+
+
+/*@
+ * Global Variables
+ */
+static bfm_WarmStartFile bfm_warmStartFile[BFM_MAX_WARM_START_VOLS] = {
+    [0 ... BFM_MAX_WARM_START_VOLS-1] = { NIL, "" }
+};
+
+
+
+/*@================================
+ * bfm_CompareHeat()
+ *================================*/
+/*
+ * Function: int bfm_CompareHeat(const void*, const void*)
+ *
+ * Description:
+ *  Order the entries from the hottest.
+ *
+ * Returns:
+ *  negative, zero, or positive as qsort() expects
+ */
+static int bfm_CompareHeat(
+    const void	*a,		/* IN entry */
+    const void	*b)		/* IN entry */
+{
+    return(((const bfm_HotTrain *)b)->heat - ((const bfm_HotTrain *)a)->heat);
+
+} /* bfm_CompareHeat() */
+
+
+
+/*@================================
+ * BfM_SaveResidentTrains()
+ *================================*/
+/*
+ * Function: Four BfM_SaveResidentTrains(VolNo, char*)
+ *
+ * Description:
+ *  Save the trains of the volume resident in the PAGE_BUF buffer pool. The
+ *  heat of a train is 1, plus 1 if it has been referenced since the last
+ *  victim search passed it, plus 1 if it is dirty or fixed. The file is
+ *  replaced atomically.
+ *
+ * Returns:
+ *  the number of trains saved
+ *  error code
+ *    eBADPARAMETER
+ *    eMEMORYALLOCERR
+ *    eWRITEFAIL_RDSM
+ */
+Four BfM_SaveResidentTrains(
+    VolNo	volNo,		/* IN volume number */
+    char	*fileName)	/* IN file to save the list into */
+{
+    Four	i;		/* index of a frame */
+    Four	n;		/* the number of entries */
+    bfm_HotTrain *entry;	/* entries */
+    bfm_HotFileHeader header;	/* header of the file */
+    char	tmpName[BFM_MAX_FILE_NAME + 8];	/* file written before renamed */
+    FILE	*fp;		/* the file */
+    Boolean	ok;		/* TRUE if the file is written */
+
+
+    if (fileName == NULL || strlen(fileName) >= BFM_MAX_FILE_NAME) ERR(eBADPARAMETER);
+
+    entry = (bfm_HotTrain *)malloc(sizeof(bfm_HotTrain) * MAX(BI_NBUFS(PAGE_BUF), 1));
+    if (entry == NULL) ERR(eMEMORYALLOCERR);
+
+    for (i = 0, n = 0; i < BI_NBUFS(PAGE_BUF); i++) {
+        if (!IS_VALID_FRAME(PAGE_BUF, i) || BI_KEY(PAGE_BUF, i).volNo != volNo) continue;
+
+        entry[n].pageNo = BI_KEY(PAGE_BUF, i).pageNo;
+        entry[n].volNo = BI_KEY(PAGE_BUF, i).volNo;
+        entry[n].heat = 1;
+        if (BI_BITS(PAGE_BUF, i) & REFER) entry[n].heat++;
+        if ((BI_BITS(PAGE_BUF, i) & DIRTY) || BI_FIXED(PAGE_BUF, i) > 0) entry[n].heat++;
+        n++;
+    }
+
+    memcpy(header.magic, BFM_HOT_MAGIC, sizeof(header.magic));
+    header.version = BFM_HOT_VERSION;
+    header.nEntries = n;
+
+    sprintf(tmpName, "%s.tmp", fileName);
+
+    fp = fopen(tmpName, "wb");
+    ok = (fp != NULL &&
+          fwrite(&header, sizeof(header), 1, fp) == 1 &&
+          (n == 0 || fwrite(entry, sizeof(bfm_HotTrain), n, fp) == (size_t)n));
+    if (fp != NULL && fclose(fp) != 0) ok = FALSE;
+
+    free(entry);
+
+    if (!ok || rename(tmpName, fileName) != 0) {
+        remove(tmpName);
+        ERR(eWRITEFAIL_RDSM);
+    }
+
+    return(n);
+
+} /* BfM_SaveResidentTrains() */
+
+
+
+/*@================================
+ * BfM_LoadResidentTrains()
+ *================================*/
+/*
+ * Function: Four BfM_LoadResidentTrains(VolNo, char*, Four)
+ *
+ * Description:
+ *  Read the hottest trains of the volume listed in the file into the buffer
+ *  pool, at most 'maxTrains' of them (0 for as many as the buffer pool
+ *  holds). A caller that wants to serve requests meanwhile can load a part
+ *  at a time with a small 'maxTrains'; the trains read already are skipped.
+ *  A missing file is not an error: there is nothing to load.
+ *
+ * Returns:
+ *  the number of trains read
+ *  error code
+ *    eBADPARAMETER
+ *    eMEMORYALLOCERR
+ *    eREADFAIL_RDSM
+ *    some errors caused by function calls
+ */
+Four BfM_LoadResidentTrains(
+    VolNo	volNo,		/* IN volume number */
+    char	*fileName,	/* IN file the list was saved into */
+    Four	maxTrains)	/* IN maximum number of trains to read; 0 for no limit */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of trains to read */
+    bfm_HotFileHeader header;	/* header of the file */
+    bfm_HotTrain *entry;	/* entries */
+    TrainID	*trainIds;	/* trains to read */
+    FILE	*fp;		/* the file */
+    BfMHashKey	key;		/* hash key of a train */
+
+
+    if (fileName == NULL || maxTrains < 0) ERR(eBADPARAMETER);
+
+    fp = fopen(fileName, "rb");
+    if (fp == NULL) return(0);
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 ||
+        memcmp(header.magic, BFM_HOT_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != BFM_HOT_VERSION || header.nEntries < 0) {
+        fclose(fp);
+        ERR(eREADFAIL_RDSM);
+    }
+
+    entry = (bfm_HotTrain *)malloc(sizeof(bfm_HotTrain) * MAX(header.nEntries, 1));
+    trainIds = (TrainID *)malloc(sizeof(TrainID) * MAX(header.nEntries, 1));
+    if (entry == NULL || trainIds == NULL) {
+        free(entry);
+        free(trainIds);
+        fclose(fp);
+        ERR(eMEMORYALLOCERR);
+    }
+
+    if (fread(entry, sizeof(bfm_HotTrain), header.nEntries, fp) != (size_t)header.nEntries) {
+        free(entry);
+        free(trainIds);
+        fclose(fp);
+        ERR(eREADFAIL_RDSM);
+    }
+    fclose(fp);
+
+    /* the hottest first; the trains read by an earlier call are skipped */
+    qsort(entry, header.nEntries, sizeof(bfm_HotTrain), bfm_CompareHeat);
+
+    if (maxTrains == 0 || maxTrains > BI_NBUFS(PAGE_BUF)) maxTrains = BI_NBUFS(PAGE_BUF);
+
+    for (i = 0, n = 0; i < header.nEntries && n < maxTrains; i++) {
+        if (entry[i].volNo != volNo) continue;
+
+        key.volNo = entry[i].volNo;
+        key.pageNo = entry[i].pageNo;
+        if (bfm_LookUp(&key, PAGE_BUF) != NOTFOUND_IN_HTABLE) continue;
+
+        trainIds[n].volNo = entry[i].volNo;
+        trainIds[n].pageNo = entry[i].pageNo;
+        n++;
+    }
+
+    /* read in the physical order */
+    e = BfM_PrefetchTrains(trainIds, n, PAGE_BUF);
+
+    free(entry);
+    free(trainIds);
+
+    if (e < 0) ERR(e);
+
+    return(e);
+
+} /* BfM_LoadResidentTrains() */
+
+
+
+/*@================================
+ * BfM_SetWarmStartFile()
+ *================================*/
+/*
+ * Function: Four BfM_SetWarmStartFile(VolNo, char*)
+ *
+ * Description:
+ *  Have the list of the volume saved into the file at every fuzzy checkpoint
+ *  of the writer. A NULL 'fileName' stops saving it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eTOOMANYVOLUMES_RDSM
+ */
+Four BfM_SetWarmStartFile(
+    VolNo	volNo,		/* IN volume number */
+    char	*fileName)	/* IN file to save the list into; NULL to stop */
+{
+    Four	i;		/* index variable */
+    Four	freeEntry;	/* unused entry */
+
+
+    if (volNo < 0) ERR(eBADPARAMETER);
+    if (fileName != NULL && strlen(fileName) >= BFM_MAX_FILE_NAME) ERR(eBADPARAMETER);
+
+    for (i = 0, freeEntry = NIL; i < BFM_MAX_WARM_START_VOLS; i++) {
+        if (bfm_warmStartFile[i].volNo == volNo) break;
+        if (bfm_warmStartFile[i].volNo == NIL && freeEntry == NIL) freeEntry = i;
+    }
+
+    if (fileName == NULL) {
+        if (i < BFM_MAX_WARM_START_VOLS) bfm_warmStartFile[i].volNo = NIL;
+        return(eNOERROR);
+    }
+
+    if (i == BFM_MAX_WARM_START_VOLS) {
+        if (freeEntry == NIL) ERR(eTOOMANYVOLUMES_RDSM);
+        i = freeEntry;
+    }
+
+    bfm_warmStartFile[i].volNo = volNo;
+    strcpy(bfm_warmStartFile[i].fileName, fileName);
+
+    return(eNOERROR);
+
+} /* BfM_SetWarmStartFile() */
+
+
+
+/*@================================
+ * bfm_SaveWarmStartFiles()
+ *================================*/
+/*
+ * Function: Four bfm_SaveWarmStartFiles(void)
+ *
+ * Description:
+ *  Save the lists of the registered volumes; called at every fuzzy
+ *  checkpoint of the writer.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four bfm_SaveWarmStartFiles(void)
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < BFM_MAX_WARM_START_VOLS; i++) {
+        if (bfm_warmStartFile[i].volNo == NIL) continue;
+
+        e = BfM_SaveResidentTrains(bfm_warmStartFile[i].volNo, bfm_warmStartFile[i].fileName);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* bfm_SaveWarmStartFiles() */
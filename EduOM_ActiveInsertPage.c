@@ -0,0 +1,625 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ActiveInsertPage.c
+ *
+ * Description:
+ *  Manage the active insert pages. When an object is created without a near
+ *  object, each thread inserts into its own active insert page of the file
+ *  instead of funneling into the head of the 'availSpaceList' or the last
+ *  page. The active insert page is owned exclusively by the thread until it
+ *  fills up or is released; while it is owned, it is kept out of the
+ *  available space lists so that other threads never choose it. A thread
+ *  should release its pages(see EduOM_ReleaseActiveInsertPages()) before
+ *  it commits or exits, or their free space is not found through the
+ *  available space lists until they are recovered:
+ *
+ *  - The pages of a thread which exited are left to no thread when it exits
+ *    and put back into the lists by the next thread which chooses an active
+ *    insert page of their file. The pages of a file destroyed meanwhile are
+ *    never put back, as its catalog object and pages may be reused.
+ *  - The pages of a process which exited are out of the lists but in no
+ *    table. The first time a process chooses an active insert page of a
+ *    file, the pages of the file are walked, and a slotted page with the
+ *    free space of a list which is in no list and owned by no thread is
+ *    put back(see EduOM_RecoverActiveInsertPages()).
+ *
+ *  The pages no longer funnel the inserts of many threads into one page,
+ *  but the inserts do not scale with the threads: the buffer manager and
+ *  the raw disk manager in cosmos.o are not thread safe, so the callers
+ *  still serialize every operation of the object manager(see EduOM_Ycsb.c).
+ *  The table is locked so that it stays consistent once they do not.
+ *
+ * Exports:
+ *  Four EduOM_ReleaseActiveInsertPages(void)
+ *  Four EduOM_RecoverActiveInsertPages(ObjectID*)
+ *
+ * Internal:
+ *  Boolean eduom_LookUpActiveInsertPage(FileID*, PageID*)
+ *  Four eduom_GetActiveInsertPageOwner(PageID*)
+ *  Boolean eduom_ClaimActiveInsertPage(ObjectID*, FileID*, PageID*)
+ *  void eduom_DisownActiveInsertPage(PageID*)
+ *  Four eduom_RecoverActiveInsertPages(ObjectID*, FileID*)
+ */
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define ORPHANED_OWNER  0   /* owner of the pages of a thread which exited; no thread gets 0 */
+
+
+
+/*@
+ * Type Definitions
+ */
+/*
+ * Entry of the active insert page table
+ * The table is shared by all threads; an entry is read and written only
+ * under 'eduom_activeInsertPageMutex'.
+ */
+typedef struct {
+    Four	owner;		/* thread which owns the page; NIL if the entry is free,
+				   ORPHANED_OWNER if the thread exited */
+    ObjectID	catObjForFile;	/* catalog object of the file containing the page */
+    FileID	fid;		/* file containing the page */
+    PageID	pid;		/* the active insert page */
+} eduom_ActiveInsertPage;
+
+
+/*@
+ * Global Variables
+ */
+static eduom_ActiveInsertPage eduom_activeInsertPageTable[MAX_ACTIVE_INSERT_PAGES] = {
+    [0 ... MAX_ACTIVE_INSERT_PAGES-1] = { NIL }
+};
+static pthread_mutex_t eduom_activeInsertPageMutex = PTHREAD_MUTEX_INITIALIZER;
+static Four eduom_lastThreadNo = 0;	/* last thread number given out */
+
+/* key whose destructor leaves the pages of an exiting thread to no thread */
+static pthread_key_t eduom_threadExitKey;
+static pthread_once_t eduom_threadExitKeyOnce = PTHREAD_ONCE_INIT;
+
+/* files whose pages were walked by this process(see EduOM_RecoverActiveInsertPages());
+   read and written under 'eduom_activeInsertPageMutex' */
+static FileID *eduom_recoveredFiles = NULL;
+static Four eduom_nRecoveredFiles = 0;
+static Four eduom_maxRecoveredFiles = 0;
+
+/* thread number of the calling thread; 0 until it is given one */
+static __thread Four eduom_threadNo = 0;
+
+/* table entries owned by the calling thread; NIL for unused slots */
+static __thread Two eduom_threadActiveInsertPage[MAX_ACTIVE_INSERT_PAGES_PER_THREAD] = {
+    [0 ... MAX_ACTIVE_INSERT_PAGES_PER_THREAD-1] = NIL
+};
+
+
+/* Macro: EDUOM_THREADNO()
+ * Description: return the number of the calling thread; give one on the first call
+ * Returns: (Four) thread number (greater than 0)
+ */
+#define EDUOM_THREADNO() \
+    (eduom_threadNo != 0 ? eduom_threadNo : \
+     (eduom_threadNo = __sync_add_and_fetch(&eduom_lastThreadNo, 1)))
+
+
+
+/*@================================
+ * eduom_LookUpActiveInsertPage()
+ *================================*/
+/*
+ * Function: Boolean eduom_LookUpActiveInsertPage(FileID*, PageID*)
+ *
+ * Description:
+ *  Find the active insert page that the calling thread owns in the given file.
+ *  The owned entries are read under the lock, as another thread may take the
+ *  page away(see eduom_DisownActiveInsertPage()).
+ *
+ * Returns:
+ *  TRUE if the calling thread owns an active insert page of the file
+ *  FALSE otherwise
+ *
+ * Side effects:
+ *  1) parameter pid
+ *     pid is set to the active insert page if it is found
+ */
+Boolean eduom_LookUpActiveInsertPage(
+    FileID	*fid,		/* IN file in which object is to be placed */
+    PageID	*pid)		/* OUT the active insert page */
+{
+    Two		i;		/* index variable */
+    Boolean	found = FALSE;	/* is the page found? */
+    eduom_ActiveInsertPage *entry; /* entry of the active insert page table */
+
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES_PER_THREAD && !found; i++) {
+        if (eduom_threadActiveInsertPage[i] == NIL) continue;
+
+        entry = &eduom_activeInsertPageTable[eduom_threadActiveInsertPage[i]];
+
+        /* the page was taken away by other operations */
+        if (entry->owner != EDUOM_THREADNO()) {
+            eduom_threadActiveInsertPage[i] = NIL;
+            continue;
+        }
+
+        if (EQUAL_FILEID(entry->fid, *fid)) {
+            *pid = entry->pid;
+            found = TRUE;
+        }
+    }
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+    return(found);
+
+} /* eduom_LookUpActiveInsertPage() */
+
+
+
+/*@================================
+ * eduom_GetActiveInsertPageOwner()
+ *================================*/
+/*
+ * Function: Four eduom_GetActiveInsertPageOwner(PageID*)
+ *
+ * Description:
+ *  Tell which thread owns the given page as its active insert page.
+ *
+ * Returns:
+ *  ACTIVE_INSERT_PAGE_NONE   if the page is not an active insert page
+ *  ACTIVE_INSERT_PAGE_SELF   if the calling thread owns the page
+ *  ACTIVE_INSERT_PAGE_OTHERS if another thread owns the page
+ */
+Four eduom_GetActiveInsertPageOwner(
+    PageID	*pid)		/* IN page to check */
+{
+    Two		i;		/* index variable */
+    Four	owner = NIL;	/* owner of the page */
+
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES; i++) {
+        if (eduom_activeInsertPageTable[i].owner == NIL ||
+            !EQUAL_PAGEID(eduom_activeInsertPageTable[i].pid, *pid)) continue;
+
+        owner = eduom_activeInsertPageTable[i].owner;
+        break;
+    }
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+    if (owner == NIL) return(ACTIVE_INSERT_PAGE_NONE);
+
+    return((owner == EDUOM_THREADNO()) ? ACTIVE_INSERT_PAGE_SELF : ACTIVE_INSERT_PAGE_OTHERS);
+
+} /* eduom_GetActiveInsertPageOwner() */
+
+
+
+/*@================================
+ * eduom_OrphanActiveInsertPages()
+ *================================*/
+/*
+ * Function: void eduom_OrphanActiveInsertPages(void*)
+ *
+ * Description:
+ *  Leave the active insert pages of the exiting thread to no thread, so
+ *  that the next thread which chooses an active insert page of their file
+ *  puts them back into the available space lists(see
+ *  eduom_RecoverActiveInsertPages()).
+ *  The buffer manager is not called here, as the thread may exit while
+ *  another thread is in an operation of the object manager.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_OrphanActiveInsertPages(
+    void	*threadNo)	/* IN number of the exiting thread */
+{
+    Two		i;		/* index variable */
+
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES; i++)
+        if (eduom_activeInsertPageTable[i].owner == (Four)(intptr_t)threadNo)
+            eduom_activeInsertPageTable[i].owner = ORPHANED_OWNER;
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+} /* eduom_OrphanActiveInsertPages() */
+
+
+
+/*@================================
+ * eduom_CreateThreadExitKey()
+ *================================*/
+/*
+ * Function: void eduom_CreateThreadExitKey(void)
+ *
+ * Description:
+ *  Create the key whose destructor is called when a thread which claimed
+ *  an active insert page exits.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_CreateThreadExitKey(void)
+{
+    pthread_key_create(&eduom_threadExitKey, eduom_OrphanActiveInsertPages);
+
+} /* eduom_CreateThreadExitKey() */
+
+
+
+/*@================================
+ * eduom_ClaimActiveInsertPage()
+ *================================*/
+/*
+ * Function: Boolean eduom_ClaimActiveInsertPage(ObjectID*, FileID*, PageID*)
+ *
+ * Description:
+ *  Make the given page the active insert page of the calling thread.
+ *  The caller should have removed the page from the available space list.
+ *  If the tables are full, the page is not claimed and the caller should
+ *  put the page back into the available space list as usual.
+ *
+ * Returns:
+ *  TRUE if the page is claimed
+ *  FALSE otherwise
+ */
+Boolean eduom_ClaimActiveInsertPage(
+    ObjectID	*catObjForFile,	/* IN catalog object of the file */
+    FileID	*fid,		/* IN file containing the page */
+    PageID	*pid)		/* IN page to claim */
+{
+    Two		i, j;		/* index variables */
+
+
+    for (j = 0; j < MAX_ACTIVE_INSERT_PAGES_PER_THREAD; j++)
+        if (eduom_threadActiveInsertPage[j] == NIL) break;
+
+    if (j == MAX_ACTIVE_INSERT_PAGES_PER_THREAD) return(FALSE);
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES; i++)
+        if (eduom_activeInsertPageTable[i].owner == NIL) break;
+
+    if (i < MAX_ACTIVE_INSERT_PAGES) {
+        eduom_activeInsertPageTable[i].catObjForFile = *catObjForFile;
+        eduom_activeInsertPageTable[i].fid = *fid;
+        eduom_activeInsertPageTable[i].pid = *pid;
+        eduom_activeInsertPageTable[i].owner = EDUOM_THREADNO();
+    }
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+    if (i == MAX_ACTIVE_INSERT_PAGES) return(FALSE);
+
+    eduom_threadActiveInsertPage[j] = i;
+
+    /* the pages are left to no thread when the thread exits */
+    pthread_once(&eduom_threadExitKeyOnce, eduom_CreateThreadExitKey);
+    pthread_setspecific(eduom_threadExitKey, (void *)(intptr_t)EDUOM_THREADNO());
+
+    return(TRUE);
+
+} /* eduom_ClaimActiveInsertPage() */
+
+
+
+/*@================================
+ * eduom_DisownActiveInsertPage()
+ *================================*/
+/*
+ * Function: void eduom_DisownActiveInsertPage(PageID*)
+ *
+ * Description:
+ *  Take the given page away from its owner. This is called whenever the
+ *  page is put back into the available space list or removed from the file,
+ *  whichever thread owns the page. The owner notices it at its next lookup.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_DisownActiveInsertPage(
+    PageID	*pid)		/* IN page to disown */
+{
+    Two		i;		/* index variable */
+
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES; i++) {
+        if (eduom_activeInsertPageTable[i].owner != NIL &&
+            EQUAL_PAGEID(eduom_activeInsertPageTable[i].pid, *pid))
+            eduom_activeInsertPageTable[i].owner = NIL;
+    }
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+} /* eduom_DisownActiveInsertPage() */
+
+
+
+/*@================================
+ * eduom_PublishActiveInsertPage()
+ *================================*/
+/*
+ * Function: Four eduom_PublishActiveInsertPage(ObjectID*, PageID*)
+ *
+ * Description:
+ *  Put the page, which no thread owns any more, back into the available
+ *  space list of its file.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_PublishActiveInsertPage(
+    ObjectID	*catObjForFile,	/* IN catalog object of the file */
+    PageID	*pid)		/* IN page to publish */
+{
+    Four	e;		/* error number */
+    SlottedPage	*apage;		/* pointer to the buffer holding the page */
+
+
+    e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    e = om_PutInAvailSpaceList(catObjForFile, pid, apage);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_PublishActiveInsertPage() */
+
+
+
+/*@================================
+ * EduOM_ReleaseActiveInsertPages()
+ *================================*/
+/*
+ * Function: Four EduOM_ReleaseActiveInsertPages(void)
+ *
+ * Description:
+ *  Publish all the active insert pages of the calling thread back to the
+ *  available space lists of their files. A thread should call this function
+ *  before it stops inserting, e.g. before it commits or exits; otherwise the
+ *  free space left in its pages is not used by objects created without a near
+ *  object until the pages are touched by other operations.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduOM_ReleaseActiveInsertPages(void)
+{
+    Four	e;		/* error number */
+    Two		i;		/* index variable */
+    eduom_ActiveInsertPage entry; /* copy of the entry to release */
+
+
+    for (i = 0; i < MAX_ACTIVE_INSERT_PAGES_PER_THREAD; i++) {
+        if (eduom_threadActiveInsertPage[i] == NIL) continue;
+
+        /* take a copy and free the entry in one step, so that the page is not taken away in between */
+        pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+        entry = eduom_activeInsertPageTable[eduom_threadActiveInsertPage[i]];
+        if (entry.owner == EDUOM_THREADNO())
+            eduom_activeInsertPageTable[eduom_threadActiveInsertPage[i]].owner = NIL;
+
+        pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+        eduom_threadActiveInsertPage[i] = NIL;
+
+        if (entry.owner != EDUOM_THREADNO()) continue;
+
+        e = eduom_PublishActiveInsertPage(&entry.catObjForFile, &entry.pid);
+        if (e < 0) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* EduOM_ReleaseActiveInsertPages() */
+
+
+
+/*@================================
+ * EduOM_RecoverActiveInsertPages()
+ *================================*/
+/*
+ * Function: Four EduOM_RecoverActiveInsertPages(ObjectID*)
+ *
+ * Description:
+ *  Walk the pages of the file and put back into the available space lists
+ *  the active insert pages left by a process which exited without
+ *  EduOM_ReleaseActiveInsertPages(): the slotted pages with the free space
+ *  of a list(SP_10SIZE) which are in no list and owned by no thread of
+ *  this process. The pages of the other layouts are not in the lists.
+ *  EduOM_CreateObject() calls this function the first time the process
+ *  chooses an active insert page of the file; it can be called right after
+ *  the volume is mounted, so that the first insert does not walk the file.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_RecoverActiveInsertPages(
+    ObjectID	*catObjForFile)	/* IN catalog object of the file */
+{
+    Four	e;		/* error number */
+    PageID	pid;		/* a page of the file */
+    PageNo	nextPage;	/* page after it */
+    Boolean	inList;		/* is the page in an available space list? */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    SlottedPage	*apage;		/* pointer to the buffer holding the page */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    for (MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage); pid.pageNo != NIL; pid.pageNo = nextPage) {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+        nextPage = apage->header.nextPage;
+
+        /* a page is in a list if it has a neighbor in the list or heads it */
+        inList = (apage->header.spaceListPrev != NIL || apage->header.spaceListNext != NIL ||
+                  pid.pageNo == catEntry->availSpaceList10 || pid.pageNo == catEntry->availSpaceList20 ||
+                  pid.pageNo == catEntry->availSpaceList30 || pid.pageNo == catEntry->availSpaceList40 ||
+                  pid.pageNo == catEntry->availSpaceList50);
+
+        if (!inList && SP_FREE(apage) >= SP_10SIZE &&
+            !IS_PAX_PAGE(apage) && !IS_FIXED_PAGE(apage) && !IS_SMALL_PAGE(apage) &&
+            eduom_GetActiveInsertPageOwner(&pid) == ACTIVE_INSERT_PAGE_NONE) {
+            e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+            if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+            if (e < 0) {
+                (Four) BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+            }
+        }
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+    }
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_RecoverActiveInsertPages() */
+
+
+
+/*@================================
+ * eduom_RecoverActiveInsertPages()
+ *================================*/
+/*
+ * Function: Four eduom_RecoverActiveInsertPages(ObjectID*, FileID*)
+ *
+ * Description:
+ *  Put the pages of the file left by the threads which exited back into the
+ *  available space lists, and, the first time in the process, those left by
+ *  the processes which exited(see EduOM_RecoverActiveInsertPages()). Only
+ *  the pages of the given file are put back: the catalog object kept with
+ *  the page of another file is stale if that file was destroyed.
+ *  EduOM_CreateObject() calls this function before it chooses an active
+ *  insert page.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+Four eduom_RecoverActiveInsertPages(
+    ObjectID	*catObjForFile,	/* IN catalog object of the file */
+    FileID	*fid)		/* IN file */
+{
+    Four	e;		/* error number */
+    Two		i;		/* index variable */
+    Boolean	walked;		/* were the pages of the file walked before? */
+    FileID	*files;		/* 'eduom_recoveredFiles' grown */
+    eduom_ActiveInsertPage entry; /* copy of an entry left by a thread */
+
+
+    for (;;) {
+        /* take the entry in one step, so that no other thread publishes it too */
+        pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+        for (i = 0; i < MAX_ACTIVE_INSERT_PAGES; i++)
+            if (eduom_activeInsertPageTable[i].owner == ORPHANED_OWNER &&
+                EQUAL_FILEID(eduom_activeInsertPageTable[i].fid, *fid)) break;
+
+        if (i < MAX_ACTIVE_INSERT_PAGES) {
+            entry = eduom_activeInsertPageTable[i];
+            eduom_activeInsertPageTable[i].owner = NIL;
+        }
+
+        pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+        if (i == MAX_ACTIVE_INSERT_PAGES) break;
+
+        e = eduom_PublishActiveInsertPage(catObjForFile, &entry.pid);
+        if (e < 0) ERR(e);
+    }
+
+    pthread_mutex_lock(&eduom_activeInsertPageMutex);
+
+    for (i = 0, walked = FALSE; i < eduom_nRecoveredFiles && !walked; i++)
+        walked = EQUAL_FILEID(eduom_recoveredFiles[i], *fid);
+
+    if (!walked && eduom_nRecoveredFiles == eduom_maxRecoveredFiles) {
+        files = (FileID *)realloc(eduom_recoveredFiles, sizeof(FileID) * (eduom_maxRecoveredFiles*2 + 16));
+        if (files == NULL) {
+            pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+            ERR(eMEMORYALLOCERR);
+        }
+        eduom_recoveredFiles = files;
+        eduom_maxRecoveredFiles = eduom_maxRecoveredFiles*2 + 16;
+    }
+    if (!walked) eduom_recoveredFiles[eduom_nRecoveredFiles++] = *fid;
+
+    pthread_mutex_unlock(&eduom_activeInsertPageMutex);
+
+    if (walked) return(eNOERROR);
+
+    e = EduOM_RecoverActiveInsertPages(catObjForFile);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_RecoverActiveInsertPages() */
@@ -0,0 +1,347 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Analyze.c
+ *
+ * Description :
+ *  Print how the space of a data file is used(see EduOM_AnalyzeFile()).
+ *
+ *  With -f, the data file of the given serial number on an existing volume
+ *  is analyzed. With -g, a volume is formatted and a data file is generated
+ *  first: 'objects' objects are created and then 'destroyPct' percent of them
+ *  are destroyed at random, which leaves 'unused' bytes in the pages; the
+ *  serial number of the file is printed so that it can be analyzed again.
+ *
+ *  The result is printed as lines of 'key=value' pairs: the totals of the
+ *  file, one line per histogram, and the pages per available space list.
+ *
+ *  usage: EduOM_Analyze -f serial [-d device] [-v volId]
+ *         EduOM_Analyze -g [-d device] [-v volId] [-p pages] [-n objects]
+ *                       [-x destroyPct] [-s minSize] [-S maxSize] [-r seed]
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define ANALYZE_DEFAULT_DEVICE      "analyze.vol"
+#define ANALYZE_DEFAULT_VOLID       1000
+#define ANALYZE_DEFAULT_PAGES       20000
+#define ANALYZE_DEFAULT_OBJECTS     10000
+#define ANALYZE_DEFAULT_DESTROY     30
+#define ANALYZE_DEFAULT_MIN_SIZE    16
+#define ANALYZE_DEFAULT_MAX_SIZE    256
+
+
+/*@
+ * Global Variables
+ */
+static char *analyze_listName[EDUOM_NUM_SPACE_LISTS] = { "10", "20", "30", "40", "50", "none" };
+static UFour analyze_seed = 1;
+
+
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+
+
+
+/*@================================
+ * analyze_Random()
+ *================================*/
+/*
+ * Function: UFour analyze_Random(UFour)
+ *
+ * Description:
+ *  Return a pseudo random number less than 'n'(xorshift).
+ *
+ * Returns:
+ *  random number in [0, n)
+ */
+static UFour analyze_Random(
+    UFour	n)		/* IN range */
+{
+    analyze_seed ^= analyze_seed << 13;
+    analyze_seed ^= analyze_seed >> 17;
+    analyze_seed ^= analyze_seed << 5;
+
+    return((n == 0) ? 0 : analyze_seed % n);
+
+} /* analyze_Random() */
+
+
+
+/*@================================
+ * analyze_Generate()
+ *================================*/
+/*
+ * Function: Four analyze_Generate(ObjectID*, Four, Four, Four, Four)
+ *
+ * Description:
+ *  Create 'nObjects' objects of random sizes in the file and destroy
+ *  'destroyPct' percent of them at random.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four analyze_Generate(
+    ObjectID	*catObjForFile,	/* IN the data file */
+    Four	nObjects,	/* IN the number of objects to create */
+    Four	destroyPct,	/* IN percent of the objects to destroy */
+    Four	minSize,	/* IN minimum length of an object */
+    Four	maxSize)	/* IN maximum length of an object */
+{
+    Four	e;		/* error number */
+    Four	i, j;		/* index variables */
+    Four	nLive;		/* live objects */
+    ObjectID	*live;		/* the live objects */
+    char	data[PAGESIZE];	/* data of the objects */
+
+
+    live = (ObjectID *)malloc(sizeof(ObjectID) * MAX(nObjects, 1));
+    if (live == NULL) ERR(eMEMORYALLOCERR);
+    memset(data, 'x', sizeof(data));
+
+    for (i = 0, e = eNOERROR; i < nObjects && e >= eNOERROR; i++)
+        e = EduOM_CreateObject(catObjForFile, NULL, NULL,
+                               minSize + analyze_Random(maxSize - minSize + 1), data, &live[i]);
+
+    for (i = 0, nLive = nObjects; i < (Four)((double)nObjects*destroyPct/100) && e >= eNOERROR; i++) {
+        j = analyze_Random(nLive);
+        e = EduOM_DestroyObject(catObjForFile, &live[j], &dlPool, &dlHead);
+        live[j] = live[--nLive];
+    }
+
+    free(live);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* analyze_Generate() */
+
+
+
+/*@================================
+ * analyze_PrintHist()
+ *================================*/
+/*
+ * Function: void analyze_PrintHist(char*, char*, UFour*, Four)
+ *
+ * Description:
+ *  Print a histogram as a comma separated list of counts.
+ *
+ * Returns:
+ *  None
+ */
+static void analyze_PrintHist(
+    char	*name,		/* IN name of the histogram */
+    char	*buckets,	/* IN description of the buckets */
+    UFour	*hist,		/* IN counts */
+    Four	nBuckets)	/* IN the number of buckets */
+{
+    Four	i;		/* index variable */
+
+
+    printf("hist=%s buckets=%s counts=", name, buckets);
+    for (i = 0; i < nBuckets; i++) printf((i == 0) ? "%u" : ",%u", hist[i]);
+    printf("\n");
+
+} /* analyze_PrintHist() */
+
+
+
+/*@================================
+ * analyze_Print()
+ *================================*/
+/*
+ * Function: void analyze_Print(FileID*, EduOM_FileSpace*)
+ *
+ * Description:
+ *  Print the analysis of a data file.
+ *
+ * Returns:
+ *  None
+ */
+static void analyze_Print(
+    FileID	*fid,		/* IN the data file */
+    EduOM_FileSpace *space)	/* IN analysis of the file */
+{
+    Four	l;		/* index of the available space list */
+    char	buckets[32];	/* description of the buckets */
+
+
+    printf("file vol=%d serial=%d pages=%d slots=%d objects=%d empty_slots=%d data_bytes=%.0f "
+           "object_bytes=%.0f slot_bytes=%.0f free_bytes=%.0f cfree_bytes=%.0f unused_bytes=%.0f "
+           "max_unused=%d pages_with_unused=%d misplaced_pages=%u space_amplification=%.3f\n",
+           fid->volNo, fid->serial, space->nPages, space->nSlots, space->nObjects, space->nEmptySlots,
+           space->dataBytes, space->objectBytes, space->slotBytes, space->freeBytes, space->cfreeBytes,
+           space->unusedBytes, space->maxUnused, space->nPagesWithUnused, space->misplacedPages,
+           space->spaceAmplification);
+
+    sprintf(buckets, "%d_bytes", PAGESIZE / EDUOM_SPACE_HIST_BUCKETS);
+    analyze_PrintHist("sp_free", buckets, space->freeHist, EDUOM_SPACE_HIST_BUCKETS);
+    analyze_PrintHist("sp_cfree", buckets, space->cfreeHist, EDUOM_SPACE_HIST_BUCKETS);
+    analyze_PrintHist("unused", buckets, space->unusedHist, EDUOM_SPACE_HIST_BUCKETS);
+    analyze_PrintHist("object_size", "log2", space->sizeHist, EDUOM_SIZE_HIST_BUCKETS);
+
+    for (l = 0; l < EDUOM_NUM_SPACE_LISTS; l++)
+        printf("space_list=%s bucket_pages=%u list_pages=%u\n",
+               analyze_listName[l], space->bucketPages[l], space->listPages[l]);
+
+} /* analyze_Print() */
+
+
+
+/*@================================
+ * main()
+ *================================*/
+Four main(int argc, char *argv[])
+{
+    Four	e;		/* error number */
+    Four	c;		/* option */
+    Four	handle;		/* system handle */
+    char	*devName = ANALYZE_DEFAULT_DEVICE;
+    Four	volId = ANALYZE_DEFAULT_VOLID;
+    Four	nPages = ANALYZE_DEFAULT_PAGES;
+    Four	nObjects = ANALYZE_DEFAULT_OBJECTS;
+    Four	destroyPct = ANALYZE_DEFAULT_DESTROY;
+    Four	minSize = ANALYZE_DEFAULT_MIN_SIZE;
+    Four	maxSize = ANALYZE_DEFAULT_MAX_SIZE;
+    Boolean	generate = FALSE;
+    Four	serial = -1;	/* serial number of the file to analyze */
+    FileID	fid;		/* data file */
+    ObjectID	catalogEntry;	/* catalog object of the data file */
+    XactID	xactId;		/* transaction identifier */
+    EduOM_FileSpace space;	/* analysis of the file */
+
+
+    while ((c = getopt(argc, argv, "f:gd:v:p:n:x:s:S:r:")) != -1) {
+        switch (c) {
+          case 'f': serial = atoi(optarg); break;
+          case 'g': generate = TRUE; break;
+          case 'd': devName = optarg; break;
+          case 'v': volId = atoi(optarg); break;
+          case 'p': nPages = atoi(optarg); break;
+          case 'n': nObjects = atoi(optarg); break;
+          case 'x': destroyPct = atoi(optarg); break;
+          case 's': minSize = atoi(optarg); break;
+          case 'S': maxSize = atoi(optarg); break;
+          case 'r': analyze_seed = (UFour)atol(optarg); break;
+          default:
+            serial = -1;
+            generate = FALSE;
+            optind = argc;
+        }
+    }
+
+    if (generate == (serial >= 0)) {
+        fprintf(stderr, "usage: %s -f serial [-d device] [-v volId]\n"
+                "       %s -g [-d device] [-v volId] [-p pages] [-n objects] [-x destroyPct] "
+                "[-s minSize] [-S maxSize] [-r seed]\n", argv[0], argv[0]);
+        exit(1);
+    }
+
+    if (minSize < 0 || maxSize < minSize || ALIGNED_LENGTH(maxSize) > LRGOBJ_THRESHOLD ||
+        nPages <= 0 || nObjects < 0 || destroyPct < 0 || destroyPct > 100) {
+        fprintf(stderr, "%s: bad object sizes, pages, objects or percent\n", argv[0]);
+        exit(1);
+    }
+    if (analyze_seed == 0) analyze_seed = 1;
+
+    e = LRDS_Init();
+    if (e < eNOERROR) {
+        printf("LRDS_Init failed!!!\n");
+        exit(1);
+    }
+
+    e = LRDS_AllocHandle(&handle);
+    if (e < eNOERROR) {
+        printf("LRDS_AllocHandle failed!!!\n");
+        LRDS_Final();
+        exit(1);
+    }
+
+    if (generate) {
+        e = LRDS_FormatDataVolume(1, &devName, "analyze", volId, 16, &nPages, 16);
+        if (e < eNOERROR) {
+            printf("LRDS_FormatDataVolume failed!!!\n");
+            LRDS_FreeHandle(handle);
+            LRDS_Final();
+            exit(1);
+        }
+    }
+
+    e = LRDS_Mount(1, &devName, &volId);
+    if (e < eNOERROR) {
+        printf("LRDS_Mount failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+
+    if (generate) {
+        if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+        if (e >= eNOERROR) e = analyze_Generate(&catalogEntry, nObjects, destroyPct, minSize, maxSize);
+        /* the pages owned for the inserts go back into the available space lists */
+        if (e >= eNOERROR) e = EduOM_ReleaseActiveInsertPages();
+    }
+    else {
+        fid.volNo = volId;
+        fid.serial = serial;
+        if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &catalogEntry);
+    }
+
+    if (e >= eNOERROR) e = EduOM_AnalyzeFile(&catalogEntry, &space);
+    if (e >= eNOERROR) analyze_Print(&fid, &space);
+
+    if (e < eNOERROR) {
+        printf("EduOM_Analyze failed!!!\n");
+        LRDS_AbortTransaction(&xactId);
+    }
+    else
+        LRDS_CommitTransaction(&xactId);
+
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+
+    return((e < eNOERROR) ? 1 : 0);
+
+} /* main() */
@@ -0,0 +1,302 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_AnalyzeFile.c
+ *
+ * Description:
+ *  Analyze how the space of a data file is used. The page list of the file
+ *  is walked and the free, contiguous free and 'unused' bytes of each page,
+ *  its slots and the lengths of its objects are summed into histograms;
+ *  then the available space lists are walked to count the pages on each.
+ *  This is what OM_DumpSlottedPage() and OM_DumpSpaceList() print, as data.
+ *
+ *  The pages on the available space lists may be fewer than those whose free
+ *  space belongs to a list: the active insert pages are kept out of the
+ *  lists while they are owned(see EduOM_ActiveInsertPage.c).
+ *
+ * Exports:
+ *  Four EduOM_AnalyzeFile(ObjectID*, EduOM_FileSpace*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
+#include "EduOM_Internal.h"
+
+
+
+/* Macro: EDUOM_SPACE_BUCKET(_bytes)
+ * Description: return the bucket of the space histograms for the bytes
+ * Returns: (Four) bucket
+ */
+#define EDUOM_SPACE_BUCKET(_bytes) \
+    MIN(MAX((_bytes), 0) / (PAGESIZE / EDUOM_SPACE_HIST_BUCKETS), EDUOM_SPACE_HIST_BUCKETS - 1)
+
+
+
+/*@================================
+ * eduom_SpaceList()
+ *================================*/
+/*
+ * Function: Four eduom_SpaceList(SlottedPage*)
+ *
+ * Description:
+ *  Return the available space list the free space of the page belongs to.
+ *
+ * Returns:
+ *  EDUOM_SPACE_LIST_XXX
+ */
+static Four eduom_SpaceList(
+    SlottedPage	*apage)		/* IN the page */
+{
+    Four	freeBytes = SP_FREE(apage);
+
+
+    if (freeBytes >= SP_50SIZE) return(EDUOM_SPACE_LIST_50);
+    if (freeBytes >= SP_40SIZE) return(EDUOM_SPACE_LIST_40);
+    if (freeBytes >= SP_30SIZE) return(EDUOM_SPACE_LIST_30);
+    if (freeBytes >= SP_20SIZE) return(EDUOM_SPACE_LIST_20);
+    if (freeBytes >= SP_10SIZE) return(EDUOM_SPACE_LIST_10);
+
+    return(EDUOM_SPACE_LIST_NONE);
+
+} /* eduom_SpaceList() */
+
+
+
+/*@================================
+ * eduom_AnalyzePage()
+ *================================*/
+/*
+ * Function: void eduom_AnalyzePage(SlottedPage*, EduOM_FileSpace*)
+ *
+ * Description:
+ *  Add the space of a page to the analysis.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_AnalyzePage(
+    SlottedPage	*apage,		/* IN the page */
+    EduOM_FileSpace *space)	/* INOUT analysis of the file */
+{
+    Four	i;		/* index variable */
+    Four	b;		/* bucket of the size histogram */
+    Object	*obj;		/* an object of the page */
+    Four	length;		/* length of an object */
+    Four	offset;		/* offset of an object */
+    Four	j;		/* index variable */
+    UFour	v;		/* varint of a small object page */
+    Four	rowWidth;	/* bytes of a row if the page is a PAX page */
+    eduom_FixedPageHdr *fixedHdr; /* header of a fixed length record page */
+
+
+    space->nPages++;
+    space->nSlots += apage->header.nSlots;
+    space->slotBytes += apage->header.nSlots * sizeof(SlottedPageSlot);
+    space->freeBytes += SP_FREE(apage);
+    space->cfreeBytes += SP_CFREE(apage);
+    space->unusedBytes += apage->header.unused;
+    space->maxUnused = MAX(space->maxUnused, apage->header.unused);
+    if (apage->header.unused > 0) space->nPagesWithUnused++;
+
+    space->freeHist[EDUOM_SPACE_BUCKET(SP_FREE(apage))]++;
+    space->cfreeHist[EDUOM_SPACE_BUCKET(SP_CFREE(apage))]++;
+    space->unusedHist[EDUOM_SPACE_BUCKET(apage->header.unused)]++;
+    space->bucketPages[eduom_SpaceList(apage)]++;
+
+    /* a fixed length record page has a bitmap of the live records instead of the slots */
+    if (IS_FIXED_PAGE(apage)) {
+        fixedHdr = FIXED_PAGE_HDR(apage);
+        space->slotBytes += fixedHdr->recordOffset - (Four)sizeof(SlottedPageSlot)*apage->header.nSlots;
+        space->nObjects += fixedHdr->nLive;
+        space->nEmptySlots += apage->header.nSlots - fixedHdr->nLive;
+        space->dataBytes += (double)fixedHdr->nLive * fixedHdr->length;
+        space->objectBytes += (double)fixedHdr->nLive * fixedHdr->length;
+
+        for (b = 0; b < EDUOM_SIZE_HIST_BUCKETS-1 && fixedHdr->length >= (1 << b); b++);
+        space->sizeHist[b] += fixedHdr->nLive;
+        return;
+    }
+
+    /* a small object page has 2-byte slots and objects with varint headers */
+    if (IS_SMALL_PAGE(apage)) {
+        space->slotBytes += (Four)sizeof(eduom_SmallPageHdr) +
+                            ((Four)sizeof(Two) - (Four)sizeof(SlottedPageSlot))*apage->header.nSlots;
+
+        for (i = 0; i < apage->header.nSlots; i++) {
+            offset = SMALL_SLOT(apage, i);
+            if (offset == EMPTYSLOT) {
+                space->nEmptySlots++;
+                continue;
+            }
+
+            /* the header is a varint of (length << 1 | tag flag) and the tag if the flag is set */
+            for (j = 0, v = 0; apage->data[offset + j] & 0x80; j++)
+                v |= (apage->data[offset + j] & 0x7f) << (7*j);
+            v |= (apage->data[offset + j] & 0x7f) << (7*j);
+            length = v >> 1;
+
+            space->nObjects++;
+            space->dataBytes += length;
+            space->objectBytes += j + 1 + ((v & 1) ? sizeof(Two) : 0) + length;
+
+            for (b = 0; b < EDUOM_SIZE_HIST_BUCKETS-1 && length >= (1 << b); b++);
+            space->sizeHist[b]++;
+        }
+        return;
+    }
+
+    /* the dictionary of a prefix page is overhead of the page, as the slots are */
+    space->slotBytes += PREFIX_DICT_SIZE(apage);
+
+    rowWidth = 0;
+    if (IS_PAX_PAGE(apage))
+        for (i = 0; i < PAX_PAGE_HDR(apage)->schema.nFields; i++)
+            rowWidth += PAX_PAGE_HDR(apage)->schema.width[i];
+
+    for (i = 0; i < apage->header.nSlots; i++) {
+        if (SLOT_OFFSET(apage, i) == EMPTYSLOT) {
+            space->nEmptySlots++;
+            continue;
+        }
+
+        /* a row of a PAX page has no object header */
+        if (IS_PAX_PAGE(apage)) {
+            length = rowWidth;
+            space->objectBytes += length;
+        } else {
+            obj = (Object *)&(apage->data[SLOT_OFFSET(apage, i)]);
+            space->objectBytes += sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
+
+            /* the data of a prefixed object is the prefix in the dictionary and the stored rest */
+            length = obj->header.length;
+            if (obj->header.properties & P_PREFIXED) length += (unsigned char)obj->data[0] - 1;
+        }
+        space->nObjects++;
+        space->dataBytes += length;
+
+        for (b = 0; b < EDUOM_SIZE_HIST_BUCKETS-1 && length >= (1 << b); b++);
+        space->sizeHist[b]++;
+    }
+
+} /* eduom_AnalyzePage() */
+
+
+
+/*@================================
+ * EduOM_AnalyzeFile()
+ *================================*/
+/*
+ * Function: Four EduOM_AnalyzeFile(ObjectID*, EduOM_FileSpace*)
+ *
+ * Description:
+ *  Analyze how the space of the data file is used. The space amplification
+ *  is the bytes of the pages of the file divided by the bytes of the object
+ *  data; 0 if the file has no data.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_AnalyzeFile(
+    ObjectID	*catObjForFile,	/* IN information about a data file */
+    EduOM_FileSpace *space)	/* OUT analysis of the file */
+{
+    Four	e;		/* error number */
+    Four	l;		/* index of the available space list */
+    Four	n;		/* pages visited in a list */
+    PageID	pid;		/* a page of the file */
+    PageNo	listHead[EDUOM_NUM_SPACE_LISTS-1]; /* first pages of the available space lists */
+    SlottedPage	*catPage;	/* page containing the catalog object */
+    SlottedPage	*apage;		/* a page of the file */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (space == NULL) ERR(eBADPARAMETER_OM);
+
+    BfM_SetCaller(BFM_CALLER_OTHER);
+
+    memset(space, 0, sizeof(EduOM_FileSpace));
+
+    /* 1. catalog entry of the file */
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    listHead[EDUOM_SPACE_LIST_10] = catEntry->availSpaceList10;
+    listHead[EDUOM_SPACE_LIST_20] = catEntry->availSpaceList20;
+    listHead[EDUOM_SPACE_LIST_30] = catEntry->availSpaceList30;
+    listHead[EDUOM_SPACE_LIST_40] = catEntry->availSpaceList40;
+    listHead[EDUOM_SPACE_LIST_50] = catEntry->availSpaceList50;
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /* 2. pages of the file */
+    while (pid.pageNo != NIL) {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        eduom_AnalyzePage(apage, space);
+        pid.pageNo = apage->header.nextPage;
+
+        e = BfM_FreeTrain((TrainID *)&apage->header.pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    /* 3. available space lists; a list longer than the file is broken */
+    for (l = 0; l < EDUOM_NUM_SPACE_LISTS-1; l++) {
+        pid.pageNo = listHead[l];
+        for (n = 0; pid.pageNo != NIL && n < space->nPages; n++) {
+            e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            space->listPages[l]++;
+            if (eduom_SpaceList(apage) != l) space->misplacedPages++;
+            pid.pageNo = apage->header.spaceListNext;
+
+            e = BfM_FreeTrain((TrainID *)&apage->header.pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+        }
+    }
+    for (l = 0, n = 0; l < EDUOM_NUM_SPACE_LISTS-1; l++) n += space->listPages[l];
+    space->listPages[EDUOM_SPACE_LIST_NONE] = MAX(space->nPages - n, 0);
+
+    space->spaceAmplification = (space->dataBytes > 0) ?
+        (double)space->nPages * PAGESIZE / space->dataBytes : 0.0;
+
+    return(eNOERROR);
+
+} /* EduOM_AnalyzeFile() */
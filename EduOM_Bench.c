@@ -0,0 +1,984 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Bench.c
+ *
+ * Description :
+ *  Microbenchmarks of the EduOM. A volume of the given size is formatted,
+ *  and the workloads given are run one after another on one data file:
+ *
+ *    create      create objects without a near object
+ *    randcreate  create objects near a random live object
+ *    nearcreate  create objects near the object created last
+ *    read        read random live objects
+ *    scanfwd     scan the file forward with EduOM_NextObject()
+ *    scanbwd     scan the file backward with EduOM_PrevObject()
+ *    destroy     destroy random live objects
+ *    churn       destroy a random live object and create another one,
+ *                so that the freed space has to be compacted
+ *    compact     compact every page of the file with EduOM_CompactPage()
+ *    kernels     time the kernels scanning the slots and moving the objects
+ *                (see EduOM_SlotKernel.c) on a copy of the pages of the
+ *                file, with each instruction set the processor supports
+ *
+ *  The objects are uniformly sized between the minimum and the maximum.
+ *  Each workload prints one line of 'key=value' pairs: the operations done,
+ *  operations per second, p50/p99/max latency in usec, the pages of the
+ *  file, and the buffer manager statistics of the workload.
+ *
+ *  With -P, the hardware counters of the workload(cycles, instructions,
+ *  L1D/LLC/dTLB read misses, branch misses; see EduOM_PerfCounter.c) are
+ *  read and one more line per workload prints them per operation. A counter
+ *  which cannot be opened, e.g. in a container, is printed as 'na', and if
+ *  none can be opened the reason is printed once.
+ *
+ *  With -U, the scans read the volume in units of the given bytes(see
+ *  EduOM_SetScanUnit()).
+ *
+ *  With -L soa, the pages of the file get the struct-of-arrays slot
+ *  directory(see EduOM_SetSoaSlots()) instead of the array of
+ *  SlottedPageSlot('aos'), so that the scans and compaction of the two
+ *  layouts can be compared.
+ *
+ *  With -I, the other workloads use the slot kernels of the given
+ *  instruction set instead of the default one. The 'kernels' workload
+ *  prints a line per kernel and instruction set: nsec per page and the
+ *  speedup over the plain C version. Only 'findempty' on the pages of 'soa'
+ *  has SIMD versions(see EduOM_SlotKernel.c), so the other kernels print
+ *  the line of the plain C version alone.
+ *
+ *  With -C, the background compactor(see EduOM_RunCompactor()) compacts up
+ *  to the given pages between two operations, outside the time measured,
+ *  as an application would from its idle loop. Each workload line also
+ *  prints the compactions done by the inserts and by the compactor, and the
+ *  bytes of the objects they moved.
+ *
+ *  With -H, the trains resident in the buffer pool are saved into the given
+ *  file before the volume is dismounted(see BfM_SaveResidentTrains()). After
+ *  the workloads the volume is then dismounted and mounted again twice, and
+ *  the 'read' workload is run once more after each restart with the same
+ *  seed: after a cold restart the buffer pool is empty, and after a warm
+ *  restart the trains of the file are read back first(see
+ *  BfM_LoadResidentTrains()). A line 'restart=cold|warm loaded=N' precedes
+ *  the line of each run, whose bfm_misses compare the two restarts.
+ *
+ *  usage: EduOM_Bench [-d device] [-p pages] [-n ops] [-s minSize] [-S maxSize]
+ *                     [-r seed] [-w workload,...] [-P] [-U scanUnit] [-L aos|soa]
+ *                     [-I scalar|sse2|avx2] [-C compactPages] [-H hotFile]
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define BENCH_DEFAULT_DEVICE    "bench.vol"
+#define BENCH_DEFAULT_PAGES     20000
+#define BENCH_DEFAULT_OPS       10000
+#define BENCH_DEFAULT_MIN_SIZE  16
+#define BENCH_DEFAULT_MAX_SIZE  256
+#define BENCH_DEFAULT_WORKLOADS "create,randcreate,nearcreate,read,scanfwd,scanbwd,destroy,churn,compact,kernels"
+#define BENCH_VOLID             1000
+
+/* slot kernels(see bench_RunKernels()) */
+#define BENCH_KERNEL_FINDEMPTY      0
+#define BENCH_KERNEL_NEXTLIVE       1
+#define BENCH_KERNEL_PREVLIVE       2
+#define BENCH_KERNEL_MOVEDOWN       3
+#define BENCH_NUM_KERNELS           4
+#define BENCH_KERNEL_VISITS         500000  /* pages a kernel visits */
+
+
+/*@
+ * Type Definitions
+ */
+/* result of a workload */
+typedef struct {
+    Four	nOps;		/* operations done */
+    double	*latency;	/* usec taken by each operation */
+    double	elapsed;	/* usec taken by the workload */
+} bench_Result;
+
+
+/*@
+ * Global Variables
+ */
+static ObjectID bench_catalogEntry;	/* catalog object of the data file */
+static ObjectID *bench_live;		/* live objects */
+static Four bench_nLive = 0;
+static Four bench_maxLive = 0;
+static ObjectID bench_lastCreated;	/* object created last */
+static Boolean bench_created = FALSE;	/* has an object been created? */
+static Four bench_minSize = BENCH_DEFAULT_MIN_SIZE;
+static Four bench_maxSize = BENCH_DEFAULT_MAX_SIZE;
+static UFour bench_seed = 1;
+static char bench_data[PAGESIZE];	/* data of the objects */
+static Boolean bench_perf = FALSE;	/* read the hardware counters? */
+static Four bench_compactPages = 0;	/* pages compacted between two operations */
+static char *bench_kernelName[BENCH_NUM_KERNELS] = {
+    "findempty", "nextlive", "prevlive", "movedown"
+};
+
+
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+
+
+/* Macro: BENCH_USEC(_from, _to)
+ * Description: return the microseconds elapsed between two times
+ * Returns: (double) microseconds
+ */
+#define BENCH_USEC(_from, _to) \
+    (((_to).tv_sec - (_from).tv_sec)*1e6 + ((_to).tv_nsec - (_from).tv_nsec)/1e3)
+
+
+
+/*@================================
+ * bench_Random()
+ *================================*/
+/*
+ * Function: UFour bench_Random(UFour)
+ *
+ * Description:
+ *  Return a pseudo random number less than 'n'(xorshift), the same sequence
+ *  on every platform for the same seed.
+ *
+ * Returns:
+ *  random number in [0, n)
+ */
+static UFour bench_Random(
+    UFour	n)		/* IN range */
+{
+    bench_seed ^= bench_seed << 13;
+    bench_seed ^= bench_seed >> 17;
+    bench_seed ^= bench_seed << 5;
+
+    return((n == 0) ? 0 : bench_seed % n);
+
+} /* bench_Random() */
+
+
+
+/*@================================
+ * bench_CompareDouble()
+ *================================*/
+/*
+ * Function: int bench_CompareDouble(const void*, const void*)
+ *
+ * Description:
+ *  Compare two latencies for qsort().
+ *
+ * Returns:
+ *  negative, zero, or positive as qsort() expects
+ */
+static int bench_CompareDouble(
+    const void	*a,		/* IN latency */
+    const void	*b)		/* IN latency */
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return((x < y) ? -1 : (x > y) ? 1 : 0);
+
+} /* bench_CompareDouble() */
+
+
+
+/*@================================
+ * bench_AddLive()
+ *================================*/
+/*
+ * Function: Four bench_AddLive(ObjectID*)
+ *
+ * Description:
+ *  Remember a created object.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four bench_AddLive(
+    ObjectID	*oid)		/* IN object created */
+{
+    ObjectID	*live;		/* enlarged array */
+
+
+    if (bench_nLive == bench_maxLive) {
+        live = (ObjectID *)realloc(bench_live, sizeof(ObjectID) * MAX(2*bench_maxLive, 1024));
+        if (live == NULL) ERR(eMEMORYALLOCERR);
+        bench_live = live;
+        bench_maxLive = MAX(2*bench_maxLive, 1024);
+    }
+
+    bench_live[bench_nLive++] = *oid;
+    bench_lastCreated = *oid;
+    bench_created = TRUE;
+
+    return(eNOERROR);
+
+} /* bench_AddLive() */
+
+
+
+/*@================================
+ * bench_Create()
+ *================================*/
+/*
+ * Function: Four bench_Create(ObjectID*)
+ *
+ * Description:
+ *  Create an object of a random size near the given object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Create(
+    ObjectID	*nearObj)	/* IN near object; NULL if none */
+{
+    Four	e;		/* error number */
+    Four	length;		/* length of the object */
+    ObjectID	oid;		/* object created */
+
+
+    length = bench_minSize + bench_Random(bench_maxSize - bench_minSize + 1);
+
+    e = EduOM_CreateObject(&bench_catalogEntry, nearObj, NULL, length, bench_data, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    return(bench_AddLive(&oid));
+
+} /* bench_Create() */
+
+
+
+/*@================================
+ * bench_Destroy()
+ *================================*/
+/*
+ * Function: Four bench_Destroy(void)
+ *
+ * Description:
+ *  Destroy a random live object.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Destroy(void)
+{
+    Four	e;		/* error number */
+    Four	i;		/* index of the object */
+
+
+    if (bench_nLive == 0) return(eNOERROR);
+
+    i = bench_Random(bench_nLive);
+
+    e = EduOM_DestroyObject(&bench_catalogEntry, &bench_live[i], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    bench_live[i] = bench_live[--bench_nLive];
+
+    return(eNOERROR);
+
+} /* bench_Destroy() */
+
+
+
+/*@================================
+ * bench_CountPages()
+ *================================*/
+/*
+ * Function: Four bench_CountPages(void)
+ *
+ * Description:
+ *  Count the pages of the data file by following the page list.
+ *
+ * Returns:
+ *  the number of pages
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_CountPages(void)
+{
+    Four	e;		/* error number */
+    Four	n;		/* the number of pages */
+    PageID	pid;		/* a page of the file */
+    PageNo	lastPage;	/* last page of the file */
+    SlottedPage	*catPage;	/* page containing the catalog object */
+    SlottedPage	*apage;		/* a page of the file */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+    ObjectID	*catObjForFile = &bench_catalogEntry;
+
+
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    lastPage = catEntry->lastPage;
+    BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+
+    for (n = 1; pid.pageNo != lastPage; n++) {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        pid.pageNo = apage->header.nextPage;
+        BfM_FreeTrain((TrainID *)&apage->header.pid, PAGE_BUF);
+        if (pid.pageNo == NIL) break;
+    }
+
+    return(n);
+
+} /* bench_CountPages() */
+
+
+
+/*@================================
+ * bench_PrintCounters()
+ *================================*/
+/*
+ * Function: void bench_PrintCounters(char*, Four, double*)
+ *
+ * Description:
+ *  Print the hardware counters of a workload per operation, and IPC.
+ *
+ * Returns:
+ *  None
+ */
+static void bench_PrintCounters(
+    char	*workload,	/* IN name of the workload */
+    Four	nOps,		/* IN the number of operations */
+    double	*value)		/* IN values of the counters */
+{
+    Four	i;		/* index variable */
+
+
+    printf("workload=%s perf", workload);
+    for (i = 0; i < EDUOM_NUM_PERF_COUNTERS; i++) {
+        if (value[i] < 0 || nOps == 0) printf(" %s_per_op=na", eduom_PerfCounterName(i));
+        else printf(" %s_per_op=%.1f", eduom_PerfCounterName(i), value[i] / nOps);
+    }
+    if (value[EDUOM_PERF_CYCLES] > 0 && value[EDUOM_PERF_INSTRUCTIONS] >= 0)
+        printf(" ipc=%.2f\n", value[EDUOM_PERF_INSTRUCTIONS] / value[EDUOM_PERF_CYCLES]);
+    else
+        printf(" ipc=na\n");
+
+} /* bench_PrintCounters() */
+
+
+
+/*@================================
+ * bench_RunOp()
+ *================================*/
+/*
+ * Function: Four bench_RunOp(char*, ObjectID*)
+ *
+ * Description:
+ *  Do one operation of the workload. A scan keeps its position in 'cursor'
+ *  and ends when the position does not move; 'compact' keeps the page to
+ *  compact next in it.
+ *
+ * Returns:
+ *  eNOERROR, EOS at the end of a scan
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_RunOp(
+    char	*workload,	/* IN name of the workload */
+    ObjectID	*cursor)	/* INOUT position of a scan; pageNo NIL before the first call */
+{
+    Four	e;		/* error number */
+    ObjectID	next;		/* next position of a scan */
+    char	buf[PAGESIZE];	/* buffer to read an object into */
+    PageID	pid;		/* page to compact */
+    SlottedPage	*apage;		/* ... fixed */
+    SlottedPage	*catPage;	/* page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+
+
+    if (strcmp(workload, "create") == 0)
+        return(bench_Create(NULL));
+
+    if (strcmp(workload, "randcreate") == 0)
+        return(bench_Create((bench_nLive > 0) ? &bench_live[bench_Random(bench_nLive)] : NULL));
+
+    if (strcmp(workload, "nearcreate") == 0)
+        return(bench_Create(bench_created ? &bench_lastCreated : NULL));
+
+    if (strcmp(workload, "read") == 0) {
+        if (bench_nLive == 0) return(EOS);
+        e = EduOM_ReadObject(&bench_live[bench_Random(bench_nLive)], 0, REMAINDER, buf);
+        if (e < eNOERROR) ERR(e);
+        return(eNOERROR);
+    }
+
+    if (strcmp(workload, "scanfwd") == 0 || strcmp(workload, "scanbwd") == 0) {
+        next = *cursor;
+        if (workload[4] == 'f')
+            e = EduOM_NextObject(&bench_catalogEntry, (cursor->pageNo == NIL) ? NULL : cursor, &next, NULL);
+        else
+            e = EduOM_PrevObject(&bench_catalogEntry, (cursor->pageNo == NIL) ? NULL : cursor, &next, NULL);
+        if (e < eNOERROR) ERR(e);
+        if (next.pageNo == cursor->pageNo && next.slotNo == cursor->slotNo) return(EOS);
+        *cursor = next;
+        return(eNOERROR);
+    }
+
+    if (strcmp(workload, "destroy") == 0) {
+        if (bench_nLive == 0) return(EOS);
+        return(bench_Destroy());
+    }
+
+    if (strcmp(workload, "churn") == 0) {
+        e = bench_Destroy();
+        if (e < eNOERROR) ERR(e);
+        return(bench_Create(NULL));
+    }
+
+    if (strcmp(workload, "compact") == 0) {
+        if (cursor->pageNo == NIL) {
+            e = BfM_GetTrain((TrainID *)&bench_catalogEntry, (char **)&catPage, PAGE_BUF);
+            if (e < eNOERROR) ERR(e);
+            GET_PTR_TO_CATENTRY_FOR_DATA((&bench_catalogEntry), catPage, catEntry);
+            MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+            BfM_FreeTrain((TrainID *)&bench_catalogEntry, PAGE_BUF);
+        }
+        else MAKE_PAGEID(pid, cursor->volNo, cursor->pageNo);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+        e = EduOM_CompactPage(apage, NIL);
+        if (e >= eNOERROR) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+        if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+        cursor->volNo = pid.volNo;
+        cursor->pageNo = apage->header.nextPage;
+        BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+
+        return(eNOERROR);
+    }
+
+    return(eBADPARAMETER);
+
+} /* bench_RunOp() */
+
+
+
+/*@================================
+ * bench_RunKernel()
+ *================================*/
+/*
+ * Function: Four bench_RunKernel(Four, SlottedPage*)
+ *
+ * Description:
+ *  Run the slot kernel on the page: find the empty slot, visit the live
+ *  slots forward or backward, or move every object to a buffer as
+ *  EduOM_CompactPage() does.
+ *
+ * Returns:
+ *  a number depending on the result, so that the call is not optimized out
+ */
+static Four bench_RunKernel(
+    Four	kernel,		/* IN BENCH_KERNEL_XXX */
+    SlottedPage	*apage)		/* IN page to run the kernel on */
+{
+    Four	s;		/* slot number */
+    Four	n;		/* result */
+    Four	len;		/* length of an object with its header */
+    Object	*obj;		/* an object */
+    static char	buf[PAGESIZE];	/* where the objects are moved to */
+
+
+    switch (kernel) {
+      case BENCH_KERNEL_FINDEMPTY:
+        return(eduom_FindEmptySlot(apage));
+
+      case BENCH_KERNEL_NEXTLIVE:
+        for (s = eduom_NextLiveSlot(apage, 0), n = 0; s < apage->header.nSlots; s = eduom_NextLiveSlot(apage, s+1)) n++;
+        return(n);
+
+      case BENCH_KERNEL_PREVLIVE:
+        for (s = eduom_PrevLiveSlot(apage, apage->header.nSlots-1), n = 0; s != NIL; s = eduom_PrevLiveSlot(apage, s-1)) n++;
+        return(n);
+
+      case BENCH_KERNEL_MOVEDOWN:
+        for (s = 0, n = 0; s < apage->header.nSlots; s++) {
+            if (SLOT_OFFSET(apage, s) == EMPTYSLOT) continue;
+            obj = (Object *)&(apage->data[SLOT_OFFSET(apage, s)]);
+            len = sizeof(ObjectHdr) + ALIGNED_LENGTH(obj->header.length);
+            eduom_MoveDown(&buf[n], (char *)obj, len);
+            n += len;
+        }
+        return(n + buf[0]);
+    }
+
+    return(0);
+
+} /* bench_RunKernel() */
+
+
+
+/*@================================
+ * bench_RunKernels()
+ *================================*/
+/*
+ * Function: Four bench_RunKernels(void)
+ *
+ * Description:
+ *  Time the slot kernels with each instruction set on a copy of the pages
+ *  of the file and print a line per kernel and instruction set. A kernel
+ *  with no SIMD version for the pages is timed in plain C only. The
+ *  kernels chosen before are chosen again at the end.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bench_RunKernels(void)
+{
+    Four	e;		/* error number */
+    Four	i, r;		/* index variables */
+    Four	kernel;		/* BENCH_KERNEL_XXX */
+    Four	isa;		/* EDUOM_ISA_XXX */
+    Four	isaBefore;	/* instruction set chosen before */
+    Four	nPages;		/* pages of the file */
+    Four	nReps;		/* times the pages are visited */
+    Boolean	simd;		/* does the kernel have SIMD versions for the pages? */
+    SlottedPage	*pages;		/* copy of the pages */
+    SlottedPage	*catPage;	/* page containing the catalog object */
+    SlottedPage	*apage;		/* a page of the file */
+    sm_CatOverlayForData *catEntry; /* catalog entry of the file */
+    PageID	pid;		/* a page of the file */
+    struct timespec t0, t1;	/* times */
+    double	nsec;		/* nsec per page */
+    double	scalarNsec;	/* ... of the plain C version */
+    volatile Four sink;		/* results of the kernels */
+
+
+    nPages = bench_CountPages();
+    if (nPages < eNOERROR) ERR(nPages);
+
+    pages = (SlottedPage *)malloc(sizeof(SlottedPage) * nPages);
+    if (pages == NULL) ERR(eMEMORYALLOCERR);
+
+    e = BfM_GetTrain((TrainID *)&bench_catalogEntry, (char **)&catPage, PAGE_BUF);
+    if (e < eNOERROR) {
+        free(pages);
+        ERR(e);
+    }
+    GET_PTR_TO_CATENTRY_FOR_DATA((&bench_catalogEntry), catPage, catEntry);
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    BfM_FreeTrain((TrainID *)&bench_catalogEntry, PAGE_BUF);
+
+    for (i = 0; i < nPages; i++) {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) {
+            free(pages);
+            ERR(e);
+        }
+        pages[i] = *apage;
+        pid.pageNo = apage->header.nextPage;
+        BfM_FreeTrain((TrainID *)&apage->header.pid, PAGE_BUF);
+    }
+
+    isaBefore = eduom_GetSlotKernels();
+    nReps = MAX(BENCH_KERNEL_VISITS / nPages, 1);
+
+    for (kernel = 0; kernel < BENCH_NUM_KERNELS; kernel++) {
+        /* only the search over the 2 byte offsets of SoA and small object pages */
+        simd = (kernel == BENCH_KERNEL_FINDEMPTY && (IS_SOA_PAGE(&pages[0]) || IS_SMALL_PAGE(&pages[0])));
+
+        for (isa = 0, scalarNsec = 0.0; isa < EDUOM_NUM_ISAS; isa++) {
+            if (isa != EDUOM_ISA_SCALAR && !simd) continue;
+            if (eduom_SelectSlotKernels(isa) < eNOERROR) continue;
+
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            for (r = 0, sink = 0; r < nReps; r++)
+                for (i = 0; i < nPages; i++) sink += bench_RunKernel(kernel, &pages[i]);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+
+            nsec = BENCH_USEC(t0, t1) * 1000.0 / ((double)nReps * nPages);
+            if (isa == EDUOM_ISA_SCALAR) scalarNsec = nsec;
+
+            printf("workload=kernels kernel=%s isa=%s pages=%d ns_per_page=%.1f speedup=%.2f\n",
+                   bench_kernelName[kernel], eduom_SlotKernelName(isa), nPages, nsec,
+                   (nsec > 0) ? scalarNsec/nsec : 0.0);
+        }
+    }
+    fflush(stdout);
+
+    eduom_SelectSlotKernels(isaBefore);
+    free(pages);
+
+    return(eNOERROR);
+
+} /* bench_RunKernels() */
+
+
+
+/*@================================
+ * bench_RunWorkload()
+ *================================*/
+/*
+ * Function: Four bench_RunWorkload(char*, Four)
+ *
+ * Description:
+ *  Run 'nOps' operations of the workload(a scan runs to its end, and
+ *  'compact' does a page at a time) and print the result.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four bench_RunWorkload(
+    char	*workload,	/* IN name of the workload */
+    Four	nOps)		/* IN the number of operations */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Boolean	scan;		/* is the workload a scan? */
+    ObjectID	cursor;		/* position of a scan */
+    struct timespec begin, t0, t1; /* times */
+    bench_Result r;		/* result of the workload */
+    BfM_Stats	bs;		/* buffer manager statistics */
+    BfM_CallerStats sum;	/* ... summed over the callers */
+    Four	nPages;		/* pages of the file */
+    double	counter[EDUOM_NUM_PERF_COUNTERS]; /* hardware counters of the workload */
+    EduOM_CompactorStats cs0, cs1; /* compactor statistics before and after the workload */
+    double	idle;		/* usec taken by the compactor between the operations */
+
+
+    if (strcmp(workload, "kernels") == 0) return(bench_RunKernels());
+
+    scan = (strncmp(workload, "scan", 4) == 0);
+    if (scan) nOps = bench_nLive + 1;
+    if (strcmp(workload, "compact") == 0) {
+        nOps = bench_CountPages();
+        if (nOps < eNOERROR) ERR(nOps);
+    }
+
+    r.latency = (double *)malloc(sizeof(double) * MAX(nOps, 1));
+    if (r.latency == NULL) ERR(eMEMORYALLOCERR);
+
+    cursor.pageNo = NIL;
+    BfM_ResetStats();
+    EduOM_GetCompactorStats(&cs0);
+
+    if (bench_perf) eduom_StartPerfCounters();
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    for (i = 0, e = eNOERROR, idle = 0; i < nOps; i++) {
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        e = bench_RunOp(workload, &cursor);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        if (e != eNOERROR) break;
+        r.latency[i] = BENCH_USEC(t0, t1);
+
+        /* the idle time between two operations */
+        if (bench_compactPages > 0) {
+            e = EduOM_RunCompactor(bench_compactPages);
+            if (e < eNOERROR) break;
+            e = eNOERROR;
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            idle += BENCH_USEC(t1, t0);
+        }
+    }
+    if (bench_perf) eduom_StopPerfCounters(counter);
+    r.elapsed = BENCH_USEC(begin, t1) - idle;
+    r.nOps = i;
+
+    if (e < eNOERROR) {
+        printf("workload=%s ops=%d error=%d\n", workload, r.nOps, e);
+        free(r.latency);
+        ERR(e);
+    }
+
+    qsort(r.latency, r.nOps, sizeof(double), bench_CompareDouble);
+
+    EduOM_GetCompactorStats(&cs1);
+    BfM_GetStats(&bs);
+    memset(&sum, 0, sizeof(sum));
+    for (i = 0; i < BFM_NUM_CALLERS; i++) {
+        sum.gets += bs.caller[i].gets;
+        sum.hits += bs.caller[i].hits;
+        sum.misses += bs.caller[i].misses + bs.caller[i].newTrains;
+        sum.evictions += bs.caller[i].evictions;
+        sum.dirtyWrites += bs.caller[i].dirtyWrites;
+    }
+
+    nPages = bench_CountPages();
+    if (nPages < eNOERROR) {
+        free(r.latency);
+        ERR(nPages);
+    }
+
+    printf("workload=%s ops=%d ops_per_sec=%.0f p50_us=%.2f p99_us=%.2f max_us=%.2f "
+           "live=%d pages=%d bfm_gets=%u bfm_hits=%u bfm_misses=%u bfm_evictions=%u "
+           "bfm_dirtywrites=%u bfm_maxpinned=%d fg_compactions=%u fg_moved=%.0f "
+           "bg_compactions=%u bg_moved=%.0f\n",
+           workload, r.nOps, (r.elapsed > 0) ? r.nOps/(r.elapsed/1e6) : 0.0,
+           (r.nOps > 0) ? r.latency[(Four)(r.nOps*0.50)] : 0.0,
+           (r.nOps > 0) ? r.latency[MIN((Four)(r.nOps*0.99), r.nOps-1)] : 0.0,
+           (r.nOps > 0) ? r.latency[r.nOps-1] : 0.0,
+           bench_nLive, nPages, sum.gets, sum.hits, sum.misses, sum.evictions,
+           sum.dirtyWrites, bs.maxPinned, cs1.foreground - cs0.foreground,
+           cs1.foregroundBytes - cs0.foregroundBytes, cs1.compacted - cs0.compacted,
+           cs1.backgroundBytes - cs0.backgroundBytes);
+    if (bench_perf) bench_PrintCounters(workload, r.nOps, counter);
+    fflush(stdout);
+
+    free(r.latency);
+
+    return(eNOERROR);
+
+} /* bench_RunWorkload() */
+
+
+
+/*@================================
+ * bench_Restart()
+ *================================*/
+/*
+ * Function: Four bench_Restart(char*, Four, char*, Boolean, Four)
+ *
+ * Description:
+ *  Save the trains resident in the buffer pool, dismount the volume, mount
+ *  it again and run the 'read' workload. After a warm restart the saved
+ *  trains are read back before the workload; after a cold one they are not.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four bench_Restart(
+    char	*devName,	/* IN device of the volume */
+    Four	volId,		/* IN volume */
+    char	*hotFile,	/* IN file of the resident trains */
+    Boolean	warm,		/* IN read the saved trains back? */
+    Four	nOps)		/* IN the number of operations */
+{
+    Four	e;		/* error number */
+    Four	loaded;		/* the number of trains read back */
+    XactID	xactId;		/* transaction identifier */
+
+
+    e = BfM_SaveResidentTrains(volId, hotFile);
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_Dismount(volId);
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_Mount(1, &devName, &volId);
+    if (e < eNOERROR) ERR(e);
+
+    /* keep the list recent at the checkpoints of the writer, too */
+    e = BfM_SetWarmStartFile(volId, hotFile);
+    if (e < eNOERROR) ERR(e);
+
+    loaded = 0;
+    if (warm) {
+        loaded = BfM_LoadResidentTrains(volId, hotFile, 0);
+        if (loaded < eNOERROR) ERR(loaded);
+    }
+
+    printf("restart=%s loaded=%d\n", (warm) ? "warm" : "cold", loaded);
+
+    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+    if (e < eNOERROR) ERR(e);
+
+    e = bench_RunWorkload("read", nOps);
+    if (e < eNOERROR) {
+        LRDS_AbortTransaction(&xactId);
+        ERR(e);
+    }
+
+    e = LRDS_CommitTransaction(&xactId);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* bench_Restart() */
+
+
+
+/*@================================
+ * main()
+ *================================*/
+Four main(int argc, char *argv[])
+{
+    Four	e;		/* error number */
+    Four	c;		/* option */
+    Four	handle;		/* system handle */
+    char	*devName = BENCH_DEFAULT_DEVICE;
+    Four	nPages = BENCH_DEFAULT_PAGES;
+    Four	nOps = BENCH_DEFAULT_OPS;
+    char	workloads[512] = BENCH_DEFAULT_WORKLOADS;
+    char	*workload;	/* a workload of the list */
+    Four	volId = BENCH_VOLID;
+    FileID	fid;		/* data file */
+    XactID	xactId;		/* transaction identifier */
+    Four	scanUnit = PAGESIZE; /* bytes a scan reads at a time */
+    char	*layout = "aos";	/* slot directory of the pages */
+    char	*isa = NULL;	/* instruction set of the slot kernels; NULL for the default one */
+    char	*hotFile = NULL;	/* file of the resident trains; NULL for no restart */
+    UFour	seed;		/* seed of the runs after the restarts */
+    Four	perfErr;	/* errno of a hardware counter which could not be opened */
+
+
+    while ((c = getopt(argc, argv, "d:p:n:s:S:r:w:PU:L:I:C:H:")) != -1) {
+        switch (c) {
+          case 'd': devName = optarg; break;
+          case 'p': nPages = atoi(optarg); break;
+          case 'n': nOps = atoi(optarg); break;
+          case 's': bench_minSize = atoi(optarg); break;
+          case 'S': bench_maxSize = atoi(optarg); break;
+          case 'r': bench_seed = (UFour)atol(optarg); break;
+          case 'w': strncpy(workloads, optarg, sizeof(workloads)-1); break;
+          case 'P': bench_perf = TRUE; break;
+          case 'U': scanUnit = atoi(optarg); break;
+          case 'L': layout = optarg; break;
+          case 'I': isa = optarg; break;
+          case 'C': bench_compactPages = atoi(optarg); break;
+          case 'H': hotFile = optarg; break;
+          default:
+            fprintf(stderr, "usage: %s [-d device] [-p pages] [-n ops] [-s minSize] [-S maxSize] "
+                    "[-r seed] [-w workload,...] [-P] [-U scanUnit] [-L aos|soa] "
+                    "[-I scalar|sse2|avx2] [-C compactPages] [-H hotFile]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    if (bench_minSize < 0 || bench_maxSize < bench_minSize ||
+        ALIGNED_LENGTH(bench_maxSize) > LRGOBJ_THRESHOLD || nPages <= 0 || nOps < 0 ||
+        bench_compactPages < 0) {
+        fprintf(stderr, "%s: bad object sizes, pages, operations or compact pages\n", argv[0]);
+        exit(1);
+    }
+    if (strcmp(layout, "aos") != 0 && strcmp(layout, "soa") != 0) {
+        fprintf(stderr, "%s: bad layout %s\n", argv[0], layout);
+        exit(1);
+    }
+    if (isa != NULL) {
+        for (c = 0; c < EDUOM_NUM_ISAS && strcmp(isa, eduom_SlotKernelName(c)) != 0; c++);
+        if (c == EDUOM_NUM_ISAS || eduom_SelectSlotKernels(c) < eNOERROR) {
+            fprintf(stderr, "%s: bad or unsupported instruction set %s\n", argv[0], isa);
+            exit(1);
+        }
+    }
+    if (bench_seed == 0) bench_seed = 1;
+    memset(bench_data, 'x', sizeof(bench_data));
+    if (bench_perf && eduom_OpenPerfCounters(&perfErr) == 0)
+        printf("perf=unavailable reason=\"%s\"\n", strerror(perfErr));
+
+    e = LRDS_Init();
+    if (e < eNOERROR) {
+        printf("LRDS_Init failed!!!\n");
+        exit(1);
+    }
+
+    e = LRDS_AllocHandle(&handle);
+    if (e < eNOERROR) {
+        printf("LRDS_AllocHandle failed!!!\n");
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_FormatDataVolume(1, &devName, "bench", volId, 16, &nPages, 16);
+    if (e < eNOERROR) {
+        printf("LRDS_FormatDataVolume failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_Mount(1, &devName, &volId);
+    if (e < eNOERROR) {
+        printf("LRDS_Mount failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = EduOM_SetScanUnit(volId, scanUnit);
+    if (e < eNOERROR) {
+        printf("EduOM_SetScanUnit failed!!!\n");
+        LRDS_Dismount(volId);
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+    if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &bench_catalogEntry);
+    if (e >= eNOERROR && strcmp(layout, "soa") == 0) e = EduOM_SetSoaSlots(&bench_catalogEntry);
+
+    printf("device=%s pages=%d ops=%d min_size=%d max_size=%d seed=%u scan_unit=%d layout=%s isa=%s\n",
+           devName, nPages, nOps, bench_minSize, bench_maxSize, bench_seed, scanUnit, layout,
+           eduom_SlotKernelName(eduom_GetSlotKernels()));
+
+    for (workload = strtok(workloads, ","); e >= eNOERROR && workload != NULL; workload = strtok(NULL, ","))
+        e = bench_RunWorkload(workload, nOps);
+
+    /* publish the free space of the active insert pages before the commit */
+    if (e >= eNOERROR) e = EduOM_ReleaseActiveInsertPages();
+
+    if (e < eNOERROR) {
+        printf("EduOM_Bench failed!!!\n");
+        LRDS_AbortTransaction(&xactId);
+    }
+    else
+        e = LRDS_CommitTransaction(&xactId);
+
+    /* the same reads after a cold and after a warm restart */
+    if (e >= eNOERROR && hotFile != NULL) {
+        seed = bench_seed;
+        e = bench_Restart(devName, volId, hotFile, FALSE, nOps);
+
+        bench_seed = seed;
+        if (e >= eNOERROR) e = bench_Restart(devName, volId, hotFile, TRUE, nOps);
+
+        if (e >= eNOERROR) e = BfM_SaveResidentTrains(volId, hotFile);
+        if (e < eNOERROR) printf("EduOM_Bench restart failed!!!\n");
+    }
+
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+
+    free(bench_live);
+
+    return((e < eNOERROR) ? 1 : 0);
+
+} /* main() */
@@ -28,20 +28,53 @@
  * Description : 
  *  EduOM_CompactPage() reorganizes the page to make sure the unused bytes
  *  in the page are located contiguously "in the middle", between the tuples
- *  and the slot array. 
+ *  and the slot array. The dictionary of a prefix page(see
+ *  EduOM_PrefixPage.c) stays at the beginning of the data area, and a SoA
+ *  page(see EduOM_SoaPage.c) is compacted in place.
+ *
+ *  EduOM_CompactPageIncrementally() only makes the contiguous free area as
+ *  large as an insert needs: the objects at the end of the data area are
+ *  moved down over the holes among them, and the objects below are left
+ *  where they are. Together with the background compactor(see
+ *  EduOM_Compactor.c), which compacts the pages with many holes between
+ *  the operations, an insert rarely rewrites a whole page.
  *
  * Exports:
  *  Four EduOM_CompactPage(SlottedPage*, Two)
+ *  Four EduOM_CompactPageIncrementally(SlottedPage*, Two, Four)
+ *
+ * Internal:
+ *  Four eduom_CompactPageTail(SlottedPage*, Two, Four)
  */
 
 
 #include <string.h>
 #include "EduOM_common.h"
+#include "BfM.h"		/* for the buffer manager call */
 #include "LOT.h"
 #include "EduOM_Internal.h"
 
 
 
+/*@
+ * Constant Definitions
+ */
+/* the most slots a page can have: every slot empty but the last one */
+#define EDUOM_MAX_SLOTS     ((PAGESIZE - SP_FIXED) / sizeof(SlottedPageSlot) + 1)
+
+
+/* Macro: EDUOM_OBJECT_SPACE(p, offset)
+ * Description: return the bytes the object takes in the data area
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Four offset         : offset of the object
+ * Returns: (Four) length of the object and its header, aligned
+ */
+#define EDUOM_OBJECT_SPACE(p, offset) \
+    ((Four)sizeof(ObjectHdr) + ALIGNED_LENGTH(((Object *)&((p)->data[offset]))->header.length))
+
+
+
 /*@================================
  * EduOM_CompactPage()
  *================================*/
@@ -62,7 +95,8 @@
  *  a. Save the given page into the temporary page
  *  b. FOR each nonempty slot DO
  *	Fill the original page by copying the object from the saved page
- *          to the data area of original page pointed by 'apageDataOffset'
+ *          to the data area of original page pointed by 'apageDataOffset';
+ *          the objects adjacent in the saved page are copied together
  *	Update the slot offset
  *	Get 'apageDataOffet' to point the next moved position
  *     ENDFOR
@@ -72,9 +106,12 @@
  * Returns:
  *  error code
  *    eNOERROR
+ *    some errors caused by function calls
  *
  * Side Effects :
  *  The slotted page is reorganized to comact the space.
+ *  The page must be fixed in the buffer by the caller; its frame version is
+ *  bumped so that optimistic readers retry.
  */
 Four EduOM_CompactPage(
     SlottedPage	*apage,		/* IN slotted page to compact */
@@ -84,62 +121,256 @@ Four EduOM_CompactPage(
     Object *obj;		/* pointer to the object in the data area */
     Two    apageDataOffset;	/* where the next object is to be moved */
     Four   len;			/* length of object + length of ObjectHdr */
-    Two    lastSlot;		/* last non empty slot */
+    Four   runFrom;		/* offset of the adjacent objects not copied yet */
+    Four   runTo;		/* where they are to be copied */
+    Four   runLen;		/* bytes of them */
     Two    i;			/* index variable */
+    Four   e;			/* error number */
+    Four   bytesMoved = 0;	/* bytes of the objects moved(see eduom:compact) */
+
+    EDUOM_STATS_TIMER(EDUOM_API_COMPACT);
+    EDUOM_PROBE_API(EDUOM_API_COMPACT, &apage->header.pid);
 
     // 하나의 slotted page 안에 있는 object가 연속할 수 있게 offset을 재조정
+    // optimistic reader가 수정 중인 page를 읽지 않도록 frame version을 올린다.
+    e = BfM_BeginFrameWrite(&apage->header.pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    // SoA page는 offset 순으로 정렬하여 page 안에서 object를 옮긴다.
+    // 어떤 page도 PAGESIZE만큼의 free area를 가질 수 없으므로 page 전체가 compact된다.
+    if (IS_SOA_PAGE(apage)) {
+        bytesMoved = eduom_CompactPageTail(apage, slotNo, PAGESIZE);
+        EDUOM_PROBE3(eduom, compact, apage->header.pid.volNo, apage->header.pid.pageNo, bytesMoved);
+
+        e = BfM_EndFrameWrite(&apage->header.pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
     // apage 원본을 keep 해놓는다.
     tpage = *apage;
 
-    // 1. slotNo가 NIL(-1)이 아니라면
-    if (slotNo != NIL) {
-        //slotNo에 대응되는 object를 제외한 모든 object들을
-        //앞에서부터 연속되게 저장한다.
-        //printf("HI!\n");
-        apageDataOffset = 0;
-        for (i = 0; i < tpage.header.nSlots; i++) {
-            if (i == slotNo) continue;
-            if (tpage.slot[-i].offset == EMPTYSLOT) continue;
-
-            obj = &(tpage.data[tpage.slot[-i].offset]);
-            len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
-            
-            //object를 복사
-            memcpy(&(apage->data[apageDataOffset]), (char *)obj, len);
-
-            //offset 정보를 slot에 기록, metadata update
-            apage->slot[-i].offset = apageDataOffset;
-            apageDataOffset += len;
+    // slotNo에 대응되는 object를 제외한 모든 object들을 앞에서부터 연속되게 저장한다.
+    // prefix page라면 dictionary 뒤부터 저장한다.
+    // tpage에서 이어져 있던 object들은 한 번에 복사하고(see eduom_MoveDown()),
+    // 자리가 바뀌지 않는 object들은 apage에 그대로 있으므로 복사하지 않는다.
+    apageDataOffset = PREFIX_DICT_SIZE(&tpage);
+    runFrom = runTo = runLen = 0;
+    for (i = 0; i < tpage.header.nSlots; i++) {
+        if (i == slotNo) continue;
+        if (tpage.slot[-i].offset == EMPTYSLOT) continue;
+
+        obj = (Object *)&(tpage.data[tpage.slot[-i].offset]);
+        len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
+
+        //앞의 object와 이어져 있지 않다면 모아 둔 object들을 복사
+        if (tpage.slot[-i].offset != runFrom + runLen) {
+            if (runFrom != runTo) eduom_MoveDown(&(apage->data[runTo]), &(tpage.data[runFrom]), runLen);
+            runFrom = tpage.slot[-i].offset;
+            runTo = apageDataOffset;
+            runLen = 0;
         }
+        runLen += len;
+        if (tpage.slot[-i].offset != apageDataOffset) bytesMoved += len;
+
+        //offset 정보를 slot에 기록, metadata update
+        apage->slot[-i].offset = apageDataOffset;
+        apageDataOffset += len;
+    }
+    if (runFrom != runTo) eduom_MoveDown(&(apage->data[runTo]), &(tpage.data[runFrom]), runLen);
 
-        //slotNo에 대응되는 object는 마지막 object로 저장한다.
-        obj = &(tpage.data[tpage.slot[-slotNo].offset]);
+    //slotNo가 NIL(-1)이 아니라면 slotNo에 대응되는 object는 마지막 object로 저장한다.
+    if (slotNo != NIL) {
+        obj = (Object *)&(tpage.data[tpage.slot[-slotNo].offset]);
         len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
 
+        if (tpage.slot[-slotNo].offset != apageDataOffset) bytesMoved += len;
         memcpy(&(apage->data[apageDataOffset]), (char *)obj, len);
-        apage->slot[slotNo].offset = apageDataOffset;
+        apage->slot[-slotNo].offset = apageDataOffset;
         apageDataOffset += len;
     }
-    // 2. slotNo가 NIL(-1)이라면
-    else {
-        //모든 object들을 앞에서부터 연속되게 저장
-        apageDataOffset = 0;
-        for (i = 0; i<tpage.header.nSlots; i++) {
-            obj = &(tpage.data[tpage.slot[-i].offset]);
-            len = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
-
-            //object를 복사
-            memcpy(&(apage->data[apageDataOffset]), (char *)obj, len);
-
-            //offset 정보를 slot에 기록, metadata update
-            apage->slot[-i].offset = apageDataOffset;
-            apageDataOffset += len;
-        }
-    }
 
     apage->header.unused = 0;
     apage->header.free = apageDataOffset;
+    EDUOM_PROBE3(eduom, compact, apage->header.pid.volNo, apage->header.pid.pageNo, bytesMoved);
+
+    e = BfM_EndFrameWrite(&apage->header.pid, PAGE_BUF);
+    if (e < 0) ERR(e);
 
     return(eNOERROR);
     
-} /* EduOM_CompactPage */
\ No newline at end of file
+} /* EduOM_CompactPage */
+
+
+/*@================================
+ * EduOM_CompactPageIncrementally()
+ *================================*/
+/*
+ * Function: Four EduOM_CompactPageIncrementally(SlottedPage*, Two, Four)
+ *
+ * Description:
+ *  Make the contiguous free area of the page at least 'neededSpace' bytes
+ *  for an insert, moving only the objects at the end of the data area(see
+ *  eduom_CompactPageTail()). The object of 'slotNo' is put at the end as
+ *  EduOM_CompactPage() does, so that the new object follows it.
+ *
+ * Returns:
+ *  error code
+ *    eNOERROR
+ *    some errors caused by function calls
+ *
+ * Side Effects:
+ *  The page must be fixed in the buffer by the caller; its frame version is
+ *  bumped so that optimistic readers retry.
+ */
+Four EduOM_CompactPageIncrementally(
+    SlottedPage	*apage,		/* IN slotted page to compact */
+    Two		slotNo,		/* IN slotNo to go to the end; NIL if none */
+    Four	neededSpace)	/* IN bytes of contiguous free area needed */
+{
+    Four	e;		/* error number */
+    Four	bytesMoved;	/* bytes of the objects moved(see eduom:compact) */
+
+    EDUOM_STATS_TIMER(EDUOM_API_COMPACT);
+    EDUOM_PROBE_API(EDUOM_API_COMPACT, &apage->header.pid);
+
+
+    e = BfM_BeginFrameWrite(&apage->header.pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    bytesMoved = eduom_CompactPageTail(apage, slotNo, neededSpace);
+    EDUOM_PROBE3(eduom, compact, apage->header.pid.volNo, apage->header.pid.pageNo, bytesMoved);
+    eduom_CountCompaction(FALSE, bytesMoved);
+
+    e = BfM_EndFrameWrite(&apage->header.pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_CompactPageIncrementally() */
+
+
+
+/*@================================
+ * eduom_CompactPageTail()
+ *================================*/
+/*
+ * Function: Four eduom_CompactPageTail(SlottedPage*, Two, Four)
+ *
+ * Description:
+ *  Compact the end of the data area of the page in place until the
+ *  contiguous free area is 'neededSpace' bytes. The live slots are sorted
+ *  by their offsets, and the fewest objects at the end whose holes add up
+ *  to the bytes missing, together with the objects below them which are not
+ *  larger than the hole under each, are moved down over the holes, the
+ *  objects which stay adjacent with one copy(see eduom_MoveDown()); the
+ *  object of 'slotNo' is saved first and put at the end, so the objects
+ *  above it are moved in any case. If the holes of the page are not enough,
+ *  the whole page is compacted.
+ *
+ * Returns:
+ *  bytes of the objects moved
+ */
+Four eduom_CompactPageTail(
+    SlottedPage	*apage,		/* INOUT page to compact; in a frame write */
+    Two		slotNo,		/* IN slot whose object goes to the end; NIL if none */
+    Four	neededSpace)	/* IN bytes of contiguous free area needed */
+{
+    Four	i, j;		/* index variables */
+    Four	n;		/* live slots sorted */
+    Four	k;		/* the objects from order[k] on are moved */
+    UFour	order[EDUOM_MAX_SLOTS]; /* offset << 16 | slot number of the live slots, sorted */
+    UFour	key;		/* an entry of 'order' */
+    Four	from;		/* offset of an object */
+    Four	len;		/* length of an object with its header */
+    Four	base;		/* where the objects moved begin */
+    Four	live;		/* bytes of the objects moved and of the object of 'slotNo' */
+    Four	missing;	/* bytes the contiguous free area lacks */
+    Four	runFrom;	/* offset of the adjacent objects not moved yet */
+    Four	runTo;		/* where they are to be moved */
+    Four	runLen;		/* bytes of them */
+    Four	dataOffset;	/* where the next object is to be moved */
+    Four	lastOffset;	/* offset of the object of 'slotNo' */
+    Four	lastLen;	/* length of the object of 'slotNo' with its header */
+    Four	bytesMoved;	/* bytes of the objects moved */
+    char	last[PAGESIZE];	/* the object of 'slotNo' */
+
+
+    if (slotNo != NIL && (slotNo >= apage->header.nSlots || SLOT_OFFSET(apage, slotNo) == EMPTYSLOT))
+        slotNo = NIL;
+
+    /* a page has tens of live slots, mostly in order, so an insertion sort does */
+    for (i = 0, n = 0; i < apage->header.nSlots; i++) {
+        if (SLOT_OFFSET(apage, i) == EMPTYSLOT || i == slotNo) continue;
+
+        key = (UFour)SLOT_OFFSET(apage, i) << 16 | i;
+        for (j = n; j > 0 && order[j-1] > key; j--) order[j] = order[j-1];
+        order[j] = key;
+        n++;
+    }
+
+    lastOffset = lastLen = 0;
+    if (slotNo != NIL) {
+        lastOffset = SLOT_OFFSET(apage, slotNo);
+        lastLen = EDUOM_OBJECT_SPACE(apage, lastOffset);
+        memcpy(last, &(apage->data[lastOffset]), lastLen);
+    }
+
+    /* the objects from order[k] on are moved to the end of order[k-1]; the
+       holes between them are 'free' - 'base' - 'live' bytes */
+    missing = neededSpace - SP_CFREE(apage);
+    for (k = n, live = lastLen; k > 0; k--) {
+        from = order[k-1] >> 16;
+        base = from + EDUOM_OBJECT_SPACE(apage, from);
+
+        if ((slotNo == NIL || base <= lastOffset) && apage->header.free - base - live >= missing) break;
+        live += EDUOM_OBJECT_SPACE(apage, from);
+    }
+
+    /* moving one more object pays if the hole below it is as large as the
+       object, so that the next inserts do not compact the page again soon */
+    for ( ; k > 0; k--) {
+        from = order[k-1] >> 16;
+        len = EDUOM_OBJECT_SPACE(apage, from);
+        base = (k > 1) ? (order[k-2] >> 16) + EDUOM_OBJECT_SPACE(apage, order[k-2] >> 16) : PREFIX_DICT_SIZE(apage);
+
+        if (from - base < len) break;
+    }
+    base = (k > 0) ? (order[k-1] >> 16) + EDUOM_OBJECT_SPACE(apage, order[k-1] >> 16) : PREFIX_DICT_SIZE(apage);
+
+    for (i = k, dataOffset = base, bytesMoved = 0, runFrom = runTo = runLen = 0; i < n; i++) {
+        from = order[i] >> 16;
+        len = EDUOM_OBJECT_SPACE(apage, from);
+
+        if (from != runFrom + runLen) {
+            eduom_MoveDown(&(apage->data[runTo]), &(apage->data[runFrom]), runLen);
+            runFrom = from;
+            runTo = dataOffset;
+            runLen = 0;
+        }
+        runLen += len;
+
+        if (from != dataOffset) {
+            SLOT_OFFSET(apage, (Four)(order[i] & 0xffff)) = dataOffset;
+            bytesMoved += len;
+        }
+        dataOffset += len;
+    }
+    eduom_MoveDown(&(apage->data[runTo]), &(apage->data[runFrom]), runLen);
+
+    if (slotNo != NIL) {
+        if (lastOffset != dataOffset) bytesMoved += lastLen;
+        memcpy(&(apage->data[dataOffset]), last, lastLen);
+        SLOT_OFFSET(apage, slotNo) = dataOffset;
+        dataOffset += lastLen;
+    }
+
+    /* the holes below 'base' stay */
+    if (k == 0) apage->header.unused = 0;
+    else apage->header.unused = MAX(apage->header.unused - (apage->header.free - dataOffset), 0);
+    apage->header.free = dataOffset;
+
+    return(bytesMoved);
+
+} /* eduom_CompactPageTail() */
@@ -0,0 +1,488 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Compactor.c
+ *
+ * Description:
+ *  Compact the pages with many holes during idle time so that an insert
+ *  rarely has to compact a page before it puts the new object.
+ *
+ *  EduOM_DestroyObject() queues a page when the bytes of the holes of the
+ *  page('unused') reach the threshold, and EduOM_RunCompactor() compacts the
+ *  queued pages entirely. A page whose holes went below the threshold in the
+ *  meantime(see EduOM_CompactPageIncrementally()), or which was destroyed or
+ *  given to another file, is skipped. The queue is a ring of a fixed size;
+ *  a page not queued as the ring is full is queued again when more of its
+ *  objects are destroyed after it is compacted by an insert.
+ *
+ *  The queue is fed only by the destroys of this process and drops pages
+ *  when it is full, so EduOM_SweepCompactor() walks the pages of a file and
+ *  compacts those whose holes reach the threshold wherever they came from:
+ *  the pages dropped, and those left by another process or before the
+ *  volume was mounted. A sweep resumes where the last sweep of the file
+ *  stopped.
+ *
+ *  The buffer manager and the raw disk manager in cosmos.o are not thread
+ *  safe, so the compactor does not run on a thread of its own. It runs when
+ *  an application calls EduOM_RunCompactor() from its idle loop, and it is
+ *  called as any other operation of the object manager.
+ *
+ * Exports:
+ *  Four EduOM_SetCompactorParams(EduOM_CompactorParams*)
+ *  Four EduOM_GetCompactorParams(EduOM_CompactorParams*)
+ *  Four EduOM_GetCompactorStats(EduOM_CompactorStats*)
+ *  Four EduOM_RunCompactor(Four)
+ *  Four EduOM_SweepCompactor(ObjectID*, Four)
+ *
+ * Internal:
+ *  void eduom_QueueCompaction(SlottedPage*, Four)
+ *  void eduom_CountCompaction(Boolean, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_COMPACT_QUEUE_SIZE    256     /* pages the queue can hold */
+
+
+
+/*@
+ * Type Definitions
+ */
+/* a page queued for the compactor */
+typedef struct {
+    PageID	pid;		/* page to compact */
+    FileID	fid;		/* file of the page when it was queued */
+} eduom_CompactEntry;
+
+
+/*@
+ * Global Variables
+ */
+static EduOM_CompactorParams eduom_compactorParams = {
+    EDUOM_DEFAULT_COMPACT_THRESHOLD,
+    EDUOM_DEFAULT_COMPACT_PAGES
+};
+static EduOM_CompactorStats eduom_compactorStats;
+
+/* ring of the queued pages; 'eduom_compactHead' is the oldest */
+static eduom_CompactEntry eduom_compactQueue[EDUOM_COMPACT_QUEUE_SIZE];
+static Four eduom_compactHead = 0;
+static Four eduom_compactCount = 0;
+
+/* page the next sweep of the file starts at; NIL to start at the first page */
+static FileID eduom_sweepFid;
+static PageNo eduom_sweepPage = NIL;
+
+
+
+/* Macro: EDUOM_COMPACTION_DUE(p)
+ * Description: tell whether the holes of the page reach the threshold. The
+ *              PAX, fixed length record, and small object pages keep no
+ *              holes of slotted objects and are never compacted. A prefix
+ *              page is compacted as any slotted page: eduom_CompactPageTail()
+ *              moves the objects down to the end of the dictionary, which
+ *              stays at the beginning of the data area(see PREFIX_DICT_SIZE()),
+ *              and moves a P_PREFIXED object byte for byte, so the prefix it
+ *              shares with the dictionary stays valid.
+ * Returns: TRUE or FALSE
+ */
+#define EDUOM_COMPACTION_DUE(p) \
+    (((p)->header.flags & PAGE_TYPE_VECTOR_MASK) == SLOTTED_PAGE_TYPE && \
+     (p)->header.nSlots > 0 && \
+     !IS_PAX_PAGE(p) && !IS_FIXED_PAGE(p) && !IS_SMALL_PAGE(p) && \
+     (p)->header.unused > 0 && (p)->header.unused >= eduom_compactorParams.threshold)
+
+
+
+static Four eduom_CompactWholePage(PageID*, SlottedPage*);
+
+
+
+/*@================================
+ * EduOM_SetCompactorParams()
+ *================================*/
+/*
+ * Function: Four EduOM_SetCompactorParams(EduOM_CompactorParams*)
+ *
+ * Description:
+ *  Set the tunables of the compactor. A threshold of 0 disables the
+ *  compactor; the pages queued already are still compacted by the runs.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduOM_SetCompactorParams(
+    EduOM_CompactorParams *params)	/* IN new tunables */
+{
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    if (params->threshold < 0 || params->threshold > PAGESIZE ||
+        params->pagesPerRun < 0) ERR(eBADPARAMETER);
+
+    eduom_compactorParams = *params;
+
+    return(eNOERROR);
+
+} /* EduOM_SetCompactorParams() */
+
+
+
+/*@================================
+ * EduOM_GetCompactorParams()
+ *================================*/
+/*
+ * Function: Four EduOM_GetCompactorParams(EduOM_CompactorParams*)
+ *
+ * Description:
+ *  Get the tunables of the compactor.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduOM_GetCompactorParams(
+    EduOM_CompactorParams *params)	/* OUT current tunables */
+{
+    if (params == NULL) ERR(eBADPARAMETER);
+
+    *params = eduom_compactorParams;
+
+    return(eNOERROR);
+
+} /* EduOM_GetCompactorParams() */
+
+
+
+/*@================================
+ * EduOM_GetCompactorStats()
+ *================================*/
+/*
+ * Function: Four EduOM_GetCompactorStats(EduOM_CompactorStats*)
+ *
+ * Description:
+ *  Get the counters of the compactor and of the compactions done by the
+ *  inserts.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduOM_GetCompactorStats(
+    EduOM_CompactorStats *stats)	/* OUT counters */
+{
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    *stats = eduom_compactorStats;
+
+    return(eNOERROR);
+
+} /* EduOM_GetCompactorStats() */
+
+
+
+/*@================================
+ * EduOM_RunCompactor()
+ *================================*/
+/*
+ * Function: Four EduOM_RunCompactor(Four)
+ *
+ * Description:
+ *  Compact up to 'maxPages' queued pages, the oldest first; NIL compacts
+ *  'pagesPerRun' pages. The pages checked and skipped do not count.
+ *
+ * Returns:
+ *  the number of pages compacted if no error
+ *  error code
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four EduOM_RunCompactor(
+    Four	maxPages)	/* IN maximum number of pages to compact; NIL for 'pagesPerRun' */
+{
+    Four	e;		/* error number */
+    Four	n;		/* pages compacted */
+    eduom_CompactEntry entry;	/* page dequeued */
+    SlottedPage	*apage;		/* pointer to the buffer holding the page */
+
+
+    if (maxPages == NIL) maxPages = eduom_compactorParams.pagesPerRun;
+    if (maxPages < 0) ERR(eBADPARAMETER);
+
+    eduom_compactorStats.runs++;
+
+    for (n = 0; n < maxPages && eduom_compactCount > 0; ) {
+        entry = eduom_compactQueue[eduom_compactHead];
+        eduom_compactHead = (eduom_compactHead + 1) % EDUOM_COMPACT_QUEUE_SIZE;
+        eduom_compactCount--;
+
+        e = BfM_GetTrain((TrainID *)&entry.pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        /* the page may have been compacted, deallocated, or given to another file;
+           a prefix page is not skipped(see EDUOM_COMPACTION_DUE()) */
+        if (!EQUAL_PAGEID(apage->header.pid, entry.pid) ||
+            !EQUAL_FILEID(apage->header.fid, entry.fid) ||
+            !EDUOM_COMPACTION_DUE(apage)) {
+            eduom_compactorStats.skipped++;
+
+            e = BfM_FreeTrain((TrainID *)&entry.pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            continue;
+        }
+
+        e = eduom_CompactWholePage(&entry.pid, apage);
+        if (e < 0) ERR(e);
+
+        n++;
+    }
+
+    return(n);
+
+} /* EduOM_RunCompactor() */
+
+
+
+/*@================================
+ * EduOM_SweepCompactor()
+ *================================*/
+/*
+ * Function: Four EduOM_SweepCompactor(ObjectID*, Four)
+ *
+ * Description:
+ *  Walk the pages of the file and compact up to 'maxPages' pages whose
+ *  holes reach the threshold, whether they are queued or not; NIL compacts
+ *  'pagesPerRun' pages. The walk starts where the last sweep of the file
+ *  stopped, and at the first page after it reached the end of the file or
+ *  swept another file. A sweep which compacts no page has walked the rest
+ *  of the file.
+ *
+ * Returns:
+ *  the number of pages compacted if no error
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four EduOM_SweepCompactor(
+    ObjectID	*catObjForFile,	/* IN catalog object of the file */
+    Four	maxPages)	/* IN maximum number of pages to compact; NIL for 'pagesPerRun' */
+{
+    Four	e;		/* error number */
+    Four	n;		/* pages compacted */
+    FileID	fid;		/* the file */
+    PageID	pid;		/* a page of the file */
+    PageNo	firstPage;	/* first page of the file */
+    PageNo	nextPage;	/* page after the page swept */
+    SlottedPage	*apage;		/* pointer to the buffer holding the page */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (maxPages == NIL) maxPages = eduom_compactorParams.pagesPerRun;
+    if (maxPages < 0) ERR(eBADPARAMETER);
+
+    if (eduom_compactorParams.threshold == 0) return(0);
+
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    fid = catEntry->fid;
+    firstPage = catEntry->firstPage;
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    eduom_compactorStats.sweeps++;
+
+    /* the page the last sweep stopped at may have been deallocated since */
+    MAKE_PAGEID(pid, fid.volNo, firstPage);
+    if (EQUAL_FILEID(eduom_sweepFid, fid) && eduom_sweepPage != NIL) {
+        pid.pageNo = eduom_sweepPage;
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        if (!EQUAL_PAGEID(apage->header.pid, pid) || !EQUAL_FILEID(apage->header.fid, fid))
+            pid.pageNo = firstPage;
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+    }
+
+    for (n = 0; n < maxPages && pid.pageNo != NIL; pid.pageNo = nextPage) {
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        eduom_compactorStats.swept++;
+        nextPage = apage->header.nextPage;
+
+        if (!EDUOM_COMPACTION_DUE(apage)) {
+            e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            continue;
+        }
+
+        e = eduom_CompactWholePage(&pid, apage);
+        if (e < 0) ERR(e);
+
+        n++;
+    }
+
+    eduom_sweepFid = fid;
+    eduom_sweepPage = pid.pageNo;
+
+    return(n);
+
+} /* EduOM_SweepCompactor() */
+
+
+
+/*@================================
+ * eduom_CompactWholePage()
+ *================================*/
+/*
+ * Function: Four eduom_CompactWholePage(PageID*, SlottedPage*)
+ *
+ * Description:
+ *  Compact the fixed page entirely and free it.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four eduom_CompactWholePage(
+    PageID	*pid,		/* IN page to compact */
+    SlottedPage	*apage)		/* IN pointer to the buffer holding the page */
+{
+    Four	e;		/* error number */
+    Four	bytesMoved;	/* bytes of the objects moved by the compaction */
+
+
+    /* the whole page is compacted in place, as a SoA page is(see eduom_CompactPageTail()) */
+    e = BfM_BeginFrameWrite(pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    bytesMoved = eduom_CompactPageTail(apage, NIL, PAGESIZE);
+    EDUOM_PROBE3(eduom, compact, pid->volNo, pid->pageNo, bytesMoved);
+    eduom_CountCompaction(TRUE, bytesMoved);
+
+    e = BfM_EndFrameWrite(pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_CompactWholePage() */
+
+
+
+/*@================================
+ * eduom_QueueCompaction()
+ *================================*/
+/*
+ * Function: void eduom_QueueCompaction(SlottedPage*, Four)
+ *
+ * Description:
+ *  Queue the page for the compactor if its 'unused' has just reached the
+ *  threshold, i.e. 'unusedBefore' was below it; a page stays queued once.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_QueueCompaction(
+    SlottedPage	*apage,		/* IN page an object was destroyed in */
+    Four	unusedBefore)	/* IN 'unused' of the page before the object was destroyed */
+{
+    eduom_CompactEntry *entry;	/* entry of the queue */
+
+
+    if (eduom_compactorParams.threshold == 0) return;
+
+    if (apage->header.unused < eduom_compactorParams.threshold ||
+        unusedBefore >= eduom_compactorParams.threshold) return;
+
+    if (eduom_compactCount == EDUOM_COMPACT_QUEUE_SIZE) {
+        eduom_compactorStats.dropped++;
+        return;
+    }
+
+    entry = &eduom_compactQueue[(eduom_compactHead + eduom_compactCount) % EDUOM_COMPACT_QUEUE_SIZE];
+    entry->pid = apage->header.pid;
+    entry->fid = apage->header.fid;
+    eduom_compactCount++;
+
+    eduom_compactorStats.queued++;
+
+} /* eduom_QueueCompaction() */
+
+
+
+/*@================================
+ * eduom_CountCompaction()
+ *================================*/
+/*
+ * Function: void eduom_CountCompaction(Boolean, Four)
+ *
+ * Description:
+ *  Count a compaction done by the compactor or by an insert(see
+ *  EduOM_CompactPageIncrementally()).
+ *
+ * Returns:
+ *  None
+ */
+void eduom_CountCompaction(
+    Boolean	background,	/* IN done by the compactor? */
+    Four	bytesMoved)	/* IN bytes of the objects moved */
+{
+    if (background) {
+        eduom_compactorStats.compacted++;
+        eduom_compactorStats.backgroundBytes += bytesMoved;
+    }
+    else {
+        eduom_compactorStats.foreground++;
+        eduom_compactorStats.foregroundBytes += bytesMoved;
+    }
+
+} /* eduom_CountCompaction() */
@@ -0,0 +1,89 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_CompressedPage.c
+ *
+ * Description:
+ *  Compressed pages of a data file. The pages are compressed by the raw disk
+ *  manager as they are written back(see RDsM_Compression.c); the object
+ *  manager and the buffer pool see them uncompressed, so every kind of page
+ *  of the file can be compressed.
+ *
+ * Exports:
+ *  Four EduOM_SetCompressedPages(ObjectID*, Boolean)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_SetCompressedPages()
+ *================================*/
+/*
+ * Function: Four EduOM_SetCompressedPages(ObjectID*, Boolean)
+ *
+ * Description:
+ *  Make the pages of the file be stored compressed(or uncompressed) from
+ *  their next write on. Unlike the page layouts, which are derived from
+ *  the first page of the file, the setting is made again after the volume
+ *  is mounted by another process; pages stored compressed are read back
+ *  either way.
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetCompressedPages(
+    ObjectID	*catObjForFile,	/* IN file */
+    Boolean	onOff)		/* IN TRUE to store the pages compressed */
+{
+    Four	e;		/* error number */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    e = RDsM_SetCompressedFile(&catEntry->fid, onOff);
+    if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetCompressedPages() */
@@ -89,7 +89,6 @@ Four EduOM_CreateObject(
     char      *data,		/* IN the initial data for the object */
     ObjectID  *oid)		/* OUT the object's ObjectID */
 {
-    Four        e;		/* error number */
     ObjectHdr   objectHdr;	/* ObjectHdr with tag set from parameter */
 
 
@@ -109,11 +108,16 @@ Four EduOM_CreateObject(
     eduom_CreateObject() 내부함수를 활용해 page에 object를 삽입한다.
     */
 
+    // buffer manager 통계를 생성 연산으로 집계한다.
+    BfM_SetCaller(BFM_CALLER_CREATE);
+    EDUOM_STATS_TIMER(EDUOM_API_CREATE);
+    EDUOM_PROBE_API(EDUOM_API_CREATE, catObjForFile);
+
     // 1. Header initialization
     objectHdr.properties = 0x0;
     objectHdr.length = 0;
     if (objHdr != NULL)
-        objectHdr.tag = objHdr;
+        objectHdr.tag = objHdr->tag;
     else 
         objectHdr.tag = 0;
 
@@ -145,6 +149,10 @@ Four EduOM_CreateObject(
  *  fail, then the new object will be put into the newly allocated page(In this
  *  case, the newly allocated page is appended at the tail of the list of pages
  *  cosisting in the file).
+ *  The page chosen for the near object NULL case becomes the active insert page
+ *  of the calling thread; following objects created by the thread without a
+ *  near object go into that page until it fills up, and the page is kept out of
+ *  the available space list meanwhile (see EduOM_ActiveInsertPage.c).
  *
  * Returns:
  *  error Code
@@ -164,7 +172,6 @@ Four eduom_CreateObject(
     Four	neededSpace;	/* space needed to put new object [+ header] */
     SlottedPage *apage;		/* pointer to the slotted page buffer */
     Four        alignedLen;	/* aligned length of initial data */
-    Boolean     needToAllocPage;/* Is there a need to alloc a new page? */
     PageID      pid;            /* PageID in which new object to be inserted */
     PageID      nearPid;
     Four        firstExt;	/* first Extent No of the file */
@@ -172,10 +179,14 @@ Four eduom_CreateObject(
     Two         i;		/* index variable */
     sm_CatOverlayForData *catEntry; /* pointer to data file catalog information */
     SlottedPage *catPage;	/* podinter to buffer containing the catalog */
-    FileID      fid;		/* ID of file where the new object is placed */
-    Two         eff;		/* extent fill factor of file */
-    Boolean     isTmp;
     PhysicalFileID pFid;
+    Boolean     ownedPage;	/* Is the page an active insert page of this thread? */
+    Four        owner;		/* owner of the near page as an active insert page */
+    eduom_FileLayout layout;	/* layout of the pages of the file */
+    Boolean     prefixFile;	/* Is the file given prefix pages? */
+    Four        prefixLength;	/* length of the prefix taken from the dictionary of the page */
+    Boolean     soaFile;	/* Is the file given SoA slots? */
+    Unique      unique;		/* unique number of the new object */
     
     
     /*@ parameter checking */
@@ -198,7 +209,60 @@ Four eduom_CreateObject(
     // -> catEntry까지 설정
     GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
 
-    fid = catEntry->fid;
+    // file의 layout은 첫 page의 표시로부터 얻는다(see EduOM_FileLayout.c).
+    e = eduom_LookUpFileLayout(catEntry, &layout);
+    if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+    // PAX layout의 file이라면 row를 PAX page에 삽입한다(see EduOM_PaxPage.c).
+    if (layout.layout == EDUOM_PAX_LAYOUT) {
+        e = eduom_CreatePaxObject(catObjForFile, catEntry, &layout.schema, nearObj, length, data, oid);
+        if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+        e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = BfM_PollWriter();
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    // fixed length record file이라면 record를 record array에 삽입한다(see EduOM_FixedPage.c).
+    if (layout.layout == EDUOM_FIXED_LAYOUT) {
+        e = eduom_CreateFixedObject(catObjForFile, catEntry, layout.recordLength, nearObj, length, data, oid);
+        if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+        e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = BfM_PollWriter();
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    // small object page를 쓰는 file이라면 작은 object는 small object page에 삽입한다(see EduOM_SmallPage.c).
+    if (layout.layout == EDUOM_SMALL_LAYOUT && length <= EDUOM_SMALL_MAX_LENGTH) {
+        e = eduom_CreateSmallObject(catObjForFile, catEntry, &layout.insertPage, nearObj, objHdr, length, data, oid);
+        if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+        eduom_SetSmallInsertPage(&catEntry->fid, layout.insertPage);
+
+        e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        e = BfM_PollWriter();
+        if (e < 0) ERR(e);
+
+        return(eNOERROR);
+    }
+
+    // prefix page를 쓰는 file이라면 새 page에 dictionary를 두고 object의 prefix를 압축한다(see EduOM_PrefixPage.c).
+    prefixFile = (layout.layout == EDUOM_PREFIX_LAYOUT);
+
+    // SoA slot을 쓰는 file이라면 새 page의 slot directory를 offset 배열과 unique 배열로 나눈다(see EduOM_SoaPage.c).
+    soaFile = (layout.layout == EDUOM_SOA_LAYOUT);
+
     MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 
     // pFid - manual p44
@@ -211,30 +275,46 @@ Four eduom_CreateObject(
     neededSpace = sizeof(ObjectHdr) + alignedLen + sizeof(SlottedPageSlot);
 
     // 2. page 선정
+    ownedPage = FALSE;
+
     // 2-1. nearObj가 NULL이 아닌 경우
     if (nearObj != NULL) {
         MAKE_PAGEID(nearPid, nearObj->volNo, nearObj->pageNo);
-        BfM_GetTrain((TrainID *)&nearPid, (char **)&apage, PAGE_BUF);
+        e = BfM_GetTrain((TrainID *)&nearPid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        // 다른 thread의 active insert page에는 삽입하지 않는다.
+        owner = eduom_GetActiveInsertPageOwner(&nearPid);
 
         // a. nearObj가 저장된 page에 충분한 여유 공간이 있는 경우
         // available space list에서 삭제 후 object를 삽입
-        if (SP_FREE(apage) >= neededSpace) {
+        if (owner != ACTIVE_INSERT_PAGE_OTHERS && SP_FREE(apage) >= eduom_NeededSpace(apage, length, data)) {
             pid = nearPid;
-            om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-
-            // compaction이 필요할 경우 compaction을 수행
-            if (SP_CFREE(apage) < neededSpace) {
-                EduOM_CompactPage(apage, nearObj->slotNo);
+            EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEAR_PAGE);
+            EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEAR_PAGE, pid.volNo, pid.pageNo);
+
+            // 자신의 active insert page는 available space list에 없으므로 계속 소유한다.
+            if (owner == ACTIVE_INSERT_PAGE_SELF) ownedPage = TRUE;
+            else om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+
+            // compaction이 필요할 경우 필요한 만큼만 compaction을 수행
+            // nearObj는 마지막 object로 옮겨지므로 새 object가 바로 뒤에 놓인다.
+            if (SP_CFREE(apage) < eduom_NeededSpace(apage, length, data)) {
+                EDUOM_STATS_BRANCH(EDUOM_BRANCH_COMPACTION);
+                e = EduOM_CompactPageIncrementally(apage, nearObj->slotNo, eduom_NeededSpace(apage, length, data));
+                if (e < 0) ERRB1(e, &pid, PAGE_BUF);
             }
         }
         // b. nearObj가 저장된 page에 충분한 여유 공간이 없는 경우
         // nearObj가 저장된 page 옆에 새 page를 할당받아 삽입한다.
         else {
             BfM_FreeTrain((TrainID *)&nearPid, PAGE_BUF);
+            EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEW_PAGE);
             // page 47
             // 새로운 page 하나를 할당하고, ID를 pid에 저장한다.
             e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
             if (e < 0) ERR(e);
+            EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEW_PAGE, pid.volNo, pid.pageNo);
         
             // page 51
             // disk에 새로 할당된 page를 fix하고, 포인터를 apage에 담아 반환한다.
@@ -242,102 +322,206 @@ Four eduom_CreateObject(
             if (e < 0) ERR(e);
 
             // header 초기화
+            // buffer frame에는 이전 page의 내용이 남아 있으므로 header 전체를 초기화한다.
             SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
+            apage->header.reserved = 0;
+            apage->header.pid = pid;
             apage->header.fid = catEntry->fid;
+            apage->header.nSlots = 0;
             apage->header.free = 0;
             apage->header.unused = 0;
+            apage->header.unique = 0;
+            apage->header.uniqueLimit = 0;
+            apage->header.nextPage = NIL;
+            apage->header.prevPage = NIL;
+            apage->header.spaceListPrev = NIL;
+            apage->header.spaceListNext = NIL;
+            if (soaFile) apage->header.reserved = EDUOM_SOA_PAGE;
+            else if (prefixFile) eduom_FormatPrefixPage(apage, length, data);
 
             //nearObj가 저장된 page의 다음 page로 insert한다.
             om_FileMapAddPage(catObjForFile, &nearPid, &pid);
         }
     }
     else { // nearObj == NULL
-        PageNo pageCandidate = NIL;
-        // available한 space들 중 가장 size가 딱 맞는 page를 찾아낸다.
-        if (neededSpace <= SP_50SIZE) pageCandidate = catEntry->availSpaceList50;
-        else if (neededSpace <= SP_40SIZE) pageCandidate = catEntry->availSpaceList40;
-        else if (neededSpace <= SP_30SIZE) pageCandidate = catEntry->availSpaceList30;
-        else if (neededSpace <= SP_20SIZE) pageCandidate = catEntry->availSpaceList20;
-        else pageCandidate = catEntry->availSpaceList10;
-
-        // a. object를 삽입할 공간이 있는 free page를 찾았다.
-        if (pageCandidate != NIL) {
-            // available space list에서 해당 entry를 삭제한다.
-            MAKE_PAGEID(pid, pFid.volNo, pageCandidate);
-            BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-            om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
-
-            // Compaction if neccessary
-            if (SP_CFREE(apage) < neededSpace) {
-                EduOM_CompactPage(apage, nearObj->slotNo);
+        // a. 자신의 active insert page에 공간이 있다면 그 page에 삽입한다.
+        if (eduom_LookUpActiveInsertPage(&catEntry->fid, &pid)) {
+            e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+            if (e < 0) ERR(e);
+
+            if (SP_FREE(apage) >= eduom_NeededSpace(apage, length, data)) {
+                ownedPage = TRUE;
+                EDUOM_STATS_BRANCH(EDUOM_BRANCH_ACTIVE_PAGE);
+                EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_ACTIVE_PAGE, pid.volNo, pid.pageNo);
             }
-        } 
-        // b. avail list에 object를 삽입할 수 있는 page를 찾지 못했다.
-        // 이 경우, file의 last page를 확인한다.
-        else {
-            MAKE_PAGEID(pid, pFid.volNo, catEntry->lastPage);
-            BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+            // 가득 찬 active insert page는 available space list에 돌려준다.
+            else {
+                eduom_DisownActiveInsertPage(&pid);
 
-            // b-1. last page에 object를 삽입할 수 있다.
-            if (SP_FREE(apage) >= neededSpace) {
-                om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+                e = om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+                if (e < 0) ERRB1(e, &pid, PAGE_BUF);
 
-                // compaction이 필요할 경우 compaction을 수행
-                if (SP_CFREE(apage) < neededSpace) {
-                    EduOM_CompactPage(apage, nearObj->slotNo);
-                }
+                e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+                if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+                BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
             }
-            // b-2. last page에 object를 삽입할 수 없어, 새 page를 할당 받아야함.
+        }
+
+        // b. 새로운 active insert page를 선정한다.
+        if (!ownedPage) {
+            PageNo pageCandidate = NIL;
+            PageNo spaceList[5];    // 10%, 20%, ..., 50% list의 첫 page
+            Four   k;
+
+            // 종료된 thread나 process가 반납하지 않은 active insert page를 available space list에 돌려준다.
+            e = eduom_RecoverActiveInsertPages(catObjForFile, &catEntry->fid);
+            if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+            spaceList[0] = catEntry->availSpaceList10;
+            spaceList[1] = catEntry->availSpaceList20;
+            spaceList[2] = catEntry->availSpaceList30;
+            spaceList[3] = catEntry->availSpaceList40;
+            spaceList[4] = catEntry->availSpaceList50;
+
+            // available한 space들 중 가장 size가 딱 맞는 page를 찾아낸다.
+            // list의 page에는 그 list의 비율(SP_10SIZE ~ SP_50SIZE)만큼의 공간이 보장되므로
+            // object가 들어갈 수 있는 가장 작은 list부터 확인하고, 비어 있으면 더 큰 list를 확인한다.
+            // page의 절반(SP_50SIZE)보다 큰 object가 들어갈 공간은 어느 list에도 보장되지 않으므로
+            // NIL로 두고 last page를 확인한다.
+            if (neededSpace <= SP_10SIZE) k = 0;
+            else if (neededSpace <= SP_20SIZE) k = 1;
+            else if (neededSpace <= SP_30SIZE) k = 2;
+            else if (neededSpace <= SP_40SIZE) k = 3;
+            else if (neededSpace <= SP_50SIZE) k = 4;
+            else k = 5;
+
+            for ( ; k < 5 && pageCandidate == NIL; k++) pageCandidate = spaceList[k];
+
+            // b-1. object를 삽입할 공간이 있는 free page를 찾았다.
+            if (pageCandidate != NIL) {
+                // available space list에서 해당 entry를 삭제한다.
+                MAKE_PAGEID(pid, pFid.volNo, pageCandidate);
+                e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+                if (e < 0) ERR(e);
+                om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+                EDUOM_STATS_BRANCH(EDUOM_BRANCH_AVAIL_LIST);
+                EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_AVAIL_LIST, pid.volNo, pid.pageNo);
+            } 
+            // b-2. avail list에 object를 삽입할 수 있는 page를 찾지 못했다.
+            // 이 경우, file의 last page를 확인한다.
             else {
-                BfM_FreeTrain((TrainID *)&pid, PAGE_BUF); 
-                MAKE_PAGEID(nearPid, pFid.volNo, catEntry->lastPage);
-                // 새로운 page 하나를 할당하고, ID를 pid에 저장한다.
-                e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+                MAKE_PAGEID(pid, pFid.volNo, catEntry->lastPage);
+                e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
                 if (e < 0) ERR(e);
+
+                // last page에 object를 삽입할 수 있고, 다른 thread의 active insert page가 아니다.
+                if (SP_FREE(apage) >= eduom_NeededSpace(apage, length, data) &&
+                    eduom_GetActiveInsertPageOwner(&pid) == ACTIVE_INSERT_PAGE_NONE) {
+                    om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+                    EDUOM_STATS_BRANCH(EDUOM_BRANCH_LAST_PAGE);
+                    EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_LAST_PAGE, pid.volNo, pid.pageNo);
+                }
+                // last page에 object를 삽입할 수 없어, 새 page를 할당 받아야함.
+                else {
+                    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF); 
+                    EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEW_PAGE);
+                    MAKE_PAGEID(nearPid, pFid.volNo, catEntry->lastPage);
+                    // 새로운 page 하나를 할당하고, ID를 pid에 저장한다.
+                    e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+                    if (e < 0) ERR(e);
+                    EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEW_PAGE, pid.volNo, pid.pageNo);
         
-                // disk에 새로 할당된 page를 fix하고, 포인터를 apage에 담아 반환한다.
-                e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-                if (e < 0) ERR(e);
+                    // disk에 새로 할당된 page를 fix하고, 포인터를 apage에 담아 반환한다.
+                    e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+                    if (e < 0) ERR(e);
+
+                    // header 초기화
+                    // buffer frame에는 이전 page의 내용이 남아 있으므로 header 전체를 초기화한다.
+                    SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
+                    apage->header.reserved = 0;
+                    apage->header.pid = pid;
+                    apage->header.fid = catEntry->fid;
+                    apage->header.nSlots = 0;
+                    apage->header.free = 0;
+                    apage->header.unused = 0;
+                    apage->header.unique = 0;
+                    apage->header.uniqueLimit = 0;
+                    apage->header.nextPage = NIL;
+                    apage->header.prevPage = NIL;
+                    apage->header.spaceListPrev = NIL;
+                    apage->header.spaceListNext = NIL;
+                    if (soaFile) apage->header.reserved = EDUOM_SOA_PAGE;
+                    else if (prefixFile) eduom_FormatPrefixPage(apage, length, data);
+
+                    //file의 last page 다음 page로 insert한다.
+                    om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+                }
+            }
 
-                // header 초기화
-                SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
-                apage->header.fid = catEntry->fid;
-                apage->header.free = 0;
-                apage->header.unused = 0;
+            // 선정된 page를 이 thread의 active insert page로 소유한다.
+            ownedPage = eduom_ClaimActiveInsertPage(catObjForFile, &catEntry->fid, &pid);
+        }
 
-                //nearObj가 저장된 page의 다음 page로 insert한다.
-                om_FileMapAddPage(catObjForFile, &nearPid, &pid);
-            }
+        // compaction이 필요할 경우 필요한 만큼만 compaction을 수행
+        // 나머지 hole들은 background compactor가 idle time에 정리한다(see EduOM_Compactor.c).
+        if (SP_CFREE(apage) < eduom_NeededSpace(apage, length, data)) {
+            EDUOM_STATS_BRANCH(EDUOM_BRANCH_COMPACTION);
+            e = EduOM_CompactPageIncrementally(apage, NIL, eduom_NeededSpace(apage, length, data));
+            if (e < 0) ERRB1(e, &pid, PAGE_BUF);
         }
     }
 
     // 3. 선정된 page에 object를 삽입
+    // optimistic reader가 수정 중인 page를 읽지 않도록 frame version을 올린다.
+    e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
     // 3-1. object header update
+    // dictionary가 빈 prefix page(prefix page를 쓰는 file의 첫 page)는 처음 삽입되는 object로 dictionary를 만든다.
+    if (IS_PREFIX_PAGE(apage) && PREFIX_DICT_LENGTH(apage) == 0 && apage->header.nSlots == 0)
+        eduom_FormatPrefixPage(apage, length, data);
+
+    // prefix page라면 dictionary와 겹치는 prefix의 길이와 나머지 data만 저장한다.
+    prefixLength = eduom_PrefixLength(apage, length, data);
     obj = (Object *)&(apage->data[apage->header.free]);
     obj->header.properties = objHdr->properties;
     obj->header.length = length;
     obj->header.tag = objHdr->tag;
 
     // 3-2. free area에 object를 복사
-    memcpy(obj->data, data, length);
-
-    // 3-3. Slot array에서 slot을 할당 받아 object 정보를 저장
-    for (i = 0; i < apage->header.nSlots; i++) {
-        if (apage->slot[-i].offset == EMPTYSLOT) break;
+    if (prefixLength > 0) {
+        obj->header.properties |= P_PREFIXED;
+        obj->header.length = 1 + length - prefixLength;
+        obj->data[0] = prefixLength;
+        memcpy(&obj->data[1], data + prefixLength, length - prefixLength);
+        alignedLen = ALIGNED_LENGTH(obj->header.length);
     }
+    else memcpy(obj->data, data, length);
 
-    SlottedPageSlot* insertedSlot = &(apage->slot[-i]);
-    insertedSlot->offset = apage->header.free;
-    om_GetUnique(&pid, &(insertedSlot->unique));
+    // 3-3. Slot array에서 slot을 할당 받아 object 정보를 저장
+    //      빈 slot은 여러 slot의 offset을 한 번에 비교하여 찾는다(see EduOM_SlotKernel.c).
+    i = eduom_FindEmptySlot(apage);
 
     // 3-4. page header 갱신
+    // 빈 slot이 없으면 slot array를 늘린다; SoA page는 unique 배열이 옮겨질 수 있다.
+    if (i == apage->header.nSlots) eduom_SetSlotCount(apage, i + 1);
+
+    SLOT_OFFSET(apage, i) = apage->header.free;
+    om_GetUnique(&pid, &unique);
+    if (IS_SOA_PAGE(apage)) SOA_UNIQUE(apage, i) = unique;
+    else apage->slot[-i].unique = unique;
+
     // free space 갱신
-    if (i == apage->header.nSlots) apage->header.nSlots++;
     apage->header.free += sizeof(ObjectHdr) + alignedLen;
 
+    e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
     // page를 알맞는 available space list에 삽입함
-    om_PutInAvailSpaceList(catObjForFile, &pid, apage);
-    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, insertedSlot->unique);
+    // 단, active insert page는 가득 차거나 release될 때까지 넣지 않는다.
+    if (!ownedPage) om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, unique);
 
     // Free resource
     e = BfM_SetDirty(&pid, PAGE_BUF);
@@ -346,6 +530,10 @@ Four eduom_CreateObject(
     BfM_FreeTrain(&pid, PAGE_BUF);
     e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
     if (e < 0) ERR(e);
+
+    // dirty page를 eviction 전에 미리 disk에 쓴다.
+    e = BfM_PollWriter();
+    if (e < 0) ERR(e);
     
     return(eNOERROR);
     
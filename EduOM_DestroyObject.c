@@ -84,24 +84,26 @@ Four EduOM_DestroyObject(
     DeallocListElem *dlHead)	/* INOUT head of dealloc list */
 {
     Four        e;		/* error number */
-    Two         i;		/* temporary variable */
-    FileID      fid;		/* ID of file where the object was placed */
     PageID	pid;		/* page on which the object resides */
     SlottedPage *apage;		/* pointer to the buffer holding the page */
     Four        offset;		/* start offset of object in data area */
     Object      *obj;		/* points to the object in data area */
     Four        alignedLen;	/* aligned length of object */
-    Boolean     last;		/* indicates the object is the last one */
+    Four        unusedBefore;	/* 'unused' of the page before the object is destroyed */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
     DeallocListElem *dlElem;	/* pointer to element of dealloc list */
-    PhysicalFileID pFid;	/* physical ID of file */
     
     /*@ Check parameters. */
     if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
 
     if (oid == NULL) ERR(eBADOBJECTID_OM);
 
+    // buffer manager 통계를 삭제 연산으로 집계한다.
+    BfM_SetCaller(BFM_CALLER_DESTROY);
+    EDUOM_STATS_TIMER(EDUOM_API_DESTROY);
+    EDUOM_PROBE_API(EDUOM_API_DESTROY, oid);
+
     /* 여기부터 구현 */
     // 1. available space list에서 object를 포함하고 있는 page를 삭제한다.
     // 1-1. File의 catPage를 얻어온다.
@@ -113,29 +115,58 @@ Four EduOM_DestroyObject(
     BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
     // 1-3. available space list에서 page를 삭제한다.
+    // active insert page였다면 아래에서 list에 다시 넣거나 file에서 삭제하므로 소유를 해제한다.
+    eduom_DisownActiveInsertPage(&pid);
     om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
 
     // 2. 삭제할 object에 대응하는 slot을 empty unused slot으로 지정한다.
     // offset of the slot = EMPTYSLOT
     
-    // 2-1. 원래 offset을 기록
-    offset = apage->slot[-oid->slotNo].offset;
-    obj = (Object *)&(apage->data[offset]);
-
-    // 2-2. offset을 EMPTYSLOT으로 초기화
-    apage->slot[-oid->slotNo].offset = EMPTYSLOT;
-
-    // 3. Page Header 업데이트
-    // Case 1. 지울 object가 slot array의 last slot이라면, slot array의 사이즈를 변경한다.
-    if (apage->header.nSlots == oid->slotNo + 1) {
-        apage->header.nSlots--;
+    // background compactor에 넘길지 정하기 위해 삭제 전의 unused를 기록한다.
+    unusedBefore = apage->header.unused;
+
+    // optimistic reader가 수정 중인 page를 읽지 않도록 frame version을 올린다.
+    e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    // fixed length record page에는 slot array가 없으므로 bitmap에서 record를 지우고,
+    // small object page는 2-byte slot과 압축된 header를 쓰므로 따로 지운다.
+    if (IS_FIXED_PAGE(apage) || IS_SMALL_PAGE(apage)) {
+        if (IS_FIXED_PAGE(apage)) e = eduom_DestroyFixedRecord(apage, oid);
+        else e = eduom_DestroySmallObject(apage, oid);
+        if (e < 0) {
+            BfM_EndFrameWrite(&pid, PAGE_BUF);
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+        }
+    }
+    else {
+        // 2-1. 원래 offset을 기록
+        offset = SLOT_OFFSET(apage, oid->slotNo);
+        obj = (Object *)&(apage->data[offset]);
+
+        // 2-2. offset을 EMPTYSLOT으로 초기화
+        SLOT_OFFSET(apage, oid->slotNo) = EMPTYSLOT;
+
+        // 3. Page Header 업데이트
+        // Case 1. 지울 object가 slot array의 last slot이라면, slot array의 사이즈를 변경한다.
+        if (apage->header.nSlots == oid->slotNo + 1) {
+            eduom_SetSlotCount(apage, apage->header.nSlots - 1);
+        }
+
+        // PAX page의 row 자리는 reserve된 채로 두고, 그 외에는
+        // Object의 offset에 따라 free나 unused 변수 값을 업데이트
+        if (IS_PAX_PAGE(apage)) SP_RESERVE_FREE(apage);
+        else {
+            alignedLen = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
+
+            if (offset + alignedLen == apage->header.free) apage->header.free -= alignedLen;
+            else apage->header.unused += alignedLen;
+        }
     }
 
-    alignedLen = ALIGNED_LENGTH(obj->header.length) + sizeof(ObjectHdr);
-
-    // Object의 offset에 따라 free나 unused 변수 값을 업데이트
-    if (offset + alignedLen == apage->header.free) apage->header.free -= alignedLen;
-    else apage->header.unused += alignedLen;
+    e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
 
     // 4. page가 file의 첫 페이지가 아니고, deleted object가 그 page의 only object라면
     if (apage->header.pid.pageNo != catEntry->firstPage && apage->header.nSlots == 0) {
@@ -158,12 +189,20 @@ Four EduOM_DestroyObject(
     else {
         // page를 appropriate available space list에 삽입한다.
         om_PutInAvailSpaceList(catObjForFile, &pid, apage);
+
+        // unused가 threshold에 이른 page는 idle time에 compact되도록 queue에 넣는다(see EduOM_Compactor.c).
+        if (!IS_PAX_PAGE(apage) && !IS_FIXED_PAGE(apage) && !IS_SMALL_PAGE(apage))
+            eduom_QueueCompaction(apage, unusedBefore);
     }
 
     // 6. 마무리
     BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
     BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
     BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+
+    // dirty page를 eviction 전에 미리 disk에 쓴다.
+    e = BfM_PollWriter();
+    if (e < 0) ERR(e);
     
     return(eNOERROR);
     
@@ -0,0 +1,3703 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_FeatureTest.c
+ *
+ * Description:
+ *  Behavior tests of the extensions of the object manager and the buffer
+ *  manager. They are run by 'EduOM_Test features'(make check) and are kept
+ *  out of EduOM_Test(), whose output is compared with test/solution.txt.
+ *
+ *  Each test works on a file of its own and prints a line of PASS or FAIL;
+ *  a failed test also prints what it found.
+ *
+ * Exports:
+ *  Four EduOM_FeatureTest(Four, char*)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+#include <stddef.h>
+#include <errno.h>
+#include <elf.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#endif
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "BfM_Internal.h"
+#include "RDsM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define FEATURE_PASS            0       /* result of a test which passed */
+#define FEATURE_FAIL            1       /* result of a test which failed */
+
+#define FEATURE_MAX_TRAINS      400     /* trains of a file a test looks at */
+#define FEATURE_AIO_DEPTH       32      /* requests in flight of the attached handle */
+#define FEATURE_OBJECTS         600     /* objects created by a test */
+#define FEATURE_DENSITY         1000    /* objects filling the first page of a density test */
+
+/* length of the i-th object of the compaction test; the holes left by the
+   short ones are smaller than the objects next to them */
+#define FEATURE_COMPACT_LENGTH(i)   (((i) % 2 == 0) ? 200 : 40)
+
+/* list of the resident trains saved by the warm start test */
+#define FEATURE_HOT_FILE        "feature.hot"
+
+
+
+/*@
+ * Type Definitions
+ */
+/* a test; returns FEATURE_PASS, FEATURE_FAIL, or an error code */
+typedef Four (*feature_TestFunc)(Four, char *);
+
+typedef struct {
+    char		*name;		/* name printed with the result */
+    feature_TestFunc	func;		/* the test */
+} feature_Test;
+
+/* an object created by another thread(see feature_CreateInThread()) */
+typedef struct {
+    ObjectID	*catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* object created */
+    Four	e;		/* error number of the create */
+} feature_Creator;
+
+
+
+/*@
+ * Function Prototypes
+ */
+/* the wrappers of the device I/O of cosmos.o(see RDsM_Compression.c) */
+int __wrap_open64(const char *, int, ...);
+int __wrap_close(int);
+
+/* the finalization of the buffer manager in cosmos.o */
+Four BfM_Final(void);
+
+
+
+/*@================================
+ * feature_Pattern()
+ *================================*/
+/*
+ * Function: void feature_Pattern(Four, Four, char*)
+ *
+ * Description:
+ *  Fill 'buf' with the contents of the i-th object of a test.
+ *
+ * Returns:
+ *  None
+ */
+static void feature_Pattern(
+    Four	i,		/* IN number of the object */
+    Four	length,		/* IN length of the object */
+    char	*buf)		/* OUT contents */
+{
+    Four	k;		/* index variable */
+
+
+    for (k = 0; k < length; k++) buf[k] = (char)('a' + (i*7 + k) % 26);
+
+} /* feature_Pattern() */
+
+
+
+/*@================================
+ * feature_CreateFile()
+ *================================*/
+/*
+ * Function: Four feature_CreateFile(Four, FileID*, ObjectID*)
+ *
+ * Description:
+ *  Create a data file and get its catalog entry.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CreateFile(
+    Four	volId,		/* IN volume of the file */
+    FileID	*fid,		/* OUT new file */
+    ObjectID	*catEntry)	/* OUT catalog entry of the file */
+{
+    Four	e;		/* error number */
+
+
+    e = SM_CreateFile(volId, fid, FALSE, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, fid, catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* feature_CreateFile() */
+
+
+
+/*@================================
+ * feature_FillFile()
+ *================================*/
+/*
+ * Function: Four feature_FillFile(ObjectID*, Four, Four, Four)
+ *
+ * Description:
+ *  Append 'n' objects of 'length' bytes to the file; the i-th one holds
+ *  feature_Pattern(first + i).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_FillFile(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    Four	first,		/* IN number of the first object */
+    Four	n,		/* IN the number of objects */
+    Four	length)		/* IN length of an object */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    ObjectID	oid;		/* object created */
+    char	buf[PAGESIZE];	/* contents of the object */
+
+
+    for (i = 0; i < n; i++) {
+        feature_Pattern(first + i, length, buf);
+
+        e = EduOM_CreateObject(catEntry, (i == 0) ? NULL : &oid, NULL, length, buf, &oid);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* feature_FillFile() */
+
+
+
+/*@================================
+ * feature_CollectTrains()
+ *================================*/
+/*
+ * Function: Four feature_CollectTrains(ObjectID*, TrainID*, Four)
+ *
+ * Description:
+ *  Get the pages holding the objects of the file in the order of the file.
+ *  EduOM_NextObject() returns EOS for every object; the scan is over when it
+ *  leaves the object identifier unchanged.
+ *
+ * Returns:
+ *  the number of pages (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CollectTrains(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    TrainID	*trains,	/* OUT pages of the file */
+    Four	maxTrains)	/* IN size of 'trains' */
+{
+    Four	e;		/* error number */
+    Four	n;		/* the number of pages */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (n = 0; oid.pageNo != NIL && n < maxTrains; ) {
+        if (n == 0 || trains[n-1].pageNo != oid.pageNo) {
+            MAKE_PAGEID(trains[n], oid.volNo, oid.pageNo);
+            n++;
+        }
+
+        prev = oid;
+        e = EduOM_NextObject(catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) break;
+    }
+
+    return(n);
+
+} /* feature_CollectTrains() */
+
+
+
+/*@================================
+ * feature_CopyTrains()
+ *================================*/
+/*
+ * Function: Four feature_CopyTrains(TrainID*, Four, char*)
+ *
+ * Description:
+ *  Copy the trains as BfM_GetTrain() gives them.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CopyTrains(
+    TrainID	*trains,	/* IN trains to copy */
+    Four	n,		/* IN the number of trains */
+    char	*copies)	/* OUT n pages */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    char	*page;		/* buffer of the train */
+
+
+    for (i = 0; i < n; i++) {
+        e = BfM_GetTrain(&trains[i], &page, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        memcpy(copies + i*PAGESIZE, page, PAGESIZE);
+
+        e = BfM_FreeTrain(&trains[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* feature_CopyTrains() */
+
+
+
+/*@================================
+ * feature_TestPrefetch()
+ *================================*/
+/*
+ * Function: Four feature_TestPrefetch(Four, char*)
+ *
+ * Description:
+ *  Prefetch the pages of a file through the asynchronous I/O attached to the
+ *  volume and compare them byte for byte with what BfM_GetTrain() read
+ *  before. This checks that a train is at 'pageNo * PAGESIZE' on the device.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four feature_TestPrefetch(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of pages of the file */
+    Four	result;		/* result of the test */
+    UFour	version;	/* version of a frame */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	*copies;	/* the pages read by BfM_GetTrain() */
+    char	*frame;		/* buffer of a prefetched train */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 2000, 100);
+    if (e < eNOERROR) ERR(e);
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+    if (n == 0) {
+        printf("  the file has no page\n");
+        return(FEATURE_FAIL);
+    }
+
+    copies = (char *)malloc(n*PAGESIZE);
+    if (copies == NULL) ERR(eMEMORYALLOCERR);
+
+    /* put the pages in the device and read them back one by one */
+    e = BfM_FlushAll();
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CopyTrains(trains, n, copies);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) goto failed;
+
+    e = RDsM_AttachAsyncIO(volId, devName, FEATURE_AIO_DEPTH, 0);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_PrefetchTrains(trains, n, PAGE_BUF);
+
+    RDsM_DetachAsyncIO(volId);
+
+    if (e < eNOERROR) goto failed;
+
+    result = FEATURE_PASS;
+    if (e != n) {
+        printf("  %ld of %ld pages prefetched\n", (long)e, (long)n);
+        result = FEATURE_FAIL;
+    }
+
+    for (i = 0; i < n && result == FEATURE_PASS; i++) {
+        frame = BfM_LookUpFrame(&trains[i], PAGE_BUF, &version);
+
+        if (frame == NULL) {
+            printf("  page %ld is not in the buffer pool\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+        else if (memcmp(frame, copies + i*PAGESIZE, PAGESIZE) != 0) {
+            printf("  page %ld differs from BfM_GetTrain()\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    free(copies);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    free(copies);
+
+    ERR(e);
+
+} /* feature_TestPrefetch() */
+
+
+
+/*@================================
+ * feature_TestMappedRead()
+ *================================*/
+/*
+ * Function: Four feature_TestMappedRead(Four, char*)
+ *
+ * Description:
+ *  Map the volume, read the pages of a file which are not in the buffer
+ *  pool through BfM_GetTrainForRead(), and compare them byte for byte with
+ *  what BfM_GetTrain() read before. Every page must come from the mapping.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four feature_TestMappedRead(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of pages of the file */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	*copies;	/* the pages read by BfM_GetTrain() */
+    char	*page;		/* train read through the mapping */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 2000, 100);
+    if (e < eNOERROR) ERR(e);
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+    if (n == 0) {
+        printf("  the file has no page\n");
+        return(FEATURE_FAIL);
+    }
+
+    copies = (char *)malloc(n*PAGESIZE);
+    if (copies == NULL) ERR(eMEMORYALLOCERR);
+
+    /* put the pages in the device and read them back one by one */
+    e = BfM_FlushAll();
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CopyTrains(trains, n, copies);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) goto failed;
+
+    e = RDsM_MapVolume(volId, devName, RDSM_ADVICE_NORMAL);
+    if (e < eNOERROR) goto failed;
+
+    result = FEATURE_PASS;
+    for (i = 0; i < n && result == FEATURE_PASS; i++) {
+        e = BfM_GetTrainForRead(&trains[i], &page, PAGE_BUF);
+        if (e < eNOERROR) break;
+
+        if (page != RDsM_GetMappedTrain(&trains[i], 1)) {
+            printf("  page %ld is not read from the mapping\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+        else if (memcmp(page, copies + i*PAGESIZE, PAGESIZE) != 0) {
+            printf("  page %ld differs from BfM_GetTrain()\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+
+        e = BfM_FreeTrainForRead(&trains[i], page, PAGE_BUF);
+        if (e < eNOERROR) break;
+    }
+
+    RDsM_UnmapVolume(volId);
+
+    if (e < eNOERROR) goto failed;
+
+    free(copies);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    free(copies);
+
+    ERR(e);
+
+} /* feature_TestMappedRead() */
+
+
+
+/*@================================
+ * feature_CountPartitionAllocs()
+ *================================*/
+/*
+ * Function: Four feature_CountPartitionAllocs(UFour*)
+ *
+ * Description:
+ *  Sum the frames allocated in the partitions of the buffer pool.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CountPartitionAllocs(
+    UFour	*nAllocs)	/* OUT frames allocated in the partitions */
+{
+    Four	e;		/* error number */
+    Four	p;		/* index of a partition */
+    BfM_PartitionStats stats;	/* statistics of a partition */
+
+
+    *nAllocs = 0;
+
+    for (p = 0; p < BfM_GetNumPartitions(); p++) {
+        e = BfM_GetPartitionStats(p, &stats);
+        if (e < eNOERROR) ERR(e);
+
+        *nAllocs += stats.localAllocs;
+    }
+
+    return(eNOERROR);
+
+} /* feature_CountPartitionAllocs() */
+
+
+
+/*@================================
+ * feature_TestPartitionedMiss()
+ *================================*/
+/*
+ * Function: Four feature_TestPartitionedMiss(Four, char*)
+ *
+ * Description:
+ *  Split the buffer pool into two partitions, scan a file whose pages are
+ *  not in the buffer pool, and check that the misses of the scan took
+ *  frames of the partitions and read the right pages. The scan is used as
+ *  the misses have to go through the wrapper of BfM_GetTrain() in the
+ *  object manager(see BfM_Stats.c). The buffer pool is given back to the
+ *  buffer manager afterwards.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four feature_TestPartitionedMiss(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of pages of the file */
+    Four	result;		/* result of the test */
+    UFour	before, after;	/* frames allocated in the partitions */
+    UFour	version;	/* version of a frame */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	*copies;	/* the pages read before partitioning */
+    char	*frame;		/* buffer of a train read by the scan */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 2000, 100);
+    if (e < eNOERROR) ERR(e);
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+    if (n == 0) {
+        printf("  the file has no page\n");
+        return(FEATURE_FAIL);
+    }
+
+    copies = (char *)malloc(n*PAGESIZE);
+    if (copies == NULL) ERR(eMEMORYALLOCERR);
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CopyTrains(trains, n, copies);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_SetUpNumaPartitions(2);
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CountPartitionAllocs(&before);
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (e < eNOERROR) goto failed;
+
+    e = feature_CountPartitionAllocs(&after);
+    if (e < eNOERROR) goto failed;
+
+    result = FEATURE_PASS;
+    if (after - before < (UFour)n) {
+        printf("  %lu frames of a partition for %ld pages\n", (unsigned long)(after - before), (long)n);
+        result = FEATURE_FAIL;
+    }
+
+    for (i = 0; i < n && result == FEATURE_PASS; i++) {
+        frame = BfM_LookUpFrame(&trains[i], PAGE_BUF, &version);
+
+        if (frame == NULL) {
+            printf("  page %ld is not in the buffer pool\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+        else if (memcmp(frame, copies + i*PAGESIZE, PAGESIZE) != 0) {
+            printf("  page %ld differs from the page read before\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    e = BfM_SetUpNumaPartitions(1);
+    if (e < eNOERROR) goto failed;
+
+    free(copies);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    free(copies);
+
+    ERR(e);
+
+} /* feature_TestPartitionedMiss() */
+
+
+
+/*@================================
+ * feature_TestDirectIO()
+ *================================*/
+/*
+ * Function: Four feature_TestDirectIO(Four, char*)
+ *
+ * Description:
+ *  Turn direct I/O on and off for the volume, and check that it is refused
+ *  when the file descriptor of the device in the volume table refers to
+ *  another file, as it would if the layout of the table were wrong.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    eVOLNOTMOUNTED_RDSM
+ *    some errors caused by function calls
+ */
+static Four feature_TestDirectIO(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index of the volume table */
+    Four	fd;		/* another file */
+    Four	devAddr;	/* file descriptor of the device */
+    Four	result;		/* result of the test */
+
+
+    for (i = 0; i < MAXNUMOFVOLS; i++)
+        if (volTable[i].volNo == volId) break;
+
+    if (i == MAXNUMOFVOLS) ERR(eVOLNOTMOUNTED_RDSM);
+
+    result = FEATURE_PASS;
+
+    /* the file system of the device may not support direct I/O */
+    e = RDsM_SetDirectIO(volId, TRUE);
+    if (e == eNOERROR) {
+        if (!(fcntl(volTable[i].devInfo[0].devAddr, F_GETFL) & O_DIRECT)) {
+            printf("  direct I/O is not turned on\n");
+            result = FEATURE_FAIL;
+        }
+
+        e = RDsM_SetDirectIO(volId, FALSE);
+        if (e < eNOERROR) ERR(e);
+    }
+    else if (e != eDIRECTIONOTSUPPORTED_RDSM) {
+        printf("  RDsM_SetDirectIO() failed with %ld\n", (long)e);
+        result = FEATURE_FAIL;
+    }
+
+    fd = open("/dev/null", O_RDONLY);
+    if (fd < 0) ERR(eDEVICEOPENFAIL_RDSM);
+
+    devAddr = volTable[i].devInfo[0].devAddr;
+    volTable[i].devInfo[0].devAddr = fd;
+
+    e = RDsM_SetDirectIO(volId, TRUE);
+
+    volTable[i].devInfo[0].devAddr = devAddr;
+    close(fd);
+
+    if (e != eBADVOLUMETABLE_RDSM) {
+        printf("  a device which is not the file named is not refused(%ld)\n", (long)e);
+        result = FEATURE_FAIL;
+    }
+
+    return(result);
+
+} /* feature_TestDirectIO() */
+
+
+
+/*@================================
+ * feature_TestAsyncWriter()
+ *================================*/
+/*
+ * Function: Four feature_TestAsyncWriter(Four, char*)
+ *
+ * Description:
+ *  Let the background writer take a checkpoint through the asynchronous
+ *  I/O attached to the volume, drop the buffer pool, and compare the pages
+ *  read back by BfM_GetTrain() with the buffers before the checkpoint.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four feature_TestAsyncWriter(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of pages of the file */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	*copies;	/* the buffers before the checkpoint */
+    char	*page;		/* buffer of a train read back */
+    BfM_WriterParams params;	/* tunables of the writer */
+    BfM_WriterParams noWriter;	/* tunables which keep the writer from running */
+    BfM_WriterStats before;	/* counters of the writer before the checkpoint */
+    BfM_WriterStats after;	/* counters of the writer after the checkpoint */
+
+
+    e = BfM_GetWriterParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    /* the buffers have to be dirty when the checkpoint is taken */
+    noWriter = params;
+    noWriter.trickleInterval = noWriter.checkpointInterval = 0;
+
+    e = BfM_SetWriterParams(&noWriter);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 2000, 100);
+    if (e < eNOERROR) ERR(e);
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+    if (n == 0) {
+        printf("  the file has no page\n");
+        return(FEATURE_FAIL);
+    }
+
+    copies = (char *)malloc(n*PAGESIZE);
+    if (copies == NULL) ERR(eMEMORYALLOCERR);
+
+    e = feature_CopyTrains(trains, n, copies);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_GetWriterStats(&before);
+    if (e < eNOERROR) goto failed;
+
+    e = RDsM_AttachAsyncIO(volId, devName, FEATURE_AIO_DEPTH, 0);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_RunWriter(TRUE);
+
+    RDsM_DetachAsyncIO(volId);
+
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_GetWriterStats(&after);
+    if (e < eNOERROR) goto failed;
+
+    /* a page not written by the checkpoint is lost here */
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) goto failed;
+
+    result = FEATURE_PASS;
+    if (after.asyncRuns == before.asyncRuns) {
+        printf("  no run was written asynchronously\n");
+        result = FEATURE_FAIL;
+    }
+
+    for (i = 0; i < n && result == FEATURE_PASS; i++) {
+        e = BfM_GetTrain(&trains[i], &page, PAGE_BUF);
+        if (e < eNOERROR) goto failed;
+
+        if (memcmp(page, copies + i*PAGESIZE, PAGESIZE) != 0) {
+            printf("  page %ld differs from the buffer written\n", (long)trains[i].pageNo);
+            result = FEATURE_FAIL;
+        }
+
+        e = BfM_FreeTrain(&trains[i], PAGE_BUF);
+        if (e < eNOERROR) goto failed;
+    }
+
+    free(copies);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_SetWriterParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    free(copies);
+
+    ERR(e);
+
+} /* feature_TestAsyncWriter() */
+
+
+
+/*@================================
+ * feature_TestPaxColumnScan()
+ *================================*/
+/*
+ * Function: Four feature_TestPaxColumnScan(Four, char*)
+ *
+ * Description:
+ *  Fill a file of the PAX layout, overwrite the minipages of all fields
+ *  but one in the buffered pages, and check that EduOM_ReadPaxColumn()
+ *  still gives every row once with the value created in that field: the
+ *  column scan reads only the minipage of the field.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestPaxColumnScan(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i, j;		/* index variables */
+    Four	n;		/* the number of pages of the file */
+    Four	nRows;		/* rows of a page */
+    Four	nMet;		/* rows given by the column scan */
+    Four	result;		/* result of the test */
+    PageNo	pageNo;		/* page of the column scan */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[FEATURE_OBJECTS]; /* the rows */
+    ObjectID	rowOids[EDUOM_PAX_MAX_ROWS]; /* rows of a page */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    EduOM_PaxSchema schema;	/* 4, 8 and 20 byte fields */
+    SlottedPage	*apage;		/* buffer of a page */
+    eduom_PaxPageHdr *paxHdr;	/* PAX header of the page */
+    char	row[32];	/* contents of a row */
+    char	column[PAGESIZE]; /* values of the second field */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    memset(&schema, 0, sizeof(EduOM_PaxSchema));
+    schema.nFields = 3;
+    schema.width[0] = 4;
+    schema.width[1] = 8;
+    schema.width[2] = 20;
+
+    e = EduOM_SetPaxLayout(&catEntry, &schema);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < FEATURE_OBJECTS; i++) {
+        feature_Pattern(i, 32, row);
+
+        e = EduOM_CreateObject(&catEntry, (i == 0) ? NULL : &oids[i-1], NULL, 32, row, &oids[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+
+    /* the first and the third field of every row become 0xa5 bytes */
+    for (i = 0; i < n; i++) {
+        e = BfM_GetTrain(&trains[i], (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        paxHdr = PAX_PAGE_HDR(apage);
+        memset(apage->data + paxHdr->offset[0], 0xa5, paxHdr->nRows*4);
+        memset(apage->data + paxHdr->offset[2], 0xa5, paxHdr->nRows*20);
+
+        e = BfM_FreeTrain(&trains[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    result = FEATURE_PASS;
+
+    e = EduOM_ReadObject(&oids[0], 0, 32, row);
+    if (e < eNOERROR) ERR(e);
+
+    if ((unsigned char)row[0] != 0xa5 || (unsigned char)row[31] != 0xa5) {
+        printf("  the other minipages were not overwritten\n");
+        result = FEATURE_FAIL;
+    }
+
+    pageNo = NIL;
+    nMet = 0;
+    do {
+        e = EduOM_ReadPaxColumn(&catEntry, &pageNo, 1, column, rowOids, &nRows);
+        if (e < eNOERROR) ERR(e);
+
+        for (i = 0; i < nRows && result == FEATURE_PASS; i++, nMet++) {
+            for (j = 0; j < FEATURE_OBJECTS; j++)
+                if (oids[j].pageNo == rowOids[i].pageNo && oids[j].slotNo == rowOids[i].slotNo) break;
+
+            if (j < FEATURE_OBJECTS) feature_Pattern(j, 32, row);
+
+            if (j == FEATURE_OBJECTS || memcmp(row + 4, column + i*8, 8) != 0) {
+                printf("  the column differs at page %ld, slot %ld\n",
+                       (long)rowOids[i].pageNo, (long)rowOids[i].slotNo);
+                result = FEATURE_FAIL;
+            }
+        }
+    } while (e != EOS && result == FEATURE_PASS);
+
+    if (result == FEATURE_PASS && nMet != FEATURE_OBJECTS) {
+        printf("  the column scan gave %ld of %ld rows\n", (long)nMet, (long)FEATURE_OBJECTS);
+        result = FEATURE_FAIL;
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestPaxColumnScan() */
+
+
+
+/*@================================
+ * feature_Density()
+ *================================*/
+/*
+ * Function: Four feature_Density(ObjectID*, Four, Four*)
+ *
+ * Description:
+ *  Append FEATURE_DENSITY objects of 'length' bytes to the empty file and
+ *  count the objects of its first page, which they fill.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_Density(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    Four	length,		/* IN length of an object */
+    Four	*nObjects)	/* OUT objects of the first page */
+{
+    Four	e;		/* error number */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+
+
+    e = feature_FillFile(catEntry, 0, FEATURE_DENSITY, length);
+    if (e < eNOERROR) ERR(e);
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    *nObjects = 0;
+    prev = oid;
+    while (oid.pageNo == prev.pageNo) {
+        (*nObjects)++;
+
+        prev = oid;
+        e = EduOM_NextObject(catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) break;
+    }
+
+    return(eNOERROR);
+
+} /* feature_Density() */
+
+
+
+/*@================================
+ * feature_PlainDensity()
+ *================================*/
+/*
+ * Function: Four feature_PlainDensity(Four, Four, Four*)
+ *
+ * Description:
+ *  Count the objects of 'length' bytes a slotted page holds(see
+ *  feature_Density()).
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_PlainDensity(
+    Four	volId,		/* IN volume to test on */
+    Four	length,		/* IN length of an object */
+    Four	*nObjects)	/* OUT objects of a page */
+{
+    Four	e;		/* error number */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_Density(&catEntry, length, nObjects);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* feature_PlainDensity() */
+
+
+
+/*@================================
+ * feature_TestFixedDensity()
+ *================================*/
+/*
+ * Function: Four feature_TestFixedDensity(Four, char*)
+ *
+ * Description:
+ *  Check that a page of fixed length records holds at least a fifth more
+ *  records of 40 bytes than a slotted page.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestFixedDensity(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	nPlain;		/* records of a slotted page */
+    Four	nFixed;		/* records of a fixed length record page */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+
+
+    e = feature_PlainDensity(volId, 40, &nPlain);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetFixedLength(&catEntry, 40);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_Density(&catEntry, 40, &nFixed);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    printf("  40 byte records per page: slotted %ld, fixed %ld\n", (long)nPlain, (long)nFixed);
+
+    return((nFixed*5 >= nPlain*6) ? FEATURE_PASS : FEATURE_FAIL);
+
+} /* feature_TestFixedDensity() */
+
+
+
+/*@================================
+ * feature_TestSmallDensity()
+ *================================*/
+/*
+ * Function: Four feature_TestSmallDensity(Four, char*)
+ *
+ * Description:
+ *  Check that a small object page holds at least two fifths more objects
+ *  of 16 bytes than a slotted page.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestSmallDensity(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	nPlain;		/* objects of a slotted page */
+    Four	nSmall;		/* objects of a small object page */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+
+
+    e = feature_PlainDensity(volId, 16, &nPlain);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetSmallObjectPages(&catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_Density(&catEntry, 16, &nSmall);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    printf("  16 byte objects per page: slotted %ld, small %ld\n", (long)nPlain, (long)nSmall);
+
+    return((nSmall*5 >= nPlain*7) ? FEATURE_PASS : FEATURE_FAIL);
+
+} /* feature_TestSmallDensity() */
+
+
+
+/*@================================
+ * feature_TestCompressedSize()
+ *================================*/
+/*
+ * Function: Four feature_TestCompressedSize(Four, char*)
+ *
+ * Description:
+ *  Fill a file whose pages are stored compressed with objects of a short
+ *  pattern, write it, and check that its pages take less than half of
+ *  their size on the device and that the objects read back from them
+ *  after they are decompressed.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestCompressedSize(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nPages;		/* pages stored compressed by the test */
+    Four	result;		/* result of the test */
+    double	nBytes;		/* bytes of those pages */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    char	buf[PAGESIZE];	/* contents of an object */
+    char	data[PAGESIZE];	/* object read back */
+    RDsM_CompressionStats before; /* counters before the writes, the reads */
+    RDsM_CompressionStats after;  /* counters after the writes, the reads */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetCompressedPages(&catEntry, TRUE);
+    if (e < eNOERROR) ERR(e);
+
+    e = RDsM_GetCompressionStats(volId, &before);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, FEATURE_OBJECTS, 100);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = RDsM_GetCompressionStats(volId, &after);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    nPages = after.nStored - before.nStored;
+    nBytes = after.storedBytes - before.storedBytes;
+    printf("  %ld pages stored in %.0f bytes\n", (long)nPages, nBytes);
+
+    if (nPages <= 0 || nBytes*2 >= (double)nPages*PAGESIZE) result = FEATURE_FAIL;
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(&catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; oid.pageNo != NIL && result == FEATURE_PASS; i++) {
+        feature_Pattern(i, 100, buf);
+
+        e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+
+        if (i >= FEATURE_OBJECTS || e != 100 || memcmp(data, buf, 100) != 0) {
+            printf("  object %ld differs after it was read from a compressed page\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) { i++; break; }
+    }
+
+    if (result == FEATURE_PASS && i != FEATURE_OBJECTS) {
+        printf("  %ld of %ld objects read back\n", (long)i, (long)FEATURE_OBJECTS);
+        result = FEATURE_FAIL;
+    }
+
+    before = after;
+    e = RDsM_GetCompressionStats(volId, &after);
+    if (e < eNOERROR) ERR(e);
+
+    if (result == FEATURE_PASS && after.nDecompressed == before.nDecompressed) {
+        printf("  no page was read decompressed\n");
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_SetCompressedPages(&catEntry, FALSE);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestCompressedSize() */
+
+
+
+/*@================================
+ * feature_CountPrefix()
+ *================================*/
+/*
+ * Function: Four feature_CountPrefix(ObjectID*, char*, Four)
+ *
+ * Description:
+ *  Count the objects of the file EduOM_NextObjectWithPrefix() gives for
+ *  the key, up to 'maxCount' + 1.
+ *
+ * Returns:
+ *  the number of objects (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CountPrefix(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    char	*key,		/* IN head of the objects to count */
+    Four	maxCount)	/* IN the number of objects expected */
+{
+    Four	e;		/* error number */
+    Four	n;		/* the number of objects */
+    ObjectID	oid;		/* current object */
+
+
+    for (n = 0; n <= maxCount; n++) {
+        e = EduOM_NextObjectWithPrefix(catEntry, (n == 0) ? NULL : &oid, key, strlen(key), &oid);
+        if (e == EOS) break;
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(n);
+
+} /* feature_CountPrefix() */
+
+
+
+/*@================================
+ * feature_TestPrefixSize()
+ *================================*/
+/*
+ * Function: Four feature_TestPrefixSize(Four, char*)
+ *
+ * Description:
+ *  Fill a file given prefix pages with objects of 100 bytes sharing a head
+ *  of 48 bytes, and check that every object of its pages is stored with
+ *  P_PREFIXED in at most 53 bytes, that the objects read back whole, and
+ *  that a scan by the head gives every object and a scan by another key
+ *  none.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestPrefixSize(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i, s;		/* index variables */
+    Four	n;		/* the number of pages, objects given by a scan */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[FEATURE_OBJECTS]; /* the objects */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    SlottedPage	*apage;		/* buffer of a page */
+    Object	*obj;		/* object of the page */
+    char	buf[100];	/* contents of an object */
+    char	data[100];	/* object read back */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetPrefixPages(&catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    memset(buf, '.', 48);
+    memcpy(buf, "feature/prefix/object:", 22);
+
+    for (i = 0; i < FEATURE_OBJECTS; i++) {
+        feature_Pattern(i, 52, buf + 48);
+
+        e = EduOM_CreateObject(&catEntry, (i == 0) ? NULL : &oids[i-1], NULL, 100, buf, &oids[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+
+    result = FEATURE_PASS;
+    for (i = 0; i < n && result == FEATURE_PASS; i++) {
+        e = BfM_GetTrain(&trains[i], (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        for (s = 0; s < apage->header.nSlots; s++) {
+            if (apage->slot[-s].offset == EMPTYSLOT) continue;
+
+            obj = (Object *)&(apage->data[apage->slot[-s].offset]);
+            if (!IS_PREFIX_PAGE(apage) || !(obj->header.properties & P_PREFIXED) || obj->header.length > 1 + 100 - 48) {
+                printf("  the object of page %ld, slot %ld is stored in %ld bytes\n",
+                       (long)trains[i].pageNo, (long)s, (long)obj->header.length);
+                result = FEATURE_FAIL;
+                break;
+            }
+        }
+
+        e = BfM_FreeTrain(&trains[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    for (i = 0; i < FEATURE_OBJECTS && result == FEATURE_PASS; i++) {
+        feature_Pattern(i, 52, buf + 48);
+
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+
+        if (e != 100 || memcmp(data, buf, 100) != 0) {
+            printf("  object %ld differs\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    if (result == FEATURE_PASS) {
+        n = feature_CountPrefix(&catEntry, "feature/prefix/", FEATURE_OBJECTS);
+        if (n < eNOERROR) ERR(n);
+
+        if (n != FEATURE_OBJECTS) {
+            printf("  the scan by the head gave %ld of %ld objects\n", (long)n, (long)FEATURE_OBJECTS);
+            result = FEATURE_FAIL;
+        }
+
+        n = feature_CountPrefix(&catEntry, "feature/prefix/other", FEATURE_OBJECTS);
+        if (n < eNOERROR) ERR(n);
+
+        if (n != 0) {
+            printf("  the scan by another key gave %ld objects\n", (long)n);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestPrefixSize() */
+
+
+
+/*@================================
+ * feature_TestSoaSlotLayout()
+ *================================*/
+/*
+ * Function: Four feature_TestSoaSlotLayout(Four, char*)
+ *
+ * Description:
+ *  Fill a file given SoA slots, destroy every third object, and check the
+ *  slots of its pages as they are laid out: the offsets of the slots at the
+ *  end of the page in the order of the slots, and the unique numbers before
+ *  them, after room for the offsets of the smallest power of two slots not
+ *  less than the slots of the page. The offset of a live object locates
+ *  its contents and the unique number is that of its ObjectID; the offset
+ *  of a destroyed object is EMPTYSLOT.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestSoaSlotLayout(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	length;		/* length of an object */
+    Four	capacity;	/* slots the offsets are laid out for */
+    Four	result;		/* result of the test */
+    Two		offset;		/* offset of the slot of an object */
+    Unique	unique;		/* unique number of the slot of an object */
+    PageID	pid;		/* page of an object */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[FEATURE_OBJECTS]; /* the objects */
+    SlottedPage	*apage;		/* buffer of a page */
+    Object	*obj;		/* object at the offset */
+    char	buf[PAGESIZE];	/* contents of an object */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetSoaSlots(&catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < FEATURE_OBJECTS; i++) {
+        feature_Pattern(i, 8 + i % 50, buf);
+
+        e = EduOM_CreateObject(&catEntry, (i == 0) ? NULL : &oids[i-1], NULL, 8 + i % 50, buf, &oids[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    for (i = 0; i < FEATURE_OBJECTS; i += 3) {
+        e = EduOM_DestroyObject(&catEntry, &oids[i], &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    result = FEATURE_PASS;
+    for (i = 0; i < FEATURE_OBJECTS && result == FEATURE_PASS; i++) {
+        MAKE_PAGEID(pid, oids[i].volNo, oids[i].pageNo);
+
+        e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        for (capacity = 2; capacity < apage->header.nSlots; capacity *= 2);
+
+        offset = ((Two *)((char *)apage + PAGESIZE))[-1 - oids[i].slotNo];
+        unique = ((Unique *)((char *)apage + PAGESIZE - capacity*sizeof(Two)))[-1 - oids[i].slotNo];
+        obj = (Object *)&(apage->data[offset]);
+        length = 8 + i % 50;
+        feature_Pattern(i, length, buf);
+
+        if (!IS_SOA_PAGE(apage)) {
+            printf("  page %ld is not a SoA page\n", (long)pid.pageNo);
+            result = FEATURE_FAIL;
+        }
+        else if (i % 3 == 0) {
+            if (offset != EMPTYSLOT) {
+                printf("  the slot of destroyed object %ld holds offset %ld\n", (long)i, (long)offset);
+                result = FEATURE_FAIL;
+            }
+        }
+        else if (offset < 0 || offset >= apage->header.free || unique != oids[i].unique ||
+                 obj->header.length != length || memcmp(obj->data, buf, length) != 0) {
+            printf("  the slot of object %ld holds offset %ld, unique %lu\n",
+                   (long)i, (long)offset, (unsigned long)unique);
+            result = FEATURE_FAIL;
+        }
+
+        e = BfM_FreeTrain(&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestSoaSlotLayout() */
+
+
+
+/*@================================
+ * feature_TestCompactIncrementally()
+ *================================*/
+/*
+ * Function: Four feature_TestCompactIncrementally(Four, char*)
+ *
+ * Description:
+ *  Fill the first page of a file with objects of 200 and 40 bytes in turn
+ *  and destroy those of 40 bytes, so that the page has the free space for
+ *  another object but not contiguously, in holes smaller than the objects
+ *  between them. Check that an insert near the last object of the
+ *  page compacts the page only as far as the object needs, leaving holes,
+ *  that the compactor then compacts the page entirely, and that every
+ *  object of the page reads back after both.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestCompactIncrementally(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* objects of the first page */
+    Four	length;		/* length of an object */
+    Four	unused;		/* holes of the page after the insert */
+    Four	result;		/* result of the test */
+    PageID	pid;		/* the first page */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[PAGESIZE/56 + 2]; /* objects of the page and the one inserted */
+    SlottedPage	*apage;		/* buffer of the page */
+    char	buf[200];	/* contents of an object */
+    char	data[200];	/* object read back */
+    EduOM_CompactorParams params;	/* parameters of the compactor before the test */
+    EduOM_CompactorParams testParams;	/* parameters of the compactor during the test */
+    EduOM_CompactorStats before;	/* statistics of the compactor before the insert */
+    EduOM_CompactorStats middle;	/* ... after it */
+    EduOM_CompactorStats after;		/* ... after the compactor ran */
+
+
+    e = EduOM_GetCompactorParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    testParams = params;
+    testParams.threshold = 1;
+
+    e = EduOM_SetCompactorParams(&testParams);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) goto failed;
+
+    /* the object which does not fit is the first one of the second page */
+    for (n = 0; n == 0 || oids[n-1].pageNo == oids[0].pageNo; n++) {
+        feature_Pattern(n, FEATURE_COMPACT_LENGTH(n), buf);
+
+        e = EduOM_CreateObject(&catEntry, (n == 0) ? NULL : &oids[n-1], NULL, FEATURE_COMPACT_LENGTH(n), buf, &oids[n]);
+        if (e < eNOERROR) goto failed;
+    }
+    n--;
+
+    /* the last object is kept so that the holes are not at the end of the page */
+    for (i = 1; i < n - 1; i += 2) {
+        e = EduOM_DestroyObject(&catEntry, &oids[i], &dlPool, &dlHead);
+        if (e < eNOERROR) goto failed;
+    }
+
+    e = EduOM_GetCompactorStats(&before);
+    if (e < eNOERROR) goto failed;
+
+    /* the object is as long as the one which did not fit */
+    feature_Pattern(n + 1, FEATURE_COMPACT_LENGTH(n), buf);
+    e = EduOM_CreateObject(&catEntry, &oids[n-1], NULL, FEATURE_COMPACT_LENGTH(n), buf, &oids[n+1]);
+    if (e < eNOERROR) goto failed;
+
+    e = EduOM_GetCompactorStats(&middle);
+    if (e < eNOERROR) goto failed;
+
+    MAKE_PAGEID(pid, oids[0].volNo, oids[0].pageNo);
+    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) goto failed;
+
+    unused = apage->header.unused;
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) goto failed;
+
+    result = FEATURE_PASS;
+    if (oids[n+1].pageNo != oids[0].pageNo || middle.foreground != before.foreground + 1 || unused == 0) {
+        printf("  the insert went to page %ld with %lu compactions, leaving %ld bytes of holes\n",
+               (long)oids[n+1].pageNo, (unsigned long)(middle.foreground - before.foreground), (long)unused);
+        result = FEATURE_FAIL;
+    }
+
+    do {
+        e = EduOM_RunCompactor(NIL);
+        if (e < eNOERROR) goto failed;
+    } while (e > 0);
+
+    e = EduOM_GetCompactorStats(&after);
+    if (e < eNOERROR) goto failed;
+
+    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) goto failed;
+
+    unused = apage->header.unused;
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) goto failed;
+
+    if (result == FEATURE_PASS && (after.compacted == middle.compacted || unused != 0)) {
+        printf("  the compactor compacted %lu pages, leaving %ld bytes of holes\n",
+               (unsigned long)(after.compacted - middle.compacted), (long)unused);
+        result = FEATURE_FAIL;
+    }
+
+    for (i = 0; i <= n + 1 && result == FEATURE_PASS; i++) {
+        if (i % 2 == 1 && i < n - 1) continue;
+
+        length = FEATURE_COMPACT_LENGTH((i == n + 1) ? n : i);
+        feature_Pattern(i, length, buf);
+
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, data);
+        if (e < eNOERROR) goto failed;
+
+        if (e != length || memcmp(data, buf, length) != 0) {
+            printf("  object %ld differs after the compactions\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) goto failed;
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) goto failed;
+
+    e = EduOM_SetCompactorParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    EduOM_SetCompactorParams(&params);
+
+    ERR(e);
+
+} /* feature_TestCompactIncrementally() */
+
+
+
+/*@================================
+ * feature_CountHoles()
+ *================================*/
+/*
+ * Function: Four feature_CountHoles(TrainID*, Four)
+ *
+ * Description:
+ *  Count the pages which have holes('unused').
+ *
+ * Returns:
+ *  the number of pages with holes (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_CountHoles(
+    TrainID	*trains,	/* IN pages to look at */
+    Four	n)		/* IN the number of pages */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nHoles;		/* pages with holes */
+    SlottedPage	*apage;		/* buffer of a page */
+
+
+    for (i = 0, nHoles = 0; i < n; i++) {
+        e = BfM_GetTrain(&trains[i], (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        if (apage->header.unused > 0) nHoles++;
+
+        e = BfM_FreeTrain(&trains[i], PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(nHoles);
+
+} /* feature_CountHoles() */
+
+
+
+/*@================================
+ * feature_TestCompactorSweep()
+ *================================*/
+/*
+ * Function: Four feature_TestCompactorSweep(Four, char*)
+ *
+ * Description:
+ *  Leave holes in the pages of a file with the compactor disabled, so that
+ *  no page is queued, as if the holes were left by another process. Then
+ *  check that sweeps of one page each compact every page with holes
+ *  without the queue, resuming where the last one stopped(the last sweep,
+ *  which finds nothing, walks the file once more), and that the objects
+ *  left read back.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestCompactorSweep(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nTrains;	/* pages of the file */
+    Four	nHoles;		/* pages with holes before the sweeps */
+    Four	nLeft;		/* ... after them */
+    Four	nSweeps;	/* sweeps which compacted a page */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[FEATURE_OBJECTS]; /* objects of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	buf[100];	/* contents of an object */
+    char	data[100];	/* object read back */
+    EduOM_CompactorParams params;	/* parameters of the compactor before the test */
+    EduOM_CompactorParams testParams;	/* parameters of the compactor during the test */
+    EduOM_CompactorStats before;	/* statistics of the compactor before the sweeps */
+    EduOM_CompactorStats after;		/* ... after them */
+
+
+    e = EduOM_GetCompactorParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    testParams = params;
+    testParams.threshold = 0;
+
+    e = EduOM_SetCompactorParams(&testParams);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) goto failed;
+
+    for (i = 0; i < FEATURE_OBJECTS; i++) {
+        feature_Pattern(i, sizeof(buf), buf);
+
+        e = EduOM_CreateObject(&catEntry, (i == 0) ? NULL : &oids[i-1], NULL, sizeof(buf), buf, &oids[i]);
+        if (e < eNOERROR) goto failed;
+    }
+
+    /* every other object, but not the last one of a page */
+    for (i = 1; i < FEATURE_OBJECTS - 1; i += 2) {
+        if (oids[i+1].pageNo != oids[i].pageNo) continue;
+
+        e = EduOM_DestroyObject(&catEntry, &oids[i], &dlPool, &dlHead);
+        if (e < eNOERROR) goto failed;
+
+        oids[i].pageNo = NIL;
+    }
+
+    nTrains = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (nTrains < eNOERROR) { e = nTrains; goto failed; }
+
+    nHoles = feature_CountHoles(trains, nTrains);
+    if (nHoles < eNOERROR) { e = nHoles; goto failed; }
+
+    testParams.threshold = 1;
+
+    e = EduOM_SetCompactorParams(&testParams);
+    if (e < eNOERROR) goto failed;
+
+    e = EduOM_GetCompactorStats(&before);
+    if (e < eNOERROR) goto failed;
+
+    for (nSweeps = 0; nSweeps <= nTrains; nSweeps++) {
+        e = EduOM_SweepCompactor(&catEntry, 1);
+        if (e < eNOERROR) goto failed;
+        if (e == 0) break;
+    }
+
+    e = EduOM_GetCompactorStats(&after);
+    if (e < eNOERROR) goto failed;
+
+    nLeft = feature_CountHoles(trains, nTrains);
+    if (nLeft < eNOERROR) { e = nLeft; goto failed; }
+
+    result = FEATURE_PASS;
+    if (nHoles < 2 || nSweeps != nHoles || nLeft != 0 ||
+        after.compacted != before.compacted + nHoles || after.queued != before.queued ||
+        after.swept - before.swept > 2*nTrains) {
+        printf("  %ld sweeps walked %lu of %ld pages and compacted %lu of %ld pages with holes, leaving %ld\n",
+               (long)nSweeps, (unsigned long)(after.swept - before.swept), (long)nTrains,
+               (unsigned long)(after.compacted - before.compacted), (long)nHoles, (long)nLeft);
+        result = FEATURE_FAIL;
+    }
+
+    for (i = 0; i < FEATURE_OBJECTS && result == FEATURE_PASS; i++) {
+        if (oids[i].pageNo == NIL) continue;
+
+        feature_Pattern(i, sizeof(buf), buf);
+
+        e = EduOM_ReadObject(&oids[i], 0, REMAINDER, data);
+        if (e < eNOERROR) goto failed;
+
+        if (e != sizeof(buf) || memcmp(data, buf, sizeof(buf)) != 0) {
+            printf("  object %ld differs after the sweeps\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) goto failed;
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) goto failed;
+
+    e = EduOM_SetCompactorParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+failed:
+    EduOM_SetCompactorParams(&params);
+
+    ERR(e);
+
+} /* feature_TestCompactorSweep() */
+
+
+
+/*@================================
+ * feature_TestCompressedSideStore()
+ *================================*/
+/*
+ * Function: Four feature_TestCompressedSideStore(Four, char*)
+ *
+ * Description:
+ *  Write the same page of a file of compressed pages back many times, and
+ *  check that the side store of the device was compacted and stays within
+ *  twice the bytes of its live records and RDSM_LZ_COMPACT_MIN, and that
+ *  the objects of the file read back from the compacted store. Then open
+ *  a file which is no device with O_CREAT through the wrapper of cosmos.o,
+ *  and check that the file next to it named as its side store is kept.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestCompressedSideStore(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	fd;		/* file descriptor of the file which is no device */
+    Four	result;		/* result of the test */
+    double	live;		/* bytes of the live records of the side stores */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    char	buf[PAGESIZE];	/* contents of an object */
+    char	data[PAGESIZE];	/* object read back */
+    char	name[MAX_DEVICE_NAME];	/* file which is no device */
+    char	sideName[MAX_DEVICE_NAME + 8]; /* ... and its side store */
+    RDsM_CompressionStats before; /* counters before the writes */
+    RDsM_CompressionStats after;  /* counters after the writes */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetCompressedPages(&catEntry, TRUE);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 30, 100);
+    if (e < eNOERROR) ERR(e);
+
+    e = RDsM_GetCompressionStats(volId, &before);
+    if (e < eNOERROR) ERR(e);
+
+    /* every flush appends another copy of the page to the side store */
+    for (i = 0; i < 300; i++) {
+        feature_Pattern(1000 + i, 50, buf);
+
+        e = EduOM_CreateObject(&catEntry, NULL, NULL, 50, buf, &oid);
+        if (e < eNOERROR) ERR(e);
+
+        e = BfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+
+        e = EduOM_DestroyObject(&catEntry, &oid, &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+
+        e = BfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+    }
+
+    e = RDsM_GetCompressionStats(volId, &after);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    live = after.storedBytes + after.nStored * 16.0;     /* a record has a header of 16 bytes */
+    if (after.nCompactions == before.nCompactions || after.sideStoreBytes > 2*live + RDSM_LZ_COMPACT_MIN) {
+        printf("  %lu compactions, %.0f bytes in the side stores for %.0f bytes of live records\n",
+               (unsigned long)(after.nCompactions - before.nCompactions), after.sideStoreBytes, live);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(&catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; oid.pageNo != NIL && result == FEATURE_PASS; i++) {
+        feature_Pattern(i, 100, buf);
+
+        e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+
+        if (i >= 30 || e != 100 || memcmp(data, buf, 100) != 0) {
+            printf("  object %ld differs after the side store was compacted\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) { i++; break; }
+    }
+
+    if (result == FEATURE_PASS && i != 30) {
+        printf("  %ld of 30 objects read back\n", (long)i);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_SetCompressedPages(&catEntry, FALSE);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    /* a file which is no device is opened as it is */
+    sprintf(name, "%.200s.feature", devName);
+    sprintf(sideName, "%s.lz", name);
+
+    fd = open(sideName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || write(fd, "not a side store", 16) != 16) ERR(eWRITEFAIL_RDSM);
+    close(fd);
+
+    fd = __wrap_open64(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) ERR(eWRITEFAIL_RDSM);
+    __wrap_close(fd);
+
+    if (result == FEATURE_PASS && access(sideName, F_OK) != 0) {
+        printf("  %s was removed by the open of %s\n", sideName, name);
+        result = FEATURE_FAIL;
+    }
+
+    unlink(name);
+    unlink(sideName);
+
+    return(result);
+
+} /* feature_TestCompressedSideStore() */
+
+
+
+/*@================================
+ * feature_TestCompressedWriter()
+ *================================*/
+/*
+ * Function: Four feature_TestCompressedWriter(Four, char*)
+ *
+ * Description:
+ *  Let the background writer take a checkpoint through the asynchronous
+ *  I/O attached to the volume while a file given compressed pages has
+ *  dirty pages never written before, and check that each of them was
+ *  written through the compression instead of by the asynchronous I/O.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestCompressedWriter(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	n;		/* the number of pages of the file */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    BfM_WriterParams params;	/* tunables of the writer */
+    BfM_WriterParams noWriter;	/* tunables which keep the writer from running */
+    RDsM_CompressionStats before; /* counters before the checkpoint */
+    RDsM_CompressionStats after;  /* counters after the checkpoint */
+
+
+    e = BfM_GetWriterParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    noWriter = params;
+    noWriter.trickleInterval = noWriter.checkpointInterval = 0;
+
+    e = BfM_SetWriterParams(&noWriter);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_SetCompressedPages(&catEntry, TRUE);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, 400, 100);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    n = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (n < eNOERROR) ERR(n);
+
+    e = RDsM_GetCompressionStats(volId, &before);
+    if (e < eNOERROR) ERR(e);
+
+    e = RDsM_AttachAsyncIO(volId, devName, FEATURE_AIO_DEPTH, 0);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_RunWriter(TRUE);
+
+    RDsM_DetachAsyncIO(volId);
+
+    if (e < eNOERROR) ERR(e);
+
+    e = RDsM_GetCompressionStats(volId, &after);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    if ((after.nCompressed - before.nCompressed) + (after.nIncompressible - before.nIncompressible) < n) {
+        printf("  %lu of the %ld pages of the file went through the compression\n",
+               (unsigned long)((after.nCompressed - before.nCompressed) +
+                               (after.nIncompressible - before.nIncompressible)), (long)n);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_SetCompressedPages(&catEntry, FALSE);
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_SetWriterParams(&params);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestCompressedWriter() */
+
+
+
+/*@================================
+ * feature_MarkFirstPage()
+ *================================*/
+/*
+ * Function: Four feature_MarkFirstPage(ObjectID*, Four, PageID*)
+ *
+ * Description:
+ *  Make the first page of the empty file a page of the layout by hand, as
+ *  another process giving the file the layout would have left it, without
+ *  telling this process about the file.
+ *
+ * Returns:
+ *  length of an object of the layout (values greater than 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_MarkFirstPage(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    Four	layout,		/* IN EDUOM_XXX_LAYOUT */
+    PageID	*pid)		/* OUT first page of the file */
+{
+    Four	e;		/* error number */
+    Four	length;		/* length of an object of the layout */
+    EduOM_PaxSchema schema;	/* schema of a PAX file */
+    SlottedPage	*apage;		/* buffer of the first page */
+    SlottedPage	*catPage;	/* buffer of the catalog object */
+    sm_CatOverlayForData *overlay; /* catalog information of the file */
+
+
+    e = BfM_GetTrain((TrainID *)catEntry, (char **)&catPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catEntry, catPage, overlay);
+
+    MAKE_PAGEID(*pid, overlay->fid.volNo, overlay->firstPage);
+    e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catEntry, PAGE_BUF);
+
+    om_RemoveFromAvailSpaceList(catEntry, pid, apage);
+    apage->header.nSlots = 0;
+    apage->header.free = 0;
+    apage->header.unused = 0;
+
+    switch (layout) {
+      case EDUOM_PAX_LAYOUT:
+        memset(&schema, 0, sizeof(EduOM_PaxSchema));
+        schema.nFields = 3;
+        schema.width[0] = 4;
+        schema.width[1] = 8;
+        schema.width[2] = 20;
+        eduom_FormatPaxPage(apage, &schema);
+        length = 32;
+        break;
+
+      case EDUOM_FIXED_LAYOUT:
+        eduom_FormatFixedPage(apage, 40);
+        length = 40;
+        break;
+
+      case EDUOM_SMALL_LAYOUT:
+        e = eduom_FormatSmallPage(apage, pid);
+        if (e < eNOERROR) ERRB1(e, (TrainID *)pid, PAGE_BUF);
+        length = 16;
+        break;
+
+      case EDUOM_PREFIX_LAYOUT:
+        eduom_FormatPrefixPage(apage, 0, NULL);
+        length = 100;
+        break;
+
+      case EDUOM_SOA_LAYOUT:
+        apage->header.reserved = EDUOM_SOA_PAGE;
+        length = 50;
+        break;
+    }
+
+    e = BfM_SetDirty((TrainID *)pid, PAGE_BUF);
+    if (e >= eNOERROR) e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e >= eNOERROR) e = BfM_FreeTrain((TrainID *)catEntry, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(length);
+
+} /* feature_MarkFirstPage() */
+
+
+
+/*@================================
+ * feature_TestLayoutFromFirstPage()
+ *================================*/
+/*
+ * Function: Four feature_TestLayoutFromFirstPage(Four, char*)
+ *
+ * Description:
+ *  For each layout, make the first page of a new file a page of the layout
+ *  behind the back of the process(see feature_MarkFirstPage()), as after
+ *  the volume is mounted again, and check that an object created in the
+ *  file is put into that page, which keeps its layout, and is read back.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestLayoutFromFirstPage(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	length;		/* length of the object */
+    Four	result;		/* result of the test */
+    Four	reserved;	/* marker of the first page after the create */
+    FileID	fid;		/* file of the test */
+    PageID	pid;		/* first page of the file */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* object created */
+    SlottedPage	*apage;		/* buffer of the first page */
+    char	buf[PAGESIZE];	/* contents of the object */
+    char	data[PAGESIZE];	/* object read back */
+    static struct {
+        Four	layout;		/* EDUOM_XXX_LAYOUT */
+        Four	marker;		/* marker of a page of the layout */
+        char	*name;		/* name of the layout */
+    } layouts[] = {
+        { EDUOM_PAX_LAYOUT,	EDUOM_PAX_PAGE,		"PAX" },
+        { EDUOM_FIXED_LAYOUT,	EDUOM_FIXED_PAGE,	"fixed length" },
+        { EDUOM_SMALL_LAYOUT,	EDUOM_SMALL_PAGE,	"small" },
+        { EDUOM_PREFIX_LAYOUT,	EDUOM_PREFIX_PAGE,	"prefix" },
+        { EDUOM_SOA_LAYOUT,	EDUOM_SOA_PAGE,		"SoA" }
+    };
+
+
+    for (i = 0, result = FEATURE_PASS; i < sizeof(layouts)/sizeof(layouts[0]) && result == FEATURE_PASS; i++) {
+        e = feature_CreateFile(volId, &fid, &catEntry);
+        if (e < eNOERROR) ERR(e);
+
+        length = feature_MarkFirstPage(&catEntry, layouts[i].layout, &pid);
+        if (length < eNOERROR) ERR(length);
+
+        feature_Pattern(i, length, buf);
+        e = EduOM_CreateObject(&catEntry, NULL, NULL, length, buf, &oid);
+        if (e < eNOERROR) ERR(e);
+
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        reserved = apage->header.reserved;
+
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < eNOERROR) ERR(e);
+
+        e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo != pid.pageNo || reserved != layouts[i].marker) {
+            printf("  the %s object went to page %ld, not to the first page %ld of the layout\n",
+                   layouts[i].name, (long)oid.pageNo, (long)pid.pageNo);
+            result = FEATURE_FAIL;
+        }
+        else if (e != length || memcmp(data, buf, length) != 0) {
+            printf("  the %s object differs\n", layouts[i].name);
+            result = FEATURE_FAIL;
+        }
+
+        e = EduOM_ReleaseActiveInsertPages();
+        if (e < eNOERROR) ERR(e);
+
+        e = SM_DestroyFile(&fid, NULL);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(result);
+
+} /* feature_TestLayoutFromFirstPage() */
+
+
+
+/*@================================
+ * feature_InAvailSpaceList()
+ *================================*/
+/*
+ * Function: Four feature_InAvailSpaceList(ObjectID*, PageID*)
+ *
+ * Description:
+ *  Tell whether the page is in an available space list of the file: it
+ *  has a neighbor in a list or heads one.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_InAvailSpaceList(
+    ObjectID	*catEntry,	/* IN catalog entry of the file */
+    PageID	*pid)		/* IN page to look for */
+{
+    Four	e;		/* error number */
+    Four	inList;		/* is the page in a list? */
+    SlottedPage	*apage;		/* buffer of the page */
+    SlottedPage	*catPage;	/* buffer of the catalog object */
+    sm_CatOverlayForData *overlay; /* catalog information of the file */
+
+
+    e = BfM_GetTrain((TrainID *)catEntry, (char **)&catPage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catEntry, catPage, overlay);
+
+    e = BfM_GetTrain((TrainID *)pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)catEntry, PAGE_BUF);
+
+    inList = (apage->header.spaceListPrev != NIL || apage->header.spaceListNext != NIL ||
+              pid->pageNo == overlay->availSpaceList10 || pid->pageNo == overlay->availSpaceList20 ||
+              pid->pageNo == overlay->availSpaceList30 || pid->pageNo == overlay->availSpaceList40 ||
+              pid->pageNo == overlay->availSpaceList50);
+
+    e = BfM_FreeTrain((TrainID *)pid, PAGE_BUF);
+    if (e >= eNOERROR) e = BfM_FreeTrain((TrainID *)catEntry, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    return(inList ? TRUE : FALSE);
+
+} /* feature_InAvailSpaceList() */
+
+
+
+/*@================================
+ * feature_CreateInThread()
+ *================================*/
+/*
+ * Function: void *feature_CreateInThread(void*)
+ *
+ * Description:
+ *  Create an object in the file near no object and exit without
+ *  EduOM_ReleaseActiveInsertPages().
+ *
+ * Returns:
+ *  NULL
+ */
+static void *feature_CreateInThread(
+    void	*arg)		/* INOUT feature_Creator */
+{
+    feature_Creator *creator = (feature_Creator *)arg; /* object to create */
+    char	buf[100];	/* contents of the object */
+
+
+    feature_Pattern(0, sizeof(buf), buf);
+    creator->e = EduOM_CreateObject(creator->catEntry, NULL, NULL, sizeof(buf), buf, &creator->oid);
+
+    return(NULL);
+
+} /* feature_CreateInThread() */
+
+
+
+/*@================================
+ * feature_TestActiveInsertPages()
+ *================================*/
+/*
+ * Function: Four feature_TestActiveInsertPages(Four, char*)
+ *
+ * Description:
+ *  Check that an object created near no object claims its page as the
+ *  active insert page of the thread, which is then in no available space
+ *  list; that destroying an object of the page disowns it and that
+ *  EduOM_ReleaseActiveInsertPages() puts it back into a list. Then let
+ *  another thread claim the page and exit, and check that the next create
+ *  of this thread finds the page again; and disown the page behind the
+ *  back of the process, as if the process exited, and check that
+ *  EduOM_RecoverActiveInsertPages() puts it back into a list. Finally,
+ *  check that the page left by a thread in a file destroyed afterwards is
+ *  not put back.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestActiveInsertPages(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	owner;		/* owner of the page */
+    Four	inList;		/* is the page in an available space list? */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    PageID	pid;		/* page of the objects */
+    PageID	activePid;	/* active insert page of the thread */
+    PageID	otherPid;	/* page left by a thread in the file destroyed */
+    FileID	otherFid;	/* file destroyed after a thread left a page */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	otherCatEntry;	/* catalog entry of the file destroyed */
+    ObjectID	oid;		/* object created */
+    pthread_t	thread;		/* thread creating an object */
+    feature_Creator creator;	/* object created by the thread */
+    char	buf[100];	/* contents of an object */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    feature_Pattern(0, sizeof(buf), buf);
+
+    /* claim */
+    e = EduOM_CreateObject(&catEntry, NULL, NULL, sizeof(buf), buf, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(pid, oid.volNo, oid.pageNo);
+    owner = eduom_GetActiveInsertPageOwner(&pid);
+    inList = feature_InAvailSpaceList(&catEntry, &pid);
+    if (inList < eNOERROR) ERR(inList);
+
+    if (owner != ACTIVE_INSERT_PAGE_SELF || inList ||
+        !eduom_LookUpActiveInsertPage(&fid, &activePid) || !EQUAL_PAGEID(activePid, pid)) {
+        printf("  the page of the first object is not claimed(owner %ld, in a list %ld)\n", (long)owner, (long)inList);
+        result = FEATURE_FAIL;
+    }
+
+    /* disown */
+    e = EduOM_DestroyObject(&catEntry, &oid, &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    owner = eduom_GetActiveInsertPageOwner(&pid);
+    inList = feature_InAvailSpaceList(&catEntry, &pid);
+    if (inList < eNOERROR) ERR(inList);
+
+    if (result == FEATURE_PASS && (owner != ACTIVE_INSERT_PAGE_NONE || !inList)) {
+        printf("  the page is not disowned by the destroy(owner %ld, in a list %ld)\n", (long)owner, (long)inList);
+        result = FEATURE_FAIL;
+    }
+
+    /* release */
+    e = EduOM_CreateObject(&catEntry, NULL, NULL, sizeof(buf), buf, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    owner = eduom_GetActiveInsertPageOwner(&pid);
+    inList = feature_InAvailSpaceList(&catEntry, &pid);
+    if (inList < eNOERROR) ERR(inList);
+
+    if (result == FEATURE_PASS && (oid.pageNo != pid.pageNo || owner != ACTIVE_INSERT_PAGE_NONE || !inList)) {
+        printf("  the page is not released(page %ld, owner %ld, in a list %ld)\n",
+               (long)oid.pageNo, (long)owner, (long)inList);
+        result = FEATURE_FAIL;
+    }
+
+    /* a thread which exits without the release */
+    creator.catEntry = &catEntry;
+    if (pthread_create(&thread, NULL, feature_CreateInThread, &creator) != 0) ERR(eMEMORYALLOCERR);
+    pthread_join(thread, NULL);
+    if (creator.e < eNOERROR) ERR(creator.e);
+
+    owner = eduom_GetActiveInsertPageOwner(&pid);
+
+    e = EduOM_CreateObject(&catEntry, NULL, NULL, sizeof(buf), buf, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    if (result == FEATURE_PASS &&
+        (creator.oid.pageNo != pid.pageNo || owner != ACTIVE_INSERT_PAGE_OTHERS || oid.pageNo != pid.pageNo)) {
+        printf("  the page left by the thread is not found again(pages %ld and %ld of %ld, owner %ld)\n",
+               (long)creator.oid.pageNo, (long)oid.pageNo, (long)pid.pageNo, (long)owner);
+        result = FEATURE_FAIL;
+    }
+
+    /* a process which exits without the release */
+    eduom_DisownActiveInsertPage(&pid);
+
+    e = EduOM_RecoverActiveInsertPages(&catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    inList = feature_InAvailSpaceList(&catEntry, &pid);
+    if (inList < eNOERROR) ERR(inList);
+
+    if (result == FEATURE_PASS && !inList) {
+        printf("  the page left by the process is not recovered\n");
+        result = FEATURE_FAIL;
+    }
+
+    /* a thread which exits without the release, and then its file is destroyed */
+    e = feature_CreateFile(volId, &otherFid, &otherCatEntry);
+    if (e < eNOERROR) ERR(e);
+
+    creator.catEntry = &otherCatEntry;
+    if (pthread_create(&thread, NULL, feature_CreateInThread, &creator) != 0) ERR(eMEMORYALLOCERR);
+    pthread_join(thread, NULL);
+    if (creator.e < eNOERROR) ERR(creator.e);
+
+    e = SM_DestroyFile(&otherFid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_CreateObject(&catEntry, NULL, NULL, sizeof(buf), buf, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(otherPid, creator.oid.volNo, creator.oid.pageNo);
+    owner = eduom_GetActiveInsertPageOwner(&otherPid);
+
+    if (result == FEATURE_PASS && owner != ACTIVE_INSERT_PAGE_OTHERS) {
+        printf("  the page left by a thread in a destroyed file is put back(owner %ld)\n", (long)owner);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestActiveInsertPages() */
+
+
+
+/*@================================
+ * feature_TestOptimisticRead()
+ *================================*/
+/*
+ * Function: Four feature_TestOptimisticRead(Four, char*)
+ *
+ * Description:
+ *  Read an object of a page in the buffer pool, and check that the read is
+ *  counted as an optimistic hit and returns the object; that a read while
+ *  a writer has the frame falls back to fixing the page; that reads past
+ *  the end of the object and of negative lengths fail as before; and that
+ *  a version taken before the page is read back into the buffer pool does
+ *  not validate.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestOptimisticRead(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	n;		/* bytes read */
+    Four	pastEnd;	/* result of a read past the end of the object */
+    Four	negative;	/* result of a read of a negative length */
+    Four	result;		/* result of the test */
+    UFour	version;	/* version of the frame of the page */
+    UFour	newVersion;	/* ... after the page is read back */
+    Boolean	valid;		/* did the old version validate after the miss? */
+    FileID	fid;		/* file of the test */
+    PageID	pid;		/* page of the object */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* object read */
+    BfM_Stats	before;		/* statistics of the buffer manager before a read */
+    BfM_Stats	after;		/* ... after it */
+    char	*frame;		/* frame holding the page */
+    char	*apage;		/* buffer of the page fixed */
+    char	buf[100];	/* contents of the object */
+    char	data[100];	/* object read back */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    feature_Pattern(0, sizeof(buf), buf);
+
+    e = EduOM_CreateObject(&catEntry, NULL, NULL, sizeof(buf), buf, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    MAKE_PAGEID(pid, oid.volNo, oid.pageNo);
+
+    /* a read of the page in the buffer pool */
+    e = BfM_GetStats(&before);
+    if (e < eNOERROR) ERR(e);
+
+    n = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+    if (n < eNOERROR) ERR(n);
+
+    e = BfM_GetStats(&after);
+    if (e < eNOERROR) ERR(e);
+
+    if (n != sizeof(buf) || memcmp(data, buf, sizeof(buf)) != 0 ||
+        after.caller[BFM_CALLER_READ].optimisticHits != before.caller[BFM_CALLER_READ].optimisticHits + 1 ||
+        after.caller[BFM_CALLER_READ].misses != before.caller[BFM_CALLER_READ].misses) {
+        printf("  the read of %ld bytes made %lu optimistic hits and %lu misses\n", (long)n,
+               (unsigned long)(after.caller[BFM_CALLER_READ].optimisticHits - before.caller[BFM_CALLER_READ].optimisticHits),
+               (unsigned long)(after.caller[BFM_CALLER_READ].misses - before.caller[BFM_CALLER_READ].misses));
+        result = FEATURE_FAIL;
+    }
+
+    /* a read while a writer has the frame */
+    e = BfM_GetTrain((TrainID *)&pid, &apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_BeginFrameWrite((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+    before = after;
+    n = EduOM_ReadObject(&oid, 10, 20, data);
+    if (n < eNOERROR) ERRB1(n, (TrainID *)&pid, PAGE_BUF);
+
+    e = BfM_GetStats(&after);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+    if (result == FEATURE_PASS &&
+        (n != 20 || memcmp(data, buf + 10, 20) != 0 ||
+         after.caller[BFM_CALLER_READ].optimisticHits != before.caller[BFM_CALLER_READ].optimisticHits)) {
+        printf("  the read during a write returned %ld bytes with %lu optimistic hits\n", (long)n,
+               (unsigned long)(after.caller[BFM_CALLER_READ].optimisticHits - before.caller[BFM_CALLER_READ].optimisticHits));
+        result = FEATURE_FAIL;
+    }
+
+    e = BfM_EndFrameWrite((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, (TrainID *)&pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    /* reads out of the object */
+    pastEnd = EduOM_ReadObject(&oid, 90, 20, data);
+    negative = EduOM_ReadObject(&oid, 0, -2, data);
+
+    if (result == FEATURE_PASS && (pastEnd != eBADLENGTH_OM || negative != eBADLENGTH_OM)) {
+        printf("  the reads out of the object returned %ld and %ld\n", (long)pastEnd, (long)negative);
+        result = FEATURE_FAIL;
+    }
+
+    /* a version taken before the page is read back */
+    frame = BfM_LookUpFrame((TrainID *)&pid, PAGE_BUF, &version);
+    if (frame == NULL) ERR(eNOTFOUND_BFM);
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    /* the miss replaces the frame which held the page, as if it had gone
+       through the other trains meanwhile */
+    BI_NEXTVICTIM(PAGE_BUF) = (frame - BI_BUFFERPOOL(PAGE_BUF)) / (BI_BUFSIZE(PAGE_BUF)*PAGESIZE);
+
+    /* the test module calls the buffer manager of cosmos.o directly, so the
+       page is read back through the object manager */
+    n = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+    if (n < eNOERROR) ERR(n);
+
+    apage = BfM_LookUpFrame((TrainID *)&pid, PAGE_BUF, &newVersion);
+    valid = BfM_ValidateFrame((TrainID *)&pid, PAGE_BUF, frame, version);
+
+    if (result == FEATURE_PASS && (apage != frame || valid)) {
+        printf("  the page was read back into %s frame, where the old version %s\n",
+               (apage == frame) ? "the same" : "another", valid ? "validated" : "did not validate");
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestOptimisticRead() */
+
+
+
+/*@================================
+ * feature_TestBufferArena()
+ *================================*/
+/*
+ * Function: Four feature_TestBufferArena(Four, char*)
+ *
+ * Description:
+ *  Move the buffer pools into each mode of memory, and check that the mode
+ *  set up is the one asked or one it falls back to, with the fallbacks
+ *  counted, that the buffer pools are aligned as the mode promises, and
+ *  that the objects of a file read back from the moved trains. Without
+ *  huge pages reserved, BFM_ARENA_HUGETLB falls back. In each mode,
+ *  finalize the buffer manager in a child process, which frees the buffer
+ *  pools through the wrapper of cosmos.o, and check that it exits normally
+ *  in the mode of BFM_ARENA_MALLOC.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestBufferArena(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i, j;		/* index variables */
+    Four	type;		/* buffer type */
+    Four	mode;		/* mode set up */
+    Four	result;		/* result of the test */
+    UFour	align;		/* alignment of the buffer pools in the mode */
+    int		status;		/* exit status of the child process */
+    pid_t	child;		/* process finalizing the buffer manager */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oids[FEATURE_OBJECTS]; /* objects of the file */
+    BfM_ArenaStats before;	/* statistics of the buffer pool memory before a mode is set up */
+    BfM_ArenaStats after;	/* ... after it */
+    char	buf[100];	/* contents of an object */
+    char	data[100];	/* object read back */
+    static struct {
+        Four	mode;		/* BFM_ARENA_XXX */
+        char	*name;		/* name of the mode */
+    } modes[] = {
+        { BFM_ARENA_HUGETLB,	"hugetlb" },
+        { BFM_ARENA_THP,	"thp" },
+        { BFM_ARENA_HEAP,	"heap" }
+    };
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; i < FEATURE_OBJECTS; i++) {
+        feature_Pattern(i, sizeof(buf), buf);
+
+        e = EduOM_CreateObject(&catEntry, (i == 0) ? NULL : &oids[i-1], NULL, sizeof(buf), buf, &oids[i]);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    for (i = 0, result = FEATURE_PASS; i < sizeof(modes)/sizeof(modes[0]) && result == FEATURE_PASS; i++) {
+        e = BfM_GetBufferArenaStats(&before);
+        if (e < eNOERROR) ERR(e);
+
+        mode = BfM_SetUpBufferArena(modes[i].mode);
+        if (mode < eNOERROR) ERR(mode);
+
+        e = BfM_GetBufferArenaStats(&after);
+        if (e < eNOERROR) ERR(e);
+
+        /* each mode falls back to the next one, down to BFM_ARENA_HEAP */
+        if (mode > modes[i].mode || mode < BFM_ARENA_HEAP || after.mode != mode ||
+            after.fallbacks != before.fallbacks + (modes[i].mode - mode)) {
+            printf("  %s set up mode %ld with %lu fallbacks\n", modes[i].name, (long)mode,
+                   (unsigned long)(after.fallbacks - before.fallbacks));
+            result = FEATURE_FAIL;
+            break;
+        }
+
+        align = (mode == BFM_ARENA_HEAP) ? PAGESIZE : BFM_HUGE_PAGE_SIZE;
+        for (type = 0; type < NUM_BUF_TYPES; type++)
+            if ((unsigned long)BI_BUFFERPOOL(type) % align != 0) {
+                printf("  the buffer pool %ld of %s is not aligned to %lu bytes\n",
+                       (long)type, modes[i].name, (unsigned long)align);
+                result = FEATURE_FAIL;
+            }
+
+        for (j = 0; j < FEATURE_OBJECTS && result == FEATURE_PASS; j++) {
+            feature_Pattern(j, sizeof(buf), buf);
+
+            e = EduOM_ReadObject(&oids[j], 0, REMAINDER, data);
+            if (e < eNOERROR) ERR(e);
+
+            if (e != sizeof(buf) || memcmp(data, buf, sizeof(buf)) != 0) {
+                printf("  object %ld differs in %s\n", (long)j, modes[i].name);
+                result = FEATURE_FAIL;
+            }
+        }
+
+        if (result != FEATURE_PASS) break;
+
+        /* nothing is left to write by the finalization in the child */
+        e = BfM_FlushAll();
+        if (e < eNOERROR) ERR(e);
+
+        fflush(stdout);
+
+        child = fork();
+        if (child < 0) ERR(eMEMORYALLOCERR);
+
+        if (child == 0) {
+            e = BfM_Final();
+            if (e >= eNOERROR) e = BfM_GetBufferArenaStats(&after);
+            _exit((e >= eNOERROR && after.mode == BFM_ARENA_MALLOC) ? 0 : 1);
+        }
+
+        if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            printf("  the finalization in %s %s %d\n", modes[i].name,
+                   WIFEXITED(status) ? "exited with" : "was killed by signal",
+                   WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+            result = FEATURE_FAIL;
+        }
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestBufferArena() */
+
+
+
+/*@================================
+ * feature_CountResident()
+ *================================*/
+/*
+ * Function: Four feature_CountResident(TrainID*, Four)
+ *
+ * Description:
+ *  Count the trains which are in the PAGE_BUF buffer pool.
+ *
+ * Returns:
+ *  the number of trains resident (values greater than or equal to 0)
+ */
+static Four feature_CountResident(
+    TrainID	*trains,	/* IN trains to look for */
+    Four	n)		/* IN the number of trains */
+{
+    Four	i;		/* index variable */
+    Four	nResident;	/* trains resident */
+
+
+    for (i = 0, nResident = 0; i < n; i++)
+        if (bfm_LookUp((BfMHashKey *)&trains[i], PAGE_BUF) >= 0) nResident++;
+
+    return(nResident);
+
+} /* feature_CountResident() */
+
+
+
+/*@================================
+ * feature_TestWarmStart()
+ *================================*/
+/*
+ * Function: Four feature_TestWarmStart(Four, char*)
+ *
+ * Description:
+ *  Save the trains resident in the buffer pool, empty the buffer pool as
+ *  after the volume is mounted again, and check that loading the list
+ *  makes every train of a file resident again, that a second load reads
+ *  nothing, that a missing list loads nothing, and that the objects read
+ *  back.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestWarmStart(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nTrains;	/* pages of the file */
+    Four	nSaved;		/* trains saved */
+    Four	nLoaded;	/* trains read by the first load */
+    Four	nAgain;		/* ... by the second one */
+    Four	nMissing;	/* ... by the load of a missing list */
+    Four	nDiscarded;	/* trains of the file resident after the discard */
+    Four	nResident;	/* ... after the load */
+    Four	result;		/* result of the test */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    char	buf[100];	/* contents of an object */
+    char	data[100];	/* object read back */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, FEATURE_OBJECTS, sizeof(buf));
+    if (e < eNOERROR) ERR(e);
+
+    nTrains = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (nTrains < eNOERROR) ERR(nTrains);
+
+    e = BfM_FlushAll();
+    if (e < eNOERROR) ERR(e);
+
+    nSaved = BfM_SaveResidentTrains(fid.volNo, FEATURE_HOT_FILE);
+    if (nSaved < eNOERROR) ERR(nSaved);
+
+    e = BfM_DiscardAll();
+    if (e < eNOERROR) ERR(e);
+
+    nDiscarded = feature_CountResident(trains, nTrains);
+
+    nLoaded = BfM_LoadResidentTrains(fid.volNo, FEATURE_HOT_FILE, 0);
+    if (nLoaded < eNOERROR) ERR(nLoaded);
+
+    nResident = feature_CountResident(trains, nTrains);
+
+    nAgain = BfM_LoadResidentTrains(fid.volNo, FEATURE_HOT_FILE, 0);
+    if (nAgain < eNOERROR) ERR(nAgain);
+
+    remove(FEATURE_HOT_FILE);
+
+    nMissing = BfM_LoadResidentTrains(fid.volNo, FEATURE_HOT_FILE, 0);
+    if (nMissing < eNOERROR) ERR(nMissing);
+
+    result = FEATURE_PASS;
+    if (nTrains < 2 || nSaved < nTrains || nDiscarded != 0 || nLoaded != nSaved ||
+        nResident != nTrains || nAgain != 0 || nMissing != 0) {
+        printf("  %ld trains saved, %ld of %ld left by the discard, %ld loaded making %ld resident, then %ld and %ld loaded\n",
+               (long)nSaved, (long)nDiscarded, (long)nTrains, (long)nLoaded, (long)nResident,
+               (long)nAgain, (long)nMissing);
+        result = FEATURE_FAIL;
+    }
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(&catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0; oid.pageNo != NIL && i < FEATURE_OBJECTS && result == FEATURE_PASS; i++) {
+        feature_Pattern(i, sizeof(buf), buf);
+
+        e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+
+        if (e != sizeof(buf) || memcmp(data, buf, sizeof(buf)) != 0) {
+            printf("  object %ld differs after the warm start\n", (long)i);
+            result = FEATURE_FAIL;
+        }
+
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) break;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestWarmStart() */
+
+
+
+/*@================================
+ * feature_CheckApiStats()
+ *================================*/
+/*
+ * Function: Four feature_CheckApiStats(EduOM_ApiStats*, char*, UFour)
+ *
+ * Description:
+ *  Check that the statistics of an interface function counted the calls
+ *  made, and that its histogram and percentiles agree with the count and
+ *  the longest call.
+ *
+ * Returns:
+ *  TRUE if the statistics are consistent, FALSE otherwise
+ */
+static Four feature_CheckApiStats(
+    EduOM_ApiStats *s,		/* IN statistics of the interface function */
+    char	*name,		/* IN name of the interface function */
+    UFour	nCalls)		/* IN the number of calls made */
+{
+    Four	b;		/* index of a bucket */
+    UFour	nCounted;	/* calls in the histogram */
+    double	p50;		/* median latency */
+    double	p99;		/* 99th percentile latency */
+
+
+    for (b = 0, nCounted = 0; b < EDUOM_LATENCY_BUCKETS; b++) nCounted += s->hist[b];
+
+    EduOM_GetLatencyPercentile(s, 50, &p50);
+    EduOM_GetLatencyPercentile(s, 99, &p99);
+
+    if (s->count != nCalls || nCounted != nCalls || s->totalTime <= 0 || s->maxTime <= 0 ||
+        p50 <= 0 || p50 > p99 || p99 > s->maxTime || s->maxTime > s->totalTime) {
+        printf("  %s: %lu of %lu calls counted, %lu in the histogram, total %.0f max %.0f p50 %.0f p99 %.0f nsec\n",
+               name, (unsigned long)s->count, (unsigned long)nCalls, (unsigned long)nCounted,
+               s->totalTime, s->maxTime, p50, p99);
+        return(FALSE);
+    }
+
+    return(TRUE);
+
+} /* feature_CheckApiStats() */
+
+
+
+/*@================================
+ * feature_TestApiStats()
+ *================================*/
+/*
+ * Function: Four feature_TestApiStats(Four, char*)
+ *
+ * Description:
+ *  Reset the statistics, call each interface function a known number of
+ *  times, one create in another thread, and check that every call and
+ *  every choice of the page of a new object is counted, that the
+ *  histograms agree with the counts, and that a reset clears them all.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestApiStats(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nNext;		/* calls of EduOM_NextObject() */
+    Four	nPrev;		/* calls of EduOM_PrevObject() */
+    Four	nRead;		/* calls of EduOM_ReadObject() */
+    Four	nDestroy;	/* calls of EduOM_DestroyObject() */
+    UFour	nBranches;	/* pages chosen for the new objects */
+    UFour	nLeft;		/* counts left by the reset */
+    Four	result;		/* result of the test */
+    PageID	pid;		/* page compacted */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    ObjectID	first;		/* first object of the file */
+    SlottedPage	*apage;		/* buffer of the page */
+    pthread_t	thread;		/* thread creating an object */
+    feature_Creator creator;	/* object created by the thread */
+    EduOM_Stats	stats;		/* statistics of the object manager */
+    char	data[100];	/* object read */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_ResetStats();
+    if (e < eNOERROR) ERR(e);
+
+    /* creates near the previous object, the first one near no object */
+    e = feature_FillFile(&catEntry, 0, FEATURE_OBJECTS, sizeof(data));
+    if (e < eNOERROR) ERR(e);
+
+    creator.catEntry = &catEntry;
+    if (pthread_create(&thread, NULL, feature_CreateInThread, &creator) != 0) ERR(eMEMORYALLOCERR);
+    pthread_join(thread, NULL);
+    if (creator.e < eNOERROR) ERR(creator.e);
+
+    /* a scan forward reading each object and one backward */
+    nNext = nPrev = nRead = 0;
+    oid.pageNo = NIL;
+    do {
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, (prev.pageNo == NIL) ? NULL : &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+        nNext++;
+
+        if (prev.pageNo == NIL) first = oid;
+        if (prev.pageNo != NIL && oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo) break;
+
+        e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+        if (e < eNOERROR) ERR(e);
+        nRead++;
+    } while (TRUE);
+
+    do {
+        prev = oid;
+        e = EduOM_PrevObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+        nPrev++;
+    } while (oid.pageNo != prev.pageNo || oid.slotNo != prev.slotNo);
+
+    /* destroy every other object of the first page and compact it */
+    nDestroy = 0;
+    for (oid = first; oid.pageNo == first.pageNo; ) {
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+        nNext++;
+
+        if (oid.pageNo != first.pageNo || (oid.pageNo == prev.pageNo && oid.slotNo == prev.slotNo)) break;
+
+        e = EduOM_DestroyObject(&catEntry, &prev, &dlPool, &dlHead);
+        if (e < eNOERROR) ERR(e);
+        nDestroy++;
+
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+        nNext++;
+    }
+
+    MAKE_PAGEID(pid, first.volNo, first.pageNo);
+    e = BfM_GetTrain(&pid, (char **)&apage, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_CompactPage(apage, NIL);
+    if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_SetDirty(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain(&pid, PAGE_BUF);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_GetStats(&stats);
+    if (e < eNOERROR) ERR(e);
+
+    result = FEATURE_PASS;
+    if (!feature_CheckApiStats(&stats.api[EDUOM_API_CREATE], "EduOM_CreateObject", FEATURE_OBJECTS + 1) ||
+        !feature_CheckApiStats(&stats.api[EDUOM_API_DESTROY], "EduOM_DestroyObject", nDestroy) ||
+        !feature_CheckApiStats(&stats.api[EDUOM_API_READ], "EduOM_ReadObject", nRead) ||
+        !feature_CheckApiStats(&stats.api[EDUOM_API_NEXT], "EduOM_NextObject", nNext) ||
+        !feature_CheckApiStats(&stats.api[EDUOM_API_PREV], "EduOM_PrevObject", nPrev) ||
+        !feature_CheckApiStats(&stats.api[EDUOM_API_COMPACT], "EduOM_CompactPage", 1))
+        result = FEATURE_FAIL;
+
+    /* a compaction is counted besides the page it made room in */
+    for (i = 0, nBranches = 0; i < EDUOM_NUM_BRANCHES; i++)
+        if (i != EDUOM_BRANCH_COMPACTION) nBranches += stats.createBranch[i];
+
+    if (result == FEATURE_PASS &&
+        (nBranches != FEATURE_OBJECTS + 1 || stats.createBranch[EDUOM_BRANCH_NEAR_PAGE] == 0 ||
+         stats.createBranch[EDUOM_BRANCH_NEW_PAGE] == 0)) {
+        printf("  %lu pages chosen for %ld creates, %lu near pages and %lu new pages\n",
+               (unsigned long)nBranches, (long)FEATURE_OBJECTS + 1,
+               (unsigned long)stats.createBranch[EDUOM_BRANCH_NEAR_PAGE],
+               (unsigned long)stats.createBranch[EDUOM_BRANCH_NEW_PAGE]);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ResetStats();
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_GetStats(&stats);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0, nLeft = 0; i < EDUOM_NUM_APIS; i++) nLeft += stats.api[i].count;
+    for (i = 0; i < EDUOM_NUM_BRANCHES; i++) nLeft += stats.createBranch[i];
+
+    if (result == FEATURE_PASS && nLeft != 0) {
+        printf("  %lu counts left by the reset\n", (unsigned long)nLeft);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestApiStats() */
+
+
+
+/*@================================
+ * feature_SumHist()
+ *================================*/
+/*
+ * Function: UFour feature_SumHist(UFour*, Four)
+ *
+ * Description:
+ *  Sum the buckets of a histogram of the space analyzer.
+ *
+ * Returns:
+ *  the sum of the buckets
+ */
+static UFour feature_SumHist(
+    UFour	*hist,		/* IN the histogram */
+    Four	nBuckets)	/* IN the number of buckets */
+{
+    Four	b;		/* index of a bucket */
+    UFour	sum;		/* sum of the buckets */
+
+
+    for (b = 0, sum = 0; b < nBuckets; b++) sum += hist[b];
+
+    return(sum);
+
+} /* feature_SumHist() */
+
+
+
+/*@================================
+ * feature_TestAnalyzeFile()
+ *================================*/
+/*
+ * Function: Four feature_TestAnalyzeFile(Four, char*)
+ *
+ * Description:
+ *  Fill a file with objects of one length, destroy every fourth one, and
+ *  check the numbers of EduOM_AnalyzeFile(): the objects, their data and
+ *  their length, the pages, the pages with holes and the pages in the
+ *  available space lists, that the objects, the slots and the free space
+ *  add up to the pages, that every histogram counts every page and that the
+ *  space amplification is the bytes of the pages over the data.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestAnalyzeFile(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nTrains;	/* pages of the file */
+    Four	nHoles;		/* pages with holes */
+    Four	nListed;	/* pages in the available space lists */
+    Four	inList;		/* is a page in an available space list? */
+    Four	nLive;		/* objects not destroyed */
+    Four	length;		/* length of an object */
+    Four	result;		/* result of the test */
+    double	pageBytes;	/* bytes of the pages but their headers */
+    double	amplification;	/* space amplification expected */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    TrainID	trains[FEATURE_MAX_TRAINS]; /* pages of the file */
+    EduOM_FileSpace space;	/* analysis of the file */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    /* 101 bytes fall in the bucket [64, 128) of the size histogram and are aligned up */
+    length = 101;
+    e = feature_FillFile(&catEntry, 0, FEATURE_OBJECTS, length);
+    if (e < eNOERROR) ERR(e);
+
+    oid.pageNo = NIL;
+    e = EduOM_NextObject(&catEntry, NULL, &oid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 0, nLive = 0; i < FEATURE_OBJECTS; i++) {
+        prev = oid;
+        e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        if (e < eNOERROR) ERR(e);
+
+        if (i % 4 == 1) {
+            e = EduOM_DestroyObject(&catEntry, &prev, &dlPool, &dlHead);
+            if (e < eNOERROR) ERR(e);
+        } else
+            nLive++;
+    }
+
+    nTrains = feature_CollectTrains(&catEntry, trains, FEATURE_MAX_TRAINS);
+    if (nTrains < eNOERROR) ERR(nTrains);
+
+    nHoles = feature_CountHoles(trains, nTrains);
+    if (nHoles < eNOERROR) ERR(nHoles);
+
+    for (i = 0, nListed = 0; i < nTrains; i++) {
+        inList = feature_InAvailSpaceList(&catEntry, &trains[i]);
+        if (inList < eNOERROR) ERR(inList);
+        if (inList) nListed++;
+    }
+
+    e = EduOM_AnalyzeFile(&catEntry, &space);
+    if (e < eNOERROR) ERR(e);
+    pageBytes = (double)space.nPages * (PAGESIZE - sizeof(SlottedPageHdr));
+    amplification = (double)space.nPages * PAGESIZE / ((double)nLive * length);
+
+    result = FEATURE_PASS;
+    if (space.nObjects != nLive || space.dataBytes != (double)nLive * length ||
+        space.objectBytes != (double)nLive * (sizeof(ObjectHdr) + ALIGNED_LENGTH(length)) ||
+        space.sizeHist[7] != nLive || feature_SumHist(space.sizeHist, EDUOM_SIZE_HIST_BUCKETS) != nLive) {
+        printf("  %ld of %ld objects with %.0f bytes of data in %.0f bytes, %lu of length [64, 128)\n",
+               (long)space.nObjects, (long)nLive, space.dataBytes, space.objectBytes,
+               (unsigned long)space.sizeHist[7]);
+        result = FEATURE_FAIL;
+    }
+
+    if (result == FEATURE_PASS &&
+        (space.nPages != nTrains || space.nPagesWithUnused != nHoles || nHoles == 0 ||
+         space.unusedBytes <= 0 || space.maxUnused <= 0 ||
+         space.nSlots != space.nObjects + space.nEmptySlots ||
+         space.freeBytes != space.cfreeBytes + space.unusedBytes ||
+         space.objectBytes + space.slotBytes + space.freeBytes != pageBytes)) {
+        printf("  %ld of %ld pages, %ld of %ld with holes, %ld slots, %ld empty, "
+               "%.0f object %.0f slot %.0f free bytes of %.0f\n",
+               (long)space.nPages, (long)nTrains, (long)space.nPagesWithUnused, (long)nHoles,
+               (long)space.nSlots, (long)space.nEmptySlots,
+               space.objectBytes, space.slotBytes, space.freeBytes, pageBytes);
+        result = FEATURE_FAIL;
+    }
+
+    if (result == FEATURE_PASS &&
+        (feature_SumHist(space.freeHist, EDUOM_SPACE_HIST_BUCKETS) != space.nPages ||
+         feature_SumHist(space.cfreeHist, EDUOM_SPACE_HIST_BUCKETS) != space.nPages ||
+         feature_SumHist(space.unusedHist, EDUOM_SPACE_HIST_BUCKETS) != space.nPages ||
+         feature_SumHist(space.bucketPages, EDUOM_NUM_SPACE_LISTS) != space.nPages ||
+         feature_SumHist(space.listPages, EDUOM_NUM_SPACE_LISTS) != space.nPages ||
+         space.unusedHist[0] + nHoles < space.nPages || space.misplacedPages != 0 ||
+         space.nPages - space.listPages[EDUOM_SPACE_LIST_NONE] != nListed ||
+         fabs(space.spaceAmplification - amplification) > 1e-9)) {
+        printf("  the histograms count %lu %lu %lu %lu %lu of %ld pages, %lu of %ld in the lists, %lu misplaced, amplification %f of %f\n",
+               (unsigned long)feature_SumHist(space.freeHist, EDUOM_SPACE_HIST_BUCKETS),
+               (unsigned long)feature_SumHist(space.cfreeHist, EDUOM_SPACE_HIST_BUCKETS),
+               (unsigned long)feature_SumHist(space.unusedHist, EDUOM_SPACE_HIST_BUCKETS),
+               (unsigned long)feature_SumHist(space.bucketPages, EDUOM_NUM_SPACE_LISTS),
+               (unsigned long)feature_SumHist(space.listPages, EDUOM_NUM_SPACE_LISTS),
+               (long)space.nPages, (unsigned long)(space.nPages - space.listPages[EDUOM_SPACE_LIST_NONE]),
+               (long)nListed, (unsigned long)space.misplacedPages,
+               space.spaceAmplification, amplification);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestAnalyzeFile() */
+
+
+
+/*@================================
+ * feature_DenyPerfEvents()
+ *================================*/
+/*
+ * Function: Four feature_DenyPerfEvents(void)
+ *
+ * Description:
+ *  Make perf_event_open() fail with EPERM in the calling process, as the
+ *  default seccomp profile of a container does.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ */
+static Four feature_DenyPerfEvents(void)
+{
+#ifdef __linux__
+    struct sock_filter filter[] = {
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(struct seccomp_data, nr)),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, __NR_perf_event_open, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ERRNO | (EPERM & SECCOMP_RET_DATA)),
+        BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW)
+    };
+    struct sock_fprog program = { sizeof(filter)/sizeof(filter[0]), filter };
+
+
+    if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0 ||
+        prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) != 0) ERR(eNOTSUPPORTED_EDUOM);
+
+    return(eNOERROR);
+#else
+    ERR(eNOTSUPPORTED_EDUOM);
+#endif
+
+} /* feature_DenyPerfEvents() */
+
+
+
+/*@================================
+ * feature_TestPerfFallback()
+ *================================*/
+/*
+ * Function: Four feature_TestPerfFallback(Four, char*)
+ *
+ * Description:
+ *  Check that the hardware counters degrade gracefully: in a child whose
+ *  perf_event_open() is denied, no counter opens, the reason is EPERM, the
+ *  objects still read back between the start and the stop of the counters
+ *  and every counter reads as unavailable; and in this process, whether
+ *  the counters open or not, only those opened read a value.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestPerfFallback(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nOpened;	/* counters opened */
+    Four	nRead;		/* counters which read a value */
+    Four	nDiffer;	/* objects which read back differently */
+    Four	err;		/* errno of a counter which could not be opened */
+    Four	result;		/* result of the test */
+    pid_t	child;		/* process whose counters are denied */
+    int		status;		/* exit status of the child */
+    FileID	fid;		/* file of the test */
+    ObjectID	catEntry;	/* catalog entry of the file */
+    ObjectID	oid;		/* current object */
+    ObjectID	prev;		/* previous object */
+    double	value[EDUOM_NUM_PERF_COUNTERS]; /* values of the counters */
+    char	buf[100];	/* contents of an object */
+    char	data[100];	/* object read back */
+
+
+    e = feature_CreateFile(volId, &fid, &catEntry);
+    if (e < eNOERROR) ERR(e);
+
+    e = feature_FillFile(&catEntry, 0, FEATURE_OBJECTS, sizeof(buf));
+    if (e < eNOERROR) ERR(e);
+
+    fflush(stdout);
+
+    child = fork();
+    if (child < 0) ERR(eMEMORYALLOCERR);
+
+    if (child == 0) {
+        e = feature_DenyPerfEvents();
+        if (e < eNOERROR) _exit(2);
+
+        nOpened = eduom_OpenPerfCounters(&err);
+        eduom_StartPerfCounters();
+
+        oid.pageNo = NIL;
+        nDiffer = 0;
+        e = EduOM_NextObject(&catEntry, NULL, &oid, NULL);
+        for (i = 0; e >= eNOERROR && i < FEATURE_OBJECTS; i++) {
+            feature_Pattern(i, sizeof(buf), buf);
+
+            e = EduOM_ReadObject(&oid, 0, REMAINDER, data);
+            if (e < eNOERROR) break;
+            if (e != sizeof(buf) || memcmp(data, buf, sizeof(buf)) != 0) nDiffer++;
+
+            prev = oid;
+            e = EduOM_NextObject(&catEntry, &prev, &oid, NULL);
+        }
+
+        eduom_StopPerfCounters(value);
+        eduom_ClosePerfCounters();
+
+        for (i = 0, nRead = 0; i < EDUOM_NUM_PERF_COUNTERS; i++)
+            if (value[i] != -1) nRead++;
+
+        if (nOpened != 0 || err != EPERM || e < eNOERROR || nDiffer != 0 || nRead != 0) {
+            printf("  with perf_event_open() denied, %ld counters opened(%s), %ld read, "
+                   "the reads returned %ld with %ld objects differing\n",
+                   (long)nOpened, strerror(err), (long)nRead, (long)e, (long)nDiffer);
+            fflush(stdout);
+            _exit(1);
+        }
+        _exit(0);
+    }
+
+    result = FEATURE_PASS;
+    if (waitpid(child, &status, 0) != child || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        printf("  the child denied perf_event_open() %s %d\n",
+               WIFEXITED(status) ? "exited with" : "was killed by signal",
+               WIFEXITED(status) ? WEXITSTATUS(status) : WTERMSIG(status));
+        result = FEATURE_FAIL;
+    }
+
+    nOpened = eduom_OpenPerfCounters(&err);
+    eduom_StartPerfCounters();
+    eduom_StopPerfCounters(value);
+    eduom_ClosePerfCounters();
+
+    for (i = 0, nRead = 0; i < EDUOM_NUM_PERF_COUNTERS; i++)
+        if (value[i] != -1) nRead++;
+
+    if (result == FEATURE_PASS && (nRead > nOpened || (nOpened < EDUOM_NUM_PERF_COUNTERS && err == 0))) {
+        printf("  %ld counters opened, %ld read, errno %ld\n", (long)nOpened, (long)nRead, (long)err);
+        result = FEATURE_FAIL;
+    }
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = SM_DestroyFile(&fid, NULL);
+    if (e < eNOERROR) ERR(e);
+
+    return(result);
+
+} /* feature_TestPerfFallback() */
+
+
+
+/*@================================
+ * feature_CountProbes()
+ *================================*/
+/*
+ * Function: Four feature_CountProbes(char*, char*)
+ *
+ * Description:
+ *  Count the sites of the static tracepoint provider:name in this program:
+ *  the notes of the section '.note.stapsdt' which <sys/sdt.h> emits. Each
+ *  note holds three addresses and then the provider, the name and the
+ *  arguments as strings.
+ *
+ * Returns:
+ *  the number of sites (values greater than or equal to 0)
+ *  error code
+ *    eMEMORYALLOCERR
+ *    eNOTSUPPORTED_EDUOM
+ */
+static Four feature_CountProbes(
+    char	*provider,	/* IN provider of the probe */
+    char	*name)		/* IN name of the probe */
+{
+    Four	i;		/* index variable */
+    Four	n;		/* sites found */
+    long	size;		/* bytes of the program */
+    long	off;		/* offset of a note in the section */
+    FILE	*fp;		/* the program */
+    char	*image;		/* contents of the program */
+    char	*desc;		/* descriptor of a note */
+    Elf64_Ehdr	*ehdr;		/* ELF header */
+    Elf64_Shdr	*shdr;		/* section headers */
+    Elf64_Nhdr	*nhdr;		/* header of a note */
+
+
+    fp = fopen("/proc/self/exe", "rb");
+    if (fp == NULL) ERR(eNOTSUPPORTED_EDUOM);
+
+    fseek(fp, 0, SEEK_END);
+    size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    image = (char *)malloc(size);
+    if (image == NULL) {
+        fclose(fp);
+        ERR(eMEMORYALLOCERR);
+    }
+    if (fread(image, 1, size, fp) != (size_t)size) size = 0;
+    fclose(fp);
+
+    ehdr = (Elf64_Ehdr *)image;
+    if (size < (long)sizeof(Elf64_Ehdr) || memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0 ||
+        ehdr->e_ident[EI_CLASS] != ELFCLASS64) {
+        free(image);
+        ERR(eNOTSUPPORTED_EDUOM);
+    }
+
+    shdr = (Elf64_Shdr *)(image + ehdr->e_shoff);
+    for (i = 0, n = 0; i < ehdr->e_shnum; i++) {
+        if (shdr[i].sh_type != SHT_NOTE ||
+            strcmp(image + shdr[ehdr->e_shstrndx].sh_offset + shdr[i].sh_name, ".note.stapsdt") != 0) continue;
+
+        for (off = 0; off + (long)sizeof(Elf64_Nhdr) <= (long)shdr[i].sh_size; ) {
+            nhdr = (Elf64_Nhdr *)(image + shdr[i].sh_offset + off);
+            desc = (char *)(nhdr + 1) + ((nhdr->n_namesz + 3) & ~3);
+
+            /* three addresses, then "provider\0name\0arguments" */
+            if (nhdr->n_type == 3 && strcmp(desc + 3*sizeof(Elf64_Addr), provider) == 0 &&
+                strcmp(desc + 3*sizeof(Elf64_Addr) + strlen(provider) + 1, name) == 0) n++;
+
+            off += sizeof(Elf64_Nhdr) + ((nhdr->n_namesz + 3) & ~3) + ((nhdr->n_descsz + 3) & ~3);
+        }
+    }
+
+    free(image);
+
+    return(n);
+
+} /* feature_CountProbes() */
+
+
+
+/*@================================
+ * feature_TestProbes()
+ *================================*/
+/*
+ * Function: Four feature_TestProbes(Four, char*)
+ *
+ * Description:
+ *  Check that the static tracepoints are in this program if and only if
+ *  they were compiled in(see Header/EduOM_Trace.h): with <sys/sdt.h>, each
+ *  probe has its sites and eduom:api_entry one per interface function at
+ *  least; without it, or without EDUOM_TRACE, no probe is left behind.
+ *  That they compile both ways is checked by 'make check-probes'.
+ *
+ * Returns:
+ *  FEATURE_PASS or FEATURE_FAIL
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four feature_TestProbes(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	i;		/* index variable */
+    Four	n;		/* sites of a probe */
+    Four	result;		/* result of the test */
+    Four	minSites;	/* sites expected of a probe */
+    static struct {
+        char	*provider;	/* provider of the probe */
+        char	*name;		/* name of the probe */
+        Four	nSites;		/* sites at least when the probes are compiled in */
+    } probes[] = {
+        { "eduom",	"api_entry",		EDUOM_NUM_APIS },
+        { "eduom",	"api_return",		EDUOM_NUM_APIS },
+        { "eduom",	"create_placement",	EDUOM_NUM_BRANCHES - 1 },
+        { "eduom",	"compact",		1 },
+        { "bfm",	"get_train_miss",	1 },
+        { "rdsm",	"alloc_trains_entry",	1 },
+        { "rdsm",	"alloc_trains_return",	1 }
+    };
+
+
+    result = FEATURE_PASS;
+    for (i = 0; i < sizeof(probes)/sizeof(probes[0]); i++) {
+        n = feature_CountProbes(probes[i].provider, probes[i].name);
+        if (n < eNOERROR) ERR(n);
+
+#ifdef EDUOM_TRACE_PROBES
+        minSites = probes[i].nSites;
+#else
+        minSites = 0;
+#endif
+        if ((minSites == 0 && n != 0) || n < minSites) {
+            printf("  %s:%s has %ld sites, expected %s%ld\n", probes[i].provider, probes[i].name,
+                   (long)n, (minSites == 0) ? "" : "at least ", (long)minSites);
+            result = FEATURE_FAIL;
+        }
+    }
+
+    return(result);
+
+} /* feature_TestProbes() */
+
+
+
+/*@================================
+ * EduOM_FeatureTest()
+ *================================*/
+/*
+ * Function: Four EduOM_FeatureTest(Four, char*)
+ *
+ * Description:
+ *  Run the behavior tests on a mounted volume of one device.
+ *
+ * Returns:
+ *  the number of tests failed (values greater than or equal to 0)
+ *  error code
+ *    some errors caused by function calls
+ */
+Four EduOM_FeatureTest(
+    Four	volId,		/* IN volume to test on */
+    char	*devName)	/* IN device of the volume */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	nFailed;	/* the number of tests failed */
+    Four	nTests;		/* the number of tests */
+    static feature_Test tests[] = {
+        { "prefetch",		feature_TestPrefetch },
+        { "mapped_read",	feature_TestMappedRead },
+        { "direct_io",		feature_TestDirectIO },
+        { "partitioned_miss",	feature_TestPartitionedMiss },
+        { "async_writer",	feature_TestAsyncWriter },
+        { "pax_column_scan",	feature_TestPaxColumnScan },
+        { "fixed_density",	feature_TestFixedDensity },
+        { "small_density",	feature_TestSmallDensity },
+        { "compressed_size",	feature_TestCompressedSize },
+        { "prefix_size",	feature_TestPrefixSize },
+        { "soa_slot_layout",	feature_TestSoaSlotLayout },
+        { "compact_incrementally",	feature_TestCompactIncrementally },
+        { "compactor_sweep",	feature_TestCompactorSweep },
+        { "compressed_side_store",	feature_TestCompressedSideStore },
+        { "compressed_writer",	feature_TestCompressedWriter },
+        { "layout_from_first_page",	feature_TestLayoutFromFirstPage },
+        { "active_insert_pages",	feature_TestActiveInsertPages },
+        { "optimistic_read",	feature_TestOptimisticRead },
+        { "buffer_arena",	feature_TestBufferArena },
+        { "warm_start",		feature_TestWarmStart },
+        { "api_stats",		feature_TestApiStats },
+        { "analyze_file",	feature_TestAnalyzeFile },
+        { "perf_fallback",	feature_TestPerfFallback },
+        { "probes",		feature_TestProbes }
+    };
+
+
+    nTests = sizeof(tests)/sizeof(tests[0]);
+
+    for (i = 0, nFailed = 0; i < nTests; i++) {
+        e = tests[i].func(volId, devName);
+        if (e < eNOERROR) {
+            printf("FAIL %s: error %ld\n", tests[i].name, (long)e);
+            ERR(e);
+        }
+
+        printf("%s %s\n", (e == FEATURE_PASS) ? "PASS" : "FAIL", tests[i].name);
+        if (e != FEATURE_PASS) nFailed++;
+    }
+
+    printf("%ld of %ld tests passed\n", (long)(nTests - nFailed), (long)nTests);
+
+    return(nFailed);
+
+} /* EduOM_FeatureTest() */
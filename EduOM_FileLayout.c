@@ -0,0 +1,418 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_FileLayout.c
+ *
+ * Description:
+ *  Layout of the pages of a data file. A file is of one layout: that of the
+ *  slotted pages of cosmos, or one given to the file while it is empty by
+ *  EduOM_SetPaxLayout(), EduOM_SetFixedLength(), EduOM_SetSmallObjectPages(),
+ *  EduOM_SetPrefixPages() or EduOM_SetSoaSlots(). Giving a file a layout
+ *  makes its first page a page of the layout, and the first page of a file
+ *  is never deallocated, so the layout is kept in the volume: it is derived
+ *  from the marker of the first page('reserved' of the slotted page header)
+ *  whenever the process looks the file up for the first time, and a volume
+ *  mounted again needs no call to set it.
+ *
+ *  The layouts looked up are cached in one table shared by all layouts. An
+ *  entry is keyed by the FileID and the first page of the file, so that the
+ *  entry of a destroyed file is not taken for a file created later with the
+ *  same FileID. As any entry can be derived again, the table never fills:
+ *  when it has no unused entry, the entries are replaced in turn.
+ *
+ * Exports:
+ *  None
+ *
+ * Internal:
+ *  Four eduom_LookUpFileLayout(sm_CatOverlayForData*, eduom_FileLayout*)
+ *  Four eduom_SetFileLayout(ObjectID*, eduom_FileLayout*)
+ *  void eduom_SetSmallInsertPage(FileID*, PageNo)
+ */
+
+
+#include <string.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_MAX_LAYOUT_FILES  64      /* files whose layout is cached */
+
+
+/*@
+ * Global Variables
+ */
+/* the cache; an entry is read and written only under 'eduom_fileLayoutMutex' */
+static eduom_FileLayout eduom_fileLayout[EDUOM_MAX_LAYOUT_FILES] = {
+    [0 ... EDUOM_MAX_LAYOUT_FILES-1] = { { NIL, NIL }, NIL, EDUOM_PLAIN_LAYOUT }
+};
+static Four eduom_nextFileLayout = 0;	/* entry to replace next when the cache is full */
+static pthread_mutex_t eduom_fileLayoutMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+static void eduom_PageLayout(SlottedPage*, eduom_FileLayout*);
+static Boolean eduom_SameLayout(eduom_FileLayout*, eduom_FileLayout*);
+static void eduom_CacheFileLayout(eduom_FileLayout*);
+
+
+
+/*@================================
+ * eduom_LookUpFileLayout()
+ *================================*/
+/*
+ * Function: Four eduom_LookUpFileLayout(sm_CatOverlayForData*, eduom_FileLayout*)
+ *
+ * Description:
+ *  Return the layout of the file. The layout is taken from the cache, or
+ *  else derived from the first page of the file and cached.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_LookUpFileLayout(
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    eduom_FileLayout *layout)	/* OUT layout of the file */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    PageID	pid;		/* first page of the file */
+    SlottedPage	*apage;		/* pointer to the buffer of the first page */
+
+
+    pthread_mutex_lock(&eduom_fileLayoutMutex);
+
+    for (i = 0; i < EDUOM_MAX_LAYOUT_FILES; i++)
+        if (EQUAL_FILEID(eduom_fileLayout[i].fid, catEntry->fid) &&
+            eduom_fileLayout[i].firstPage == catEntry->firstPage) break;
+
+    if (i < EDUOM_MAX_LAYOUT_FILES) *layout = eduom_fileLayout[i];
+
+    pthread_mutex_unlock(&eduom_fileLayoutMutex);
+
+    if (i < EDUOM_MAX_LAYOUT_FILES) return(eNOERROR);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    eduom_PageLayout(apage, layout);
+    layout->fid = catEntry->fid;
+    layout->firstPage = catEntry->firstPage;
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    eduom_CacheFileLayout(layout);
+
+    return(eNOERROR);
+
+} /* eduom_LookUpFileLayout() */
+
+
+
+/*@================================
+ * eduom_SetFileLayout()
+ *================================*/
+/*
+ * Function: Four eduom_SetFileLayout(ObjectID*, eduom_FileLayout*)
+ *
+ * Description:
+ *  Give the file the layout by making its first page a page of the layout.
+ *  The file must be an empty file of the slotted pages, or already of the
+ *  same layout(e.g. a file of a volume mounted again); a file of another
+ *  layout is not changed. 'fid' and 'firstPage' of the layout are set.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four eduom_SetFileLayout(
+    ObjectID	*catObjForFile,	/* IN file to be given the layout */
+    eduom_FileLayout *layout)	/* INOUT layout to give */
+{
+    Four	e;		/* error number */
+    Four	j;		/* index variable */
+    PageID	pid;		/* first page of the file */
+    eduom_FileLayout current;	/* layout of the first page */
+    SlottedPage	*apage;		/* pointer to the buffer of the first page */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    e = BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+
+    eduom_PageLayout(apage, &current);
+
+    if (current.layout == layout->layout) {
+        if (!eduom_SameLayout(&current, layout)) {
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(eBADPARAMETER_OM, (TrainID *)catObjForFile, PAGE_BUF);
+        }
+    }
+    else {
+        for (j = 0; j < apage->header.nSlots && current.layout == EDUOM_PLAIN_LAYOUT; j++)
+            if (apage->slot[-j].offset != EMPTYSLOT) break;
+
+        if (current.layout != EDUOM_PLAIN_LAYOUT || catEntry->firstPage != catEntry->lastPage ||
+            j < apage->header.nSlots) {
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(eBADPARAMETER_OM, (TrainID *)catObjForFile, PAGE_BUF);
+        }
+
+        /* the page is found as the last page of the file until it is put into a list again */
+        eduom_DisownActiveInsertPage(&pid);
+        om_RemoveFromAvailSpaceList(catObjForFile, &pid, apage);
+
+        e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+        if (e < 0) {
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+        }
+
+        /* the slots are all empty; a page of a layout begins with none */
+        apage->header.nSlots = 0;
+        apage->header.free = 0;
+        apage->header.unused = 0;
+
+        switch (layout->layout) {
+          case EDUOM_PAX_LAYOUT:
+            eduom_FormatPaxPage(apage, &layout->schema);
+            break;
+
+          case EDUOM_FIXED_LAYOUT:
+            eduom_FormatFixedPage(apage, layout->recordLength);
+            break;
+
+          case EDUOM_SMALL_LAYOUT:
+            e = eduom_FormatSmallPage(apage, &pid);
+            if (e < 0) {
+                BfM_EndFrameWrite(&pid, PAGE_BUF);
+                BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+                ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+            }
+            break;
+
+          case EDUOM_PREFIX_LAYOUT:
+            eduom_FormatPrefixPage(apage, 0, NULL);
+            break;
+
+          case EDUOM_SOA_LAYOUT:
+            apage->header.reserved = EDUOM_SOA_PAGE;
+            break;
+        }
+
+        e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+        if (e >= 0) e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) {
+            BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            ERRB1(e, (TrainID *)catObjForFile, PAGE_BUF);
+        }
+    }
+
+    layout->fid = catEntry->fid;
+    layout->firstPage = catEntry->firstPage;
+    eduom_CacheFileLayout(layout);
+
+    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    e = BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_SetFileLayout() */
+
+
+
+/*@================================
+ * eduom_SetSmallInsertPage()
+ *================================*/
+/*
+ * Function: void eduom_SetSmallInsertPage(FileID*, PageNo)
+ *
+ * Description:
+ *  Remember the small object page the file of small objects put its last
+ *  object into(see eduom_CreateSmallObject()). Nothing is remembered if
+ *  the file is not in the cache; the next object then goes to the last
+ *  page of the file.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_SetSmallInsertPage(
+    FileID	*fid,		/* IN file of small objects */
+    PageNo	insertPage)	/* IN the small object page */
+{
+    Four	i;		/* index variable */
+
+
+    pthread_mutex_lock(&eduom_fileLayoutMutex);
+
+    for (i = 0; i < EDUOM_MAX_LAYOUT_FILES; i++)
+        if (EQUAL_FILEID(eduom_fileLayout[i].fid, *fid)) {
+            eduom_fileLayout[i].insertPage = insertPage;
+            break;
+        }
+
+    pthread_mutex_unlock(&eduom_fileLayoutMutex);
+
+} /* eduom_SetSmallInsertPage() */
+
+
+
+/*@================================
+ * eduom_PageLayout()
+ *================================*/
+/*
+ * Function: static void eduom_PageLayout(SlottedPage*, eduom_FileLayout*)
+ *
+ * Description:
+ *  Derive the layout of a file from the marker of its first page. A page
+ *  without a marker of a layout is a slotted page of cosmos.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_PageLayout(
+    SlottedPage	*apage,		/* IN first page of the file */
+    eduom_FileLayout *layout)	/* OUT layout of the file; 'fid' and 'firstPage' are not set */
+{
+    memset(layout, 0, sizeof(eduom_FileLayout));
+
+    switch (apage->header.reserved) {
+      case EDUOM_PAX_PAGE:
+        layout->layout = EDUOM_PAX_LAYOUT;
+        layout->schema = PAX_PAGE_HDR(apage)->schema;
+        break;
+
+      case EDUOM_FIXED_PAGE:
+        layout->layout = EDUOM_FIXED_LAYOUT;
+        layout->recordLength = FIXED_PAGE_HDR(apage)->length;
+        break;
+
+      case EDUOM_SMALL_PAGE:
+        layout->layout = EDUOM_SMALL_LAYOUT;
+        layout->insertPage = NIL;
+        break;
+
+      case EDUOM_PREFIX_PAGE:
+        layout->layout = EDUOM_PREFIX_LAYOUT;
+        break;
+
+      case EDUOM_SOA_PAGE:
+        layout->layout = EDUOM_SOA_LAYOUT;
+        break;
+
+      default:
+        layout->layout = EDUOM_PLAIN_LAYOUT;
+        break;
+    }
+
+} /* eduom_PageLayout() */
+
+
+
+/*@================================
+ * eduom_SameLayout()
+ *================================*/
+/*
+ * Function: static Boolean eduom_SameLayout(eduom_FileLayout*, eduom_FileLayout*)
+ *
+ * Description:
+ *  Tell whether two layouts of the same kind have the same parameters.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ */
+static Boolean eduom_SameLayout(
+    eduom_FileLayout *a,	/* IN a layout */
+    eduom_FileLayout *b)	/* IN another layout of the same kind */
+{
+    switch (a->layout) {
+      case EDUOM_PAX_LAYOUT:
+        return(memcmp(&a->schema, &b->schema, sizeof(EduOM_PaxSchema)) == 0);
+
+      case EDUOM_FIXED_LAYOUT:
+        return(a->recordLength == b->recordLength);
+
+      default:
+        return(TRUE);
+    }
+
+} /* eduom_SameLayout() */
+
+
+
+/*@================================
+ * eduom_CacheFileLayout()
+ *================================*/
+/*
+ * Function: static void eduom_CacheFileLayout(eduom_FileLayout*)
+ *
+ * Description:
+ *  Put the layout of the file into the cache, replacing the entry of the
+ *  file, or else an unused entry, or else the next entry in turn.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_CacheFileLayout(
+    eduom_FileLayout *layout)	/* IN layout of a file */
+{
+    Four	i;		/* index variable */
+    Four	freeEntry;	/* unused entry */
+
+
+    pthread_mutex_lock(&eduom_fileLayoutMutex);
+
+    for (i = 0, freeEntry = NIL; i < EDUOM_MAX_LAYOUT_FILES; i++) {
+        if (EQUAL_FILEID(eduom_fileLayout[i].fid, layout->fid)) break;
+        if (eduom_fileLayout[i].fid.volNo == NIL && freeEntry == NIL) freeEntry = i;
+    }
+    if (i == EDUOM_MAX_LAYOUT_FILES) {
+        if (freeEntry != NIL) i = freeEntry;
+        else {
+            i = eduom_nextFileLayout;
+            eduom_nextFileLayout = (eduom_nextFileLayout + 1) % EDUOM_MAX_LAYOUT_FILES;
+        }
+    }
+
+    eduom_fileLayout[i] = *layout;
+
+    pthread_mutex_unlock(&eduom_fileLayoutMutex);
+
+} /* eduom_CacheFileLayout() */
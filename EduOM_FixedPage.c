@@ -0,0 +1,419 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_FixedPage.c
+ *
+ * Description:
+ *  Files of fixed length records. A file is given the length of its records
+ *  by EduOM_SetFixedLength() while it is empty, and its records are then
+ *  stored in fixed length record pages: the data area of a page is a header,
+ *  a bitmap of the live records and an array of the records, without object
+ *  headers, slots or alignment padding. The slot number of a record is its
+ *  index in the array, and 'nSlots' of the page is one more than the index
+ *  of the last live record, so the ObjectIDs and EduOM_NextObject()/
+ *  EduOM_PrevObject() are the same as those of the slotted pages. As there
+ *  is no slot array, the unique numbers of the records are 0(see
+ *  SLOT_UNIQUE()), and the ObjectID of a destroyed record names the record
+ *  created in its place later.
+ *
+ *  The fixed length record pages are kept out of the available space lists
+ *  (see SP_RESERVE_FREE()); a record is put into the page of the near object
+ *  or the last page of the file, or into a new page if neither has a free
+ *  record. The tag given to EduOM_CreateObject() is not kept.
+ *  EduOM_SetFixedLength() makes the first page of the file a fixed length
+ *  record page, from which the length of the records is derived after the
+ *  volume is mounted again(see EduOM_FileLayout.c).
+ *
+ * Exports:
+ *  Four EduOM_SetFixedLength(ObjectID*, Four)
+ *
+ * Internal:
+ *  Four eduom_CreateFixedObject(ObjectID*, sm_CatOverlayForData*, Four, ObjectID*, Four, char*, ObjectID*)
+ *  Four eduom_CopyFixedRecord(SlottedPage*, ObjectID*, Four, Four, char*)
+ *  Four eduom_DestroyFixedRecord(SlottedPage*, ObjectID*)
+ *  void eduom_FormatFixedPage(SlottedPage*, Four)
+ */
+
+
+#include <stddef.h>
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_FIXED_ALIGN       8       /* alignment of the record array */
+
+
+/*@
+ * Macro Definitions
+ */
+#define EDUOM_FIXED_ALIGNED(n)  (((n) + EDUOM_FIXED_ALIGN - 1) & ~(EDUOM_FIXED_ALIGN - 1))
+
+/* bytes of the header and the bitmap of a page of n records */
+#define EDUOM_FIXED_HDR_SIZE(n) \
+    EDUOM_FIXED_ALIGNED(offsetof(eduom_FixedPageHdr, bitmap) + (((n) + 31) / 32) * sizeof(UFour))
+
+#define IS_LIVE_RECORD(h, r)    (((h)->bitmap[(r) >> 5] >> ((r) & 31)) & 1)
+#define SET_LIVE_RECORD(h, r)   ((h)->bitmap[(r) >> 5] |= (1U << ((r) & 31)))
+#define RESET_LIVE_RECORD(h, r) ((h)->bitmap[(r) >> 5] &= ~(1U << ((r) & 31)))
+
+
+static Four eduom_FindFixedRecord(SlottedPage*);
+
+
+
+/*@================================
+ * EduOM_SetFixedLength()
+ *================================*/
+/*
+ * Function: Four EduOM_SetFixedLength(ObjectID*, Four)
+ *
+ * Description:
+ *  Make the file a file of fixed length records; the objects created in the
+ *  file must be 'length' bytes. The file must be empty, or already a file of
+ *  records of the same length(e.g. a file of a volume mounted again).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADLENGTH_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetFixedLength(
+    ObjectID	*catObjForFile,	/* IN file to be of fixed length records */
+    Four	length)		/* IN bytes of a record */
+{
+    Four	e;		/* error number */
+    eduom_FileLayout layout;	/* the layout of records of the length */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (length <= 0 || EDUOM_FIXED_HDR_SIZE(1) + length > PAGESIZE - SP_FIXED) ERR(eBADLENGTH_OM);
+
+    memset(&layout, 0, sizeof(eduom_FileLayout));
+    layout.layout = EDUOM_FIXED_LAYOUT;
+    layout.recordLength = length;
+
+    e = eduom_SetFileLayout(catObjForFile, &layout);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetFixedLength() */
+
+
+
+/*@================================
+ * eduom_CreateFixedObject()
+ *================================*/
+/*
+ * Function: Four eduom_CreateFixedObject(ObjectID*, sm_CatOverlayForData*, Four,
+ *                                        ObjectID*, Four, char*, ObjectID*)
+ *
+ * Description:
+ *  Create a record in the file of fixed length records; the record is put
+ *  into the page of the near object, or the last page of the file if the
+ *  near object is NULL, or into a new page following that page if it has
+ *  no free record.
+ *
+ * Returns:
+ *  error code
+ *    eBADLENGTH_OM
+ *    some errors caused by function calls
+ */
+Four eduom_CreateFixedObject(
+    ObjectID	*catObjForFile,	/* IN file in which the record is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    Four	recordLength,	/* IN bytes of a record of the file */
+    ObjectID	*nearObj,	/* IN create the record near this object */
+    Four	length,		/* IN bytes of the record */
+    char	*data,		/* IN the record */
+    ObjectID	*oid)		/* OUT the record's ObjectID */
+{
+    Four	e;		/* error number */
+    Four	r;		/* index of the new record in the page */
+    Four	firstExt;	/* first extent of the file */
+    PageID	pid;		/* page in which the record is placed */
+    PageID	nearPid;	/* page the new page follows */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    eduom_FixedPageHdr *fixedHdr; /* header of the fixed length record page */
+
+
+    if (length != recordLength) ERR(eBADLENGTH_OM);
+
+    if (nearObj != NULL) MAKE_PAGEID(pid, nearObj->volNo, nearObj->pageNo);
+    else MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->lastPage);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (IS_FIXED_PAGE(apage) && (r = eduom_FindFixedRecord(apage)) != NIL) {
+        EDUOM_STATS_BRANCH(nearObj != NULL ? EDUOM_BRANCH_NEAR_PAGE : EDUOM_BRANCH_LAST_PAGE);
+        EDUOM_PROBE3(eduom, create_placement, nearObj != NULL ? EDUOM_BRANCH_NEAR_PAGE : EDUOM_BRANCH_LAST_PAGE,
+                     pid.volNo, pid.pageNo);
+    }
+    else {
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        nearPid = pid;
+        MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+        e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+        if (e < 0) ERR(e);
+
+        e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+        if (e < 0) ERR(e);
+        EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEW_PAGE);
+        EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEW_PAGE, pid.volNo, pid.pageNo);
+
+        e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
+        apage->header.pid = pid;
+        apage->header.fid = catEntry->fid;
+        apage->header.unique = 0;
+        apage->header.uniqueLimit = 0;
+        apage->header.nextPage = NIL;
+        apage->header.prevPage = NIL;
+        apage->header.spaceListPrev = NIL;
+        apage->header.spaceListNext = NIL;
+        eduom_FormatFixedPage(apage, recordLength);
+
+        e = om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        r = 0;
+    }
+
+    e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    fixedHdr = FIXED_PAGE_HDR(apage);
+    memcpy(&(apage->data[fixedHdr->recordOffset + r*recordLength]), data, recordLength);
+    SET_LIVE_RECORD(fixedHdr, r);
+    fixedHdr->nLive++;
+
+    if (r == apage->header.nSlots) apage->header.nSlots++;
+    SP_RESERVE_FREE(apage);
+
+    e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, r, 0);
+
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_CreateFixedObject() */
+
+
+
+/*@================================
+ * eduom_CopyFixedRecord()
+ *================================*/
+/*
+ * Function: Four eduom_CopyFixedRecord(SlottedPage*, ObjectID*, Four, Four, char*)
+ *
+ * Description:
+ *  Copy the requested bytes of the record in the fixed length record page
+ *  into the user buffer. As the page may be read without being fixed(see
+ *  eduom_CopyObjectData()), the header of the page is checked against the
+ *  page bounds before it is used.
+ *
+ * Returns:
+ *  1) number of bytes copied (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ */
+Four eduom_CopyFixedRecord(
+    SlottedPage	*apage,		/* IN fixed length record page containing the record */
+    ObjectID	*oid,		/* IN record to read */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four	r;		/* index of the record in the page */
+    Four	recordLength;	/* bytes of a record */
+    eduom_FixedPageHdr *fixedHdr; /* header of the fixed length record page */
+
+
+    fixedHdr = FIXED_PAGE_HDR(apage);
+    recordLength = fixedHdr->length;
+    r = oid->slotNo;
+
+    if (recordLength <= 0 || fixedHdr->nRecords <= 0 ||
+        fixedHdr->recordOffset < EDUOM_FIXED_HDR_SIZE(fixedHdr->nRecords) ||
+        fixedHdr->recordOffset + fixedHdr->nRecords*recordLength > PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+
+    if (r < 0 || r >= fixedHdr->nRecords || !IS_LIVE_RECORD(fixedHdr, r)) return(eBADOBJECTID_OM);
+
+    if (start > recordLength) return(eBADSTART_OM);
+
+    if (length == REMAINDER) length = recordLength - start;
+    if (length < 0 || start + length > recordLength) return(eBADLENGTH_OM);
+    memcpy(buf, &(apage->data[fixedHdr->recordOffset + r*recordLength + start]), length);
+
+    return(length);
+
+} /* eduom_CopyFixedRecord() */
+
+
+
+/*@================================
+ * eduom_DestroyFixedRecord()
+ *================================*/
+/*
+ * Function: Four eduom_DestroyFixedRecord(SlottedPage*, ObjectID*)
+ *
+ * Description:
+ *  Destroy the record in the fixed length record page; 'nSlots' of the page
+ *  becomes one more than the index of the last live record, so it is 0 if
+ *  the page has no more records.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ */
+Four eduom_DestroyFixedRecord(
+    SlottedPage	*apage,		/* INOUT fixed length record page containing the record */
+    ObjectID	*oid)		/* IN record to destroy */
+{
+    Four	r;		/* index of the record in the page */
+    eduom_FixedPageHdr *fixedHdr; /* header of the fixed length record page */
+
+
+    fixedHdr = FIXED_PAGE_HDR(apage);
+    r = oid->slotNo;
+
+    if (r < 0 || r >= apage->header.nSlots || !IS_LIVE_RECORD(fixedHdr, r)) ERR(eBADOBJECTID_OM);
+
+    RESET_LIVE_RECORD(fixedHdr, r);
+    fixedHdr->nLive--;
+
+    while (apage->header.nSlots > 0 && !IS_LIVE_RECORD(fixedHdr, apage->header.nSlots - 1))
+        apage->header.nSlots--;
+    SP_RESERVE_FREE(apage);
+
+    return(eNOERROR);
+
+} /* eduom_DestroyFixedRecord() */
+
+
+
+/*@================================
+ * eduom_FormatFixedPage()
+ *================================*/
+/*
+ * Function: void eduom_FormatFixedPage(SlottedPage*, Four)
+ *
+ * Description:
+ *  Make the page an empty page of fixed length records; the links of the
+ *  page are kept. As many records as fit with their bits of the bitmap are
+ *  given to the page, and the record array is aligned to EDUOM_FIXED_ALIGN
+ *  bytes.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FormatFixedPage(
+    SlottedPage	*apage,		/* INOUT page to format */
+    Four	length)		/* IN bytes of a record */
+{
+    Four	nRecords;	/* records the page can hold */
+    eduom_FixedPageHdr *fixedHdr; /* header of the fixed length record page */
+
+
+    /* a record takes 'length' bytes and a bit; the bitmap is rounded up to words and aligned */
+    nRecords = (PAGESIZE - SP_FIXED - offsetof(eduom_FixedPageHdr, bitmap)) * 8 / (length*8 + 1);
+    while (EDUOM_FIXED_HDR_SIZE(nRecords) + nRecords*length > PAGESIZE - SP_FIXED) nRecords--;
+
+    fixedHdr = FIXED_PAGE_HDR(apage);
+    fixedHdr->length = length;
+    fixedHdr->nRecords = nRecords;
+    fixedHdr->nLive = 0;
+    fixedHdr->recordOffset = EDUOM_FIXED_HDR_SIZE(nRecords);
+    memset(fixedHdr->bitmap, 0, ((nRecords + 31) / 32) * sizeof(UFour));
+
+    apage->header.reserved = EDUOM_FIXED_PAGE;
+    apage->header.nSlots = 0;
+    SP_RESERVE_FREE(apage);
+
+} /* eduom_FormatFixedPage() */
+
+
+
+/*@================================
+ * eduom_FindFixedRecord()
+ *================================*/
+/*
+ * Function: Four eduom_FindFixedRecord(SlottedPage*)
+ *
+ * Description:
+ *  Find the first free record of the fixed length record page by a word of
+ *  the bitmap at a time.
+ *
+ * Returns:
+ *  index of the free record, or NIL if the page is full
+ */
+static Four eduom_FindFixedRecord(
+    SlottedPage	*apage)		/* IN fixed length record page */
+{
+    Four	w;		/* index variable */
+    Four	r;		/* index of the free record */
+    eduom_FixedPageHdr *fixedHdr; /* header of the fixed length record page */
+
+
+    fixedHdr = FIXED_PAGE_HDR(apage);
+    if (fixedHdr->nLive == fixedHdr->nRecords) return(NIL);
+
+    for (w = 0; w*32 < fixedHdr->nRecords; w++) {
+        if (fixedHdr->bitmap[w] == ~(UFour)0) continue;
+
+        r = w*32 + __builtin_ctz(~fixedHdr->bitmap[w]);
+        return(r < fixedHdr->nRecords ? r : NIL);
+    }
+
+    return(NIL);
+
+} /* eduom_FindFixedRecord() */
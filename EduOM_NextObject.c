@@ -34,6 +34,7 @@
 
 
 #include "EduOM_common.h"
+#include "RDsM.h"
 #include "BfM.h"
 #include "EduOM_Internal.h"
 
@@ -50,7 +51,8 @@
  *  Return the next Object of the given Current Object.  Find the Object in the
  *  same page which has the current Object and  if there  is no next Object in
  *  the same page, find it from the next page. If the Current Object is NULL,
- *  return the first Object of the file.
+ *  return the first Object of the file. The empty slots are skipped; the
+ *  nextOID is left as it is at the end of the file.
  *
  * Returns:
  *  error code
@@ -70,13 +72,11 @@ Four EduOM_NextObject(
     ObjectID  *nextOID,		/* OUT the next Object of a current Object */
     ObjectHdr *objHdr)		/* OUT the object header of next object */
 {
-    Four e;			/* error */
-    Two  i;			/* index */
-    Four offset;		/* starting offset of object within a page */
+    Four slotNo;		/* slot of the next object */
     PageID pid;			/* a page identifier */
+    PageID aheadPid;		/* the page the scan is going to visit next */
     PageNo pageNo;		/* a temporary var for next page's PageNo */
     SlottedPage *apage;		/* a pointer to the data page */
-    Object *obj;		/* a pointer to the Object */
     PhysicalFileID pFid;	/* file in which the objects are located */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* data structure for catalog object access */
@@ -88,67 +88,66 @@ Four EduOM_NextObject(
     
     if (nextOID == NULL) ERR(eBADOBJECTID_OM);
 
+    // buffer manager 통계를 scan 연산으로 집계한다.
+    BfM_SetCaller(BFM_CALLER_SCAN);
+    EDUOM_STATS_TIMER(EDUOM_API_NEXT);
+    EDUOM_PROBE_API(EDUOM_API_NEXT, curOID);
+
     // 0. catEntry를 불러온다.
-    BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    BfM_GetTrainForRead((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
     GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 
     // 1. curOID가 NULL인 경우
     if (curOID == NULL) {
-        // File에 들어있는 첫 object의 ID를 반환한다.
-        pageNo = catEntry->firstPage;
-
-        MAKE_PAGEID(pid, pFid.volNo, pageNo);
-        BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        nextOID->volNo = pid.volNo;
-        nextOID->pageNo = pageNo;
-        nextOID->slotNo = 0; // 첫 object
-        nextOID->unique = apage->slot[0].unique;
+        // File의 첫 page부터 첫 object를 찾는다.
+        MAKE_PAGEID(pid, pFid.volNo, catEntry->firstPage);
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-        //BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        slotNo = eduom_NextLiveSlot(apage, 0);
     }
     // 2. curOID가 NULL이 아닌 경우
     else {
         // 2-1. curOID에 대응되는 object를 찾는다.
         MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
-        BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        // 2-2. slot array에서 curOID 다음에 있는 object를 찾아 ID를 반환한다.
-        //      만약 curOID object가 현재 page의 마지막 object라면 다음 page의 첫 object를 찾아 반환한다.
-        //      만약 curOID object가 마지막 page의 마지막 object라면 EOS를 반환한다.
-
-        // Case 1. curOID가 해당 page의 마지막 object가 아님
-        if (curOID->slotNo + 1 != apage->header.nSlots) {
-            nextOID->volNo = curOID->volNo;
-            nextOID->pageNo = curOID->pageNo;
-            nextOID->slotNo = curOID->slotNo + 1;
-            nextOID->unique = apage->slot[-nextOID->slotNo].unique;
-        }
-        // Case 2. curOID가 해당 page의 마지막 object임
-        else {
-            // Case 2-1. curOID가 마지막 page의 마지막 object 였음
-            //if (apage->header.pid.pageNo == catEntry->lastPage) continue;
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-            // Case 2-2. curOID가 nextPage가 있는 page의 마지막 object 였음
-            if (apage->header.pid.pageNo != catEntry->lastPage) {
-                pageNo = apage->header.nextPage;
+        // 2-2. slot array에서 curOID 다음에 있는 object를 찾는다.
+        //      빈 slot은 건너뛴다(see EduOM_SlotKernel.c).
+        slotNo = eduom_NextLiveSlot(apage, curOID->slotNo + 1);
+    }
 
-                nextOID->volNo = curOID->volNo;
-                nextOID->pageNo = pageNo;
-                nextOID->slotNo = 0; //첫 object
+    // 3. 현재 page에 다음 object가 없다면 다음 page들에서 첫 object를 찾는다.
+    //    마지막 page까지 object가 없다면 nextOID를 바꾸지 않고 EOS를 반환한다.
+    while (slotNo == apage->header.nSlots && apage->header.pid.pageNo != catEntry->lastPage) {
+        pageNo = apage->header.nextPage;
 
-                BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-                MAKE_PAGEID(pid, nextOID->volNo, nextOID->pageNo);
-                BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+        MAKE_PAGEID(pid, pid.volNo, pageNo);
 
-                nextOID->unique = apage->slot[0].unique;
-            }
+        // 다음 page가 buffer에 없다면 volume의 scan unit만큼 뒤의 page들을 함께 읽는다.
+        // read-ahead는 hint이므로 실패해도 scan을 계속한다.
+        eduom_ReadAhead(&pid, 1);
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+
+        // mapped volume이라면 scan이 다음에 방문할 page를 미리 읽어 두도록 hint를 준다.
+        if (apage->header.nextPage != NIL) {
+            MAKE_PAGEID(aheadPid, pid.volNo, apage->header.nextPage);
+            RDsM_AdviseMappedTrains(&aheadPid, 1, RDSM_ADVICE_WILLNEED);
         }
+
+        slotNo = eduom_NextLiveSlot(apage, 0);
+    }
+
+    if (slotNo < apage->header.nSlots) {
+        nextOID->volNo = pid.volNo;
+        nextOID->pageNo = pid.pageNo;
+        nextOID->slotNo = slotNo;
+        nextOID->unique = SLOT_UNIQUE(apage, slotNo);
     }
 
-    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-    BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+    BfM_FreeTrainForRead((TrainID *)catObjForFile, (char *)catPage, PAGE_BUF);
     return(EOS);		/* end of scan */
     
 } /* EduOM_NextObject() */
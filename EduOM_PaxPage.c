@@ -0,0 +1,544 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PaxPage.c
+ *
+ * Description:
+ *  PAX layout of a data file. A file is given a schema of fixed width fields
+ *  by EduOM_SetPaxLayout() while it is empty, and its rows are then stored
+ *  in PAX pages: the data area of a page begins with the schema and is
+ *  divided into a minipage per field, and the n-th value of a field is at
+ *  the n-th place of its minipage. A PAX page is a slotted page otherwise;
+ *  the 'offset' of a slot is the row of the object, so the ObjectIDs, the
+ *  unique numbers and EduOM_NextObject()/EduOM_PrevObject() are the same
+ *  as those of the slotted pages, and EduOM_ReadObject() gathers the fields
+ *  of the row. EduOM_ReadPaxColumn() scans a file a page at a time copying
+ *  the values of one field, so that only the minipage of the field and the
+ *  slot array are read.
+ *
+ *  The PAX pages are kept out of the available space lists(see
+ *  SP_RESERVE_FREE()); a row is put into the page of the near object or
+ *  the last page of the file, or into a new page if neither has a free row.
+ *  A row has no object header, so the tag given to EduOM_CreateObject() is
+ *  not kept. EduOM_SetPaxLayout() makes the first page of the file a PAX
+ *  page, from which the layout and the schema are derived after the volume
+ *  is mounted again(see EduOM_FileLayout.c).
+ *
+ * Exports:
+ *  Four EduOM_SetPaxLayout(ObjectID*, EduOM_PaxSchema*)
+ *  Four EduOM_ReadPaxColumn(ObjectID*, PageNo*, Four, void*, ObjectID*, Four*)
+ *
+ * Internal:
+ *  Four eduom_CreatePaxObject(ObjectID*, sm_CatOverlayForData*, EduOM_PaxSchema*, ObjectID*, Four, char*, ObjectID*)
+ *  Four eduom_CopyPaxRow(SlottedPage*, ObjectID*, Four, Four, char*)
+ *  void eduom_FormatPaxPage(SlottedPage*, EduOM_PaxSchema*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_PAX_ALIGN         8       /* alignment of the minipages */
+
+
+/*@
+ * Macro Definitions
+ */
+#define EDUOM_PAX_ALIGNED(n)    (((n) + EDUOM_PAX_ALIGN - 1) & ~(EDUOM_PAX_ALIGN - 1))
+
+
+static Four eduom_PaxRowWidth(EduOM_PaxSchema*);
+static Four eduom_FindPaxRow(SlottedPage*);
+
+
+
+/*@================================
+ * EduOM_SetPaxLayout()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPaxLayout(ObjectID*, EduOM_PaxSchema*)
+ *
+ * Description:
+ *  Make the file of the PAX layout with the schema; the objects created in
+ *  the file are rows whose length is the sum of the widths of the fields.
+ *  The file must be empty, or already of the PAX layout with the same
+ *  schema(e.g. a file of a volume mounted again).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPaxLayout(
+    ObjectID	*catObjForFile,	/* IN file to be of the PAX layout */
+    EduOM_PaxSchema *schema)	/* IN schema of the rows */
+{
+    Four	e;		/* error number */
+    Four	f;		/* index variable */
+    eduom_FileLayout layout;	/* the PAX layout of the schema */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (schema == NULL || eduom_PaxRowWidth(schema) < 0) ERR(eBADPARAMETER_OM);
+
+    /* the widths after the fields are 0 as in the header of a PAX page */
+    memset(&layout, 0, sizeof(eduom_FileLayout));
+    layout.layout = EDUOM_PAX_LAYOUT;
+    layout.schema.nFields = schema->nFields;
+    for (f = 0; f < schema->nFields; f++) layout.schema.width[f] = schema->width[f];
+
+    e = eduom_SetFileLayout(catObjForFile, &layout);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetPaxLayout() */
+
+
+
+/*@================================
+ * EduOM_ReadPaxColumn()
+ *================================*/
+/*
+ * Function: Four EduOM_ReadPaxColumn(ObjectID*, PageNo*, Four, void*, ObjectID*, Four*)
+ *
+ * Description:
+ *  Copy the values of a field of the rows in a page of the PAX file into
+ *  'buf', packed in the order of the slots, and the ObjectIDs of the rows
+ *  into 'oids' unless it is NULL. 'buf' must hold PAGESIZE bytes and
+ *  'oids' EDUOM_PAX_MAX_ROWS ObjectIDs. The page is '*pageNo', or the first
+ *  page of the file if it is NIL; '*pageNo' is set to the next page.
+ *
+ * Returns:
+ *  EOS if the page is the last page of the file, otherwise eNOERROR
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    eBADUSERBUF_OM
+ *    eNOTSUPPORTED_EDUOM
+ *    some errors caused by function calls
+ */
+Four EduOM_ReadPaxColumn(
+    ObjectID	*catObjForFile,	/* IN file to scan */
+    PageNo	*pageNo,	/* INOUT page to read; the next page on return */
+    Four	field,		/* IN field to read */
+    void	*buf,		/* OUT values of the field */
+    ObjectID	*oids,		/* OUT ObjectIDs of the rows; may be NULL */
+    Four	*nRows)		/* OUT number of the rows copied */
+{
+    Four	e;		/* error number */
+    Four	i, j, k;	/* index variables */
+    Four	n;		/* rows copied */
+    Four	width;		/* bytes of the field */
+    Four	offset;		/* offset of the row */
+    char	*minipage;	/* minipage of the field */
+    Boolean	last;		/* is the page the last page of the file? */
+    PageID	pid;		/* page to read */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    eduom_PaxPageHdr *paxHdr;	/* PAX header of the page */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (pageNo == NULL || nRows == NULL || field < 0 || field >= EDUOM_PAX_MAX_FIELDS) ERR(eBADPARAMETER_OM);
+
+    if (buf == NULL) ERR(eBADUSERBUF_OM);
+
+    BfM_SetCaller(BFM_CALLER_SCAN);
+
+    e = BfM_GetTrainForRead((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    if (*pageNo == NIL) MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->firstPage);
+    else {
+        MAKE_PAGEID(pid, catEntry->fid.volNo, *pageNo);
+        eduom_ReadAhead(&pid, 1);
+    }
+    last = (pid.pageNo == catEntry->lastPage);
+
+    e = BfM_FreeTrainForRead((TrainID *)catObjForFile, (char *)catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    e = BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    paxHdr = PAX_PAGE_HDR(apage);
+    if (!IS_PAX_PAGE(apage) || field >= paxHdr->schema.nFields) {
+        BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+        ERR(IS_PAX_PAGE(apage) ? eBADPARAMETER_OM : eNOTSUPPORTED_EDUOM);
+    }
+
+    width = paxHdr->schema.width[field];
+    minipage = &(apage->data[paxHdr->offset[field]]);
+
+    /* copy the values of the rows of consecutive slots at a time */
+    for (i = 0, n = 0; i < apage->header.nSlots; i = j) {
+        offset = apage->slot[-i].offset;
+        if (offset == EMPTYSLOT) {
+            j = i + 1;
+            continue;
+        }
+
+        for (j = i + 1; j < apage->header.nSlots && apage->slot[-j].offset == offset + (j - i); j++);
+
+        memcpy((char *)buf + n*width, minipage + offset*width, (j - i)*width);
+        if (oids != NULL)
+            for (k = i; k < j; k++)
+                MAKE_OBJECTID(oids[n + k - i], pid.volNo, pid.pageNo, k, apage->slot[-k].unique);
+        n += j - i;
+    }
+
+    *nRows = n;
+    *pageNo = last ? NIL : apage->header.nextPage;
+
+    e = BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(last ? EOS : eNOERROR);
+
+} /* EduOM_ReadPaxColumn() */
+
+
+
+/*@================================
+ * eduom_CreatePaxObject()
+ *================================*/
+/*
+ * Function: Four eduom_CreatePaxObject(ObjectID*, sm_CatOverlayForData*, EduOM_PaxSchema*,
+ *                                      ObjectID*, Four, char*, ObjectID*)
+ *
+ * Description:
+ *  Create a row in the file of the PAX layout; the row is put into the page
+ *  of the near object, or the last page of the file if the near object is
+ *  NULL, or into a new page following that page if it has no free row.
+ *  The fields of the row are laid in 'data' one after another.
+ *
+ * Returns:
+ *  error code
+ *    eBADLENGTH_OM
+ *    some errors caused by function calls
+ */
+Four eduom_CreatePaxObject(
+    ObjectID	*catObjForFile,	/* IN file in which the row is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    EduOM_PaxSchema *schema,	/* IN schema of the rows of the file */
+    ObjectID	*nearObj,	/* IN create the row near this object */
+    Four	length,		/* IN bytes of the row */
+    char	*data,		/* IN the fields of the row */
+    ObjectID	*oid)		/* OUT the row's ObjectID */
+{
+    Four	e;		/* error number */
+    Four	f;		/* index variable */
+    Four	row;		/* row of the new object in the page */
+    Four	firstExt;	/* first extent of the file */
+    PageID	pid;		/* page in which the row is placed */
+    PageID	nearPid;	/* page the new page follows */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    eduom_PaxPageHdr *paxHdr;	/* PAX header of the page */
+
+
+    if (length != eduom_PaxRowWidth(schema)) ERR(eBADLENGTH_OM);
+
+    if (nearObj != NULL) MAKE_PAGEID(pid, nearObj->volNo, nearObj->pageNo);
+    else MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->lastPage);
+
+    e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (IS_PAX_PAGE(apage) && (row = eduom_FindPaxRow(apage)) != NIL) {
+        EDUOM_STATS_BRANCH(nearObj != NULL ? EDUOM_BRANCH_NEAR_PAGE : EDUOM_BRANCH_LAST_PAGE);
+        EDUOM_PROBE3(eduom, create_placement, nearObj != NULL ? EDUOM_BRANCH_NEAR_PAGE : EDUOM_BRANCH_LAST_PAGE,
+                     pid.volNo, pid.pageNo);
+    }
+    else {
+        e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        nearPid = pid;
+        MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+        e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+        if (e < 0) ERR(e);
+
+        e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+        if (e < 0) ERR(e);
+        EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEW_PAGE);
+        EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEW_PAGE, pid.volNo, pid.pageNo);
+
+        e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
+        apage->header.pid = pid;
+        apage->header.fid = catEntry->fid;
+        apage->header.unique = 0;
+        apage->header.uniqueLimit = 0;
+        apage->header.nextPage = NIL;
+        apage->header.prevPage = NIL;
+        apage->header.spaceListPrev = NIL;
+        apage->header.spaceListNext = NIL;
+        eduom_FormatPaxPage(apage, schema);
+
+        e = om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        row = 0;
+    }
+
+    e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    paxHdr = PAX_PAGE_HDR(apage);
+    for (f = 0; f < paxHdr->schema.nFields; f++) {
+        memcpy(&(apage->data[paxHdr->offset[f] + row*paxHdr->schema.width[f]]), data, paxHdr->schema.width[f]);
+        data += paxHdr->schema.width[f];
+    }
+
+    apage->slot[-row].offset = row;
+    e = om_GetUnique(&pid, &(apage->slot[-row].unique));
+    if (e < 0) {
+        apage->slot[-row].offset = EMPTYSLOT;
+        BfM_EndFrameWrite(&pid, PAGE_BUF);
+        ERRB1(e, &pid, PAGE_BUF);
+    }
+
+    if (row == apage->header.nSlots) apage->header.nSlots++;
+    SP_RESERVE_FREE(apage);
+
+    e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, row, apage->slot[-row].unique);
+
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_CreatePaxObject() */
+
+
+
+/*@================================
+ * eduom_CopyPaxRow()
+ *================================*/
+/*
+ * Function: Four eduom_CopyPaxRow(SlottedPage*, ObjectID*, Four, Four, char*)
+ *
+ * Description:
+ *  Copy the requested bytes of the row in the PAX page into the user buffer;
+ *  the bytes of a row are its fields one after another. As the page may be
+ *  read without being fixed(see eduom_CopyObjectData()), the PAX header and
+ *  the slot are checked against the page bounds before they are used.
+ *
+ * Returns:
+ *  1) number of bytes copied (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ */
+Four eduom_CopyPaxRow(
+    SlottedPage	*apage,		/* IN PAX page containing the row */
+    ObjectID	*oid,		/* IN row to read */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four	f;		/* index variable */
+    Four	row;		/* row of the object in the page */
+    Four	nFields;	/* fields of a row */
+    Four	width;		/* bytes of a field */
+    Four	rowWidth;	/* bytes of a row */
+    Four	pos;		/* offset of a field in the row */
+    Four	from, to;	/* bytes of a field to copy */
+    eduom_PaxPageHdr *paxHdr;	/* PAX header of the page */
+
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots) return(eBADOBJECTID_OM);
+
+    paxHdr = PAX_PAGE_HDR(apage);
+    nFields = paxHdr->schema.nFields;
+    row = apage->slot[-oid->slotNo].offset;
+    if (nFields <= 0 || nFields > EDUOM_PAX_MAX_FIELDS || row < 0 || row >= paxHdr->nRows) return(eBADOBJECTID_OM);
+
+    for (f = 0, rowWidth = 0; f < nFields; f++) {
+        width = paxHdr->schema.width[f];
+        if (width <= 0 || paxHdr->offset[f] < 0 ||
+            paxHdr->offset[f] + paxHdr->nRows*width > PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+        rowWidth += width;
+    }
+
+    if (start > rowWidth) return(eBADSTART_OM);
+
+    if (length == REMAINDER) length = rowWidth - start;
+    if (length < 0 || start + length > rowWidth) return(eBADLENGTH_OM);
+
+    for (f = 0, pos = 0; f < nFields && pos < start + length; f++, pos += width) {
+        width = paxHdr->schema.width[f];
+        from = MAX(start, pos);
+        to = MIN(start + length, pos + width);
+        if (from < to)
+            memcpy(buf + (from - start), &(apage->data[paxHdr->offset[f] + row*width + (from - pos)]), to - from);
+    }
+
+    return(length);
+
+} /* eduom_CopyPaxRow() */
+
+
+
+/*@================================
+ * eduom_PaxRowWidth()
+ *================================*/
+/*
+ * Function: Four eduom_PaxRowWidth(EduOM_PaxSchema*)
+ *
+ * Description:
+ *  Return the bytes of a row of the schema, checking that a page can hold
+ *  a row of it.
+ *
+ * Returns:
+ *  bytes of a row, or NIL if the schema is not valid
+ */
+static Four eduom_PaxRowWidth(
+    EduOM_PaxSchema *schema)	/* IN schema of the rows */
+{
+    Four	f;		/* index variable */
+    Four	rowWidth;	/* bytes of a row */
+
+
+    if (schema->nFields <= 0 || schema->nFields > EDUOM_PAX_MAX_FIELDS) return(NIL);
+
+    for (f = 0, rowWidth = 0; f < schema->nFields; f++) {
+        if (schema->width[f] <= 0) return(NIL);
+        rowWidth += schema->width[f];
+    }
+
+    if (EDUOM_PAX_ALIGNED(sizeof(eduom_PaxPageHdr)) + schema->nFields*EDUOM_PAX_ALIGN + rowWidth > PAGESIZE - SP_FIXED)
+        return(NIL);
+
+    return(rowWidth);
+
+} /* eduom_PaxRowWidth() */
+
+
+
+/*@================================
+ * eduom_FormatPaxPage()
+ *================================*/
+/*
+ * Function: void eduom_FormatPaxPage(SlottedPage*, EduOM_PaxSchema*)
+ *
+ * Description:
+ *  Make the page an empty PAX page of the schema; the links of the page
+ *  are kept. As many rows as fit with their slots are given to the page,
+ *  and the minipage of each field is aligned to EDUOM_PAX_ALIGN bytes.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FormatPaxPage(
+    SlottedPage	*apage,		/* INOUT page to format */
+    EduOM_PaxSchema *schema)	/* IN schema of the rows */
+{
+    Four	f;		/* index variable */
+    Four	nRows;		/* rows the page can hold */
+    Four	offset;		/* offset of a minipage */
+    eduom_PaxPageHdr *paxHdr;	/* PAX header of the page */
+
+
+    /* the slot of the first row is in SP_FIXED; a minipage wastes less than EDUOM_PAX_ALIGN bytes */
+    nRows = (PAGESIZE - SP_FIXED - EDUOM_PAX_ALIGNED(sizeof(eduom_PaxPageHdr)) - schema->nFields*(EDUOM_PAX_ALIGN-1)
+             + sizeof(SlottedPageSlot)) / (eduom_PaxRowWidth(schema) + sizeof(SlottedPageSlot));
+
+    paxHdr = PAX_PAGE_HDR(apage);
+    paxHdr->schema = *schema;
+    paxHdr->nRows = nRows;
+
+    for (f = 0, offset = EDUOM_PAX_ALIGNED(sizeof(eduom_PaxPageHdr)); f < schema->nFields; f++) {
+        paxHdr->offset[f] = offset;
+        offset += EDUOM_PAX_ALIGNED(nRows*schema->width[f]);
+    }
+    for (; f < EDUOM_PAX_MAX_FIELDS; f++) {
+        paxHdr->schema.width[f] = 0;
+        paxHdr->offset[f] = 0;
+    }
+
+    apage->header.reserved = EDUOM_PAX_PAGE;
+    apage->header.nSlots = 0;
+    SP_RESERVE_FREE(apage);
+
+} /* eduom_FormatPaxPage() */
+
+
+
+/*@================================
+ * eduom_FindPaxRow()
+ *================================*/
+/*
+ * Function: Four eduom_FindPaxRow(SlottedPage*)
+ *
+ * Description:
+ *  Find a free row of the PAX page; the row of a slot is the slot itself,
+ *  so the first empty slot, or the slot following the slot array.
+ *
+ * Returns:
+ *  the free row, or NIL if the page is full
+ */
+static Four eduom_FindPaxRow(
+    SlottedPage	*apage)		/* IN PAX page */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (apage->slot[-i].offset == EMPTYSLOT) return(i);
+
+    if (i < PAX_PAGE_HDR(apage)->nRows) return(i);
+
+    return(NIL);
+
+} /* eduom_FindPaxRow() */
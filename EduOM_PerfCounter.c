@@ -0,0 +1,248 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PerfCounter.c
+ *
+ * Description:
+ *  Hardware counters of the calling process(cycles, instructions, L1D/LLC/
+ *  dTLB read misses, branch misses), read with perf_event_open() around the
+ *  workloads of EduOM_Bench.c. Only the user mode of this process is
+ *  counted, so that perf_event_paranoid up to 2 is enough.
+ *
+ *  The counters degrade gracefully: a counter which cannot be opened, e.g.
+ *  in a container whose seccomp profile denies perf_event_open() or on a
+ *  virtual machine without a PMU, is left unavailable and reads as -1, and
+ *  the others are still counted. Without Linux no counter is available.
+ *
+ * Internal:
+ *  Four eduom_OpenPerfCounters(Four*)
+ *  void eduom_StartPerfCounters(void)
+ *  void eduom_StopPerfCounters(double*)
+ *  void eduom_ClosePerfCounters(void)
+ *  char *eduom_PerfCounterName(Four)
+ */
+
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Global Variables
+ */
+/* file descriptors of the counters; -1 if the counter is not available */
+static int eduom_perfCounterFd[EDUOM_NUM_PERF_COUNTERS] = {
+    [0 ... EDUOM_NUM_PERF_COUNTERS-1] = -1
+};
+
+static char *eduom_perfCounterName[EDUOM_NUM_PERF_COUNTERS] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "dtlb_misses", "branch_misses"
+};
+
+
+
+/*@================================
+ * eduom_OpenPerfCounters()
+ *================================*/
+/*
+ * Function: Four eduom_OpenPerfCounters(Four*)
+ *
+ * Description:
+ *  Open the hardware counters of this process, disabled. A counter which
+ *  cannot be opened is left unavailable.
+ *
+ * Returns:
+ *  the number of counters opened (values greater than or equal to 0);
+ *  'err' is the errno of the last counter which could not be opened
+ */
+Four eduom_OpenPerfCounters(
+    Four	*err)		/* OUT errno of the last failure; 0 if none failed */
+{
+    Four	i;		/* index variable */
+    Four	nOpened;	/* counters opened */
+#ifdef __linux__
+    struct perf_event_attr attr;
+    static unsigned long long config[EDUOM_NUM_PERF_COUNTERS][2] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+              (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL |
+              (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB |
+              (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES }
+    };
+#endif
+
+
+    eduom_ClosePerfCounters();
+
+    *err = 0;
+    for (i = 0, nOpened = 0; i < EDUOM_NUM_PERF_COUNTERS; i++) {
+#ifdef __linux__
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = config[i][0];
+        attr.config = config[i][1];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        eduom_perfCounterFd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        if (eduom_perfCounterFd[i] < 0) *err = errno;
+        else nOpened++;
+#else
+        *err = ENOSYS;
+#endif
+    }
+
+    return(nOpened);
+
+} /* eduom_OpenPerfCounters() */
+
+
+
+/*@================================
+ * eduom_StartPerfCounters()
+ *================================*/
+/*
+ * Function: void eduom_StartPerfCounters(void)
+ *
+ * Description:
+ *  Reset and enable the available hardware counters.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_StartPerfCounters(void)
+{
+#ifdef __linux__
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < EDUOM_NUM_PERF_COUNTERS; i++)
+        if (eduom_perfCounterFd[i] >= 0) {
+            ioctl(eduom_perfCounterFd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(eduom_perfCounterFd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+
+} /* eduom_StartPerfCounters() */
+
+
+
+/*@================================
+ * eduom_StopPerfCounters()
+ *================================*/
+/*
+ * Function: void eduom_StopPerfCounters(double*)
+ *
+ * Description:
+ *  Disable the hardware counters and read them. A counter multiplexed with
+ *  others is scaled by the time it was enabled over the time it ran.
+ *
+ * Returns:
+ *  None; 'value' is -1 for a counter not available or never run
+ */
+void eduom_StopPerfCounters(
+    double	*value)		/* OUT values of the counters, indexed by EDUOM_PERF_XXX */
+{
+    Four	i;		/* index variable */
+#ifdef __linux__
+    unsigned long long buf[3];	/* value, time enabled, time running */
+#endif
+
+
+    for (i = 0; i < EDUOM_NUM_PERF_COUNTERS; i++) {
+        value[i] = -1;
+#ifdef __linux__
+        if (eduom_perfCounterFd[i] < 0) continue;
+
+        ioctl(eduom_perfCounterFd[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(eduom_perfCounterFd[i], buf, sizeof(buf)) != sizeof(buf) || buf[2] == 0) continue;
+
+        value[i] = (double)buf[0] * buf[1] / buf[2];
+#endif
+    }
+
+} /* eduom_StopPerfCounters() */
+
+
+
+/*@================================
+ * eduom_ClosePerfCounters()
+ *================================*/
+/*
+ * Function: void eduom_ClosePerfCounters(void)
+ *
+ * Description:
+ *  Close the hardware counters opened; they are all unavailable afterwards.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_ClosePerfCounters(void)
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < EDUOM_NUM_PERF_COUNTERS; i++) {
+        if (eduom_perfCounterFd[i] >= 0) close(eduom_perfCounterFd[i]);
+        eduom_perfCounterFd[i] = -1;
+    }
+
+} /* eduom_ClosePerfCounters() */
+
+
+
+/*@================================
+ * eduom_PerfCounterName()
+ *================================*/
+/*
+ * Function: char *eduom_PerfCounterName(Four)
+ *
+ * Description:
+ *  Return the name of the hardware counter.
+ *
+ * Returns:
+ *  name of the counter
+ */
+char *eduom_PerfCounterName(
+    Four	counter)	/* IN EDUOM_PERF_XXX */
+{
+    return(eduom_perfCounterName[counter]);
+
+} /* eduom_PerfCounterName() */
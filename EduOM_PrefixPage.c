@@ -0,0 +1,455 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_PrefixPage.c
+ *
+ * Description:
+ *  Prefix compression of the objects of a page. A new page of a file given
+ *  prefix pages by EduOM_SetPrefixPages() keeps a dictionary at the
+ *  beginning of its data area: the first EDUOM_PREFIX_MAX_LENGTH bytes of
+ *  the object the page is created for. An object put into the page which
+ *  shares a prefix with the dictionary(enough to save an aligned word) is
+ *  stored as the length of the prefix and the rest of its data, with
+ *  P_PREFIXED in its header. The length in the header is that of the bytes
+ *  stored, so the space of the page is managed as that of any slotted page;
+ *  eduom_CreateObject() encodes the objects, EduOM_CompactPage() keeps the
+ *  dictionary in place, and EduOM_ReadObject() reassembles the data.
+ *
+ *  EduOM_NextObjectWithPrefix() scans for the objects whose data begins
+ *  with a key. The key is compared with the dictionary once per page, so an
+ *  object of a prefix page is matched without reassembling its data.
+ *
+ *  EduOM_SetPrefixPages() makes the first page of the empty file a prefix
+ *  page with an empty dictionary, which the first object put into the page
+ *  fills, and the layout is derived from that page after the volume is
+ *  mounted again(see EduOM_FileLayout.c).
+ *
+ * Exports:
+ *  Four EduOM_SetPrefixPages(ObjectID*)
+ *  Four EduOM_NextObjectWithPrefix(ObjectID*, ObjectID*, char*, Four, ObjectID*)
+ *
+ * Internal:
+ *  void eduom_FormatPrefixPage(SlottedPage*, Four, char*)
+ *  Four eduom_PrefixLength(SlottedPage*, Four, char*)
+ *  Four eduom_NeededSpace(SlottedPage*, Four, char*)
+ *  Four eduom_CopyPrefixObject(SlottedPage*, Object*, Four, Four, char*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+static Four eduom_CommonPrefix(char*, char*, Four);
+static Boolean eduom_MatchPrefix(SlottedPage*, ObjectID*, char*, Four, Four);
+
+
+
+/*@================================
+ * EduOM_SetPrefixPages()
+ *================================*/
+/*
+ * Function: Four EduOM_SetPrefixPages(ObjectID*)
+ *
+ * Description:
+ *  Make the pages of the file prefix pages. The file must be empty, or
+ *  already given prefix pages(e.g. a file of a volume mounted again).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetPrefixPages(
+    ObjectID	*catObjForFile)	/* IN file to be given prefix pages */
+{
+    Four	e;		/* error number */
+    eduom_FileLayout layout;	/* the layout of prefix pages */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    memset(&layout, 0, sizeof(eduom_FileLayout));
+    layout.layout = EDUOM_PREFIX_LAYOUT;
+
+    e = eduom_SetFileLayout(catObjForFile, &layout);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetPrefixPages() */
+
+
+
+/*@================================
+ * EduOM_NextObjectWithPrefix()
+ *================================*/
+/*
+ * Function: Four EduOM_NextObjectWithPrefix(ObjectID*, ObjectID*, char*, Four, ObjectID*)
+ *
+ * Description:
+ *  Return the next object after 'curOID'(the first object of the file if
+ *  NULL) whose data begins with the key. The objects of the PAX, fixed
+ *  length record and small object pages are matched by copying their
+ *  first bytes.
+ *
+ * Returns:
+ *  error code
+ *    EOS if there is no such object
+ *    eBADCATALOGOBJECT_OM
+ *    eBADOBJECTID_OM
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four EduOM_NextObjectWithPrefix(
+    ObjectID	*catObjForFile,	/* IN file to scan */
+    ObjectID	*curOID,	/* IN object to scan after; NULL to scan from the beginning */
+    char	*key,		/* IN prefix of the objects to find */
+    Four	keyLen,		/* IN length of the key */
+    ObjectID	*nextOID)	/* OUT object found */
+{
+    Four	e;		/* error number */
+    Four	slotNo;		/* slot to look at */
+    Four	dictMatch;	/* bytes of the key matching the dictionary of the page */
+    PageID	pid;		/* page to look at */
+    PageNo	lastPage;	/* last page of the file */
+    PageNo	nextPage;	/* page after pid */
+    ObjectID	oid;		/* object looked at */
+    SlottedPage	*apage;		/* the page */
+    SlottedPage	*catPage;	/* buffer page containing the catalog object */
+    sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    if (nextOID == NULL) ERR(eBADOBJECTID_OM);
+
+    if (keyLen < 0 || (keyLen > 0 && key == NULL)) ERR(eBADPARAMETER);
+
+    BfM_SetCaller(BFM_CALLER_SCAN);
+
+    e = BfM_GetTrainForRead((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+    GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
+
+    pid.volNo = catEntry->fid.volNo;
+    pid.pageNo = (curOID == NULL) ? catEntry->firstPage : curOID->pageNo;
+    slotNo = (curOID == NULL) ? 0 : curOID->slotNo + 1;
+    lastPage = catEntry->lastPage;
+
+    e = BfM_FreeTrainForRead((TrainID *)catObjForFile, (char *)catPage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    /* no object is as long as a page */
+    if (keyLen >= PAGESIZE) return(EOS);
+
+    while (pid.pageNo != NIL) {
+        e = BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        dictMatch = (IS_PREFIX_PAGE(apage)) ?
+            eduom_CommonPrefix(PREFIX_DICT(apage), key, MIN(keyLen, PREFIX_DICT_LENGTH(apage))) : 0;
+
+        for ( ; slotNo < apage->header.nSlots; slotNo++) {
+            MAKE_OBJECTID(oid, pid.volNo, pid.pageNo, slotNo, SLOT_UNIQUE(apage, slotNo));
+
+            if (eduom_MatchPrefix(apage, &oid, key, keyLen, dictMatch)) {
+                *nextOID = oid;
+                e = BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+                if (e < 0) ERR(e);
+                return(eNOERROR);
+            }
+        }
+
+        nextPage = (pid.pageNo == lastPage) ? NIL : apage->header.nextPage;
+
+        e = BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        pid.pageNo = nextPage;
+        slotNo = 0;
+    }
+
+    return(EOS);
+
+} /* EduOM_NextObjectWithPrefix() */
+
+
+
+/*@================================
+ * eduom_FormatPrefixPage()
+ *================================*/
+/*
+ * Function: void eduom_FormatPrefixPage(SlottedPage*, Four, char*)
+ *
+ * Description:
+ *  Make the new empty page a prefix page whose dictionary is the head of
+ *  the object the page is created for. The page is left as it is if the
+ *  object is shorter than EDUOM_PREFIX_MIN_LENGTH bytes, or too long to be
+ *  put into the page after the dictionary. If 'data' is NULL, the page is
+ *  made a prefix page with an empty dictionary, which is made again from
+ *  the first object put into the page(see eduom_CreateObject()).
+ *
+ * Returns:
+ *  None
+ */
+void eduom_FormatPrefixPage(
+    SlottedPage	*apage,		/* INOUT new page */
+    Four	length,		/* IN length of the object */
+    char	*data)		/* IN data of the object; NULL for an empty dictionary */
+{
+    Four	dictLength;	/* length of the dictionary */
+
+
+    if (data == NULL) {
+        apage->header.reserved = EDUOM_PREFIX_PAGE;
+        PREFIX_DICT_LENGTH(apage) = 0;
+        apage->header.free = PREFIX_DICT_SIZE(apage);
+        return;
+    }
+
+    dictLength = MIN(length, EDUOM_PREFIX_MAX_LENGTH);
+    if (dictLength < EDUOM_PREFIX_MIN_LENGTH) return;
+
+    if (ALIGNED_LENGTH((Four)sizeof(Two) + dictLength) + (Four)sizeof(ObjectHdr) +
+        ALIGNED_LENGTH(1 + length - dictLength) > PAGESIZE - SP_FIXED) return;
+
+    apage->header.reserved = EDUOM_PREFIX_PAGE;
+    PREFIX_DICT_LENGTH(apage) = dictLength;
+    memcpy(PREFIX_DICT(apage), data, dictLength);
+    apage->header.free = PREFIX_DICT_SIZE(apage);
+
+} /* eduom_FormatPrefixPage() */
+
+
+
+/*@================================
+ * eduom_PrefixLength()
+ *================================*/
+/*
+ * Function: Four eduom_PrefixLength(SlottedPage*, Four, char*)
+ *
+ * Description:
+ *  Return the length of the prefix of the object to be taken from the
+ *  dictionary of the page. The prefix is used only if it makes the object
+ *  take fewer aligned bytes.
+ *
+ * Returns:
+ *  length of the prefix; 0 if the object is to be stored as it is
+ */
+Four eduom_PrefixLength(
+    SlottedPage	*apage,		/* IN page the object is to be put into */
+    Four	length,		/* IN length of the object */
+    char	*data)		/* IN data of the object */
+{
+    Four	prefixLength;	/* length of the common prefix */
+
+
+    if (!IS_PREFIX_PAGE(apage)) return(0);
+
+    prefixLength = eduom_CommonPrefix(PREFIX_DICT(apage), data, MIN(length, PREFIX_DICT_LENGTH(apage)));
+
+    if (ALIGNED_LENGTH(1 + length - prefixLength) >= ALIGNED_LENGTH(length)) return(0);
+
+    return(prefixLength);
+
+} /* eduom_PrefixLength() */
+
+
+
+/*@================================
+ * eduom_NeededSpace()
+ *================================*/
+/*
+ * Function: Four eduom_NeededSpace(SlottedPage*, Four, char*)
+ *
+ * Description:
+ *  Return the space the object takes if it is put into the page: its
+ *  header, its aligned data and a slot. The data of an object of a prefix
+ *  page may be shorter(see eduom_PrefixLength()).
+ *
+ * Returns:
+ *  bytes of the page needed
+ */
+Four eduom_NeededSpace(
+    SlottedPage	*apage,		/* IN page the object is to be put into */
+    Four	length,		/* IN length of the object */
+    char	*data)		/* IN data of the object */
+{
+    Four	prefixLength;	/* length of the prefix taken from the dictionary */
+
+
+    prefixLength = eduom_PrefixLength(apage, length, data);
+    if (prefixLength > 0) length = 1 + length - prefixLength;
+
+    return(sizeof(ObjectHdr) + ALIGNED_LENGTH(length) + sizeof(SlottedPageSlot));
+
+} /* eduom_NeededSpace() */
+
+
+
+/*@================================
+ * eduom_CopyPrefixObject()
+ *================================*/
+/*
+ * Function: Four eduom_CopyPrefixObject(SlottedPage*, Object*, Four, Four, char*)
+ *
+ * Description:
+ *  Copy the requested bytes of the P_PREFIXED object into the user buffer,
+ *  taking its prefix from the dictionary of the page. As the page may be
+ *  read without being fixed, the prefix length is checked before use.
+ *
+ * Returns:
+ *  1) number of bytes copied (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ */
+Four eduom_CopyPrefixObject(
+    SlottedPage	*apage,		/* IN page containing the object */
+    Object	*obj,		/* IN the object; its stored length is checked by the caller */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four	prefixLength;	/* length of the prefix taken from the dictionary */
+    Four	objLength;	/* length of the object */
+    Four	n;		/* bytes copied from the dictionary */
+
+
+    if (!IS_PREFIX_PAGE(apage) || obj->header.length < 1) return(eBADOBJECTID_OM);
+
+    prefixLength = (unsigned char)obj->data[0];
+    if (prefixLength > PREFIX_DICT_LENGTH(apage) || PREFIX_DICT_LENGTH(apage) > EDUOM_PREFIX_MAX_LENGTH)
+        return(eBADOBJECTID_OM);
+
+    objLength = prefixLength + obj->header.length - 1;
+
+    if (start > objLength) return(eBADSTART_OM);
+
+    if (length == REMAINDER) length = objLength - start;
+    if (length < 0 || start + length > objLength) return(eBADLENGTH_OM);
+
+    n = (start < prefixLength) ? MIN(prefixLength - start, length) : 0;
+    memcpy(buf, PREFIX_DICT(apage) + start, n);
+    if (length > n) memcpy(buf + n, &obj->data[1 + start + n - prefixLength], length - n);
+
+    return(length);
+
+} /* eduom_CopyPrefixObject() */
+
+
+
+/*@================================
+ * eduom_CommonPrefix()
+ *================================*/
+/*
+ * Function: Four eduom_CommonPrefix(char*, char*, Four)
+ *
+ * Description:
+ *  Return the length of the common prefix of two byte strings.
+ *
+ * Returns:
+ *  length of the common prefix, at most 'n'
+ */
+static Four eduom_CommonPrefix(
+    char	*a,		/* IN a byte string */
+    char	*b,		/* IN another byte string */
+    Four	n)		/* IN bytes to compare */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < n && a[i] == b[i]; i++);
+
+    return(i);
+
+} /* eduom_CommonPrefix() */
+
+
+
+/*@================================
+ * eduom_MatchPrefix()
+ *================================*/
+/*
+ * Function: Boolean eduom_MatchPrefix(SlottedPage*, ObjectID*, char*, Four, Four)
+ *
+ * Description:
+ *  Tell whether the data of the object begins with the key. The prefix of
+ *  a P_PREFIXED object is matched through 'dictMatch', the bytes of the key
+ *  matching the dictionary of the page, and only the rest is compared.
+ *
+ * Returns:
+ *  TRUE or FALSE; FALSE for an empty slot
+ */
+static Boolean eduom_MatchPrefix(
+    SlottedPage	*apage,		/* IN page containing the object */
+    ObjectID	*oid,		/* IN the object */
+    char	*key,		/* IN prefix to match */
+    Four	keyLen,		/* IN length of the key */
+    Four	dictMatch)	/* IN bytes of the key matching the dictionary */
+{
+    Four	n;		/* bytes copied */
+    Four	prefixLength;	/* length of the prefix taken from the dictionary */
+    Object	*obj;		/* the object */
+    char	buf[PAGESIZE];	/* first bytes of an object of another kind of page */
+
+
+    /* the other kinds of pages: copy the first bytes of the object */
+    if (IS_PAX_PAGE(apage) || IS_FIXED_PAGE(apage) || IS_SMALL_PAGE(apage)) {
+        if (IS_PAX_PAGE(apage)) n = eduom_CopyPaxRow(apage, oid, 0, keyLen, buf);
+        else if (IS_FIXED_PAGE(apage)) n = eduom_CopyFixedRecord(apage, oid, 0, keyLen, buf);
+        else n = eduom_CopySmallObject(apage, oid, 0, keyLen, buf);
+
+        return(n == keyLen && memcmp(buf, key, keyLen) == 0);
+    }
+
+    if (SLOT_OFFSET(apage, oid->slotNo) == EMPTYSLOT) return(FALSE);
+
+    obj = (Object *)&(apage->data[SLOT_OFFSET(apage, oid->slotNo)]);
+
+    if (!(obj->header.properties & P_PREFIXED))
+        return(obj->header.length >= keyLen && memcmp(obj->data, key, keyLen) == 0);
+
+    prefixLength = (unsigned char)obj->data[0];
+
+    /* the key ends within the prefix, or differs from the dictionary there */
+    if (keyLen <= prefixLength) return(dictMatch >= keyLen);
+    if (dictMatch < prefixLength) return(FALSE);
+
+    return(obj->header.length - 1 >= keyLen - prefixLength &&
+           memcmp(&obj->data[1], key + prefixLength, keyLen - prefixLength) == 0);
+
+} /* eduom_MatchPrefix() */
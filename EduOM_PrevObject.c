@@ -34,6 +34,7 @@
 
 
 #include "EduOM_common.h"
+#include "RDsM.h"
 #include "BfM.h"
 #include "EduOM_Internal.h"
 
@@ -51,6 +52,8 @@
  *  the same page which has the current object and  if there  is no previous
  *  object in the same page, find it from the previous page.
  *  If the current object is NULL, return the last object of the file.
+ *  The empty slots are skipped; the prevOID is left as it is at the
+ *  beginning of the file.
  *
  * Returns:
  *  error code
@@ -70,13 +73,11 @@ Four EduOM_PrevObject(
     ObjectID *prevOID,		/* OUT the previous object of a current object */
     ObjectHdr*objHdr)		/* OUT the object header of previous object */
 {
-    Four e;			/* error */
-    Two  i;			/* index */
-    Four offset;		/* starting offset of object within a page */
+    Four slotNo;		/* slot of the previous object */
     PageID pid;			/* a page identifier */
+    PageID aheadPid;		/* the page the scan is going to visit next */
     PageNo pageNo;		/* a temporary var for previous page's PageNo */
     SlottedPage *apage;		/* a pointer to the data page */
-    Object *obj;		/* a pointer to the Object */
     SlottedPage *catPage;	/* buffer page containing the catalog object */
     sm_CatOverlayForData *catEntry; /* overlay structure for catalog object access */
 
@@ -87,69 +88,66 @@ Four EduOM_PrevObject(
     
     if (prevOID == NULL) ERR(eBADOBJECTID_OM);
 
+    // buffer manager 통계를 scan 연산으로 집계한다.
+    BfM_SetCaller(BFM_CALLER_SCAN);
+    EDUOM_STATS_TIMER(EDUOM_API_PREV);
+    EDUOM_PROBE_API(EDUOM_API_PREV, curOID);
+
     // 0. catEntry를 불러온다.
-    BfM_GetTrain((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
+    BfM_GetTrainForRead((TrainID *)catObjForFile, (char **)&catPage, PAGE_BUF);
     GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry);
     //MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
 
     // 1. curOID가 NULL인 경우
     if (curOID == NULL) {
-        // File에 들어있는 마지막 object의 ID를 반환한다.
-        //pageNo = catEntry->firstPage;
-        pageNo = catEntry->lastPage;
-
-        MAKE_PAGEID(pid, catEntry->fid.volNo, pageNo);
-        BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        prevOID->volNo = pid.volNo;
-        prevOID->pageNo = pageNo;
-        prevOID->slotNo = apage->header.nSlots - 1; // 마지막 object
-        prevOID->unique = apage->slot[-prevOID->slotNo].unique;
+        // File의 마지막 page부터 마지막 object를 찾는다.
+        MAKE_PAGEID(pid, catEntry->fid.volNo, catEntry->lastPage);
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-        //BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+        slotNo = eduom_PrevLiveSlot(apage, apage->header.nSlots - 1);
     }
     // 2. curOID가 NULL이 아닌 경우
     else {
         // 2-1. curOID에 대응되는 object를 찾는다.
         MAKE_PAGEID(pid, curOID->volNo, curOID->pageNo);
-        BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
-
-        // 2-2. slot array에서 curOID 이전에 있는 object를 찾아 ID를 반환한다.
-        //      만약 curOID object가 현재 page의 첫 object라면 이전 page의 마지막 object를 찾아 반환한다.
-        //      만약 이전 page가 EMPTY라면 EOS를 반환한다.
-        //      만약 curOID object가 첫 page의 첫 object라면 EOS를 반환한다.
-
-        // Case 1. curOID가 해당 page의 첫 object가 아님
-        if (curOID->slotNo != 0) {
-            prevOID->volNo = curOID->volNo;
-            prevOID->pageNo = curOID->pageNo;
-            prevOID->slotNo = curOID->slotNo - 1;
-            prevOID->unique = apage->slot[-prevOID->slotNo].unique;
-        }
-        // Case 2. curOID가 해당 page의 첫 object임
-        else {
-            // Case 2-1. curOID가 마지막 page의 마지막 object 였음
-            //if (apage->header.pid.pageNo == catEntry->lastPage) continue;
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-            // Case 2-2. curOID가 prevPage가 있는 page의 마지막 object 였음
-            if (apage->header.pid.pageNo != catEntry->firstPage) {
-                pageNo = apage->header.prevPage;
+        // 2-2. slot array에서 curOID 이전에 있는 object를 찾는다.
+        //      빈 slot은 건너뛴다(see EduOM_SlotKernel.c).
+        slotNo = eduom_PrevLiveSlot(apage, curOID->slotNo - 1);
+    }
 
-                prevOID->volNo = curOID->volNo;
-                prevOID->pageNo = pageNo;
-                prevOID->slotNo = apage->header.nSlots - 1; //첫 object
+    // 3. 현재 page에 이전 object가 없다면 이전 page들에서 마지막 object를 찾는다.
+    //    첫 page까지 object가 없다면 prevOID를 바꾸지 않고 EOS를 반환한다.
+    while (slotNo == NIL && apage->header.pid.pageNo != catEntry->firstPage) {
+        pageNo = apage->header.prevPage;
 
-                BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-                MAKE_PAGEID(pid, prevOID->volNo, prevOID->pageNo);
-                BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+        MAKE_PAGEID(pid, pid.volNo, pageNo);
 
-                prevOID->unique = apage->slot[-prevOID->slotNo].unique;
-            }
+        // 이전 page가 buffer에 없다면 volume의 scan unit만큼 앞의 page들을 함께 읽는다.
+        // read-ahead는 hint이므로 실패해도 scan을 계속한다.
+        eduom_ReadAhead(&pid, -1);
+        BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+
+        // mapped volume이라면 scan이 다음에 방문할 page를 미리 읽어 두도록 hint를 준다.
+        if (apage->header.prevPage != NIL) {
+            MAKE_PAGEID(aheadPid, pid.volNo, apage->header.prevPage);
+            RDsM_AdviseMappedTrains(&aheadPid, 1, RDSM_ADVICE_WILLNEED);
         }
+
+        slotNo = eduom_PrevLiveSlot(apage, apage->header.nSlots - 1);
+    }
+
+    if (slotNo != NIL) {
+        prevOID->volNo = pid.volNo;
+        prevOID->pageNo = pid.pageNo;
+        prevOID->slotNo = slotNo;
+        prevOID->unique = SLOT_UNIQUE(apage, slotNo);
     }
 
-    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
-    BfM_FreeTrain((TrainID *)catObjForFile, PAGE_BUF);
+    BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+    BfM_FreeTrainForRead((TrainID *)catObjForFile, (char *)catPage, PAGE_BUF);
     
 
     return(EOS);
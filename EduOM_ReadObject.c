@@ -41,6 +41,8 @@
 #include "EduOM_Internal.h"
 
 
+static Four eduom_CopyObjectData(SlottedPage*, ObjectID*, Four, Four, char*);
+
 
 /*@================================
  * EduOM_ReadObject()
@@ -64,6 +66,9 @@
  *
  *  (2) How to do?
  *  a. Read in the slotted page
+ *     (If the page is in the buffer pool, the object is copied without fixing
+ *      the page and the copy is validated against the frame version; the page
+ *      is fixed only when the page is not in the pool or validation fails.)
  *  b. See the object header
  *  c. IF moved object THEN
  *	   call this routine recursively with the forwarded object's identifier
@@ -95,8 +100,8 @@ Four EduOM_ReadObject(
     Four     	e;              /* error code */
     PageID 	pid;		/* page containing object specified by 'oid' */
     SlottedPage	*apage;		/* pointer to the buffer of the page  */
-    Object	*obj;		/* pointer to the object in the slotted page */
-    Four	offset;		/* offset of the object in the page */
+    UFour	version;	/* version of the buffer frame read optimistically */
+    Four	retry;		/* number of optimistic reads tried */
 
     
     
@@ -108,22 +113,108 @@ Four EduOM_ReadObject(
     
     if (buf == NULL) ERR(eBADUSERBUF_OM);
 
-    // 1. oid를 활용해 object에 접근한다.
-    // 1-1. oid를 활용해 object가 들어있는 page를 알아낸다.
+    if (start < 0) ERR(eBADSTART_OM);
+
+    // buffer manager 통계를 읽기 연산으로 집계한다.
+    BfM_SetCaller(BFM_CALLER_READ);
+    EDUOM_STATS_TIMER(EDUOM_API_READ);
+    EDUOM_PROBE_API(EDUOM_API_READ, oid);
+
+    // 1. oid를 활용해 object가 들어있는 page를 알아낸다.
     MAKE_PAGEID(pid, oid->volNo, oid->pageNo);
-    BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
 
-    // 1-2. obj 포인터를 얻는다.
-    obj = (Object *)&(apage->data[apage->slot[-oid->slotNo].offset]);
+    // 2. page가 buffer에 있다면 fix하지 않고 optimistic하게 읽는다.
+    //    writer가 중간에 page를 수정했다면 version이 달라지므로 다시 읽는다.
+    for (retry = 0; retry < MAX_OPTIMISTIC_READ_RETRIES; retry++) {
+        apage = (SlottedPage *)BfM_LookUpFrame((TrainID *)&pid, PAGE_BUF, &version);
+        if (apage == NULL) break;	/* not in the buffer pool */
+        if (version & 1) continue;	/* a writer is modifying the page */
 
-    // 2. start, length를 사용해 object의 데이터를 읽는다.
-    // If length == REMAINDER, reade data to the end
-    if (length == REMAINDER) length = obj->header.length;
-    memcpy(buf, &(obj->data[start]), length);
+        e = eduom_CopyObjectData(apage, oid, start, length, buf);
+        if (BfM_ValidateFrame((TrainID *)&pid, PAGE_BUF, (char *)apage, version)) {
+            if (e < 0) ERR(e);
+            return(e);
+        }
+    }
+
+    // 3. optimistic read에 실패하면 page를 fix해서 읽는다.
+    //    mapped volume의 page가 buffer에 없다면 mapping에서 바로 읽는다.
+    e = BfM_GetTrainForRead((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    length = eduom_CopyObjectData(apage, oid, start, length, buf);
 
-    // 3. 마무리
-    BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    // 4. 마무리
+    e = BfM_FreeTrainForRead((TrainID *)&pid, (char *)apage, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    if (length < 0) ERR(length);
 
     return(length);
     
 } /* EduOM_ReadObject() */
+
+
+
+/*@================================
+ * eduom_CopyObjectData()
+ *================================*/
+/*
+ * Function: Four eduom_CopyObjectData(SlottedPage*, ObjectID*, Four, Four, char*)
+ *
+ * Description:
+ *  Copy the requested bytes of the object into the user buffer. The page may
+ *  be read without being fixed and so may be modified concurrently; every
+ *  offset and length taken from the page is checked against the page bounds
+ *  before it is used, and the result is trusted only after validation.
+ *
+ * Returns:
+ *  1) number of bytes copied (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ */
+static Four eduom_CopyObjectData(
+    SlottedPage	*apage,		/* IN page containing the object */
+    ObjectID	*oid,		/* IN object to read */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four	offset;		/* offset of the object in the page */
+    Four	objLength;	/* length of the object */
+    Object	*obj;		/* pointer to the object in the slotted page */
+
+
+    // PAX page라면 minipage들에서 row의 field들을 모은다.
+    if (IS_PAX_PAGE(apage)) return(eduom_CopyPaxRow(apage, oid, start, length, buf));
+
+    // fixed length record page라면 record array에서 바로 읽는다.
+    if (IS_FIXED_PAGE(apage)) return(eduom_CopyFixedRecord(apage, oid, start, length, buf));
+
+    // small object page라면 압축된 header를 풀어서 읽는다.
+    if (IS_SMALL_PAGE(apage)) return(eduom_CopySmallObject(apage, oid, start, length, buf));
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots) return(eBADOBJECTID_OM);
+
+    offset = SLOT_OFFSET(apage, oid->slotNo);
+    if (offset < 0 || offset + (Four)sizeof(ObjectHdr) > PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+
+    obj = (Object *)&(apage->data[offset]);
+    objLength = obj->header.length;
+    if (objLength < 0 || offset + (Four)sizeof(ObjectHdr) + objLength > PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+
+    // prefix가 압축된 object라면 page의 dictionary에서 prefix를 가져와 다시 조립한다.
+    if (obj->header.properties & P_PREFIXED) return(eduom_CopyPrefixObject(apage, obj, start, length, buf));
+
+    if (start > objLength) return(eBADSTART_OM);
+
+    // If length == REMAINDER, reade data to the end
+    if (length == REMAINDER) length = objLength - start;
+    if (length < 0 || start + length > objLength) return(eBADLENGTH_OM);
+    memcpy(buf, &(obj->data[start]), length);
+
+    return(length);
+
+} /* eduom_CopyObjectData() */
@@ -0,0 +1,216 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_ScanUnit.c
+ *
+ * Description:
+ *  Scan unit of a volume. The slotted pages are PAGESIZE bytes, fixed when
+ *  cosmos.o was built, so a volume cannot be formatted with larger pages;
+ *  instead a scan of a volume reads its pages in units of 8K..64K. When
+ *  EduOM_NextObject() or EduOM_PrevObject() moves to a page which is not
+ *  in the buffer pool, the pages following it in the scan direction, up to
+ *  the scan unit and within the extent of the page, are prefetched together
+ *  (see BfM_PrefetchTrains()). The pages of a data file are allocated near
+ *  each other in its extents, so most of them are the pages the scan visits
+ *  next; a prefetched page which is not is just a clean unfixed buffer.
+ *
+ *  The pages of a mapped volume are read from the mapping, not the buffer
+ *  pool, so they are not prefetched(see RDsM_AdviseMappedTrains()).
+ *
+ * Exports:
+ *  Four EduOM_SetScanUnit(VolNo, Four)
+ *  Four EduOM_GetScanUnit(VolNo)
+ *
+ * Internal:
+ *  Four eduom_ReadAhead(PageID*, Four)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_MAX_SCAN_UNIT_VOLS    20      /* volumes whose scan unit can be set */
+#define EDUOM_MAX_SCAN_UNIT         (64*1024)
+
+
+/*@
+ * Type Definitions
+ */
+/* scan unit of a volume */
+typedef struct {
+    VolNo	volNo;		/* NIL if the entry is not used */
+    Four	nPages;		/* pages read at a time */
+} eduom_ScanUnit;
+
+
+/*@
+ * Global Variables
+ */
+static eduom_ScanUnit eduom_scanUnit[EDUOM_MAX_SCAN_UNIT_VOLS] = {
+    [0 ... EDUOM_MAX_SCAN_UNIT_VOLS-1] = { NIL, 1 }
+};
+
+
+
+/*@================================
+ * EduOM_SetScanUnit()
+ *================================*/
+/*
+ * Function: Four EduOM_SetScanUnit(VolNo, Four)
+ *
+ * Description:
+ *  Set the bytes a scan of the volume reads at a time: PAGESIZE(the default;
+ *  no read-ahead) or a power of two multiple of it up to 64K.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER_OM
+ *    eTABLEFULL_EDUOM
+ */
+Four EduOM_SetScanUnit(
+    VolNo	volNo,		/* IN volume number */
+    Four	unitSize)	/* IN bytes read at a time */
+{
+    Four	i;		/* index variable */
+    Four	freeEntry;	/* unused entry */
+
+
+    /*@ check parameters */
+
+    if (volNo < 0) ERR(eBADPARAMETER_OM);
+
+    if (unitSize < PAGESIZE || unitSize > EDUOM_MAX_SCAN_UNIT ||
+        unitSize % PAGESIZE != 0 || (unitSize & (unitSize - 1)) != 0) ERR(eBADPARAMETER_OM);
+
+    for (i = 0, freeEntry = NIL; i < EDUOM_MAX_SCAN_UNIT_VOLS; i++) {
+        if (eduom_scanUnit[i].volNo == volNo) break;
+        if (eduom_scanUnit[i].volNo == NIL && freeEntry == NIL) freeEntry = i;
+    }
+
+    if (unitSize == PAGESIZE) {
+        if (i < EDUOM_MAX_SCAN_UNIT_VOLS) eduom_scanUnit[i].volNo = NIL;
+        return(eNOERROR);
+    }
+
+    if (i == EDUOM_MAX_SCAN_UNIT_VOLS) {
+        if (freeEntry == NIL) ERR(eTABLEFULL_EDUOM);
+        i = freeEntry;
+    }
+
+    eduom_scanUnit[i].volNo = volNo;
+    eduom_scanUnit[i].nPages = unitSize / PAGESIZE;
+
+    return(eNOERROR);
+
+} /* EduOM_SetScanUnit() */
+
+
+
+/*@================================
+ * EduOM_GetScanUnit()
+ *================================*/
+/*
+ * Function: Four EduOM_GetScanUnit(VolNo)
+ *
+ * Description:
+ *  Return the bytes a scan of the volume reads at a time.
+ *
+ * Returns:
+ *  scan unit in bytes
+ */
+Four EduOM_GetScanUnit(
+    VolNo	volNo)		/* IN volume number */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < EDUOM_MAX_SCAN_UNIT_VOLS; i++)
+        if (eduom_scanUnit[i].volNo == volNo) return(eduom_scanUnit[i].nPages * PAGESIZE);
+
+    return(PAGESIZE);
+
+} /* EduOM_GetScanUnit() */
+
+
+
+/*@================================
+ * eduom_ReadAhead()
+ *================================*/
+/*
+ * Function: Four eduom_ReadAhead(PageID*, Four)
+ *
+ * Description:
+ *  Prefetch the page a scan is moving to and the pages following it in the
+ *  scan direction, up to the scan unit of its volume and within its extent,
+ *  if the page is not in the buffer pool.
+ *
+ * Returns:
+ *  the number of pages prefetched
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_ReadAhead(
+    PageID	*pid,		/* IN page the scan is moving to */
+    Four	direction)	/* IN 1 for a forward scan, -1 for a backward one */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	n;		/* pages to prefetch */
+    Four	nPages;		/* scan unit in pages */
+    Four	extNo;		/* extent of the page */
+    Four	ext;		/* extent of a following page */
+    UFour	version;	/* version of the buffer frame */
+    PageID	pages[EDUOM_MAX_SCAN_UNIT / PAGESIZE]; /* pages to prefetch */
+
+
+    nPages = EduOM_GetScanUnit(pid->volNo) / PAGESIZE;
+    if (nPages <= 1) return(0);
+
+    if (BfM_LookUpFrame((TrainID *)pid, PAGE_BUF, &version) != NULL) return(0);
+    if (RDsM_GetMappedTrain(pid, 1) != NULL) return(0);
+
+    e = RDsM_PageIdToExtNo(pid, &extNo);
+    if (e < 0) ERR(e);
+
+    pages[0] = *pid;
+    for (n = 1, i = 1; i < nPages && pid->pageNo + i*direction >= 0; i++, n++) {
+        MAKE_PAGEID(pages[n], pid->volNo, pid->pageNo + i*direction);
+        e = RDsM_PageIdToExtNo(&pages[n], &ext);
+        if (e < 0 || ext != extNo) break;
+    }
+
+    e = BfM_PrefetchTrains((TrainID *)pages, n, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(e);
+
+} /* eduom_ReadAhead() */
@@ -0,0 +1,470 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_SlotKernel.c
+ *
+ * Description:
+ *  Kernels which scan the slot array of a page and move the objects when
+ *  the page is compacted. The search for an empty slot has a plain C
+ *  version and SSE2 and AVX2 versions. The SSE2 version is chosen when it
+ *  is first called if the processor supports it, as the AVX2 version was
+ *  no faster, and eduom_SelectSlotKernels() chooses another, e.g. to
+ *  compare them.
+ *
+ *  A SIMD version compares the offsets of 16 slots with EMPTYSLOT at a time
+ *  and returns a mask of the empty ones, bit k for the k-th slot from the
+ *  lowest address; since the slot arrays grow backwards, bit k is the slot
+ *  15-k of the 16. It is used only where the offsets are 2 bytes apart, in
+ *  a SoA page(see EduOM_SoaPage.c) and a small object page(see
+ *  EduOM_SmallPage.c). Where they are 8 bytes apart, in SlottedPageSlot,
+ *  the masks were not faster than the plain C loop(see the 'kernels'
+ *  workload of EduOM_Bench.c), so every instruction set scans those slots
+ *  one by one. The first few slots are looked at one by one in any case,
+ *  as the slot looked for is often one of them. The 16 slots read may go
+ *  past 'nSlots' towards the data area, but never out of the page.
+ *
+ *  The searches for the next and the previous live slot and eduom_MoveDown()
+ *  are plain C for every instruction set, for the same reason: a live slot
+ *  is found within a few slots on most pages, and memmove() of the C
+ *  library is already vectorized. A fixed length record page(see
+ *  EduOM_FixedPage.c) is scanned through its bitmap a word at a time.
+ *  eduom_MoveDown() moves a run of objects which stay adjacent with one
+ *  call, so that EduOM_CompactPage() copies each run once.
+ *
+ * Internal:
+ *  Four eduom_SelectSlotKernels(Four)
+ *  Four eduom_GetSlotKernels(void)
+ *  char *eduom_SlotKernelName(Four)
+ *  Four eduom_FindEmptySlot(SlottedPage*)
+ *  Four eduom_NextLiveSlot(SlottedPage*, Four)
+ *  Four eduom_PrevLiveSlot(SlottedPage*, Four)
+ *  void eduom_MoveDown(char*, char*, Four)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "EduOM_Internal.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define EDUOM_SLOT_KERNEL_X86
+#endif
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_KERNEL_SLOTS      16      /* slots a mask covers */
+#define EDUOM_KERNEL_FULL_MASK  0xffff  /* ... all of them */
+#define EDUOM_KERNEL_PROBE      4       /* slots looked at one by one before the masks */
+#define EDUOM_KERNEL_DEFAULT    EDUOM_ISA_SSE2 /* instruction set chosen if none is given */
+
+
+/*@
+ * Type Definitions
+ */
+/* kernel returning the mask of the empty ones of the 16 slots from the given offset on */
+typedef UFour (*eduom_EmptyMaskFunc)(char*);
+
+/* versions of the kernels for an instruction set */
+typedef struct {
+    char  *name;                            /* name of the instruction set */
+    eduom_EmptyMaskFunc emptyMask2;         /* for the offsets 2 bytes apart */
+} eduom_SlotKernel;
+
+
+/*@
+ * Function Prototypes
+ */
+#ifdef EDUOM_SLOT_KERNEL_X86
+static UFour eduom_EmptyMask2Sse2(char*);
+static UFour eduom_EmptyMask2Avx2(char*);
+#endif
+
+
+/*@
+ * Global Variables
+ */
+/* the plain C version scans slot by slot without masks */
+static eduom_SlotKernel eduom_slotKernels[EDUOM_NUM_ISAS] = {
+    { "scalar", NULL },
+#ifdef EDUOM_SLOT_KERNEL_X86
+    { "sse2", eduom_EmptyMask2Sse2 },
+    { "avx2", eduom_EmptyMask2Avx2 }
+#else
+    { "sse2", NULL },
+    { "avx2", NULL }
+#endif
+};
+
+/* kernels chosen; NULL until a kernel is first called */
+static eduom_SlotKernel *eduom_slotKernel = NULL;
+
+
+/* Macro: EDUOM_SLOT_KERNEL()
+ * Description: return the kernels chosen, choosing those of
+ *              EDUOM_KERNEL_DEFAULT or the one below it the processor
+ *              supports if none is chosen yet
+ * Returns: (eduom_SlotKernel *) the kernels
+ */
+#define EDUOM_SLOT_KERNEL() \
+    ((eduom_slotKernel != NULL || eduom_SelectSlotKernels(NIL) == eNOERROR) ? \
+     eduom_slotKernel : &eduom_slotKernels[EDUOM_ISA_SCALAR])
+
+
+
+/*@================================
+ * eduom_SelectSlotKernels()
+ *================================*/
+/*
+ * Function: Four eduom_SelectSlotKernels(Four)
+ *
+ * Description:
+ *  Choose the kernels of the instruction set, or if 'isa' is NIL, of
+ *  EDUOM_KERNEL_DEFAULT or the instruction set below it the processor
+ *  supports.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four eduom_SelectSlotKernels(
+    Four	isa)		/* IN EDUOM_ISA_XXX; NIL for the default one */
+{
+    Boolean	supported[EDUOM_NUM_ISAS]; /* instruction sets the processor supports */
+
+
+    if (isa != NIL && (isa < 0 || isa >= EDUOM_NUM_ISAS)) ERR(eBADPARAMETER);
+
+    supported[EDUOM_ISA_SCALAR] = TRUE;
+#ifdef EDUOM_SLOT_KERNEL_X86
+    __builtin_cpu_init();
+    supported[EDUOM_ISA_SSE2] = __builtin_cpu_supports("sse2") ? TRUE : FALSE;
+    supported[EDUOM_ISA_AVX2] = __builtin_cpu_supports("avx2") ? TRUE : FALSE;
+#else
+    supported[EDUOM_ISA_SSE2] = FALSE;
+    supported[EDUOM_ISA_AVX2] = FALSE;
+#endif
+
+    if (isa == NIL)
+        for (isa = EDUOM_KERNEL_DEFAULT; !supported[isa]; isa--);
+
+    if (!supported[isa]) ERR(eNOTSUPPORTED_EDUOM);
+
+    eduom_slotKernel = &eduom_slotKernels[isa];
+
+    return(eNOERROR);
+
+} /* eduom_SelectSlotKernels() */
+
+
+
+/*@================================
+ * eduom_GetSlotKernels()
+ *================================*/
+/*
+ * Function: Four eduom_GetSlotKernels(void)
+ *
+ * Description:
+ *  Return the instruction set of the kernels chosen.
+ *
+ * Returns:
+ *  EDUOM_ISA_XXX
+ */
+Four eduom_GetSlotKernels(void)
+{
+    return(EDUOM_SLOT_KERNEL() - eduom_slotKernels);
+
+} /* eduom_GetSlotKernels() */
+
+
+
+/*@================================
+ * eduom_SlotKernelName()
+ *================================*/
+/*
+ * Function: char *eduom_SlotKernelName(Four)
+ *
+ * Description:
+ *  Return the name of the instruction set.
+ *
+ * Returns:
+ *  name; "unknown" if 'isa' is not one
+ */
+char *eduom_SlotKernelName(
+    Four	isa)		/* IN EDUOM_ISA_XXX */
+{
+    if (isa < 0 || isa >= EDUOM_NUM_ISAS) return("unknown");
+
+    return(eduom_slotKernels[isa].name);
+
+} /* eduom_SlotKernelName() */
+
+
+
+/*@================================
+ * eduom_SlotArray()
+ *================================*/
+/*
+ * Function: eduom_EmptyMaskFunc eduom_SlotArray(eduom_SlotKernel*, SlottedPage*, char**, Four*)
+ *
+ * Description:
+ *  Return where the offset of slot 0 of the page is and how many bytes the
+ *  offsets are apart, and the mask kernel for them. 'kernel' is NULL to
+ *  get only the slot array.
+ *
+ * Returns:
+ *  mask kernel; NULL for the plain C version
+ */
+static eduom_EmptyMaskFunc eduom_SlotArray(
+    eduom_SlotKernel *kernel,	/* IN kernels chosen */
+    SlottedPage	*apage,		/* IN page to look at */
+    char	**slot0,	/* OUT offset of slot 0 */
+    Four	*stride)	/* OUT bytes between the offsets of two slots */
+{
+    if (IS_SOA_PAGE(apage) || IS_SMALL_PAGE(apage)) {
+        *slot0 = IS_SOA_PAGE(apage) ? (char *)&SOA_OFFSET(apage, 0) : (char *)&SMALL_SLOT(apage, 0);
+        *stride = sizeof(Two);
+        return((kernel != NULL) ? kernel->emptyMask2 : NULL);
+    }
+
+    /* the masks of the offsets 8 bytes apart do not pay off */
+    *slot0 = (char *)&(apage->slot[0].offset);
+    *stride = sizeof(SlottedPageSlot);
+    return(NULL);
+
+} /* eduom_SlotArray() */
+
+
+
+/*@================================
+ * eduom_FindEmptySlot()
+ *================================*/
+/*
+ * Function: Four eduom_FindEmptySlot(SlottedPage*)
+ *
+ * Description:
+ *  Return the first empty slot of the slotted page of either slot
+ *  directory.
+ *
+ * Returns:
+ *  slot number; nSlots if no slot is empty
+ */
+Four eduom_FindEmptySlot(
+    SlottedPage	*apage)		/* IN page to look at */
+{
+    Four	s;		/* slot number */
+    Four	n;		/* slots of the page */
+    char	*slot0;		/* offset of slot 0 */
+    Four	stride;		/* bytes between the offsets of two slots */
+    char	*lowest;	/* offset of the last of the 16 slots */
+    UFour	mask;		/* empty ones of the 16 slots */
+    eduom_EmptyMaskFunc emptyMask; /* mask kernel */
+
+
+    n = apage->header.nSlots;
+    emptyMask = eduom_SlotArray(EDUOM_SLOT_KERNEL(), apage, &slot0, &stride);
+
+    /* the slot looked for is often one of the first few, which are looked at one by one */
+    for (s = 0; s < MIN(EDUOM_KERNEL_PROBE, n); s++)
+        if (*(Two *)(slot0 - s*stride) == EMPTYSLOT) return(s);
+
+    for ( ; s < n; s += EDUOM_KERNEL_SLOTS) {
+        lowest = slot0 - (s + EDUOM_KERNEL_SLOTS - 1)*stride;
+        if (emptyMask == NULL || lowest < (char *)apage) break;
+
+        /* slot s+j is bit 15-j; the slots from 'n' on are cleared */
+        mask = emptyMask(lowest);
+        if (s + EDUOM_KERNEL_SLOTS > n) mask &= EDUOM_KERNEL_FULL_MASK << (s + EDUOM_KERNEL_SLOTS - n);
+        if (mask != 0) return(s + __builtin_clz(mask) - (32 - EDUOM_KERNEL_SLOTS));
+    }
+
+    for ( ; s < n; s++)
+        if (*(Two *)(slot0 - s*stride) == EMPTYSLOT) break;
+
+    return(MIN(s, n));
+
+} /* eduom_FindEmptySlot() */
+
+
+
+/*@================================
+ * eduom_NextLiveSlot()
+ *================================*/
+/*
+ * Function: Four eduom_NextLiveSlot(SlottedPage*, Four)
+ *
+ * Description:
+ *  Return the first live slot of the page from the given slot on.
+ *
+ * Returns:
+ *  slot number; nSlots if there is none
+ */
+Four eduom_NextLiveSlot(
+    SlottedPage	*apage,		/* IN page to look at */
+    Four	s)		/* IN slot to begin with */
+{
+    Four	n;		/* slots of the page */
+    char	*slot0;		/* offset of slot 0 */
+    Four	stride;		/* bytes between the offsets of two slots */
+    UFour	*bitmap;	/* bitmap of the live records of a fixed length record page */
+    UFour	word;		/* a word of the bitmap */
+
+
+    n = apage->header.nSlots;
+    if (s < 0) s = 0;
+
+    /* record s is bit s%32 of word s/32 of the bitmap */
+    if (IS_FIXED_PAGE(apage)) {
+        bitmap = FIXED_PAGE_HDR(apage)->bitmap;
+        for ( ; s < n; s = (s | 31) + 1) {
+            word = bitmap[s >> 5] >> (s & 31);
+            if (word != 0) return(MIN(s + __builtin_ctz(word), n));
+        }
+        return(n);
+    }
+
+    eduom_SlotArray(NULL, apage, &slot0, &stride);
+
+    for ( ; s < n; s++)
+        if (*(Two *)(slot0 - s*stride) != EMPTYSLOT) break;
+
+    return(s);
+
+} /* eduom_NextLiveSlot() */
+
+
+
+/*@================================
+ * eduom_PrevLiveSlot()
+ *================================*/
+/*
+ * Function: Four eduom_PrevLiveSlot(SlottedPage*, Four)
+ *
+ * Description:
+ *  Return the last live slot of the page up to the given slot.
+ *
+ * Returns:
+ *  slot number; NIL if there is none
+ */
+Four eduom_PrevLiveSlot(
+    SlottedPage	*apage,		/* IN page to look at */
+    Four	s)		/* IN slot to begin with */
+{
+    char	*slot0;		/* offset of slot 0 */
+    Four	stride;		/* bytes between the offsets of two slots */
+    UFour	*bitmap;	/* bitmap of the live records of a fixed length record page */
+    UFour	word;		/* a word of the bitmap */
+
+
+    if (s >= apage->header.nSlots) s = apage->header.nSlots - 1;
+
+    if (IS_FIXED_PAGE(apage)) {
+        bitmap = FIXED_PAGE_HDR(apage)->bitmap;
+        for ( ; s >= 0; s = (s & ~31) - 1) {
+            word = bitmap[s >> 5] << (31 - (s & 31));
+            if (word != 0) return(s - __builtin_clz(word));
+        }
+        return(NIL);
+    }
+
+    eduom_SlotArray(NULL, apage, &slot0, &stride);
+
+    for ( ; s >= 0; s--)
+        if (*(Two *)(slot0 - s*stride) != EMPTYSLOT) break;
+
+    return(s);
+
+} /* eduom_PrevLiveSlot() */
+
+
+
+/*@================================
+ * eduom_MoveDown()
+ *================================*/
+/*
+ * Function: void eduom_MoveDown(char*, char*, Four)
+ *
+ * Description:
+ *  Copy the bytes to a lower address, or to another buffer; the two areas
+ *  may overlap if 'to' is below 'from'.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_MoveDown(
+    char	*to,		/* OUT where to copy the bytes */
+    char	*from,		/* IN bytes to copy */
+    Four	length)		/* IN bytes to copy */
+{
+    if (to == from || length <= 0) return;
+
+    memmove(to, from, length);
+
+} /* eduom_MoveDown() */
+
+
+
+#ifdef EDUOM_SLOT_KERNEL_X86
+/*
+ * The SSE2 versions
+ */
+__attribute__((target("sse2")))
+static UFour eduom_EmptyMask2Sse2(
+    char	*lowest)	/* IN offset of the slot at the lowest address */
+{
+    __m128i	empty;		/* EMPTYSLOT in every lane */
+    __m128i	lo, hi;		/* offsets compared */
+
+
+    empty = _mm_set1_epi16(EMPTYSLOT);
+    lo = _mm_cmpeq_epi16(_mm_loadu_si128((__m128i *)lowest), empty);
+    hi = _mm_cmpeq_epi16(_mm_loadu_si128((__m128i *)(lowest + 16)), empty);
+
+    return((UFour)_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+
+} /* eduom_EmptyMask2Sse2() */
+
+
+/*
+ * The AVX2 versions
+ */
+__attribute__((target("avx2")))
+static UFour eduom_EmptyMask2Avx2(
+    char	*lowest)	/* IN offset of the slot at the lowest address */
+{
+    __m256i	v;		/* offsets compared */
+
+
+    /* the 16-bit lanes are packed to bytes in each 128-bit half, so the halves are put together */
+    v = _mm256_cmpeq_epi16(_mm256_loadu_si256((__m256i *)lowest), _mm256_set1_epi16(EMPTYSLOT));
+    v = _mm256_permute4x64_epi64(_mm256_packs_epi16(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+
+    return((UFour)_mm256_movemask_epi8(v) & EDUOM_KERNEL_FULL_MASK);
+
+} /* eduom_EmptyMask2Avx2() */
+#endif /* EDUOM_SLOT_KERNEL_X86 */
@@ -0,0 +1,600 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_SmallPage.c
+ *
+ * Description:
+ *  Compact encoding of small objects. A file given small object pages by
+ *  EduOM_SetSmallObjectPages() puts its objects of up to
+ *  EDUOM_SMALL_MAX_LENGTH bytes into small object pages, and its larger
+ *  objects into slotted pages as before. In a small object page
+ *   - the header of an object is a varint of its length and a flag telling
+ *     whether the tag follows; the tag is omitted when it is 0, and the
+ *     objects are not aligned,
+ *   - a slot is the 2-byte offset of the object; the slot array grows down
+ *     from the end of the data area,
+ *   - the unique number is shared by the objects of the page: it is taken
+ *     when the page is formatted(or emptied) and returned by SLOT_UNIQUE(),
+ * so a 16-byte object takes 19 bytes instead of 32. The slot numbers and
+ * 'nSlots' are those of the slotted pages, so the ObjectIDs,
+ * EduOM_ReadObject(), EduOM_NextObject()/EduOM_PrevObject() and
+ * EduOM_DestroyObject() work on both kinds of pages.
+ *
+ *  The small object pages are kept out of the available space lists(see
+ *  SP_RESERVE_FREE()); an object is put into the small object page of the
+ *  near object, or the small object page the file put its last object into,
+ *  or into a new page. EduOM_SetSmallObjectPages() makes the first page of
+ *  the empty file a small object page, from which the layout is derived
+ *  after the volume is mounted again(see EduOM_FileLayout.c).
+ *
+ * Exports:
+ *  Four EduOM_SetSmallObjectPages(ObjectID*)
+ *
+ * Internal:
+ *  Four eduom_CreateSmallObject(ObjectID*, sm_CatOverlayForData*, PageNo*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*)
+ *  Four eduom_CopySmallObject(SlottedPage*, ObjectID*, Four, Four, char*)
+ *  Four eduom_DestroySmallObject(SlottedPage*, ObjectID*)
+ *  Four eduom_FormatSmallPage(SlottedPage*, PageID*)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define EDUOM_SMALL_MAX_HDR     5       /* bytes of the longest object header: varint and tag */
+
+
+/*@
+ * Macro Definitions
+ */
+/* bytes of the data area of a small object page usable by the objects and the slots */
+#define SMALL_PAGE_SPACE        ((Four)(PAGESIZE - SP_FIXED - sizeof(eduom_SmallPageHdr)))
+
+/* contiguous free bytes of the small object page */
+#define SMALL_CFREE(p) \
+    (PAGESIZE - SP_FIXED - SMALL_PAGE_HDR(p)->free - (p)->header.nSlots*(Four)sizeof(Two))
+
+
+static Boolean eduom_FindSmallSlot(SlottedPage*, FileID*, Four, Four*);
+static void eduom_DefragSmallPage(SlottedPage*);
+static Four eduom_EncodeSmallObjectHdr(Four, Two, char*);
+static Four eduom_DecodeSmallObjectHdr(char*, Four, Four*, Two*);
+
+
+
+/*@================================
+ * EduOM_SetSmallObjectPages()
+ *================================*/
+/*
+ * Function: Four EduOM_SetSmallObjectPages(ObjectID*)
+ *
+ * Description:
+ *  Make the small objects created in the file go into small object pages.
+ *  The file must be empty, or already given small object pages(e.g. a file
+ *  of a volume mounted again).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetSmallObjectPages(
+    ObjectID	*catObjForFile)	/* IN file to be given small object pages */
+{
+    Four	e;		/* error number */
+    eduom_FileLayout layout;	/* the layout of small object pages */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    memset(&layout, 0, sizeof(eduom_FileLayout));
+    layout.layout = EDUOM_SMALL_LAYOUT;
+    layout.insertPage = NIL;
+
+    e = eduom_SetFileLayout(catObjForFile, &layout);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetSmallObjectPages() */
+
+
+
+/*@================================
+ * eduom_CreateSmallObject()
+ *================================*/
+/*
+ * Function: Four eduom_CreateSmallObject(ObjectID*, sm_CatOverlayForData*, PageNo*, ObjectID*,
+ *                                        ObjectHdr*, Four, char*, ObjectID*)
+ *
+ * Description:
+ *  Create a small object in the file; the object is put into the small
+ *  object page of the near object, or else the insert page of the file,
+ *  compacting the page if needed. If neither has room, the object is put
+ *  into a new page following the page of the near object or the last page
+ *  of the file, and the new page becomes the insert page.
+ *
+ * Returns:
+ *  error code
+ *    eBADLENGTH_OM
+ *    some errors caused by function calls
+ */
+Four eduom_CreateSmallObject(
+    ObjectID	*catObjForFile,	/* IN file in which the object is to be placed */
+    sm_CatOverlayForData *catEntry, /* IN catalog information of the file */
+    PageNo	*insertPage,	/* INOUT small object page the last object was put into */
+    ObjectID	*nearObj,	/* IN create the object near this object */
+    ObjectHdr	*objHdr,	/* IN from which the tag is set */
+    Four	length,		/* IN amount of data */
+    char	*data,		/* IN the initial data for the object */
+    ObjectID	*oid)		/* OUT the object's ObjectID */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	hdrLength;	/* bytes of the object header */
+    Four	neededSpace;	/* bytes of the object and its slot */
+    Boolean	found;		/* has a page with room been found? */
+    Four	firstExt;	/* first extent of the file */
+    char	hdr[EDUOM_SMALL_MAX_HDR]; /* the object header */
+    PageID	pid;		/* page in which the object is placed */
+    PageID	nearPid;	/* page the new page follows */
+    PhysicalFileID pFid;	/* physical ID of the file */
+    SlottedPage	*apage;		/* pointer to the buffer of the page */
+    eduom_SmallPageHdr *smallHdr; /* header of the small object page */
+
+
+    if (length < 0 || length > EDUOM_SMALL_MAX_LENGTH) ERR(eBADLENGTH_OM);
+
+    hdrLength = eduom_EncodeSmallObjectHdr(length, objHdr->tag, hdr);
+
+    /* try the page of the near object, and then the insert page of the file */
+    found = FALSE;
+    if (nearObj != NULL) {
+        MAKE_PAGEID(pid, nearObj->volNo, nearObj->pageNo);
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        found = eduom_FindSmallSlot(apage, &catEntry->fid, hdrLength + length, &i);
+        if (found) {
+            EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEAR_PAGE);
+            EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEAR_PAGE, pid.volNo, pid.pageNo);
+        }
+        else {
+            e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    if (!found) {
+        MAKE_PAGEID(pid, catEntry->fid.volNo, *insertPage != NIL ? *insertPage : catEntry->lastPage);
+        e = BfM_GetTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        found = eduom_FindSmallSlot(apage, &catEntry->fid, hdrLength + length, &i);
+        if (found) {
+            EDUOM_STATS_BRANCH(EDUOM_BRANCH_ACTIVE_PAGE);
+            EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_ACTIVE_PAGE, pid.volNo, pid.pageNo);
+        }
+        else {
+            e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+            if (e < 0) ERR(e);
+        }
+    }
+
+    if (!found) {
+        if (nearObj != NULL) MAKE_PAGEID(nearPid, nearObj->volNo, nearObj->pageNo);
+        else MAKE_PAGEID(nearPid, catEntry->fid.volNo, catEntry->lastPage);
+        MAKE_PAGEID(pFid, catEntry->fid.volNo, catEntry->firstPage);
+        e = RDsM_PageIdToExtNo((PageID *)&pFid, &firstExt);
+        if (e < 0) ERR(e);
+
+        e = RDsM_AllocTrains(catEntry->fid.volNo, firstExt, &nearPid, catEntry->eff, 1, PAGESIZE2, &pid);
+        if (e < 0) ERR(e);
+        EDUOM_STATS_BRANCH(EDUOM_BRANCH_NEW_PAGE);
+        EDUOM_PROBE3(eduom, create_placement, EDUOM_BRANCH_NEW_PAGE, pid.volNo, pid.pageNo);
+
+        e = BfM_GetNewTrain((TrainID *)&pid, (char **)&apage, PAGE_BUF);
+        if (e < 0) ERR(e);
+
+        SET_PAGE_TYPE(apage, SLOTTED_PAGE_TYPE);
+        apage->header.pid = pid;
+        apage->header.fid = catEntry->fid;
+        apage->header.unique = 0;
+        apage->header.uniqueLimit = 0;
+        apage->header.nextPage = NIL;
+        apage->header.prevPage = NIL;
+        apage->header.spaceListPrev = NIL;
+        apage->header.spaceListNext = NIL;
+        apage->header.nSlots = 0;
+        e = eduom_FormatSmallPage(apage, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        e = om_FileMapAddPage(catObjForFile, &nearPid, &pid);
+        if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+        i = 0;
+        *insertPage = pid.pageNo;
+    }
+    neededSpace = hdrLength + length + (i == apage->header.nSlots ? sizeof(Two) : 0);
+
+    e = BfM_BeginFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    if (SMALL_CFREE(apage) < neededSpace) {
+        EDUOM_STATS_BRANCH(EDUOM_BRANCH_COMPACTION);
+        eduom_DefragSmallPage(apage);
+    }
+
+    smallHdr = SMALL_PAGE_HDR(apage);
+    memcpy(&(apage->data[smallHdr->free]), hdr, hdrLength);
+    memcpy(&(apage->data[smallHdr->free + hdrLength]), data, length);
+
+    if (i == apage->header.nSlots) apage->header.nSlots++;
+    SMALL_SLOT(apage, i) = smallHdr->free;
+    smallHdr->free += hdrLength + length;
+    SP_RESERVE_FREE(apage);
+
+    e = BfM_EndFrameWrite(&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    MAKE_OBJECTID(*oid, pid.volNo, pid.pageNo, i, smallHdr->unique);
+
+    e = BfM_SetDirty((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERRB1(e, &pid, PAGE_BUF);
+
+    e = BfM_FreeTrain((TrainID *)&pid, PAGE_BUF);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_CreateSmallObject() */
+
+
+
+/*@================================
+ * eduom_CopySmallObject()
+ *================================*/
+/*
+ * Function: Four eduom_CopySmallObject(SlottedPage*, ObjectID*, Four, Four, char*)
+ *
+ * Description:
+ *  Copy the requested bytes of the object in the small object page into the
+ *  user buffer. As the page may be read without being fixed(see
+ *  eduom_CopyObjectData()), the slot and the object header are checked
+ *  against the page bounds before they are used.
+ *
+ * Returns:
+ *  1) number of bytes copied (values greater than or equal to 0)
+ *  2) Error Code (negative values)
+ *    eBADOBJECTID_OM
+ *    eBADLENGTH_OM
+ *    eBADSTART_OM
+ */
+Four eduom_CopySmallObject(
+    SlottedPage	*apage,		/* IN small object page containing the object */
+    ObjectID	*oid,		/* IN object to read */
+    Four	start,		/* IN starting offset of read */
+    Four	length,		/* IN amount of data to read */
+    char	*buf)		/* OUT user buffer to return the read data */
+{
+    Four	offset;		/* offset of the object in the page */
+    Four	hdrLength;	/* bytes of the object header */
+    Four	objLength;	/* length of the object */
+    Two		tag;		/* tag of the object */
+
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots ||
+        apage->header.nSlots*(Four)sizeof(Two) > SMALL_PAGE_SPACE) return(eBADOBJECTID_OM);
+
+    offset = SMALL_SLOT(apage, oid->slotNo);
+    if (offset < (Four)sizeof(eduom_SmallPageHdr) || offset >= PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+
+    hdrLength = eduom_DecodeSmallObjectHdr(&(apage->data[offset]), PAGESIZE - SP_FIXED - offset, &objLength, &tag);
+    if (hdrLength < 0 || offset + hdrLength + objLength > PAGESIZE - SP_FIXED) return(eBADOBJECTID_OM);
+
+    if (start > objLength) return(eBADSTART_OM);
+
+    if (length == REMAINDER) length = objLength - start;
+    if (length < 0 || start + length > objLength) return(eBADLENGTH_OM);
+    memcpy(buf, &(apage->data[offset + hdrLength + start]), length);
+
+    return(length);
+
+} /* eduom_CopySmallObject() */
+
+
+
+/*@================================
+ * eduom_DestroySmallObject()
+ *================================*/
+/*
+ * Function: Four eduom_DestroySmallObject(SlottedPage*, ObjectID*)
+ *
+ * Description:
+ *  Destroy the object in the small object page; the empty slots at the end
+ *  of the slot array are removed, and a page left without objects is given
+ *  a new unique number.
+ *
+ * Returns:
+ *  error code
+ *    eBADOBJECTID_OM
+ *    some errors caused by function calls
+ */
+Four eduom_DestroySmallObject(
+    SlottedPage	*apage,		/* INOUT small object page containing the object */
+    ObjectID	*oid)		/* IN object to destroy */
+{
+    Four	e;		/* error number */
+    Four	offset;		/* offset of the object in the page */
+    Four	hdrLength;	/* bytes of the object header */
+    Four	objLength;	/* length of the object */
+    Two		tag;		/* tag of the object */
+    eduom_SmallPageHdr *smallHdr; /* header of the small object page */
+
+
+    smallHdr = SMALL_PAGE_HDR(apage);
+
+    if (oid->slotNo < 0 || oid->slotNo >= apage->header.nSlots) ERR(eBADOBJECTID_OM);
+
+    offset = SMALL_SLOT(apage, oid->slotNo);
+    if (offset == EMPTYSLOT) ERR(eBADOBJECTID_OM);
+
+    hdrLength = eduom_DecodeSmallObjectHdr(&(apage->data[offset]), smallHdr->free - offset, &objLength, &tag);
+    if (hdrLength < 0) ERR(eBADOBJECTID_OM);
+
+    if (offset + hdrLength + objLength == smallHdr->free) smallHdr->free = offset;
+    else smallHdr->unused += hdrLength + objLength;
+
+    SMALL_SLOT(apage, oid->slotNo) = EMPTYSLOT;
+    while (apage->header.nSlots > 0 && SMALL_SLOT(apage, apage->header.nSlots - 1) == EMPTYSLOT)
+        apage->header.nSlots--;
+
+    if (apage->header.nSlots == 0) {
+        e = eduom_FormatSmallPage(apage, &apage->header.pid);
+        if (e < 0) ERR(e);
+    }
+    SP_RESERVE_FREE(apage);
+
+    return(eNOERROR);
+
+} /* eduom_DestroySmallObject() */
+
+
+
+/*@================================
+ * eduom_FormatSmallPage()
+ *================================*/
+/*
+ * Function: Four eduom_FormatSmallPage(SlottedPage*, PageID*)
+ *
+ * Description:
+ *  Make the page an empty small object page with a new unique number; the
+ *  links of the page are kept.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four eduom_FormatSmallPage(
+    SlottedPage	*apage,		/* INOUT page to format */
+    PageID	*pid)		/* IN ID of the page */
+{
+    Four	e;		/* error number */
+    eduom_SmallPageHdr *smallHdr; /* header of the small object page */
+
+
+    smallHdr = SMALL_PAGE_HDR(apage);
+    smallHdr->free = sizeof(eduom_SmallPageHdr);
+    smallHdr->unused = 0;
+
+    apage->header.reserved = EDUOM_SMALL_PAGE;
+    apage->header.nSlots = 0;
+    SP_RESERVE_FREE(apage);
+
+    e = om_GetUnique(pid, &(smallHdr->unique));
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* eduom_FormatSmallPage() */
+
+
+
+/*@================================
+ * eduom_FindSmallSlot()
+ *================================*/
+/*
+ * Function: Boolean eduom_FindSmallSlot(SlottedPage*, FileID*, Four, Four*)
+ *
+ * Description:
+ *  Check whether the page is a small object page of the file with room for
+ *  an object, and find the slot for the object: the first empty slot, or
+ *  the slot following the slot array. The page of an ObjectID kept by the
+ *  caller may have been deallocated and given to another file.
+ *
+ * Returns:
+ *  TRUE if the object can be put into the page, otherwise FALSE
+ */
+static Boolean eduom_FindSmallSlot(
+    SlottedPage	*apage,		/* IN page to check */
+    FileID	*fid,		/* IN file of the object */
+    Four	objSpace,	/* IN bytes of the object with its header */
+    Four	*slotNo)	/* OUT slot for the object */
+{
+    Four	i;		/* index variable */
+
+
+    if (!IS_SMALL_PAGE(apage) || !EQUAL_FILEID(apage->header.fid, *fid)) return(FALSE);
+
+    for (i = 0; i < apage->header.nSlots; i++)
+        if (SMALL_SLOT(apage, i) == EMPTYSLOT) break;
+    if (i == apage->header.nSlots) objSpace += sizeof(Two);
+
+    *slotNo = i;
+    return(SMALL_CFREE(apage) + SMALL_PAGE_HDR(apage)->unused >= objSpace);
+
+} /* eduom_FindSmallSlot() */
+
+
+
+/*@================================
+ * eduom_DefragSmallPage()
+ *================================*/
+/*
+ * Function: void eduom_DefragSmallPage(SlottedPage*)
+ *
+ * Description:
+ *  Move the objects of the small object page to the beginning of its data
+ *  area in the order of the slots, so that the unused bytes become part of
+ *  the contiguous free area.
+ *
+ * Returns:
+ *  None
+ */
+static void eduom_DefragSmallPage(
+    SlottedPage	*apage)		/* INOUT small object page */
+{
+    Four	i;		/* index variable */
+    Four	offset;		/* offset of an object */
+    Four	objLength;	/* bytes of an object with its header */
+    Four	hdrLength;	/* bytes of an object header */
+    Two		tag;		/* tag of an object */
+    Four	free;		/* offset the next object is moved to */
+    char	tmpPage[PAGESIZE]; /* copy of the data area */
+    eduom_SmallPageHdr *smallHdr; /* header of the small object page */
+
+
+    smallHdr = SMALL_PAGE_HDR(apage);
+    memcpy(tmpPage, apage->data, smallHdr->free);
+
+    for (i = 0, free = sizeof(eduom_SmallPageHdr); i < apage->header.nSlots; i++) {
+        offset = SMALL_SLOT(apage, i);
+        if (offset == EMPTYSLOT) continue;
+
+        hdrLength = eduom_DecodeSmallObjectHdr(&tmpPage[offset], smallHdr->free - offset, &objLength, &tag);
+        objLength += hdrLength;
+
+        memcpy(&(apage->data[free]), &tmpPage[offset], objLength);
+        SMALL_SLOT(apage, i) = free;
+        free += objLength;
+    }
+
+    smallHdr->free = free;
+    smallHdr->unused = 0;
+
+} /* eduom_DefragSmallPage() */
+
+
+
+/*@================================
+ * eduom_EncodeSmallObjectHdr()
+ *================================*/
+/*
+ * Function: Four eduom_EncodeSmallObjectHdr(Four, Two, char*)
+ *
+ * Description:
+ *  Encode the header of an object of a small object page: a varint(7 bits
+ *  per byte, low bits first) of the length shifted by one with the lowest
+ *  bit telling whether the tag follows, and the tag if it is not 0.
+ *
+ * Returns:
+ *  bytes of the header
+ */
+static Four eduom_EncodeSmallObjectHdr(
+    Four	length,		/* IN length of the object */
+    Two		tag,		/* IN tag of the object */
+    char	*hdr)		/* OUT the header; EDUOM_SMALL_MAX_HDR bytes */
+{
+    UFour	v;		/* value to encode */
+    Four	n;		/* bytes of the header */
+
+
+    v = ((UFour)length << 1) | (tag != 0);
+    for (n = 0; v >= 0x80; v >>= 7) hdr[n++] = (char)(v | 0x80);
+    hdr[n++] = (char)v;
+
+    if (tag != 0) {
+        memcpy(&hdr[n], &tag, sizeof(Two));
+        n += sizeof(Two);
+    }
+
+    return(n);
+
+} /* eduom_EncodeSmallObjectHdr() */
+
+
+
+/*@================================
+ * eduom_DecodeSmallObjectHdr()
+ *================================*/
+/*
+ * Function: Four eduom_DecodeSmallObjectHdr(char*, Four, Four*, Two*)
+ *
+ * Description:
+ *  Decode the header of an object of a small object page, reading at most
+ *  'limit' bytes.
+ *
+ * Returns:
+ *  bytes of the header, or NIL if it is not valid
+ */
+static Four eduom_DecodeSmallObjectHdr(
+    char	*hdr,		/* IN the header */
+    Four	limit,		/* IN bytes which can be read */
+    Four	*length,	/* OUT length of the object */
+    Two		*tag)		/* OUT tag of the object */
+{
+    UFour	v;		/* decoded value */
+    Four	n;		/* bytes of the header */
+    Four	shift;		/* bits decoded */
+
+
+    for (n = 0, v = 0, shift = 0; n < limit && n < EDUOM_SMALL_MAX_HDR; shift += 7) {
+        v |= (UFour)(hdr[n] & 0x7f) << shift;
+        if ((hdr[n++] & 0x80) == 0) break;
+    }
+    if (n == 0 || (hdr[n-1] & 0x80) != 0) return(NIL);
+
+    *length = v >> 1;
+    *tag = 0;
+    if (v & 1) {
+        if (n + (Four)sizeof(Two) > limit) return(NIL);
+        memcpy(tag, &hdr[n], sizeof(Two));
+        n += sizeof(Two);
+    }
+
+    return(n);
+
+} /* eduom_DecodeSmallObjectHdr() */
@@ -0,0 +1,136 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_SoaPage.c
+ *
+ * Description:
+ *  Struct-of-arrays slot directory. A new page of a file given SoA slots by
+ *  EduOM_SetSoaSlots() keeps the offsets and the unique numbers of its slots
+ *  in two arrays instead of one array of SlottedPageSlot: the offsets(Two)
+ *  grow backwards from the end of the page, and the unique numbers grow
+ *  backwards from below the SOA_CAPACITY(nSlots) offsets reserved(see
+ *  EduOM_Internal.h). A scan for the live slots or for an empty slot reads
+ *  only the offsets, 2 bytes a slot and contiguous(see EduOM_SlotKernel.c),
+ *  and EduOM_CompactPage() sorts the offsets and moves the objects within
+ *  the page instead of copying the whole page aside first(see
+ *  eduom_CompactPageTail()).
+ *
+ *  The unique numbers are moved when the reserved offsets are doubled or
+ *  halved(see eduom_SetSlotCount()). The directory never takes more than
+ *  nSlots*sizeof(SlottedPageSlot) bytes, so the space of a SoA page is
+ *  accounted by SP_CFREE() as that of any slotted page and the available
+ *  space lists of cosmos hold it as they are.
+ *
+ *  EduOM_SetSoaSlots() makes the first page of the empty file a SoA page,
+ *  from which the layout is derived after the volume is mounted again(see
+ *  EduOM_FileLayout.c).
+ *
+ * Exports:
+ *  Four EduOM_SetSoaSlots(ObjectID*)
+ *
+ * Internal:
+ *  void eduom_SetSlotCount(SlottedPage*, Four)
+ */
+
+
+#include <string.h>
+#include "EduOM_common.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@================================
+ * EduOM_SetSoaSlots()
+ *================================*/
+/*
+ * Function: Four EduOM_SetSoaSlots(ObjectID*)
+ *
+ * Description:
+ *  Make the pages of the file SoA pages. The file must be empty, or
+ *  already given SoA slots(e.g. a file of a volume mounted again).
+ *
+ * Returns:
+ *  error code
+ *    eBADCATALOGOBJECT_OM
+ *    eBADPARAMETER_OM
+ *    some errors caused by function calls
+ */
+Four EduOM_SetSoaSlots(
+    ObjectID	*catObjForFile)	/* IN file to be given SoA slots */
+{
+    Four	e;		/* error number */
+    eduom_FileLayout layout;	/* the layout of SoA pages */
+
+
+    /*@ check parameters */
+
+    if (catObjForFile == NULL) ERR(eBADCATALOGOBJECT_OM);
+
+    memset(&layout, 0, sizeof(eduom_FileLayout));
+    layout.layout = EDUOM_SOA_LAYOUT;
+
+    e = eduom_SetFileLayout(catObjForFile, &layout);
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* EduOM_SetSoaSlots() */
+
+
+
+/*@================================
+ * eduom_SetSlotCount()
+ *================================*/
+/*
+ * Function: void eduom_SetSlotCount(SlottedPage*, Four)
+ *
+ * Description:
+ *  Change 'nSlots' of the slotted page. The unique numbers of a SoA page
+ *  are moved if SOA_CAPACITY() changes; the space the directory grows into
+ *  is accounted for by SP_CFREE() of the new 'nSlots'.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_SetSlotCount(
+    SlottedPage	*apage,		/* INOUT page to change */
+    Four	nSlots)		/* IN new number of slots */
+{
+    Four	n;		/* unique numbers to move */
+    Unique	*from;		/* unique number of slot 0 now */
+    Unique	*to;		/* ... after the change */
+
+
+    if (IS_SOA_PAGE(apage) && SOA_CAPACITY(nSlots) != SOA_CAPACITY(apage->header.nSlots)) {
+        n = MIN(nSlots, apage->header.nSlots);
+        from = &SOA_UNIQUE(apage, 0);
+        to = (Unique *)((char *)apage + PAGESIZE - SOA_CAPACITY(nSlots)*(Four)sizeof(Two)) - 1;
+        memmove(to - (n - 1), from - (n - 1), n*sizeof(Unique));
+    }
+
+    apage->header.nSlots = nSlots;
+
+} /* eduom_SetSlotCount() */
@@ -0,0 +1,412 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module : EduOM_Stats.c
+ *
+ * Description :
+ *  Count the calls of the object manager interface and how long they take,
+ *  and which way EduOM_CreateObject() chose the page for the new object.
+ *
+ *  Each thread counts into its own statistics so that no counter is shared;
+ *  EduOM_GetStats() sums the statistics of all threads. The latencies are
+ *  kept in log-linear histograms: the values between 2^k and 2^(k+1) nsec
+ *  are counted in EDUOM_LATENCY_SUB_BUCKETS buckets of equal width, so a
+ *  percentile is off by at most 1/EDUOM_LATENCY_SUB_BUCKETS.
+ *
+ *  The statistics are compiled in only if EDUOM_STATS is defined(see the
+ *  Makefile); otherwise the calls cost nothing and EduOM_GetStats() returns
+ *  eNOTSUPPORTED_EDUOM.
+ *
+ * Exports:
+ *  Four EduOM_GetStats(EduOM_Stats*)
+ *  Four EduOM_ResetStats(void)
+ *  Four EduOM_GetLatencyPercentile(EduOM_ApiStats*, double, double*)
+ *
+ * Internal:
+ *  eduom_StatsTimer eduom_BeginStatsTimer(Four)
+ *  void eduom_EndStatsTimer(eduom_StatsTimer*)
+ *  void eduom_CountBranch(Four)
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+/* threads whose statistics are kept apart; the others share the last ones */
+#define EDUOM_MAX_STATS_THREADS 64
+
+
+#ifdef EDUOM_STATS
+/*@
+ * Global Variables
+ */
+static EduOM_Stats *eduom_statsTable[EDUOM_MAX_STATS_THREADS];
+static Four eduom_nStatsThreads = 0;
+static pthread_mutex_t eduom_statsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/* statistics of the calling thread; NULL until its first call */
+static __thread EduOM_Stats *eduom_threadStats = NULL;
+
+
+
+/*@================================
+ * eduom_GetThreadStats()
+ *================================*/
+/*
+ * Function: EduOM_Stats *eduom_GetThreadStats(void)
+ *
+ * Description:
+ *  Return the statistics of the calling thread, allocating them on the
+ *  first call.
+ *
+ * Returns:
+ *  pointer to the statistics; NULL if they cannot be allocated
+ */
+static EduOM_Stats *eduom_GetThreadStats(void)
+{
+    EduOM_Stats *stats;		/* statistics of the thread */
+
+
+    if (eduom_threadStats != NULL) return(eduom_threadStats);
+
+    pthread_mutex_lock(&eduom_statsMutex);
+
+    if (eduom_nStatsThreads < EDUOM_MAX_STATS_THREADS) {
+        stats = (EduOM_Stats *)calloc(1, sizeof(EduOM_Stats));
+        if (stats != NULL) eduom_statsTable[eduom_nStatsThreads++] = stats;
+    }
+    else
+        stats = eduom_statsTable[EDUOM_MAX_STATS_THREADS-1];
+
+    pthread_mutex_unlock(&eduom_statsMutex);
+
+    eduom_threadStats = stats;
+
+    return(stats);
+
+} /* eduom_GetThreadStats() */
+
+
+
+/*@================================
+ * eduom_LatencyBucket()
+ *================================*/
+/*
+ * Function: Four eduom_LatencyBucket(UFour)
+ *
+ * Description:
+ *  Return the bucket of the latency histogram counting the value.
+ *
+ * Returns:
+ *  index of the bucket
+ */
+static Four eduom_LatencyBucket(
+    UFour	nsec)		/* IN latency */
+{
+    Four	k;		/* 2^k <= nsec < 2^(k+1) */
+
+
+    if (nsec < EDUOM_LATENCY_SUB_BUCKETS) return(nsec);
+
+    k = 31 - __builtin_clz(nsec);
+
+    return((k - EDUOM_LATENCY_SUB_BITS + 1)*EDUOM_LATENCY_SUB_BUCKETS +
+           ((nsec >> (k - EDUOM_LATENCY_SUB_BITS)) & (EDUOM_LATENCY_SUB_BUCKETS-1)));
+
+} /* eduom_LatencyBucket() */
+#endif /* EDUOM_STATS */
+
+
+
+/*@================================
+ * eduom_BucketUpperBound()
+ *================================*/
+/*
+ * Function: double eduom_BucketUpperBound(Four)
+ *
+ * Description:
+ *  Return the least latency which is not counted in the bucket.
+ *
+ * Returns:
+ *  latency in nsec
+ */
+static double eduom_BucketUpperBound(
+    Four	bucket)		/* IN index of the bucket */
+{
+    Four	k;		/* 2^k <= values of the bucket < 2^(k+1) */
+    Four	sub;		/* index in the buckets of 2^k */
+
+
+    if (bucket < EDUOM_LATENCY_SUB_BUCKETS) return(bucket + 1);
+
+    k = bucket/EDUOM_LATENCY_SUB_BUCKETS + EDUOM_LATENCY_SUB_BITS - 1;
+    sub = bucket%EDUOM_LATENCY_SUB_BUCKETS;
+
+    return((double)(EDUOM_LATENCY_SUB_BUCKETS + sub + 1) * (double)(1U << (k - EDUOM_LATENCY_SUB_BITS)));
+
+} /* eduom_BucketUpperBound() */
+
+
+
+#ifdef EDUOM_STATS
+/*@================================
+ * eduom_BeginStatsTimer()
+ *================================*/
+/*
+ * Function: eduom_StatsTimer eduom_BeginStatsTimer(Four)
+ *
+ * Description:
+ *  Start timing a call of the interface(see EDUOM_STATS_TIMER()).
+ *
+ * Returns:
+ *  the timer
+ */
+eduom_StatsTimer eduom_BeginStatsTimer(
+    Four	api)		/* IN EDUOM_API_XXX */
+{
+    eduom_StatsTimer timer;	/* timer of the call */
+
+
+    timer.api = api;
+    timer.stats = eduom_GetThreadStats();
+    if (timer.stats != NULL) clock_gettime(CLOCK_MONOTONIC, &timer.start);
+
+    return(timer);
+
+} /* eduom_BeginStatsTimer() */
+
+
+
+/*@================================
+ * eduom_EndStatsTimer()
+ *================================*/
+/*
+ * Function: void eduom_EndStatsTimer(eduom_StatsTimer*)
+ *
+ * Description:
+ *  Account the call when it returns; called when the timer goes out of
+ *  scope.
+ *
+ * Returns:
+ *  None
+ */
+void eduom_EndStatsTimer(
+    eduom_StatsTimer *timer)	/* IN timer of the call */
+{
+    struct timespec now;	/* current time */
+    EduOM_ApiStats *s;		/* statistics of the interface function */
+    double	nsec;		/* time taken by the call */
+
+
+    if (timer->stats == NULL) return;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    nsec = (now.tv_sec - timer->start.tv_sec)*1e9 + (now.tv_nsec - timer->start.tv_nsec);
+    if (nsec < 0) nsec = 0;
+    if (nsec > (double)0xFFFFFFFFU) nsec = (double)0xFFFFFFFFU;
+
+    s = &timer->stats->api[timer->api];
+    s->count++;
+    s->totalTime += nsec;
+    if (nsec > s->maxTime) s->maxTime = nsec;
+    s->hist[eduom_LatencyBucket((UFour)nsec)]++;
+
+} /* eduom_EndStatsTimer() */
+
+
+
+/*@================================
+ * eduom_CountBranch()
+ *================================*/
+/*
+ * Function: void eduom_CountBranch(Four)
+ *
+ * Description:
+ *  Count the way EduOM_CreateObject() chose the page(see EDUOM_STATS_BRANCH()).
+ *
+ * Returns:
+ *  None
+ */
+void eduom_CountBranch(
+    Four	branch)		/* IN EDUOM_BRANCH_XXX */
+{
+    EduOM_Stats *stats;		/* statistics of the thread */
+
+
+    stats = eduom_GetThreadStats();
+    if (stats != NULL) stats->createBranch[branch]++;
+
+} /* eduom_CountBranch() */
+#endif /* EDUOM_STATS */
+
+
+
+/*@================================
+ * EduOM_GetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_GetStats(EduOM_Stats*)
+ *
+ * Description:
+ *  Return the statistics summed over all threads. A thread calling the
+ *  object manager meanwhile may be counted partly.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_GetStats(
+    EduOM_Stats	*stats)		/* OUT statistics */
+{
+#ifdef EDUOM_STATS
+    Four	t;		/* index of a thread */
+    Four	i;		/* index variable */
+    Four	b;		/* index of a bucket */
+    EduOM_Stats *ts;		/* statistics of a thread */
+
+
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    memset(stats, 0, sizeof(EduOM_Stats));
+
+    pthread_mutex_lock(&eduom_statsMutex);
+
+    for (t = 0; t < eduom_nStatsThreads; t++) {
+        ts = eduom_statsTable[t];
+
+        for (i = 0; i < EDUOM_NUM_APIS; i++) {
+            stats->api[i].count += ts->api[i].count;
+            stats->api[i].totalTime += ts->api[i].totalTime;
+            if (ts->api[i].maxTime > stats->api[i].maxTime) stats->api[i].maxTime = ts->api[i].maxTime;
+            for (b = 0; b < EDUOM_LATENCY_BUCKETS; b++)
+                stats->api[i].hist[b] += ts->api[i].hist[b];
+        }
+
+        for (i = 0; i < EDUOM_NUM_BRANCHES; i++)
+            stats->createBranch[i] += ts->createBranch[i];
+    }
+
+    pthread_mutex_unlock(&eduom_statsMutex);
+
+    return(eNOERROR);
+#else
+    ERR(eNOTSUPPORTED_EDUOM);
+#endif
+
+} /* EduOM_GetStats() */
+
+
+
+/*@================================
+ * EduOM_ResetStats()
+ *================================*/
+/*
+ * Function: Four EduOM_ResetStats(void)
+ *
+ * Description:
+ *  Zero the statistics of all threads.
+ *
+ * Returns:
+ *  error code
+ *    eNOTSUPPORTED_EDUOM
+ */
+Four EduOM_ResetStats(void)
+{
+#ifdef EDUOM_STATS
+    Four	t;		/* index of a thread */
+
+
+    pthread_mutex_lock(&eduom_statsMutex);
+
+    for (t = 0; t < eduom_nStatsThreads; t++)
+        memset(eduom_statsTable[t], 0, sizeof(EduOM_Stats));
+
+    pthread_mutex_unlock(&eduom_statsMutex);
+
+    return(eNOERROR);
+#else
+    ERR(eNOTSUPPORTED_EDUOM);
+#endif
+
+} /* EduOM_ResetStats() */
+
+
+
+/*@================================
+ * EduOM_GetLatencyPercentile()
+ *================================*/
+/*
+ * Function: Four EduOM_GetLatencyPercentile(EduOM_ApiStats*, double, double*)
+ *
+ * Description:
+ *  Compute a percentile of the latencies of an interface function from its
+ *  histogram. The upper bound of the bucket holding the percentile is
+ *  returned, so the result is never below the true value.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four EduOM_GetLatencyPercentile(
+    EduOM_ApiStats *s,		/* IN statistics of an interface function */
+    double	percentile,	/* IN percentile(0 ~ 100) */
+    double	*nsec)		/* OUT latency in nsec; 0 if no call was counted */
+{
+    Four	b;		/* index of a bucket */
+    double	rank;		/* calls at or below the percentile */
+    double	seen;		/* calls in the buckets visited */
+
+
+    if (s == NULL || nsec == NULL || percentile < 0 || percentile > 100) ERR(eBADPARAMETER);
+
+    *nsec = 0;
+    if (s->count == 0) return(eNOERROR);
+
+    rank = (percentile/100) * s->count;
+    if (rank < 1) rank = 1;
+
+    for (b = 0, seen = 0; b < EDUOM_LATENCY_BUCKETS; b++) {
+        seen += s->hist[b];
+        if (seen >= rank) break;
+    }
+    if (b == EDUOM_LATENCY_BUCKETS) b--;
+
+    *nsec = eduom_BucketUpperBound(b);
+    if (*nsec > s->maxTime) *nsec = s->maxTime;
+
+    return(eNOERROR);
+
+} /* EduOM_GetLatencyPercentile() */
@@ -32,6 +32,7 @@
  *  Four EduOM_Test(Four, Four)
  */
 #include <string.h>
+#include <ctype.h>
 #include "EduOM_common.h"
 #include "EduOM.h"
 #include "EduOM_Internal.h"
@@ -71,7 +72,7 @@ void press_enter_for_continue(Boolean);
 Four EduOM_Test(Four volId, Four handle, Boolean getcharFlag){
 
   Four 		e;										/* for errors */
-  Four		i, j;									/* loop index */
+  Four		i;										/* loop index */
   FileID      fid;									/* file identifier */
   ObjectID    catalogEntry;							/* catalog object */
   ObjectID	oid;									/* object identifeier */	
@@ -418,6 +419,8 @@ Four EduOM_Test(Four volId, Four handle, Boolean getcharFlag){
   /* Destroy File */
   e = SM_DestroyFile(&fid, NULL);
   if (e < eNOERROR) ERR(e); 
+
+  return(eNOERROR);
 }
 
 /*@================================
@@ -447,7 +450,7 @@ Four eduom_DumpPage(
   printf("|  nSlots = %-3d         free = %-4d          unused = %-4d   |\n",
       apage->header.nSlots, apage->header.free, apage->header.unused);
   printf("| FREE = %-4d           CFREE = %-4d                         |\n",
-      SP_FREE(apage), SP_CFREE(apage));
+      (int)SP_FREE(apage), (int)SP_CFREE(apage));
   printf("+------------------------------------------------------------+\n");
   printf("| fid = (%4d, %4d)                                         |\n",
       apage->header.fid.volNo, apage->header.fid.serial);                 /* COOKIE17NOV1999 */
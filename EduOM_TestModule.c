@@ -31,7 +31,9 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "EduOM_common.h"
+#include "EduOM.h"
 #include "EduOM_Internal.h"
 #include "EduOM_TestModule.h"
 
@@ -40,7 +42,6 @@ Four main(int argc, char *argv[])
 {
 
 	Four	e;									/* for errors */
-	Four 	i;									/* loop index */
 	Four	handle;								/* system handle */
 	Four	numDevices = 0;						/* # of devices which consists formated volume */
 	char 	*devNames[MAX_DEVICES_IN_VOLUME];	/* device name */
@@ -51,6 +52,7 @@ Four main(int argc, char *argv[])
 	Four 	segmentSize;						/* size of a segment */
 	XactID 	xactId;								/* transaction identifier */
 	Boolean getcharFlag;						/* flag for getchar */
+	Four	nFailed = 0;						/* # of behavior tests failed */
 
 	/*
 	 *   Initialize the storage system 
@@ -81,6 +83,9 @@ Four main(int argc, char *argv[])
 	numPagesInDevices[0] = 500;
 	segmentSize = 16;
 
+	/* the behavior tests create a file per test */
+	if (argc > 1 && strcmp(argv[1], "features") == 0) numPagesInDevices[0] = 4000;
+
 	/*
 	 *  Format volume
 	 */
@@ -110,9 +115,14 @@ Four main(int argc, char *argv[])
 		LRDS_Final();
 	}
 	
-	/* Test EduOM */
+	/* Test EduOM, or run the behavior tests with "features" */
 	getcharFlag = argc > 1 ? FALSE : TRUE;
-	e = EduOM_Test(volId, handle, getcharFlag);
+	if (argc > 1 && strcmp(argv[1], "features") == 0) {
+		e = EduOM_FeatureTest(volId, devNames[0]);
+		if (e != eNOERROR) nFailed = (e > 0) ? e : 1;
+	}
+	else
+		e = EduOM_Test(volId, handle, getcharFlag);
 
 	if (e < eNOERROR){
 		printf("EduOM_Test failed!!!\n");
@@ -122,6 +132,12 @@ Four main(int argc, char *argv[])
 		LRDS_Final();
 	}
 
+	/* Put the active insert pages back into the available space lists */
+	e = EduOM_ReleaseActiveInsertPages();
+	if (e < eNOERROR){
+		printf("EduOM_ReleaseActiveInsertPages failed!!!\n");
+	}
+
 	/* Commit Transaction */
 	e = LRDS_CommitTransaction(&xactId);
 	if (e < eNOERROR){
@@ -155,5 +171,5 @@ Four main(int argc, char *argv[])
 		exit(1);
 	}
 
-	return 0;
+	return (nFailed > 0) ? 1 : 0;
 }
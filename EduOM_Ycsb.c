@@ -0,0 +1,1034 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: EduOM_Ycsb.c
+ *
+ * Description :
+ *  YCSB-style workload driver of the EduOM. A volume of the given size is
+ *  formatted, 'records' objects are loaded into one data file, and then a
+ *  mix of operations is run by the client threads. A record is named by a
+ *  key in [0, the number of records); the driver keeps the map from the keys
+ *  to the ObjectIDs of the records in memory.
+ *
+ *    read    read the record of a key
+ *    update  replace the record of a key by a new one created near it; the
+ *            EduOM has no interface to overwrite an object
+ *    insert  create the record of a new key
+ *    scan    read a random number of records with EduOM_NextObject(),
+ *            starting at the record of a key
+ *    rmw     read the record of a key and update it
+ *
+ *  The mixes of the core workloads of YCSB are predefined:
+ *
+ *    a  update heavy   50% read, 50% update, zipfian
+ *    b  read mostly    95% read, 5% update, zipfian
+ *    c  read only      100% read, zipfian
+ *    d  read latest    95% read, 5% insert, latest
+ *    e  short ranges   95% scan, 5% insert, zipfian
+ *    f  read-modify-write  50% read, 50% rmw, zipfian
+ *
+ *  The keys are chosen by the zipfian distribution of YCSB(scrambled, so that
+ *  the popular keys are spread over the file), by the uniform distribution,
+ *  or by the 'latest' distribution which favors the keys inserted last.
+ *
+ *  While the mix runs, one line of 'key=value' pairs is printed per interval
+ *  with the throughput of the interval; at the end one line is printed per
+ *  kind of operation with the operations done and p50/p95/p99/p99.9/max
+ *  latency in usec.
+ *
+ *  The object manager is not thread safe yet, so each operation of a client
+ *  thread holds ycsb_engineMutex; with more than one client the operations
+ *  are interleaved, not run in parallel, and the latencies include the time
+ *  waiting for the mutex.
+ *
+ *  With -H, the volume is dismounted and mounted again between the load and
+ *  the run, as a server restarting on a loaded database would. The trains
+ *  resident in the buffer pool are saved into the given file before each
+ *  dismount(see BfM_SaveResidentTrains()) and read back after the mount(see
+ *  BfM_LoadResidentTrains()), so the run starts warm; a line 'restart=warm
+ *  loaded=N' tells how many trains were read back.
+ *
+ *  usage: EduOM_Ycsb [-d device] [-p pages] [-r records] [-n ops] [-s size]
+ *                    [-w a|b|c|d|e|f] [-k zipfian|uniform|latest] [-z theta]
+ *                    [-l maxScanLength] [-t threads] [-i intervalMsec] [-R seed]
+ *                    [-H hotFile]
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "EduOM.h"
+#include "EduOM_Internal.h"
+#include "EduOM_TestModule.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define YCSB_DEFAULT_DEVICE     "ycsb.vol"
+#define YCSB_DEFAULT_PAGES      20000
+#define YCSB_DEFAULT_RECORDS    10000
+#define YCSB_DEFAULT_OPS        100000
+#define YCSB_DEFAULT_SIZE       100
+#define YCSB_DEFAULT_THETA      0.99
+#define YCSB_DEFAULT_SCAN       100
+#define YCSB_DEFAULT_INTERVAL   1000
+#define YCSB_MAX_THREADS        64
+#define YCSB_VOLID              1000
+
+/* kinds of the operations */
+#define YCSB_OP_READ            0
+#define YCSB_OP_UPDATE          1
+#define YCSB_OP_INSERT          2
+#define YCSB_OP_SCAN            3
+#define YCSB_OP_RMW             4
+#define YCSB_NUM_OPS            5
+
+/* distributions of the keys */
+#define YCSB_DIST_ZIPFIAN       0
+#define YCSB_DIST_UNIFORM       1
+#define YCSB_DIST_LATEST        2
+
+
+/*@
+ * Type Definitions
+ */
+/* mix of the operations */
+typedef struct {
+    char	name;			/* name of the workload */
+    double	prop[YCSB_NUM_OPS];	/* proportion of each kind of operation */
+    Four	dist;			/* distribution of the keys */
+} ycsb_Workload;
+
+/* zipfian distribution over [0, n) */
+typedef struct {
+    Four	n;		/* the number of items */
+    double	theta;		/* skew */
+    double	zetan;		/* zeta(n, theta) */
+    double	zeta2;		/* zeta(2, theta) */
+    double	alpha;		/* 1/(1 - theta) */
+    double	eta;
+} ycsb_Zipfian;
+
+/* latencies of one kind of operation */
+typedef struct {
+    Four	n;		/* the number of latencies */
+    double	*usec;		/* latencies in usec */
+} ycsb_Latency;
+
+/* state of a client thread */
+typedef struct {
+    pthread_t	thread;
+    Four	id;		/* index of the client */
+    Four	nOps;		/* operations to do */
+    UFour	seed;		/* state of the random number generator */
+    ycsb_Latency latency[YCSB_NUM_OPS];
+    struct timespec end;	/* time the client finished */
+    Four	e;		/* error of the client */
+} ycsb_Client;
+
+
+/*@
+ * Global Variables
+ */
+static ycsb_Workload ycsb_workloads[] = {
+    /*        read  update insert scan  rmw */
+    { 'a', { 0.50, 0.50, 0.00, 0.00, 0.00 }, YCSB_DIST_ZIPFIAN },
+    { 'b', { 0.95, 0.05, 0.00, 0.00, 0.00 }, YCSB_DIST_ZIPFIAN },
+    { 'c', { 1.00, 0.00, 0.00, 0.00, 0.00 }, YCSB_DIST_ZIPFIAN },
+    { 'd', { 0.95, 0.00, 0.05, 0.00, 0.00 }, YCSB_DIST_LATEST },
+    { 'e', { 0.00, 0.00, 0.05, 0.95, 0.00 }, YCSB_DIST_ZIPFIAN },
+    { 'f', { 0.50, 0.00, 0.00, 0.00, 0.50 }, YCSB_DIST_ZIPFIAN }
+};
+static char *ycsb_opName[YCSB_NUM_OPS] = { "read", "update", "insert", "scan", "rmw" };
+static char *ycsb_distName[] = { "zipfian", "uniform", "latest" };
+
+static pthread_mutex_t ycsb_engineMutex = PTHREAD_MUTEX_INITIALIZER; /* serializes the EduOM and the map */
+static ObjectID ycsb_catalogEntry;	/* catalog object of the data file */
+static ObjectID *ycsb_keys = NULL;	/* map from the keys to the records */
+static Four ycsb_nKeys = 0;
+static Four ycsb_maxKeys = 0;
+static ycsb_Workload *ycsb_workload;	/* mix being run */
+static Four ycsb_dist;			/* distribution of the keys */
+static ycsb_Zipfian ycsb_zipfian;	/* zipfian distribution over the keys */
+static Four ycsb_size = YCSB_DEFAULT_SIZE;
+static Four ycsb_maxScan = YCSB_DEFAULT_SCAN;
+static volatile Four ycsb_opsDone = 0;	/* operations done by all the clients */
+static volatile Four ycsb_nRunning = 0;	/* clients running */
+static char ycsb_data[PAGESIZE];	/* data of the records */
+
+
+Four SM_CreateFile(Four, FileID*, Boolean, void*);
+Four sm_GetCatalogEntryFromDataFileId(Four, FileID*, ObjectID*);
+
+
+/* Macro: YCSB_USEC(_from, _to)
+ * Description: return the microseconds elapsed between two times
+ * Returns: (double) microseconds
+ */
+#define YCSB_USEC(_from, _to) \
+    (((_to).tv_sec - (_from).tv_sec)*1e6 + ((_to).tv_nsec - (_from).tv_nsec)/1e3)
+
+
+
+/*@================================
+ * ycsb_Random()
+ *================================*/
+/*
+ * Function: UFour ycsb_Random(UFour*)
+ *
+ * Description:
+ *  Return a pseudo random number(xorshift) from the state of a client, the
+ *  same sequence on every platform for the same seed.
+ *
+ * Returns:
+ *  random number
+ */
+static UFour ycsb_Random(
+    UFour	*seed)		/* INOUT state of the generator */
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+
+    return(*seed);
+
+} /* ycsb_Random() */
+
+
+
+/* Macro: YCSB_RANDOM01(_seed)
+ * Description: return a pseudo random number in [0, 1)
+ * Returns: (double) random number
+ */
+#define YCSB_RANDOM01(_seed) (ycsb_Random(_seed) / 4294967296.0)
+
+
+
+/*@================================
+ * ycsb_Hash()
+ *================================*/
+/*
+ * Function: UFour ycsb_Hash(UFour)
+ *
+ * Description:
+ *  FNV-1a hash of a number; scrambles the ranks of the zipfian distribution.
+ *
+ * Returns:
+ *  hash value
+ */
+static UFour ycsb_Hash(
+    UFour	x)		/* IN number to hash */
+{
+    UFour	h = 2166136261U;	/* FNV offset basis */
+    Four	i;			/* index variable */
+
+
+    for (i = 0; i < 4; i++) {
+        h ^= (x >> (8*i)) & 0xff;
+        h *= 16777619U;			/* FNV prime */
+    }
+
+    return(h);
+
+} /* ycsb_Hash() */
+
+
+
+/*@================================
+ * ycsb_SetZipfian()
+ *================================*/
+/*
+ * Function: void ycsb_SetZipfian(ycsb_Zipfian*, Four)
+ *
+ * Description:
+ *  Set the number of items of the zipfian distribution. zeta(n, theta) is
+ *  extended from the previous number of items, so the keys inserted during
+ *  the run cost one term each.
+ *
+ * Returns:
+ *  None
+ */
+static void ycsb_SetZipfian(
+    ycsb_Zipfian *z,		/* INOUT zipfian distribution */
+    Four	n)		/* IN the number of items */
+{
+    Four	i;		/* index variable */
+
+
+    if (n < z->n) {
+        z->n = 0;
+        z->zetan = 0.0;
+    }
+    for (i = z->n + 1; i <= n; i++)
+        z->zetan += 1.0 / pow((double)i, z->theta);
+    z->n = n;
+
+    z->zeta2 = 1.0 + pow(0.5, z->theta);
+    z->alpha = 1.0 / (1.0 - z->theta);
+    z->eta = (n > 2) ? (1.0 - pow(2.0/n, 1.0 - z->theta)) / (1.0 - z->zeta2/z->zetan) : 1.0;
+
+} /* ycsb_SetZipfian() */
+
+
+
+/*@================================
+ * ycsb_NextZipfian()
+ *================================*/
+/*
+ * Function: Four ycsb_NextZipfian(ycsb_Zipfian*, UFour*)
+ *
+ * Description:
+ *  Return a rank of the zipfian distribution; rank 0 is the most popular
+ *  (Gray et al., "Quickly Generating Billion-Record Synthetic Databases").
+ *
+ * Returns:
+ *  rank in [0, n)
+ */
+static Four ycsb_NextZipfian(
+    ycsb_Zipfian *z,		/* IN zipfian distribution */
+    UFour	*seed)		/* INOUT state of the random number generator */
+{
+    double	u;		/* uniform random number */
+    double	uz;
+    Four	rank;
+
+
+    u = YCSB_RANDOM01(seed);
+    uz = u * z->zetan;
+
+    if (uz < 1.0) return(0);
+    if (uz < z->zeta2 && z->n > 1) return(1);
+
+    rank = (Four)(z->n * pow(z->eta*u - z->eta + 1.0, z->alpha));
+
+    return(MIN(MAX(rank, 0), z->n - 1));
+
+} /* ycsb_NextZipfian() */
+
+
+
+/*@================================
+ * ycsb_ChooseKey()
+ *================================*/
+/*
+ * Function: Four ycsb_ChooseKey(UFour*)
+ *
+ * Description:
+ *  Choose an existing key by the distribution of the run. The caller holds
+ *  ycsb_engineMutex.
+ *
+ * Returns:
+ *  key; -1 if there is no key
+ */
+static Four ycsb_ChooseKey(
+    UFour	*seed)		/* INOUT state of the random number generator */
+{
+    if (ycsb_nKeys == 0) return(-1);
+
+    switch (ycsb_dist) {
+      case YCSB_DIST_UNIFORM:
+        return(ycsb_Random(seed) % ycsb_nKeys);
+
+      case YCSB_DIST_LATEST:
+        if (ycsb_zipfian.n != ycsb_nKeys) ycsb_SetZipfian(&ycsb_zipfian, ycsb_nKeys);
+        return(ycsb_nKeys - 1 - ycsb_NextZipfian(&ycsb_zipfian, seed));
+
+      default:
+        if (ycsb_zipfian.n != ycsb_nKeys) ycsb_SetZipfian(&ycsb_zipfian, ycsb_nKeys);
+        return(ycsb_Hash(ycsb_NextZipfian(&ycsb_zipfian, seed)) % ycsb_nKeys);
+    }
+
+} /* ycsb_ChooseKey() */
+
+
+
+/*@================================
+ * ycsb_Insert()
+ *================================*/
+/*
+ * Function: Four ycsb_Insert(void)
+ *
+ * Description:
+ *  Create the record of a new key. The caller holds ycsb_engineMutex.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four ycsb_Insert(void)
+{
+    Four	e;		/* error number */
+    ObjectID	*keys;		/* enlarged map */
+    ObjectID	oid;		/* record created */
+
+
+    if (ycsb_nKeys == ycsb_maxKeys) {
+        keys = (ObjectID *)realloc(ycsb_keys, sizeof(ObjectID) * MAX(2*ycsb_maxKeys, 1024));
+        if (keys == NULL) ERR(eMEMORYALLOCERR);
+        ycsb_keys = keys;
+        ycsb_maxKeys = MAX(2*ycsb_maxKeys, 1024);
+    }
+
+    e = EduOM_CreateObject(&ycsb_catalogEntry, NULL, NULL, ycsb_size, ycsb_data, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    ycsb_keys[ycsb_nKeys++] = oid;
+
+    return(eNOERROR);
+
+} /* ycsb_Insert() */
+
+
+
+/*@================================
+ * ycsb_Update()
+ *================================*/
+/*
+ * Function: Four ycsb_Update(Four)
+ *
+ * Description:
+ *  Replace the record of a key by a new one created near it. The caller
+ *  holds ycsb_engineMutex.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four ycsb_Update(
+    Four	key)		/* IN key of the record */
+{
+    Four	e;		/* error number */
+    ObjectID	oid;		/* new record */
+
+
+    e = EduOM_CreateObject(&ycsb_catalogEntry, &ycsb_keys[key], NULL, ycsb_size, ycsb_data, &oid);
+    if (e < eNOERROR) ERR(e);
+
+    e = EduOM_DestroyObject(&ycsb_catalogEntry, &ycsb_keys[key], &dlPool, &dlHead);
+    if (e < eNOERROR) ERR(e);
+
+    ycsb_keys[key] = oid;
+
+    return(eNOERROR);
+
+} /* ycsb_Update() */
+
+
+
+/*@================================
+ * ycsb_Scan()
+ *================================*/
+/*
+ * Function: Four ycsb_Scan(Four, Four)
+ *
+ * Description:
+ *  Read up to 'length' records in the order of the file, starting at the
+ *  record of a key. The scan ends early when the position does not move.
+ *  The caller holds ycsb_engineMutex.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four ycsb_Scan(
+    Four	key,		/* IN key of the first record */
+    Four	length)		/* IN the number of records to read */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    ObjectID	cursor;		/* position of the scan */
+    ObjectID	next;		/* next position */
+    char	buf[PAGESIZE];	/* buffer to read a record into */
+
+
+    cursor = ycsb_keys[key];
+    e = EduOM_ReadObject(&cursor, 0, REMAINDER, buf);
+    if (e < eNOERROR) ERR(e);
+
+    for (i = 1; i < length; i++) {
+        next = cursor;
+        e = EduOM_NextObject(&ycsb_catalogEntry, &cursor, &next, NULL);
+        if (e < eNOERROR) ERR(e);
+        if (next.pageNo == cursor.pageNo && next.slotNo == cursor.slotNo) break;
+        cursor = next;
+
+        e = EduOM_ReadObject(&cursor, 0, REMAINDER, buf);
+        if (e < eNOERROR) ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* ycsb_Scan() */
+
+
+
+/*@================================
+ * ycsb_RunOp()
+ *================================*/
+/*
+ * Function: Four ycsb_RunOp(ycsb_Client*, Four)
+ *
+ * Description:
+ *  Do one operation of the given kind for a client.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four ycsb_RunOp(
+    ycsb_Client	*client,	/* INOUT client doing the operation */
+    Four	op)		/* IN kind of the operation */
+{
+    Four	e;		/* error number */
+    Four	key;		/* key of the record */
+    Four	length;		/* length of a scan */
+    char	buf[PAGESIZE];	/* buffer to read a record into */
+
+
+    pthread_mutex_lock(&ycsb_engineMutex);
+
+    if (op == YCSB_OP_INSERT)
+        e = ycsb_Insert();
+
+    else if ((key = ycsb_ChooseKey(&client->seed)) < 0)
+        e = eNOERROR;
+
+    else switch (op) {
+      case YCSB_OP_READ:
+        e = EduOM_ReadObject(&ycsb_keys[key], 0, REMAINDER, buf);
+        break;
+
+      case YCSB_OP_UPDATE:
+        e = ycsb_Update(key);
+        break;
+
+      case YCSB_OP_SCAN:
+        length = 1 + ycsb_Random(&client->seed) % ycsb_maxScan;
+        e = ycsb_Scan(key, length);
+        break;
+
+      case YCSB_OP_RMW:
+        e = EduOM_ReadObject(&ycsb_keys[key], 0, REMAINDER, buf);
+        if (e >= eNOERROR) e = ycsb_Update(key);
+        break;
+
+      default:
+        e = eBADPARAMETER;
+    }
+
+    pthread_mutex_unlock(&ycsb_engineMutex);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* ycsb_RunOp() */
+
+
+
+/*@================================
+ * ycsb_ClientMain()
+ *================================*/
+/*
+ * Function: void *ycsb_ClientMain(void*)
+ *
+ * Description:
+ *  Body of a client thread: do the operations of the client, choosing the
+ *  kind of each by the mix, and keep their latencies.
+ *
+ * Returns:
+ *  NULL; the error is left in the client
+ */
+static void *ycsb_ClientMain(
+    void	*arg)		/* IN the client(ycsb_Client*) */
+{
+    ycsb_Client	*client = (ycsb_Client *)arg;
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	op;		/* kind of the operation */
+    double	u;		/* uniform random number */
+    ycsb_Latency *l;		/* latencies of the kind */
+    struct timespec t0, t1;	/* times */
+
+
+    client->e = eNOERROR;
+
+    for (i = 0; i < client->nOps; i++) {
+        u = YCSB_RANDOM01(&client->seed);
+        for (op = 0; op < YCSB_NUM_OPS-1; op++) {
+            if (u < ycsb_workload->prop[op]) break;
+            u -= ycsb_workload->prop[op];
+        }
+        while (ycsb_workload->prop[op] == 0.0) op--; /* rounding of the proportions */
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        client->e = ycsb_RunOp(client, op);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        if (client->e < eNOERROR) break;
+
+        l = &client->latency[op];
+        l->usec[l->n++] = YCSB_USEC(t0, t1);
+
+        __sync_fetch_and_add(&ycsb_opsDone, 1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &client->end);
+
+    /* the active insert pages are owned by this thread(see EduOM_ReleaseActiveInsertPages()) */
+    pthread_mutex_lock(&ycsb_engineMutex);
+    e = EduOM_ReleaseActiveInsertPages();
+    pthread_mutex_unlock(&ycsb_engineMutex);
+    if (client->e >= eNOERROR) client->e = e;
+
+    __sync_fetch_and_sub(&ycsb_nRunning, 1);
+
+    return(NULL);
+
+} /* ycsb_ClientMain() */
+
+
+
+/*@================================
+ * ycsb_CompareDouble()
+ *================================*/
+/*
+ * Function: int ycsb_CompareDouble(const void*, const void*)
+ *
+ * Description:
+ *  Compare two latencies for qsort().
+ *
+ * Returns:
+ *  negative, zero, or positive as qsort() expects
+ */
+static int ycsb_CompareDouble(
+    const void	*a,		/* IN latency */
+    const void	*b)		/* IN latency */
+{
+    double x = *(const double *)a, y = *(const double *)b;
+
+    return((x < y) ? -1 : (x > y) ? 1 : 0);
+
+} /* ycsb_CompareDouble() */
+
+
+
+/*@================================
+ * ycsb_PrintLatencies()
+ *================================*/
+/*
+ * Function: Four ycsb_PrintLatencies(ycsb_Client*, Four)
+ *
+ * Description:
+ *  Merge the latencies of the clients and print one line per kind of
+ *  operation done.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four ycsb_PrintLatencies(
+    ycsb_Client	*clients,	/* IN the clients */
+    Four	nClients)	/* IN the number of clients */
+{
+    Four	op;		/* kind of the operation */
+    Four	i;		/* index variable */
+    Four	n;		/* the number of latencies */
+    double	*all;		/* latencies of all the clients */
+
+
+    for (op = 0; op < YCSB_NUM_OPS; op++) {
+        for (i = 0, n = 0; i < nClients; i++) n += clients[i].latency[op].n;
+        if (n == 0) continue;
+
+        all = (double *)malloc(sizeof(double) * n);
+        if (all == NULL) ERR(eMEMORYALLOCERR);
+
+        for (i = 0, n = 0; i < nClients; i++) {
+            memcpy(&all[n], clients[i].latency[op].usec, sizeof(double) * clients[i].latency[op].n);
+            n += clients[i].latency[op].n;
+        }
+        qsort(all, n, sizeof(double), ycsb_CompareDouble);
+
+        printf("op=%s count=%d p50_us=%.2f p95_us=%.2f p99_us=%.2f p999_us=%.2f max_us=%.2f\n",
+               ycsb_opName[op], n, all[(Four)(n*0.50)], all[MIN((Four)(n*0.95), n-1)],
+               all[MIN((Four)(n*0.99), n-1)], all[MIN((Four)(n*0.999), n-1)], all[n-1]);
+
+        free(all);
+    }
+
+    return(eNOERROR);
+
+} /* ycsb_PrintLatencies() */
+
+
+
+/*@================================
+ * ycsb_Run()
+ *================================*/
+/*
+ * Function: Four ycsb_Run(Four, Four, Four, UFour)
+ *
+ * Description:
+ *  Run 'nOps' operations of the mix split over the client threads, print
+ *  the throughput of every interval while they run, and print the
+ *  latencies at the end.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ *    some errors caused by function calls
+ */
+static Four ycsb_Run(
+    Four	nOps,		/* IN the number of operations */
+    Four	nClients,	/* IN the number of client threads */
+    Four	interval,	/* IN interval of the throughput report in msec */
+    UFour	seed)		/* IN seed of the random number generators */
+{
+    Four	e;		/* error number */
+    Four	i, op;		/* index variables */
+    Four	lastOps;	/* operations done until the previous report */
+    Four	ops;		/* operations done until now */
+    ycsb_Client	*clients;	/* the clients */
+    struct timespec begin, last, now; /* times */
+    struct timespec tick;	/* interval of polling the clients */
+    double	secs;
+
+
+    clients = (ycsb_Client *)calloc(nClients, sizeof(ycsb_Client));
+    if (clients == NULL) ERR(eMEMORYALLOCERR);
+
+    for (i = 0, e = eNOERROR; i < nClients; i++) {
+        clients[i].id = i;
+        clients[i].nOps = nOps / nClients + ((i < nOps % nClients) ? 1 : 0);
+        clients[i].seed = ycsb_Hash(seed + i) | 1;
+        for (op = 0; op < YCSB_NUM_OPS; op++) {
+            clients[i].latency[op].usec = (double *)malloc(sizeof(double) * MAX(clients[i].nOps, 1));
+            if (clients[i].latency[op].usec == NULL) e = eMEMORYALLOCERR;
+        }
+    }
+    if (e < eNOERROR) goto done;
+
+    ycsb_opsDone = 0;
+    ycsb_nRunning = nClients;
+    tick.tv_sec = 0;
+    tick.tv_nsec = MIN(interval, 10) * 1000000L;
+
+    clock_gettime(CLOCK_MONOTONIC, &begin);
+    last = begin;
+    lastOps = 0;
+
+    for (i = 0; i < nClients; i++)
+        if (pthread_create(&clients[i].thread, NULL, ycsb_ClientMain, &clients[i]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+
+    while (ycsb_nRunning > 0) {
+        nanosleep(&tick, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (ycsb_nRunning > 0 && YCSB_USEC(last, now) < interval*1e3) continue;
+        ops = ycsb_opsDone;
+        printf("time_s=%.3f ops=%d interval_ops=%d ops_per_sec=%.0f\n",
+               YCSB_USEC(begin, now)/1e6, ops, ops - lastOps,
+               (ops - lastOps) / (YCSB_USEC(last, now)/1e6));
+        fflush(stdout);
+        last = now;
+        lastOps = ops;
+    }
+
+    for (i = 0, secs = 0.0; i < nClients; i++) {
+        pthread_join(clients[i].thread, NULL);
+        if (clients[i].e < eNOERROR) e = clients[i].e;
+        secs = MAX(secs, YCSB_USEC(begin, clients[i].end)/1e6);
+    }
+
+    if (e < eNOERROR) {
+        printf("run ops=%d error=%d\n", ycsb_opsDone, e);
+        goto done;
+    }
+
+    printf("run ops=%d secs=%.3f ops_per_sec=%.0f records=%d\n",
+           ycsb_opsDone, secs, (secs > 0) ? ycsb_opsDone/secs : 0.0, ycsb_nKeys);
+
+    e = ycsb_PrintLatencies(clients, nClients);
+    fflush(stdout);
+
+  done:
+    for (i = 0; i < nClients; i++)
+        for (op = 0; op < YCSB_NUM_OPS; op++) free(clients[i].latency[op].usec);
+    free(clients);
+
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* ycsb_Run() */
+
+
+
+/*@================================
+ * ycsb_Load()
+ *================================*/
+/*
+ * Function: Four ycsb_Load(Four)
+ *
+ * Description:
+ *  Insert the records of the keys [0, nRecords) and print the throughput.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four ycsb_Load(
+    Four	nRecords)	/* IN the number of records */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    struct timespec t0, t1;	/* times */
+    double	secs;
+
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < nRecords; i++) {
+        e = ycsb_Insert();
+        if (e < eNOERROR) ERR(e);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    secs = YCSB_USEC(t0, t1)/1e6;
+
+    printf("load records=%d secs=%.3f ops_per_sec=%.0f\n",
+           nRecords, secs, (secs > 0) ? nRecords/secs : 0.0);
+    fflush(stdout);
+
+    return(eNOERROR);
+
+} /* ycsb_Load() */
+
+
+
+/*@================================
+ * ycsb_Restart()
+ *================================*/
+/*
+ * Function: Four ycsb_Restart(char*, Four, char*, XactID*)
+ *
+ * Description:
+ *  Commit the transaction of the load, save the trains resident in the
+ *  buffer pool, dismount the volume and mount it again, read the saved
+ *  trains back and begin the transaction of the run. The ObjectIDs of the
+ *  records stay valid over the restart.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+static Four ycsb_Restart(
+    char	*devName,	/* IN device of the volume */
+    Four	volId,		/* IN volume */
+    char	*hotFile,	/* IN file of the resident trains */
+    XactID	*xactId)	/* INOUT transaction of the load, then of the run */
+{
+    Four	e;		/* error number */
+    Four	loaded;		/* the number of trains read back */
+
+
+    e = EduOM_ReleaseActiveInsertPages();
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_CommitTransaction(xactId);
+    if (e < eNOERROR) ERR(e);
+
+    e = BfM_SaveResidentTrains(volId, hotFile);
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_Dismount(volId);
+    if (e < eNOERROR) ERR(e);
+
+    e = LRDS_Mount(1, &devName, &volId);
+    if (e < eNOERROR) ERR(e);
+
+    /* keep the list recent at the checkpoints of the writer, too */
+    e = BfM_SetWarmStartFile(volId, hotFile);
+    if (e < eNOERROR) ERR(e);
+
+    loaded = BfM_LoadResidentTrains(volId, hotFile, 0);
+    if (loaded < eNOERROR) ERR(loaded);
+
+    printf("restart=warm loaded=%d\n", loaded);
+
+    e = LRDS_BeginTransaction(xactId, X_RR_RR);
+    if (e < eNOERROR) ERR(e);
+
+    return(eNOERROR);
+
+} /* ycsb_Restart() */
+
+
+
+/*@================================
+ * main()
+ *================================*/
+Four main(int argc, char *argv[])
+{
+    Four	e;		/* error number */
+    Four	c;		/* option */
+    Four	i;		/* index variable */
+    Four	handle;		/* system handle */
+    char	*devName = YCSB_DEFAULT_DEVICE;
+    Four	nPages = YCSB_DEFAULT_PAGES;
+    Four	nRecords = YCSB_DEFAULT_RECORDS;
+    Four	nOps = YCSB_DEFAULT_OPS;
+    Four	nClients = 1;
+    Four	interval = YCSB_DEFAULT_INTERVAL;
+    UFour	seed = 1;
+    char	workload = 'a';
+    char	*dist = NULL;	/* distribution overriding that of the mix */
+    char	*hotFile = NULL;	/* file of the resident trains; NULL for no restart */
+    Four	volId = YCSB_VOLID;
+    FileID	fid;		/* data file */
+    XactID	xactId;		/* transaction identifier */
+
+
+    ycsb_zipfian.theta = YCSB_DEFAULT_THETA;
+
+    while ((c = getopt(argc, argv, "d:p:r:n:s:w:k:z:l:t:i:R:H:")) != -1) {
+        switch (c) {
+          case 'd': devName = optarg; break;
+          case 'p': nPages = atoi(optarg); break;
+          case 'r': nRecords = atoi(optarg); break;
+          case 'n': nOps = atoi(optarg); break;
+          case 's': ycsb_size = atoi(optarg); break;
+          case 'w': workload = optarg[0]; break;
+          case 'k': dist = optarg; break;
+          case 'z': ycsb_zipfian.theta = atof(optarg); break;
+          case 'l': ycsb_maxScan = atoi(optarg); break;
+          case 't': nClients = atoi(optarg); break;
+          case 'i': interval = atoi(optarg); break;
+          case 'R': seed = (UFour)atol(optarg); break;
+          case 'H': hotFile = optarg; break;
+          default:
+            fprintf(stderr, "usage: %s [-d device] [-p pages] [-r records] [-n ops] [-s size] "
+                    "[-w a|b|c|d|e|f] [-k zipfian|uniform|latest] [-z theta] [-l maxScanLength] "
+                    "[-t threads] [-i intervalMsec] [-R seed] [-H hotFile]\n", argv[0]);
+            exit(1);
+        }
+    }
+
+    for (i = 0, ycsb_workload = NULL; i < sizeof(ycsb_workloads)/sizeof(ycsb_workloads[0]); i++)
+        if (ycsb_workloads[i].name == workload) ycsb_workload = &ycsb_workloads[i];
+    if (ycsb_workload == NULL) {
+        fprintf(stderr, "%s: unknown workload '%c'\n", argv[0], workload);
+        exit(1);
+    }
+
+    ycsb_dist = ycsb_workload->dist;
+    if (dist != NULL) {
+        for (ycsb_dist = 0; ycsb_dist < sizeof(ycsb_distName)/sizeof(ycsb_distName[0]); ycsb_dist++)
+            if (strcmp(dist, ycsb_distName[ycsb_dist]) == 0) break;
+        if (ycsb_dist == sizeof(ycsb_distName)/sizeof(ycsb_distName[0])) {
+            fprintf(stderr, "%s: unknown distribution '%s'\n", argv[0], dist);
+            exit(1);
+        }
+    }
+
+    if (ycsb_size < 0 || ALIGNED_LENGTH(ycsb_size) > LRGOBJ_THRESHOLD || nPages <= 0 ||
+        nRecords < 0 || nOps < 0 || ycsb_maxScan <= 0 || interval <= 0 ||
+        nClients <= 0 || nClients > YCSB_MAX_THREADS ||
+        ycsb_zipfian.theta <= 0.0 || ycsb_zipfian.theta >= 1.0) {
+        fprintf(stderr, "%s: bad size, pages, records, operations, scan length, interval, threads or theta\n", argv[0]);
+        exit(1);
+    }
+    if (seed == 0) seed = 1;
+    memset(ycsb_data, 'x', sizeof(ycsb_data));
+
+    e = LRDS_Init();
+    if (e < eNOERROR) {
+        printf("LRDS_Init failed!!!\n");
+        exit(1);
+    }
+
+    e = LRDS_AllocHandle(&handle);
+    if (e < eNOERROR) {
+        printf("LRDS_AllocHandle failed!!!\n");
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_FormatDataVolume(1, &devName, "ycsb", volId, 16, &nPages, 16);
+    if (e < eNOERROR) {
+        printf("LRDS_FormatDataVolume failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_Mount(1, &devName, &volId);
+    if (e < eNOERROR) {
+        printf("LRDS_Mount failed!!!\n");
+        LRDS_FreeHandle(handle);
+        LRDS_Final();
+        exit(1);
+    }
+
+    e = LRDS_BeginTransaction(&xactId, X_RR_RR);
+    if (e >= eNOERROR) e = SM_CreateFile(volId, &fid, FALSE, NULL);
+    if (e >= eNOERROR) e = sm_GetCatalogEntryFromDataFileId(ARRAYINDEX, &fid, &ycsb_catalogEntry);
+
+    printf("device=%s pages=%d records=%d ops=%d size=%d workload=%c distribution=%s theta=%.2f "
+           "max_scan=%d threads=%d seed=%u\n",
+           devName, nPages, nRecords, nOps, ycsb_size, workload, ycsb_distName[ycsb_dist],
+           ycsb_zipfian.theta, ycsb_maxScan, nClients, seed);
+
+    if (e >= eNOERROR) e = ycsb_Load(nRecords);
+    if (e >= eNOERROR && hotFile != NULL) e = ycsb_Restart(devName, volId, hotFile, &xactId);
+    if (e >= eNOERROR) e = ycsb_Run(nOps, nClients, interval, seed);
+    if (e >= eNOERROR) e = EduOM_ReleaseActiveInsertPages();
+
+    if (e < eNOERROR) {
+        printf("EduOM_Ycsb failed!!!\n");
+        LRDS_AbortTransaction(&xactId);
+    }
+    else
+        e = LRDS_CommitTransaction(&xactId);
+
+    if (e >= eNOERROR && hotFile != NULL) e = BfM_SaveResidentTrains(volId, hotFile);
+
+    LRDS_Dismount(volId);
+    LRDS_FreeHandle(handle);
+    LRDS_Final();
+
+    free(ycsb_keys);
+
+    return((e < eNOERROR) ? 1 : 0);
+
+} /* main() */
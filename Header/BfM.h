@@ -33,11 +33,143 @@
 #define PAGE_BUF    0
 #define LOT_LEAF_BUF 1
 
+/* default tunables of the writer(msec, pages) */
+#define BFM_DEFAULT_TRICKLE_INTERVAL     100
+#define BFM_DEFAULT_TRICKLE_PAGES        16
+#define BFM_DEFAULT_CHECKPOINT_INTERVAL  30000
+
+/* memory of the buffer pools(see BfM_SetUpBufferArena()) */
+#define BFM_ARENA_MALLOC    0   /* as allocated by the buffer manager */
+#define BFM_ARENA_HEAP      1   /* aligned to PAGESIZE */
+#define BFM_ARENA_THP       2   /* transparent huge pages */
+#define BFM_ARENA_HUGETLB   3   /* explicit huge pages */
+
+#define BFM_HUGE_PAGE_SIZE  (2*1024*1024)
+
+/* maximum number of partitions of the buffer pool(see BfM_SetUpNumaPartitions()) */
+#define BFM_MAX_PARTITIONS  64
+
+/* callers of the buffer manager(see BfM_SetCaller()) */
+#define BFM_CALLER_OTHER    0
+#define BFM_CALLER_CREATE   1
+#define BFM_CALLER_DESTROY  2
+#define BFM_CALLER_READ     3
+#define BFM_CALLER_SCAN     4
+#define BFM_CALLER_COMPACT  5
+#define BFM_NUM_CALLERS     6
+
+/* buckets of the pin time histogram; bucket i counts the pins shorter than 2^i usec */
+#define BFM_PIN_HIST_BUCKETS 24
+
+
+/*@
+ * Type Definitions
+ */
+/* tunables of the writer; an interval of 0 disables the activity */
+typedef struct {
+    Four trickleInterval;       /* msec between two trickles */
+    Four tricklePages;          /* maximum number of buffers written by a trickle */
+    Four checkpointInterval;    /* msec between two fuzzy checkpoints */
+} BfM_WriterParams;
+
+/* counters of the writer */
+typedef struct {
+    UFour pagesWritten;         /* buffers written by the writer */
+    UFour writeRuns;            /* runs of physically adjacent buffers written */
+    UFour asyncRuns;            /* of them, runs written by an asynchronous I/O handle */
+    UFour trickles;             /* trickles done */
+    UFour checkpoints;          /* fuzzy checkpoints done */
+    UFour stallsAvoided;        /* cleaned buffers replaced without a write (approximate) */
+} BfM_WriterStats;
+
+/* statistics of the buffer pool memory */
+typedef struct {
+    Four  mode;                 /* BFM_ARENA_XXX */
+    UFour hugePages;            /* huge pages spanned by the buffer pools */
+    UFour framesPerHugePage;    /* PAGE_BUF frames covered by one TLB entry */
+    UFour fallbacks;            /* times a mode was not available */
+} BfM_ArenaStats;
+
+/* statistics of a partition of the buffer pool */
+typedef struct {
+    Four  node;                 /* NUMA node holding the partition */
+    Four  nFrames;              /* buffer frames in the partition */
+    Four  nValid;               /* frames holding a train */
+    Four  nDirty;               /* frames holding a modified train */
+    Four  nFixed;               /* frames fixed */
+    UFour localAllocs;          /* frames allocated in the partition */
+    UFour fallbacks;            /* allocations passed to the buffer manager */
+} BfM_PartitionStats;
+
+/* statistics of the buffer manager used by a caller */
+typedef struct {
+    UFour gets;                 /* BfM_GetTrain() calls and optimistic reads */
+    UFour hits;                 /* ... finding the train in the buffer pool */
+    UFour optimisticHits;       /* ... of which read the frame without fixing it */
+    UFour misses;               /* ... reading the train */
+    UFour newTrains;            /* BfM_GetNewTrain() calls */
+    UFour frees;                /* BfM_FreeTrain() calls */
+    UFour setDirties;           /* BfM_SetDirty() calls */
+    /* the following are counted only with BFM_STATS_DETAIL(see BfM_Stats.c) */
+    UFour evictions;            /* trains replaced by the misses and new trains */
+    UFour dirtyWrites;          /* ... which had to be written first */
+    UFour pins;                 /* frames fixed and unfixed again */
+    double pinTime;             /* usec the frames stayed fixed in total */
+    UFour maxPinTime;           /* usec of the longest pin */
+    UFour pinHist[BFM_PIN_HIST_BUCKETS];    /* pins by their time */
+} BfM_CallerStats;
+
+/* statistics of the buffer manager */
+typedef struct {
+    BfM_CallerStats caller[BFM_NUM_CALLERS];    /* indexed by BFM_CALLER_XXX */
+    /* the following are counted only with BFM_STATS_DETAIL(see BfM_Stats.c) */
+    Four  nPinned;              /* frames fixed at the moment */
+    Four  maxPinned;            /* maximum number of frames fixed at a time */
+    UFour unpredicted;          /* misses whose victim is not known */
+} BfM_Stats;
+
 
 Four BfM_FreeTrain(TrainID *, Four);
 Four BfM_GetTrain(TrainID *, char **, Four);
 Four BfM_GetNewTrain(TrainID *, char **, Four);
 Four BfM_SetDirty(TrainID *, Four);
+Four BfM_FlushAll(void);
+Four BfM_DiscardAll(void);
+
+Four BfM_BeginFrameWrite(TrainID *, Four);
+Four BfM_EndFrameWrite(TrainID *, Four);
+char *BfM_LookUpFrame(TrainID *, Four, UFour *);
+Boolean BfM_ValidateFrame(TrainID *, Four, char *, UFour);
+
+Four BfM_SetWriterParams(BfM_WriterParams *);
+Four BfM_GetWriterParams(BfM_WriterParams *);
+Four BfM_GetWriterStats(BfM_WriterStats *);
+Four BfM_RunWriter(Boolean);
+Four BfM_PollWriter(void);
+
+Four BfM_PrefetchTrains(TrainID *, Four, Four);
+
+Four BfM_GetTrainForRead(TrainID *, char **, Four);
+Four BfM_FreeTrainForRead(TrainID *, char *, Four);
+
+Four BfM_SetUpBufferArena(Four);
+Four BfM_ReleaseBufferArena(void);
+Four BfM_GetBufferArenaStats(BfM_ArenaStats *);
+Four BfM_AlignBufferPools(void);
+
+Four BfM_SaveResidentTrains(VolNo, char *);
+Four BfM_LoadResidentTrains(VolNo, char *, Four);
+Four BfM_SetWarmStartFile(VolNo, char *);
+
+Four BfM_SetCaller(Four);
+Four BfM_GetStats(BfM_Stats *);
+Four BfM_ResetStats(void);
+Four BfM_DumpStats(FILE *);
+Four BfM_SetStatsDump(FILE *, Four);
+
+Four BfM_SetUpNumaPartitions(Four);
+Four BfM_GetNumPartitions(void);
+Four BfM_GetPartitionStats(Four, BfM_PartitionStats *);
 
 
 #endif /* _BFM_H_ */
@@ -0,0 +1,133 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _BFM_INTERNAL_H_
+#define _BFM_INTERNAL_H_
+
+
+#include "BfM.h"
+
+
+/*@
+ * Constant Definitions
+ */
+/* the number of buffer types(PAGE_BUF and LOT_LEAF_BUF) */
+#define NUM_BUF_TYPES   2
+
+/* bits of the buffer table entry; whether a frame holds a train is told by
+ * its key(see IS_VALID_FRAME()), not by a bit */
+#define DIRTY   0x01    /* the buffer has been modified */
+#define REFER   0x04    /* the buffer has been referenced since the last victim search */
+#define NEW_TRAIN 0x08  /* the train was allocated by BfM_GetNewTrain() and is not written yet */
+
+/* return value of bfm_LookUp() when the train is not in the buffer pool */
+#define NOTFOUND_IN_HTABLE  -1
+
+
+/*@
+ * Type Definitions
+ *
+ * Be CAREFUL: These must match the layout used by the buffer manager in cosmos.o.
+ */
+/* key of the buffer hash table */
+typedef struct {
+    PageNo  pageNo;         /* a PageNo */
+    VolNo   volNo;          /* a VolNo */
+} BfMHashKey;
+
+/* entry of the buffer table; one entry per buffer frame */
+typedef struct {
+    BfMHashKey  key;            /* identifier of the train held in the frame */
+    Two         fixed;          /* fixed count */
+    One         bits;           /* DIRTY, REFER */
+    Two         nextHashEntry;  /* next entry in the same hash chain */
+} BufferTable;
+
+/* buffer manager information of a buffer type */
+typedef struct {
+    Two         bufSize;        /* the number of pages in a train */
+    UTwo        nextVictim;     /* where the next victim search starts */
+    Two         nBufs;          /* the number of buffer frames */
+    BufferTable *bufTable;      /* buffer table */
+    char        *bufferPool;    /* buffer frames */
+    Two         *hashTable;     /* buffer hash table */
+} BufferInfo;
+
+
+/*@
+ * Macro Definitions
+ */
+#define BI_BUFSIZE(type)            (bufInfo[type].bufSize)
+#define BI_NEXTVICTIM(type)         (bufInfo[type].nextVictim)
+#define BI_NBUFS(type)              (bufInfo[type].nBufs)
+#define BI_BUFTABLE_ENTRY(type,idx) (&(bufInfo[type].bufTable[idx]))
+#define BI_KEY(type,idx)            (bufInfo[type].bufTable[idx].key)
+#define BI_FIXED(type,idx)          (bufInfo[type].bufTable[idx].fixed)
+#define BI_BITS(type,idx)           (bufInfo[type].bufTable[idx].bits)
+#define BI_BUFFERPOOL(type)         (bufInfo[type].bufferPool)
+#define BI_BUFFER(type,idx)         (bufInfo[type].bufferPool + (idx)*BI_BUFSIZE(type)*PAGESIZE)
+
+/* Macro: IS_VALID_FRAME(type, idx)
+ * Description: check whether the buffer frame holds a train
+ * Returns: TRUE(1) if it does, otherwise FALSE(0)
+ */
+#define IS_VALID_FRAME(type,idx)    ((BI_KEY(type,idx).pageNo != NIL) ? TRUE:FALSE)
+
+/* Macro: EQUAL_BFMHASHKEY(key, tid)
+ * Description: check whether the hash key identifies the given train
+ * Returns: TRUE(1) if they are equal, otherwise FALSE(0)
+ */
+#define EQUAL_BFMHASHKEY(key, tid) \
+    (((key).volNo == (tid).volNo && (key).pageNo == (tid).pageNo) ? TRUE:FALSE)
+
+
+/*@
+ * Global Variables
+ */
+extern BufferInfo bufInfo[NUM_BUF_TYPES];
+
+/* non-zero if a written train must be saved for rollback first(see bfm_FlushTrain()) */
+extern Four RM_RollbackRequiredFlag;
+
+
+/*@
+ * Function Prototypes
+ */
+/* internal function prototypes of the buffer manager in cosmos.o */
+Four bfm_LookUp(BfMHashKey *, Four);
+Four bfm_FlushTrain(TrainID *, Four);
+Four bfm_AllocTrain(Four);
+Four bfm_Insert(BfMHashKey *, Two, Four);
+Four bfm_Delete(BfMHashKey *, Four);
+Four bfm_ReadTrain(TrainID *, char *, Four);
+
+/* internal function prototypes of the buffer manager in this tree */
+Four bfm_AllocPartitionTrain(TrainID *, Four);
+Four bfm_ReadPartitionTrain(TrainID *, Four);
+Four bfm_SaveWarmStartFiles(void);
+void bfm_CountOptimisticHit(Four);
+void bfm_ReplaceFrameVersion(TrainID *, Four);
+
+
+#endif /* _BFM_INTERNAL_H_ */
@@ -36,11 +36,33 @@
  */
 /* Interface Function Prototypes */
 Four EduOM_CompactPage(SlottedPage*, Two);
+Four EduOM_CompactPageIncrementally(SlottedPage*, Two, Four);
 Four EduOM_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, void*, ObjectID*);
 Four EduOM_DestroyObject(ObjectID*, ObjectID*, Pool*, DeallocListElem*);
 Four EduOM_NextObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_PrevObject(ObjectID*, ObjectID*, ObjectID*, ObjectHdr*);
 Four EduOM_ReadObject(ObjectID*, Four, Four, void*);
+Four EduOM_ReleaseActiveInsertPages(void);
+Four EduOM_RecoverActiveInsertPages(ObjectID*);
+Four EduOM_GetStats(EduOM_Stats*);
+Four EduOM_ResetStats(void);
+Four EduOM_GetLatencyPercentile(EduOM_ApiStats*, double, double*);
+Four EduOM_AnalyzeFile(ObjectID*, EduOM_FileSpace*);
+Four EduOM_SetScanUnit(VolNo, Four);
+Four EduOM_GetScanUnit(VolNo);
+Four EduOM_SetPaxLayout(ObjectID*, EduOM_PaxSchema*);
+Four EduOM_ReadPaxColumn(ObjectID*, PageNo*, Four, void*, ObjectID*, Four*);
+Four EduOM_SetFixedLength(ObjectID*, Four);
+Four EduOM_SetSmallObjectPages(ObjectID*);
+Four EduOM_SetCompressedPages(ObjectID*, Boolean);
+Four EduOM_SetPrefixPages(ObjectID*);
+Four EduOM_NextObjectWithPrefix(ObjectID*, ObjectID*, char*, Four, ObjectID*);
+Four EduOM_SetSoaSlots(ObjectID*);
+Four EduOM_SetCompactorParams(EduOM_CompactorParams*);
+Four EduOM_GetCompactorParams(EduOM_CompactorParams*);
+Four EduOM_GetCompactorStats(EduOM_CompactorStats*);
+Four EduOM_RunCompactor(Four);
+Four EduOM_SweepCompactor(ObjectID*, Four);
 
 Four OM_DumpObject(ObjectID *);
 
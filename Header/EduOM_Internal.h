@@ -25,6 +25,11 @@
 #ifndef _EDUOM_INTERNAL_H_
 #define _EDUOM_INTERNAL_H_
 
+#ifdef EDUOM_STATS
+#include <time.h>
+#endif
+#include "EduOM_Trace.h"
+
 
 /*@
  * Type Definitions
@@ -75,6 +80,166 @@ typedef struct {
 } SlottedPage;
 
 
+/* interface functions counted by the statistics(see EduOM_GetStats()) */
+#define EDUOM_API_CREATE    0
+#define EDUOM_API_DESTROY   1
+#define EDUOM_API_READ      2
+#define EDUOM_API_NEXT      3
+#define EDUOM_API_PREV      4
+#define EDUOM_API_COMPACT   5
+#define EDUOM_NUM_APIS      6
+
+/* ways EduOM_CreateObject() chooses the page of the new object */
+#define EDUOM_BRANCH_NEAR_PAGE      0   /* the page of the near object */
+#define EDUOM_BRANCH_ACTIVE_PAGE    1   /* the active insert page of the thread */
+#define EDUOM_BRANCH_AVAIL_LIST     2   /* a page in the available space lists */
+#define EDUOM_BRANCH_LAST_PAGE      3   /* the last page of the file */
+#define EDUOM_BRANCH_NEW_PAGE       4   /* a newly allocated page */
+#define EDUOM_BRANCH_COMPACTION     5   /* the page had to be compacted */
+#define EDUOM_NUM_BRANCHES          6
+
+/* latency histogram: 2^EDUOM_LATENCY_SUB_BITS buckets per power of two nsec */
+#define EDUOM_LATENCY_SUB_BITS      3
+#define EDUOM_LATENCY_SUB_BUCKETS   (1 << EDUOM_LATENCY_SUB_BITS)
+#define EDUOM_LATENCY_BUCKETS       ((32 - EDUOM_LATENCY_SUB_BITS + 1) * EDUOM_LATENCY_SUB_BUCKETS)
+
+
+/*
+ * Typedefs for the statistics of the object manager
+ */
+/* statistics of an interface function */
+typedef struct {
+	UFour  count;                       /* calls */
+	double totalTime;                   /* nsec taken by the calls in total */
+	double maxTime;                     /* nsec taken by the longest call */
+	UFour  hist[EDUOM_LATENCY_BUCKETS]; /* calls by their latency */
+} EduOM_ApiStats;
+
+/* statistics of the object manager */
+typedef struct {
+	EduOM_ApiStats api[EDUOM_NUM_APIS];         /* indexed by EDUOM_API_XXX */
+	UFour createBranch[EDUOM_NUM_BRANCHES];     /* indexed by EDUOM_BRANCH_XXX */
+} EduOM_Stats;
+
+/* space of a data file(see EduOM_AnalyzeFile()) */
+#define EDUOM_SPACE_HIST_BUCKETS    16  /* pages by free bytes in buckets of PAGESIZE/16 bytes */
+#define EDUOM_SIZE_HIST_BUCKETS     13  /* objects by length in buckets [2^(k-1), 2^k) */
+
+/* available space lists of a data file; EDUOM_SPACE_LIST_NONE is no list */
+#define EDUOM_SPACE_LIST_10         0
+#define EDUOM_SPACE_LIST_20         1
+#define EDUOM_SPACE_LIST_30         2
+#define EDUOM_SPACE_LIST_40         3
+#define EDUOM_SPACE_LIST_50         4
+#define EDUOM_SPACE_LIST_NONE       5
+#define EDUOM_NUM_SPACE_LISTS       6
+
+typedef struct {
+	Four   nPages;                                  /* pages in the page list of the file */
+	Four   nSlots;                                  /* slots of the pages */
+	Four   nObjects;                                /* live objects */
+	Four   nEmptySlots;                             /* slots of destroyed objects */
+	double dataBytes;                               /* bytes of the object data */
+	double objectBytes;                             /* bytes taken by the objects with their headers */
+	double slotBytes;                               /* bytes taken by the slot arrays */
+	double freeBytes;                               /* SP_FREE() of the pages in total */
+	double cfreeBytes;                              /* SP_CFREE() of the pages in total */
+	double unusedBytes;                             /* 'unused' of the pages in total */
+	Four   maxUnused;                               /* largest 'unused' of a page */
+	Four   nPagesWithUnused;                        /* pages whose 'unused' is not 0 */
+	UFour  freeHist[EDUOM_SPACE_HIST_BUCKETS];      /* pages by SP_FREE() */
+	UFour  cfreeHist[EDUOM_SPACE_HIST_BUCKETS];     /* pages by SP_CFREE() */
+	UFour  unusedHist[EDUOM_SPACE_HIST_BUCKETS];    /* pages by 'unused' */
+	UFour  sizeHist[EDUOM_SIZE_HIST_BUCKETS];       /* objects by length */
+	UFour  bucketPages[EDUOM_NUM_SPACE_LISTS];      /* pages by the list their SP_FREE() belongs to */
+	UFour  listPages[EDUOM_NUM_SPACE_LISTS];        /* pages found in each available space list */
+	UFour  misplacedPages;                          /* pages in a list not matching their SP_FREE() */
+	double spaceAmplification;                      /* bytes of the pages / bytes of the object data */
+} EduOM_FileSpace;
+
+/* background compactor(see EduOM_RunCompactor()) */
+#define EDUOM_DEFAULT_COMPACT_THRESHOLD ((CONSTANT_CASTING_TYPE)((PAGESIZE-SP_FIXED)/8))
+#define EDUOM_DEFAULT_COMPACT_PAGES     16
+
+typedef struct {
+	Four   threshold;                           /* 'unused' bytes a page is queued at; 0 disables */
+	Four   pagesPerRun;                         /* maximum number of pages compacted by a run */
+} EduOM_CompactorParams;
+
+typedef struct {
+	UFour  queued;                              /* pages queued by EduOM_DestroyObject() */
+	UFour  dropped;                             /* ... not queued as the queue was full */
+	UFour  runs;                                /* runs of the compactor */
+	UFour  compacted;                           /* pages compacted by the runs */
+	UFour  skipped;                             /* pages dequeued but compacted already or gone */
+	UFour  sweeps;                              /* sweeps of a file(see EduOM_SweepCompactor()) */
+	UFour  swept;                               /* pages walked by the sweeps */
+	UFour  foreground;                          /* compactions done by the inserts */
+	double backgroundBytes;                     /* bytes of the objects moved by the runs */
+	double foregroundBytes;                     /* ... by the inserts */
+} EduOM_CompactorStats;
+
+/* schema of a file of the PAX layout(see EduOM_SetPaxLayout()) */
+#define EDUOM_PAX_MAX_FIELDS        16  /* fields of a row */
+
+typedef struct {
+	Two    nFields;                             /* fields of a row */
+	Two    width[EDUOM_PAX_MAX_FIELDS];         /* bytes of each field */
+} EduOM_PaxSchema;
+
+/* header at the beginning of the data area of a fixed length record page;
+   the bitmap of the live records follows it and the records follow the bitmap */
+typedef struct {
+	Two    length;                              /* bytes of a record */
+	Two    nRecords;                            /* records the page can hold */
+	Two    nLive;                               /* live records */
+	Two    recordOffset;                        /* offset of the first record */
+	UFour  bitmap[1];                           /* bit i is set if record i is live */
+} eduom_FixedPageHdr;
+
+/* header at the beginning of the data area of a small object page;
+   the objects follow it and the 2-byte slots grow down from the end of the data area */
+typedef struct {
+	Unique unique;                              /* unique number of the objects of the page */
+	Two    free;                                /* offset of contiguous free area */
+	Two    unused;                              /* bytes of destroyed objects not in the free area */
+} eduom_SmallPageHdr;
+
+/* header at the beginning of the data area of a PAX page */
+typedef struct {
+	EduOM_PaxSchema schema;                     /* schema of the rows */
+	Two    nRows;                               /* rows the page can hold */
+	Two    offset[EDUOM_PAX_MAX_FIELDS];        /* offset of the minipage of each field */
+} eduom_PaxPageHdr;
+
+/* layouts of the pages of a data file(see EduOM_FileLayout.c) */
+#define EDUOM_PLAIN_LAYOUT          0   /* slotted pages of cosmos */
+#define EDUOM_PAX_LAYOUT            1   /* PAX pages(see EduOM_SetPaxLayout()) */
+#define EDUOM_FIXED_LAYOUT          2   /* fixed length record pages(see EduOM_SetFixedLength()) */
+#define EDUOM_SMALL_LAYOUT          3   /* small object pages(see EduOM_SetSmallObjectPages()) */
+#define EDUOM_PREFIX_LAYOUT         4   /* prefix pages(see EduOM_SetPrefixPages()) */
+#define EDUOM_SOA_LAYOUT            5   /* SoA pages(see EduOM_SetSoaSlots()) */
+
+/* layout of a data file, derived from the marker of its first page */
+typedef struct {
+	FileID fid;                                 /* the file */
+	PageNo firstPage;                           /* first page of the file */
+	Four   layout;                              /* EDUOM_XXX_LAYOUT */
+	EduOM_PaxSchema schema;                     /* schema of the rows of a PAX file */
+	Four   recordLength;                        /* bytes of a record of a file of fixed length records */
+	PageNo insertPage;                          /* small object page a file of small objects put its last object into */
+} eduom_FileLayout;
+
+#ifdef EDUOM_STATS
+/* timer of a call of an interface function(see EDUOM_STATS_TIMER()) */
+typedef struct {
+	Four api;                   /* EDUOM_API_XXX */
+	EduOM_Stats *stats;         /* statistics of the calling thread */
+	struct timespec start;      /* when the call began */
+} eduom_StatsTimer;
+#endif
+
+
 /*@
  * Macro Function Definitions
  */
@@ -104,6 +269,201 @@ typedef struct {
 #define SP_50SIZE       ((CONSTANT_CASTING_TYPE)((PAGESIZE-SP_FIXED)/2))
 
 
+/* 'reserved' of the slotted page header which marks a PAX page */
+#define EDUOM_PAX_PAGE      0x50415831  /* "PAX1" */
+
+/* the most rows a PAX page can hold: rows of one byte fields */
+#define EDUOM_PAX_MAX_ROWS  ((PAGESIZE - SP_FIXED + sizeof(SlottedPageSlot)) / (1 + sizeof(SlottedPageSlot)))
+
+/* Macro: IS_PAX_PAGE(p)
+ * Description: check whether the page is of the PAX layout
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is a PAX page, otherwise FALSE(0)
+ */
+#define IS_PAX_PAGE(p)      ((p)->header.reserved == EDUOM_PAX_PAGE)
+
+/* Macro: PAX_PAGE_HDR(p)
+ * Description: return the PAX header in the data area of the page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the PAX page
+ * Returns: (eduom_PaxPageHdr *) the PAX header
+ */
+#define PAX_PAGE_HDR(p)     ((eduom_PaxPageHdr *)(p)->data)
+
+/* 'reserved' of the slotted page header which marks a page of fixed length records */
+#define EDUOM_FIXED_PAGE    0x46495831  /* "FIX1" */
+
+/* Macro: IS_FIXED_PAGE(p)
+ * Description: check whether the page is a page of fixed length records
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is a fixed length record page, otherwise FALSE(0)
+ */
+#define IS_FIXED_PAGE(p)    ((p)->header.reserved == EDUOM_FIXED_PAGE)
+
+/* Macro: FIXED_PAGE_HDR(p)
+ * Description: return the header in the data area of the fixed length record page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the fixed length record page
+ * Returns: (eduom_FixedPageHdr *) the header
+ */
+#define FIXED_PAGE_HDR(p)   ((eduom_FixedPageHdr *)(p)->data)
+
+/* 'reserved' of the slotted page header which marks a small object page */
+#define EDUOM_SMALL_PAGE    0x534d4c31  /* "SML1" */
+
+/* the longest object put into a small object page */
+#define EDUOM_SMALL_MAX_LENGTH  255
+
+/* Macro: IS_SMALL_PAGE(p)
+ * Description: check whether the page is a small object page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is a small object page, otherwise FALSE(0)
+ */
+#define IS_SMALL_PAGE(p)    ((p)->header.reserved == EDUOM_SMALL_PAGE)
+
+/* Macro: SMALL_PAGE_HDR(p)
+ * Description: return the header in the data area of the small object page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the small object page
+ * Returns: (eduom_SmallPageHdr *) the header
+ */
+#define SMALL_PAGE_HDR(p)   ((eduom_SmallPageHdr *)(p)->data)
+
+/* Macro: SMALL_SLOT(p, s)
+ * Description: access the 2-byte slot of the small object page; the slot
+ *              holds the offset of the object or EMPTYSLOT
+ * Parameters:
+ *  SlottedPage *p      : pointer to the small object page
+ *  Four s              : slot number
+ * Returns: (Two) lvalue of the slot
+ */
+#define SMALL_SLOT(p, s)    (((Two *)&(p)->data[PAGESIZE - SP_FIXED])[-1 - (s)])
+
+/* 'reserved' of the slotted page header which marks a prefix page */
+#define EDUOM_PREFIX_PAGE   0x50465831  /* "PFX1" */
+
+/* bounds of the length of the dictionary of a prefix page */
+#define EDUOM_PREFIX_MIN_LENGTH 8
+#define EDUOM_PREFIX_MAX_LENGTH 64
+
+/* property of an object of a prefix page: the first data byte is the length
+   of the prefix it shares with the dictionary, and the rest of the data follows */
+#define P_PREFIXED          0x10
+
+/* Macro: IS_PREFIX_PAGE(p)
+ * Description: check whether the page is a prefix page
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is a prefix page, otherwise FALSE(0)
+ */
+#define IS_PREFIX_PAGE(p)   ((p)->header.reserved == EDUOM_PREFIX_PAGE)
+
+/* Macro: PREFIX_DICT_LENGTH(p), PREFIX_DICT(p)
+ * Description: access the dictionary at the beginning of the data area of
+ *              the prefix page: its length(Two) followed by its bytes
+ * Parameter:
+ *  SlottedPage *p      : pointer to the prefix page
+ */
+#define PREFIX_DICT_LENGTH(p)   (*(Two *)(p)->data)
+#define PREFIX_DICT(p)          ((p)->data + sizeof(Two))
+
+/* Macro: PREFIX_DICT_SIZE(p)
+ * Description: return the bytes of the data area taken by the dictionary;
+ *              the objects of the page start there
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: (Four) the aligned size of the dictionary, 0 if not a prefix page
+ */
+#define PREFIX_DICT_SIZE(p) \
+	(IS_PREFIX_PAGE(p) ? (Four)ALIGNED_LENGTH((Four)sizeof(Two) + PREFIX_DICT_LENGTH(p)) : 0)
+
+/* 'reserved' of the slotted page header which marks a page of the struct-of-arrays slot directory */
+#define EDUOM_SOA_PAGE      0x534f4131  /* "SOA1" */
+
+/* Macro: IS_SOA_PAGE(p)
+ * Description: check whether the slot directory of the page is a struct of arrays
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ * Returns: TRUE(1) if the page is a SoA page, otherwise FALSE(0)
+ */
+#define IS_SOA_PAGE(p)      ((p)->header.reserved == EDUOM_SOA_PAGE)
+
+/* Macro: SOA_CAPACITY(n)
+ * Description: return the offsets reserved for 'n' slots of a SoA page: the
+ *              power of two not less than n, at least 2. The directory takes
+ *              at most n*sizeof(SlottedPageSlot) bytes, so SP_CFREE() holds.
+ * Parameter:
+ *  Four n              : slots of the page
+ * Returns: (Four) offsets reserved
+ */
+#define SOA_CAPACITY(n)     ((Four)1 << (32 - __builtin_clz((UFour)MAX((n), 2) - 1)))
+
+/* Macro: SOA_OFFSET(p, s), SOA_UNIQUE(p, s)
+ * Description: access the slot of the SoA page; the offsets are an array of
+ *              Two indexed backwards from the end of the page, and the unique
+ *              numbers an array of Unique indexed backwards from the end of
+ *              the SOA_CAPACITY(nSlots) offsets
+ * Parameters:
+ *  SlottedPage *p      : pointer to the SoA page
+ *  Four s              : slot number
+ * Returns: lvalue of the offset(Two) or the unique number(Unique)
+ */
+#define SOA_OFFSET(p, s)    (((Two *)((char *)(p) + PAGESIZE))[-1 - (s)])
+#define SOA_UNIQUE(p, s) \
+	(((Unique *)((char *)(p) + PAGESIZE - SOA_CAPACITY((p)->header.nSlots)*(Four)sizeof(Two)))[-1 - (s)])
+
+/* instruction sets of the kernels scanning the slots(see EduOM_SlotKernel.c) */
+#define EDUOM_ISA_SCALAR    0   /* plain C */
+#define EDUOM_ISA_SSE2      1
+#define EDUOM_ISA_AVX2      2
+#define EDUOM_NUM_ISAS      3
+
+/* hardware counters of the benchmarks(see EduOM_PerfCounter.c) */
+#define EDUOM_PERF_CYCLES           0
+#define EDUOM_PERF_INSTRUCTIONS     1
+#define EDUOM_PERF_L1D_MISSES       2
+#define EDUOM_PERF_LLC_MISSES       3
+#define EDUOM_PERF_DTLB_MISSES      4
+#define EDUOM_PERF_BRANCH_MISSES    5
+#define EDUOM_NUM_PERF_COUNTERS     6
+
+/* Macro: SLOT_OFFSET(p, s)
+ * Description: access the offset of the slot of the page of either slot directory
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Four s              : slot number
+ * Returns: (Two) lvalue of the offset
+ */
+#define SLOT_OFFSET(p, s)   (*(IS_SOA_PAGE(p) ? &SOA_OFFSET(p, s) : &(p)->slot[-(s)].offset))
+
+/* Macro: SLOT_UNIQUE(p, s)
+ * Description: return the unique number of the slot; a fixed length record
+ *              page has no slot array, and the unique numbers of its records
+ *              are 0; the objects of a small object page share a unique number
+ * Parameters:
+ *  SlottedPage *p      : pointer to the page
+ *  Four s              : slot number
+ * Returns: (Unique) the unique number
+ */
+#define SLOT_UNIQUE(p, s) \
+	(IS_FIXED_PAGE(p) ? 0 : IS_SMALL_PAGE(p) ? SMALL_PAGE_HDR(p)->unique : \
+	 IS_SOA_PAGE(p) ? SOA_UNIQUE(p, s) : (p)->slot[-(s)].unique)
+
+/* Macro: SP_RESERVE_FREE(p)
+ * Description: make SP_FREE() of the PAX, fixed length record or small
+ *              object page 0 so that its space is reserved; the page is
+ *              never put into the available space lists nor chosen for a
+ *              slotted object. Called whenever 'nSlots' of the page changes.
+ * Parameter:
+ *  SlottedPage *p      : pointer to the page
+ */
+#define SP_RESERVE_FREE(p) \
+	((p)->header.unused = 0, \
+	 (p)->header.free = PAGESIZE - SP_FIXED - ((p)->header.nSlots-1)*((CONSTANT_CASTING_TYPE)sizeof(SlottedPageSlot)))
+
 /* constant macro for the empty slot */
 /* The empty slots have EMPTYSLOT with the 'offset' */
 #define EMPTYSLOT       -1
@@ -116,11 +476,23 @@ typedef struct {
  * Returns: TRUE(1) if oid is valid, otherwise FALSE(0)
  */
 #define IS_VALID_OBJECTID(oid, s_page) \
-	(((s_page->slot[-(oid)->slotNo].offset == EMPTYSLOT) || \
-	  (s_page->slot[-(oid)->slotNo].unique != (oid)->unique)) ? FALSE : TRUE)
+	(((SLOT_OFFSET(s_page, (oid)->slotNo) == EMPTYSLOT) || \
+	  (SLOT_UNIQUE(s_page, (oid)->slotNo) != (oid)->unique)) ? FALSE : TRUE)
 
 #define LRGOBJ_THRESHOLD (PAGESIZE - SP_FIXED - sizeof(ObjectHdr))
 
+/* constants for the active insert pages */
+#define MAX_ACTIVE_INSERT_PAGES             64  /* active insert pages of all threads */
+#define MAX_ACTIVE_INSERT_PAGES_PER_THREAD  8   /* active insert pages of a thread */
+
+/* the number of optimistic reads tried before the page is fixed */
+#define MAX_OPTIMISTIC_READ_RETRIES         4
+
+/* owner of a page returned by eduom_GetActiveInsertPageOwner() */
+#define ACTIVE_INSERT_PAGE_NONE     0
+#define ACTIVE_INSERT_PAGE_SELF     1
+#define ACTIVE_INSERT_PAGE_OTHERS   2
+
 /* Macro: GET_PTR_TO_CATENTRY_FOR_DATA(catObjForFile, catPage, catEntry)
  * Description: get the information about the data file(sm_CatOverlayForData) residing in the catalog object for data file
  * Parameters:
@@ -136,12 +508,91 @@ typedef struct {
 }
 
 
+/* Macro: EDUOM_STATS_TIMER(api)
+ * Description: time the call of the interface function from here until it returns;
+ *              used where a declaration may be placed
+ * Parameter:
+ *  Four api            : EDUOM_API_XXX
+ */
+/* Macro: EDUOM_STATS_BRANCH(branch)
+ * Description: count the way EduOM_CreateObject() chose the page
+ * Parameter:
+ *  Four branch         : EDUOM_BRANCH_XXX
+ */
+#ifdef EDUOM_STATS
+#define EDUOM_STATS_TIMER(api) \
+	eduom_StatsTimer _eduom_statsTimer __attribute__((cleanup(eduom_EndStatsTimer))) = \
+	eduom_BeginStatsTimer(api)
+#define EDUOM_STATS_BRANCH(branch)  eduom_CountBranch(branch)
+#else
+#define EDUOM_STATS_TIMER(api)
+#define EDUOM_STATS_BRANCH(branch)
+#endif
+
+
 /*@
  * Function Prototypes
  */
 /* internal function prototypes */
 Four eduom_CreateObject(ObjectID*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
 
+Boolean eduom_LookUpActiveInsertPage(FileID*, PageID*);
+Four eduom_GetActiveInsertPageOwner(PageID*);
+Boolean eduom_ClaimActiveInsertPage(ObjectID*, FileID*, PageID*);
+void eduom_DisownActiveInsertPage(PageID*);
+Four eduom_RecoverActiveInsertPages(ObjectID*, FileID*);
+
+Four eduom_ReadAhead(PageID*, Four);
+
+Four eduom_LookUpFileLayout(sm_CatOverlayForData*, eduom_FileLayout*);
+Four eduom_SetFileLayout(ObjectID*, eduom_FileLayout*);
+void eduom_SetSmallInsertPage(FileID*, PageNo);
+
+void eduom_FormatPaxPage(SlottedPage*, EduOM_PaxSchema*);
+Four eduom_CreatePaxObject(ObjectID*, sm_CatOverlayForData*, EduOM_PaxSchema*, ObjectID*, Four, char*, ObjectID*);
+Four eduom_CopyPaxRow(SlottedPage*, ObjectID*, Four, Four, char*);
+
+void eduom_FormatFixedPage(SlottedPage*, Four);
+Four eduom_CreateFixedObject(ObjectID*, sm_CatOverlayForData*, Four, ObjectID*, Four, char*, ObjectID*);
+Four eduom_CopyFixedRecord(SlottedPage*, ObjectID*, Four, Four, char*);
+Four eduom_DestroyFixedRecord(SlottedPage*, ObjectID*);
+
+Four eduom_FormatSmallPage(SlottedPage*, PageID*);
+Four eduom_CreateSmallObject(ObjectID*, sm_CatOverlayForData*, PageNo*, ObjectID*, ObjectHdr*, Four, char*, ObjectID*);
+Four eduom_CopySmallObject(SlottedPage*, ObjectID*, Four, Four, char*);
+Four eduom_DestroySmallObject(SlottedPage*, ObjectID*);
+
+void eduom_FormatPrefixPage(SlottedPage*, Four, char*);
+Four eduom_PrefixLength(SlottedPage*, Four, char*);
+Four eduom_NeededSpace(SlottedPage*, Four, char*);
+Four eduom_CopyPrefixObject(SlottedPage*, Object*, Four, Four, char*);
+
+void eduom_SetSlotCount(SlottedPage*, Four);
+
+Four EduOM_CompactPageIncrementally(SlottedPage*, Two, Four);
+Four eduom_CompactPageTail(SlottedPage*, Two, Four);
+void eduom_QueueCompaction(SlottedPage*, Four);
+void eduom_CountCompaction(Boolean, Four);
+
+Four eduom_SelectSlotKernels(Four);
+Four eduom_GetSlotKernels(void);
+char *eduom_SlotKernelName(Four);
+Four eduom_FindEmptySlot(SlottedPage*);
+Four eduom_NextLiveSlot(SlottedPage*, Four);
+Four eduom_PrevLiveSlot(SlottedPage*, Four);
+void eduom_MoveDown(char*, char*, Four);
+
+Four eduom_OpenPerfCounters(Four*);
+void eduom_StartPerfCounters(void);
+void eduom_StopPerfCounters(double*);
+void eduom_ClosePerfCounters(void);
+char *eduom_PerfCounterName(Four);
+
+#ifdef EDUOM_STATS
+eduom_StatsTimer eduom_BeginStatsTimer(Four);
+void eduom_EndStatsTimer(eduom_StatsTimer*);
+void eduom_CountBranch(Four);
+#endif
 Four om_FileMapAddPage(ObjectID*, PageID*, PageID*);
 Four om_FileMapDeletePage(ObjectID*, PageID*);
 Four om_GetUnique(PageID*, Unique*);
@@ -0,0 +1,91 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _EDUOM_TRACE_H_
+#define _EDUOM_TRACE_H_
+
+/*
+ * Static tracepoints(USDT) of the object manager, the buffer manager and the
+ * raw disk manager. The probes are compiled in if EDUOM_TRACE is defined(see
+ * the Makefile) and <sys/sdt.h> of SystemTap is found; a probe is then a nop
+ * instruction and a note in the ELF file until a tracer such as bpftrace or
+ * perf attaches to it. Otherwise the macros expand to nothing. 'make
+ * check-probes' compiles the probes both ways(see Header/Stub/sys/sdt.h).
+ *
+ *  eduom:api_entry(api, oid)            an EduOM_XXX() call began; EDUOM_API_XXX, ObjectID*
+ *                                       (PageID* for EduOM_CompactPage())
+ *  eduom:api_return(api)                the call returned
+ *  eduom:create_placement(branch, volNo, pageNo)
+ *                                       EduOM_CreateObject() chose the page; EDUOM_BRANCH_XXX
+ *  eduom:compact(volNo, pageNo, bytesMoved)
+ *                                       EduOM_CompactPage() reorganized a page
+ *  bfm:get_train_miss(volNo, pageNo, type)
+ *                                       BfM_GetTrain() read the train from the disk
+ *  bfm:evict(volNo, pageNo, dirty)      a frame was replaced; BFM_STATS_DETAIL only(see BfM_Stats.c)
+ *  rdsm:alloc_trains_entry(volNo, nearPageNo, numTrains)
+ *  rdsm:alloc_trains_return(e, volNo, firstPageNo)
+ *                                       RDsM_AllocTrains() was called from this tree
+ */
+#if defined(EDUOM_TRACE) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define EDUOM_TRACE_PROBES
+#endif
+#endif
+
+
+/*@
+ * Macro Function Definitions
+ */
+/* Macro: EDUOM_PROBEn(provider, name, ...)
+ * Description: fire the probe provider:name with n arguments
+ */
+/* Macro: EDUOM_PROBE_API(api, oid)
+ * Description: fire eduom:api_entry here and eduom:api_return when the
+ *              interface function returns; used where a declaration may be placed
+ * Parameters:
+ *  Four api            : EDUOM_API_XXX
+ *  void *oid           : object, catalog object or page(PageID*) the call is about
+ */
+#ifdef EDUOM_TRACE_PROBES
+#define EDUOM_PROBE0(provider, name)                DTRACE_PROBE(provider, name)
+#define EDUOM_PROBE1(provider, name, a1)            DTRACE_PROBE1(provider, name, a1)
+#define EDUOM_PROBE2(provider, name, a1, a2)        DTRACE_PROBE2(provider, name, a1, a2)
+#define EDUOM_PROBE3(provider, name, a1, a2, a3)    DTRACE_PROBE3(provider, name, a1, a2, a3)
+
+static inline void eduom_ProbeReturn(Four *api) { DTRACE_PROBE1(eduom, api_return, *api); }
+
+#define EDUOM_PROBE_API(api, oid) \
+	Four _eduom_probeApi __attribute__((cleanup(eduom_ProbeReturn))) = (api); \
+	DTRACE_PROBE2(eduom, api_entry, _eduom_probeApi, (oid))
+#else
+#define EDUOM_PROBE0(provider, name)
+#define EDUOM_PROBE1(provider, name, a1)
+#define EDUOM_PROBE2(provider, name, a1, a2)
+#define EDUOM_PROBE3(provider, name, a1, a2, a3)
+#define EDUOM_PROBE_API(api, oid)
+#endif
+
+
+#endif /* _EDUOM_TRACE_H_ */
@@ -30,8 +30,40 @@
 /*
  * Error Base Definitions
  */
+#define GENERAL_ERR_BASE                         1
+#define RDSM_ERR_BASE                            3
+#define BFM_ERR_BASE                             4
 #define OM_ERR_BASE                              6
 
+/*
+ * Error Definitions for GENERAL_ERR_BASE
+ */
+#define eBADPARAMETER                            ERR_ENCODE_ERROR_CODE(GENERAL_ERR_BASE,2)
+#define eMEMORYALLOCERR                          ERR_ENCODE_ERROR_CODE(GENERAL_ERR_BASE,12)
+
+/*
+ * Error Definitions for RDSM_ERR_BASE
+ */
+#define eVOLNOTMOUNTED_RDSM                      ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,0)
+#define eTOOMANYVOLUMES_RDSM                     ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,2)
+#define eDEVICEOPENFAIL_RDSM                     ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,3)
+#define eDEVICECLOSEFAIL_RDSM                    ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,4)
+#define eREADFAIL_RDSM                           ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,5)
+#define eWRITEFAIL_RDSM                          ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,6)
+#define eINVALIDTRAINSIZE_RDSM                   ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,8)
+#define NUM_ERRORS_RDSM_ERR_BASE                 20
+#define eASYNCIOQUEUEFULL_RDSM                   ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,20)
+#define eDIRECTIONOTSUPPORTED_RDSM               ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,21)
+#define eBADVOLUMETABLE_RDSM                     ERR_ENCODE_ERROR_CODE(RDSM_ERR_BASE,22)
+
+/*
+ * Error Definitions for BFM_ERR_BASE
+ */
+#define eBADBUFFERTYPE_BFM                       ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,0)
+#define eNOTFOUND_BFM                            ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,6)
+#define NUM_ERRORS_BFM_ERR_BASE                  60
+#define eFIXEDBUFFERS_BFM                        ERR_ENCODE_ERROR_CODE(BFM_ERR_BASE,60)
+
 /*
  * Error Definitions for OM_ERR_BASE
  */
@@ -47,3 +79,4 @@
 #define eCANTALLOCEXTENT_BL_OM                   ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,9)
 #define NUM_ERRORS_OM_ERR_BASE                   10
 #define eNOTSUPPORTED_EDUOM			             ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,11)
+#define eTABLEFULL_EDUOM                         ERR_ENCODE_ERROR_CODE(OM_ERR_BASE,12)
@@ -26,9 +26,73 @@
 #define _RDsM_H_
 
 
+/*
+ * Asynchronous I/O
+ */
+/* flags of RDsM_OpenAsyncIO() */
+#define RDSM_AIO_READONLY       0x1     /* open the device read only */
+#define RDSM_AIO_NOIOURING      0x2     /* use the thread pool even if io_uring is available */
+#define RDSM_AIO_DIRECT         0x4     /* bypass the page cache; buffers must be aligned to PAGESIZE */
+
+/* backends */
+#define RDSM_AIO_IOURING        1
+#define RDSM_AIO_THREADPOOL     2
+
+typedef struct rdsm_AsyncIO RDsM_AsyncIO;
+
+typedef struct {
+    void *userData;             /* given when the request was submitted */
+    Four result;                /* eNOERROR or error code */
+} RDsM_AsyncIOCompletion;
+
+/*
+ * Memory-mapped volumes
+ */
+/* access hints */
+#define RDSM_ADVICE_NORMAL      0       /* no particular order */
+#define RDSM_ADVICE_SCAN        1       /* sequential scans */
+#define RDSM_ADVICE_POINT       2       /* random object reads */
+#define RDSM_ADVICE_WILLNEED    3       /* the pages are going to be read soon */
+
+/*
+ * Compressed pages
+ */
+/* counters of the compressed pages of a volume */
+typedef struct {
+    UFour  nCompressed;         /* pages written compressed */
+    UFour  nIncompressible;     /* pages of the compressed files written uncompressed */
+    UFour  nDecompressed;       /* pages read and decompressed */
+    Four   nStored;             /* pages stored compressed now */
+    double storedBytes;         /* bytes of those pages */
+    double sideStoreBytes;      /* bytes of the side stores, including replaced pages not compacted yet */
+    UFour  nCompactions;        /* compactions of the side stores */
+} RDsM_CompressionStats;
+
+
 Four    RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
 Four    RDsM_GetUnique(PageID*, Unique*, Four*);
 Four	RDsM_PageIdToExtNo(PageID *, Four *);
+Four    RDsM_WriteTrains(char *, PageID *, Four, Two);
+
+Four    RDsM_OpenAsyncIO(char *, Four, Four, RDsM_AsyncIO **);
+Four    RDsM_CloseAsyncIO(RDsM_AsyncIO *);
+Four    RDsM_GetAsyncIOBackend(RDsM_AsyncIO *);
+Four    RDsM_SubmitReadTrain(RDsM_AsyncIO *, PageID *, char *, Four, void *);
+Four    RDsM_SubmitWriteTrain(RDsM_AsyncIO *, char *, PageID *, Four, void *);
+Four    RDsM_WaitAsyncIO(RDsM_AsyncIO *, Four, RDsM_AsyncIOCompletion *, Four);
+Four    RDsM_AttachAsyncIO(VolNo, char *, Four, Four);
+Four    RDsM_DetachAsyncIO(VolNo);
+RDsM_AsyncIO *RDsM_GetAttachedAsyncIO(VolNo);
+
+Four    RDsM_MapVolume(VolNo, char *, Four);
+Four    RDsM_UnmapVolume(VolNo);
+char    *RDsM_GetMappedTrain(PageID *, Four);
+Four    RDsM_AdviseMappedTrains(PageID *, Four, Four);
+
+Four    RDsM_SetDirectIO(VolNo, Boolean);
+
+Four    RDsM_SetCompressedFile(FileID *, Boolean);
+Four    RDsM_GetCompressionStats(VolNo, RDsM_CompressionStats *);
 
 
 #endif /* _RDsM_H_ */
@@ -0,0 +1,91 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _RDSM_INTERNAL_H_
+#define _RDSM_INTERNAL_H_
+
+
+#include "RDsM.h"
+
+
+/*@
+ * Constant Definitions
+ */
+/* the number of entries of the volume table */
+#define MAXNUMOFVOLS        20
+
+/* maximum length of a device name */
+#define MAX_DEVICE_NAME     256
+
+/* maximum number of devices of a volume */
+#define MAX_DEVICES_IN_VOLUME 20
+
+/* a side store of compressed pages is compacted when its replaced records
+   take this many bytes and more than the live ones(see RDsM_Compression.c) */
+#define RDSM_LZ_COMPACT_MIN (64*PAGESIZE)
+
+
+/*@
+ * Type Definitions
+ *
+ * Be CAREFUL: These must match the layout used by the raw disk manager in
+ * cosmos.o. Only the fields used here are named. The layout was inferred
+ * from the object code, so a user of 'devAddr' checks the entry first(see
+ * RDsM_SetDirectIO()).
+ */
+/* device of a volume */
+typedef struct {
+    char        devName[MAX_DEVICE_NAME];   /* device(file) name */
+    Four        devAddr;                    /* file descriptor of the opened device */
+    char        rest[40];                   /* the other fields */
+} RDsM_DevInfo;
+
+/* entry of the volume table; one entry per mounted volume */
+typedef struct {
+    char        head[50];       /* the other fields */
+    VolNo       volNo;          /* volume number; NIL if the entry is not used */
+    Two         sizeOfExt;      /* the number of pages in an extent */
+    char        middle[38];     /* the other fields */
+    Four        numDevices;     /* the number of devices of the volume */
+    char        tail[8];        /* the other fields */
+    RDsM_DevInfo *devInfo;      /* devices of the volume */
+} RDsM_VolumeTable;
+
+
+/*@
+ * Global Variables
+ */
+extern RDsM_VolumeTable volTable[MAXNUMOFVOLS];
+
+
+/*@
+ * Function Prototypes
+ */
+/* internal function prototypes of the raw disk manager in this tree */
+Boolean rdsm_IsCompressedTrain(PageID *, Four);
+Boolean rdsm_HoldsCompressedFilePage(char *, Four);
+Boolean rdsm_CheckVolumeEntry(RDsM_VolumeTable *);
+
+
+#endif /* _RDSM_INTERNAL_H_ */
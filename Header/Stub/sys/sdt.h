@@ -0,0 +1,50 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+#ifndef _SYS_SDT_H
+#define _SYS_SDT_H
+
+/*
+ * Stand-in for <sys/sdt.h> of SystemTap, so that the probes of EduOM_Trace.h
+ * are compiled in where the real header is not installed(see 'make
+ * check-probes'). A probe emits no note and cannot be attached to, but its
+ * name is stringized and each argument is passed as an asm operand with the
+ * constraint of the real header("nor"), so that a probe which would not
+ * compile against the real header does not compile against this one.
+ * Never put this directory on the include path of a build that is run.
+ */
+#define _SDT_ARG(a)     __asm__ __volatile__ ("" :: "nor" (a))
+#define _SDT_NAME(provider, name) \
+	((void)sizeof(#provider ":" #name))
+
+#define DTRACE_PROBE(provider, name) \
+	do { _SDT_NAME(provider, name); } while (0)
+#define DTRACE_PROBE1(provider, name, a1) \
+	do { _SDT_NAME(provider, name); _SDT_ARG(a1); } while (0)
+#define DTRACE_PROBE2(provider, name, a1, a2) \
+	do { _SDT_NAME(provider, name); _SDT_ARG(a1); _SDT_ARG(a2); } while (0)
+#define DTRACE_PROBE3(provider, name, a1, a2, a3) \
+	do { _SDT_NAME(provider, name); _SDT_ARG(a1); _SDT_ARG(a2); _SDT_ARG(a3); } while (0)
+
+#endif /* _SYS_SDT_H */
@@ -0,0 +1,884 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: RDsM_AsyncIO.c
+ *
+ * Description:
+ *  Asynchronous train I/O on a volume device. Requests are submitted without
+ *  waiting and reaped later, so that many reads or writes can be in flight
+ *  at once. Two backends are provided:
+ *   - io_uring, driven by raw system calls (no library is needed), and
+ *   - a pool of threads doing pread()/pwrite(), used when io_uring is not
+ *     available(old kernels, seccomp filtered containers) or is not wanted.
+ *  Both work on an ordinary file such as a formatted volume 'test.vol'.
+ *
+ *  The device is opened separately from the raw disk manager in cosmos.o
+ *  and is accessed through the same page cache, so the two see each other's
+ *  writes. A train is located at 'pageNo * PAGESIZE' on the device, which
+ *  holds for volumes consisting of one device.
+ *
+ *  An asynchronous I/O handle can be attached to a mounted volume; the buffer
+ *  manager then uses it for batched reads(see BfM_Prefetch.c) and for the
+ *  writes of the background writer(see BfM_BackgroundWriter.c).
+ *
+ * Exports:
+ *  Four RDsM_OpenAsyncIO(char*, Four, Four, RDsM_AsyncIO**)
+ *  Four RDsM_CloseAsyncIO(RDsM_AsyncIO*)
+ *  Four RDsM_GetAsyncIOBackend(RDsM_AsyncIO*)
+ *  Four RDsM_SubmitReadTrain(RDsM_AsyncIO*, PageID*, char*, Four, void*)
+ *  Four RDsM_SubmitWriteTrain(RDsM_AsyncIO*, char*, PageID*, Four, void*)
+ *  Four RDsM_WaitAsyncIO(RDsM_AsyncIO*, Four, RDsM_AsyncIOCompletion*, Four)
+ *  Four RDsM_AttachAsyncIO(VolNo, char*, Four, Four)
+ *  Four RDsM_DetachAsyncIO(VolNo)
+ *  RDsM_AsyncIO *RDsM_GetAttachedAsyncIO(VolNo)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "EduOM_common.h"
+#include "RDsM.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define RDSM_AIO_READ   0
+#define RDSM_AIO_WRITE  1
+
+#define RDSM_AIO_MAX_WORKERS        8   /* threads of the thread pool backend */
+#define RDSM_AIO_MAX_ATTACHED       20  /* volumes which can have a handle attached */
+
+
+/*@
+ * Type Definitions
+ */
+/* an I/O request; one per slot of the queue */
+typedef struct {
+    Four	op;		/* RDSM_AIO_READ or RDSM_AIO_WRITE */
+    char	*buf;		/* buffer to read into or write from */
+    size_t	len;		/* bytes to transfer */
+    off_t	offset;		/* position on the device */
+    void	*userData;	/* returned with the completion */
+    Four	result;		/* eNOERROR or error code when done */
+    Four	next;		/* next slot in the free, pending, or done list */
+} rdsm_AsyncIORequest;
+
+/* ring of an io_uring instance */
+typedef struct {
+    Four	ringFd;		/* io_uring file descriptor */
+    void	*sqRing;	/* mapped submission queue ring */
+    void	*cqRing;	/* mapped completion queue ring */
+    size_t	sqRingSize;
+    size_t	cqRingSize;
+    struct io_uring_sqe *sqes;	/* mapped submission queue entries */
+    size_t	sqesSize;
+    unsigned	*sqHead, *sqTail, *sqMask, *sqArray;
+    unsigned	*cqHead, *cqTail, *cqMask;
+    struct io_uring_cqe *cqes;
+    Four	nToSubmit;	/* entries queued but not yet passed to the kernel */
+} rdsm_IoUring;
+
+/* thread pool */
+typedef struct {
+    pthread_t	workers[RDSM_AIO_MAX_WORKERS];
+    Four	nWorkers;
+    pthread_mutex_t mutex;
+    pthread_cond_t pendingCond;	/* signaled when a request is queued */
+    pthread_cond_t doneCond;	/* signaled when a request is done */
+    Four	pendingHead, pendingTail;	/* FIFO of requests to do */
+    Four	doneHead, doneTail;		/* FIFO of requests done */
+    Boolean	shutdown;
+} rdsm_ThreadPool;
+
+struct rdsm_AsyncIO {
+    Four	backend;	/* RDSM_AIO_IOURING or RDSM_AIO_THREADPOOL */
+    Four	fd;		/* device file descriptor */
+    Boolean	direct;		/* TRUE if the device is opened for direct I/O */
+    Four	queueDepth;	/* the number of slots */
+    Four	nInFlight;	/* slots in use */
+    Four	freeSlot;	/* head of the free slots */
+    rdsm_AsyncIORequest *slot;	/* slots */
+    union {
+        rdsm_IoUring	uring;
+        rdsm_ThreadPool	pool;
+    } u;
+};
+
+/* a handle attached to a mounted volume */
+typedef struct {
+    VolNo	volNo;		/* NIL if the entry is not used */
+    RDsM_AsyncIO *aio;
+} rdsm_AttachedAsyncIO;
+
+
+/*@
+ * Global Variables
+ */
+static rdsm_AttachedAsyncIO rdsm_attachedAsyncIO[RDSM_AIO_MAX_ATTACHED] = {
+    [0 ... RDSM_AIO_MAX_ATTACHED-1] = { NIL, NULL }
+};
+
+
+
+/*@================================
+ * rdsm_DoRequest()
+ *================================*/
+/*
+ * Function: Four rdsm_DoRequest(Four, rdsm_AsyncIORequest*)
+ *
+ * Description:
+ *  Do the request synchronously; used by the thread pool.
+ *
+ * Returns:
+ *  error code
+ *    eREADFAIL_RDSM
+ *    eWRITEFAIL_RDSM
+ */
+static Four rdsm_DoRequest(
+    Four	fd,		/* IN device file descriptor */
+    rdsm_AsyncIORequest *req)	/* IN request */
+{
+    size_t	done;		/* bytes transferred so far */
+    ssize_t	n;		/* bytes transferred by a call */
+
+
+    for (done = 0; done < req->len; done += n) {
+        if (req->op == RDSM_AIO_READ)
+            n = pread(fd, req->buf + done, req->len - done, req->offset + done);
+        else
+            n = pwrite(fd, req->buf + done, req->len - done, req->offset + done);
+
+        if (n < 0 && errno == EINTR) { n = 0; continue; }
+        if (n <= 0) return((req->op == RDSM_AIO_READ) ? eREADFAIL_RDSM : eWRITEFAIL_RDSM);
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_DoRequest() */
+
+
+
+/*@================================
+ * rdsm_Worker()
+ *================================*/
+/*
+ * Function: void *rdsm_Worker(void*)
+ *
+ * Description:
+ *  Main loop of a thread of the thread pool backend.
+ *
+ * Returns:
+ *  NULL
+ */
+static void *rdsm_Worker(
+    void	*arg)		/* IN asynchronous I/O handle */
+{
+    RDsM_AsyncIO *aio = (RDsM_AsyncIO *)arg;
+    rdsm_ThreadPool *pool = &aio->u.pool;
+    Four	s;		/* slot taken */
+
+
+    pthread_mutex_lock(&pool->mutex);
+
+    for (;;) {
+        while (pool->pendingHead == NIL && !pool->shutdown)
+            pthread_cond_wait(&pool->pendingCond, &pool->mutex);
+
+        if (pool->pendingHead == NIL) break;	/* shut down */
+
+        s = pool->pendingHead;
+        pool->pendingHead = aio->slot[s].next;
+        if (pool->pendingHead == NIL) pool->pendingTail = NIL;
+
+        pthread_mutex_unlock(&pool->mutex);
+        aio->slot[s].result = rdsm_DoRequest(aio->fd, &aio->slot[s]);
+        pthread_mutex_lock(&pool->mutex);
+
+        aio->slot[s].next = NIL;
+        if (pool->doneTail == NIL) pool->doneHead = s;
+        else aio->slot[pool->doneTail].next = s;
+        pool->doneTail = s;
+
+        pthread_cond_signal(&pool->doneCond);
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return(NULL);
+
+} /* rdsm_Worker() */
+
+
+
+/*@================================
+ * rdsm_SetUpIoUring()
+ *================================*/
+/*
+ * Function: Four rdsm_SetUpIoUring(RDsM_AsyncIO*)
+ *
+ * Description:
+ *  Create an io_uring instance and map its rings. Fail if the kernel does not
+ *  support io_uring or the read/write operations.
+ *
+ * Returns:
+ *  error code
+ *    eDEVICEOPENFAIL_RDSM
+ */
+static Four rdsm_SetUpIoUring(
+    RDsM_AsyncIO *aio)		/* INOUT asynchronous I/O handle */
+{
+    rdsm_IoUring *ring = &aio->u.uring;
+    struct io_uring_params params;	/* parameters of the instance */
+    struct io_uring_probe *probe;	/* supported operations */
+    Four	nOps;		/* the number of operations probed */
+
+
+    memset(&params, 0, sizeof(params));
+    memset(ring, 0, sizeof(*ring));
+
+    ring->ringFd = syscall(__NR_io_uring_setup, aio->queueDepth, &params);
+    if (ring->ringFd < 0) return(eDEVICEOPENFAIL_RDSM);
+
+    /* IORING_OP_READ/WRITE are available from Linux 5.6 */
+    nOps = IORING_OP_WRITE + 1;
+    probe = (struct io_uring_probe *)calloc(1, sizeof(*probe) + nOps*sizeof(struct io_uring_probe_op));
+    if (probe == NULL ||
+        syscall(__NR_io_uring_register, ring->ringFd, IORING_REGISTER_PROBE, probe, nOps) < 0 ||
+        probe->last_op < IORING_OP_WRITE ||
+        !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) ||
+        !(probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED)) {
+        free(probe);
+        close(ring->ringFd);
+        return(eDEVICEOPENFAIL_RDSM);
+    }
+    free(probe);
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries*sizeof(struct io_uring_cqe);
+    ring->sqesSize = params.sq_entries*sizeof(struct io_uring_sqe);
+
+    ring->sqRing = mmap(NULL, ring->sqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                        ring->ringFd, IORING_OFF_SQ_RING);
+    ring->cqRing = mmap(NULL, ring->cqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+                        ring->ringFd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe *)mmap(NULL, ring->sqesSize, PROT_READ|PROT_WRITE,
+                                             MAP_SHARED|MAP_POPULATE, ring->ringFd, IORING_OFF_SQES);
+
+    if (ring->sqRing == MAP_FAILED || ring->cqRing == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        if (ring->sqRing != MAP_FAILED) munmap(ring->sqRing, ring->sqRingSize);
+        if (ring->cqRing != MAP_FAILED) munmap(ring->cqRing, ring->cqRingSize);
+        if (ring->sqes != MAP_FAILED) munmap(ring->sqes, ring->sqesSize);
+        close(ring->ringFd);
+        return(eDEVICEOPENFAIL_RDSM);
+    }
+
+    ring->sqHead = (unsigned *)((char *)ring->sqRing + params.sq_off.head);
+    ring->sqTail = (unsigned *)((char *)ring->sqRing + params.sq_off.tail);
+    ring->sqMask = (unsigned *)((char *)ring->sqRing + params.sq_off.ring_mask);
+    ring->sqArray = (unsigned *)((char *)ring->sqRing + params.sq_off.array);
+    ring->cqHead = (unsigned *)((char *)ring->cqRing + params.cq_off.head);
+    ring->cqTail = (unsigned *)((char *)ring->cqRing + params.cq_off.tail);
+    ring->cqMask = (unsigned *)((char *)ring->cqRing + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((char *)ring->cqRing + params.cq_off.cqes);
+
+    return(eNOERROR);
+
+} /* rdsm_SetUpIoUring() */
+
+
+
+/*@================================
+ * rdsm_SetUpThreadPool()
+ *================================*/
+/*
+ * Function: Four rdsm_SetUpThreadPool(RDsM_AsyncIO*)
+ *
+ * Description:
+ *  Start the threads of the thread pool backend.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four rdsm_SetUpThreadPool(
+    RDsM_AsyncIO *aio)		/* INOUT asynchronous I/O handle */
+{
+    rdsm_ThreadPool *pool = &aio->u.pool;
+    Four	i;		/* index variable */
+
+
+    memset(pool, 0, sizeof(*pool));
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->pendingCond, NULL);
+    pthread_cond_init(&pool->doneCond, NULL);
+    pool->pendingHead = pool->pendingTail = NIL;
+    pool->doneHead = pool->doneTail = NIL;
+    pool->shutdown = FALSE;
+
+    pool->nWorkers = MIN(aio->queueDepth, RDSM_AIO_MAX_WORKERS);
+    for (i = 0; i < pool->nWorkers; i++) {
+        if (pthread_create(&pool->workers[i], NULL, rdsm_Worker, aio) != 0) break;
+    }
+    pool->nWorkers = i;
+
+    if (pool->nWorkers == 0) ERR(eMEMORYALLOCERR);
+
+    return(eNOERROR);
+
+} /* rdsm_SetUpThreadPool() */
+
+
+
+/*@================================
+ * RDsM_OpenAsyncIO()
+ *================================*/
+/*
+ * Function: Four RDsM_OpenAsyncIO(char*, Four, Four, RDsM_AsyncIO**)
+ *
+ * Description:
+ *  Open the device for asynchronous I/O with at most 'queueDepth' requests
+ *  in flight. io_uring is used if it works; otherwise the thread pool.
+ *
+ *  flags:
+ *   RDSM_AIO_READONLY   open the device read only
+ *   RDSM_AIO_NOIOURING  do not try io_uring
+ *   RDSM_AIO_DIRECT     bypass the page cache(O_DIRECT); every buffer
+ *                       submitted must then be aligned to PAGESIZE
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eDEVICEOPENFAIL_RDSM
+ *    eMEMORYALLOCERR
+ */
+Four RDsM_OpenAsyncIO(
+    char	*devName,	/* IN device(file) of the volume */
+    Four	queueDepth,	/* IN maximum number of requests in flight */
+    Four	flags,		/* IN RDSM_AIO_READONLY | RDSM_AIO_NOIOURING | RDSM_AIO_DIRECT */
+    RDsM_AsyncIO **aio)		/* OUT asynchronous I/O handle */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    RDsM_AsyncIO *h;		/* new handle */
+
+
+    if (devName == NULL || aio == NULL || queueDepth <= 0) ERR(eBADPARAMETER);
+
+    h = (RDsM_AsyncIO *)calloc(1, sizeof(RDsM_AsyncIO));
+    if (h == NULL) ERR(eMEMORYALLOCERR);
+
+    h->slot = (rdsm_AsyncIORequest *)calloc(queueDepth, sizeof(rdsm_AsyncIORequest));
+    if (h->slot == NULL) {
+        free(h);
+        ERR(eMEMORYALLOCERR);
+    }
+
+    h->fd = open(devName, ((flags & RDSM_AIO_READONLY) ? O_RDONLY : O_RDWR) | ((flags & RDSM_AIO_DIRECT) ? O_DIRECT : 0));
+    if (h->fd < 0) {
+        free(h->slot);
+        free(h);
+        ERR(eDEVICEOPENFAIL_RDSM);
+    }
+
+    h->direct = (flags & RDSM_AIO_DIRECT) ? TRUE : FALSE;
+    h->queueDepth = queueDepth;
+    h->nInFlight = 0;
+    for (i = 0; i < queueDepth; i++) h->slot[i].next = i + 1;
+    h->slot[queueDepth-1].next = NIL;
+    h->freeSlot = 0;
+
+    if (!(flags & RDSM_AIO_NOIOURING) && rdsm_SetUpIoUring(h) == eNOERROR) {
+        h->backend = RDSM_AIO_IOURING;
+    }
+    else {
+        e = rdsm_SetUpThreadPool(h);
+        if (e < 0) {
+            close(h->fd);
+            free(h->slot);
+            free(h);
+            ERR(e);
+        }
+        h->backend = RDSM_AIO_THREADPOOL;
+    }
+
+    *aio = h;
+
+    return(eNOERROR);
+
+} /* RDsM_OpenAsyncIO() */
+
+
+
+/*@================================
+ * RDsM_CloseAsyncIO()
+ *================================*/
+/*
+ * Function: Four RDsM_CloseAsyncIO(RDsM_AsyncIO*)
+ *
+ * Description:
+ *  Wait for the requests in flight and close the handle. Their completions
+ *  are discarded.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eDEVICECLOSEFAIL_RDSM
+ */
+Four RDsM_CloseAsyncIO(
+    RDsM_AsyncIO *aio)		/* IN asynchronous I/O handle */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    RDsM_AsyncIOCompletion done;	/* completion discarded */
+
+
+    if (aio == NULL) ERR(eBADPARAMETER);
+
+    while (aio->nInFlight > 0) {
+        e = RDsM_WaitAsyncIO(aio, 1, &done, 1);
+        if (e < 0) break;
+    }
+
+    if (aio->backend == RDSM_AIO_IOURING) {
+        munmap(aio->u.uring.sqes, aio->u.uring.sqesSize);
+        munmap(aio->u.uring.cqRing, aio->u.uring.cqRingSize);
+        munmap(aio->u.uring.sqRing, aio->u.uring.sqRingSize);
+        close(aio->u.uring.ringFd);
+    }
+    else {
+        pthread_mutex_lock(&aio->u.pool.mutex);
+        aio->u.pool.shutdown = TRUE;
+        pthread_cond_broadcast(&aio->u.pool.pendingCond);
+        pthread_mutex_unlock(&aio->u.pool.mutex);
+
+        for (i = 0; i < aio->u.pool.nWorkers; i++) pthread_join(aio->u.pool.workers[i], NULL);
+
+        pthread_cond_destroy(&aio->u.pool.doneCond);
+        pthread_cond_destroy(&aio->u.pool.pendingCond);
+        pthread_mutex_destroy(&aio->u.pool.mutex);
+    }
+
+    e = close(aio->fd);
+
+    free(aio->slot);
+    free(aio);
+
+    if (e < 0) ERR(eDEVICECLOSEFAIL_RDSM);
+
+    return(eNOERROR);
+
+} /* RDsM_CloseAsyncIO() */
+
+
+
+/*@================================
+ * RDsM_GetAsyncIOBackend()
+ *================================*/
+/*
+ * Function: Four RDsM_GetAsyncIOBackend(RDsM_AsyncIO*)
+ *
+ * Description:
+ *  Tell which backend the handle uses.
+ *
+ * Returns:
+ *  RDSM_AIO_IOURING or RDSM_AIO_THREADPOOL
+ *  error code
+ *    eBADPARAMETER
+ */
+Four RDsM_GetAsyncIOBackend(
+    RDsM_AsyncIO *aio)		/* IN asynchronous I/O handle */
+{
+    if (aio == NULL) ERR(eBADPARAMETER);
+
+    return(aio->backend);
+
+} /* RDsM_GetAsyncIOBackend() */
+
+
+
+/*@================================
+ * rdsm_Submit()
+ *================================*/
+/*
+ * Function: Four rdsm_Submit(RDsM_AsyncIO*, Four, char*, PageID*, Four, void*)
+ *
+ * Description:
+ *  Queue a read or write request. With io_uring the request is passed to the
+ *  kernel at the next RDsM_WaitAsyncIO() so that a batch costs one system call.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eINVALIDTRAINSIZE_RDSM
+ *    eASYNCIOQUEUEFULL_RDSM
+ */
+static Four rdsm_Submit(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    Four	op,		/* IN RDSM_AIO_READ or RDSM_AIO_WRITE */
+    char	*buf,		/* IN buffer */
+    PageID	*pid,		/* IN first page of the train */
+    Four	sizeOfTrain,	/* IN the number of pages in the train */
+    void	*userData)	/* IN returned with the completion */
+{
+    Four	s;		/* slot used */
+    rdsm_AsyncIORequest *req;	/* request in the slot */
+    rdsm_IoUring *ring;		/* io_uring backend */
+    rdsm_ThreadPool *pool;	/* thread pool backend */
+    struct io_uring_sqe *sqe;	/* submission queue entry */
+    unsigned	tail;		/* tail of the submission queue */
+
+
+    if (aio == NULL || buf == NULL || pid == NULL) ERR(eBADPARAMETER);
+    if (aio->direct && ((unsigned long)buf & (PAGESIZE - 1)) != 0) ERR(eBADPARAMETER);
+    if (sizeOfTrain <= 0) ERR(eINVALIDTRAINSIZE_RDSM);
+    if (aio->freeSlot == NIL) ERR(eASYNCIOQUEUEFULL_RDSM);
+
+    s = aio->freeSlot;
+    req = &aio->slot[s];
+    aio->freeSlot = req->next;
+    aio->nInFlight++;
+
+    req->op = op;
+    req->buf = buf;
+    req->len = (size_t)sizeOfTrain * PAGESIZE;
+    req->offset = (off_t)pid->pageNo * PAGESIZE;
+    req->userData = userData;
+    req->result = eNOERROR;
+    req->next = NIL;
+
+    if (aio->backend == RDSM_AIO_IOURING) {
+        ring = &aio->u.uring;
+
+        tail = *ring->sqTail;
+        sqe = &ring->sqes[tail & *ring->sqMask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = (op == RDSM_AIO_READ) ? IORING_OP_READ : IORING_OP_WRITE;
+        sqe->fd = aio->fd;
+        sqe->addr = (unsigned long)req->buf;
+        sqe->len = req->len;
+        sqe->off = req->offset;
+        sqe->user_data = s;
+
+        ring->sqArray[tail & *ring->sqMask] = tail & *ring->sqMask;
+        __atomic_store_n(ring->sqTail, tail + 1, __ATOMIC_RELEASE);
+        ring->nToSubmit++;
+    }
+    else {
+        pool = &aio->u.pool;
+
+        pthread_mutex_lock(&pool->mutex);
+        if (pool->pendingTail == NIL) pool->pendingHead = s;
+        else aio->slot[pool->pendingTail].next = s;
+        pool->pendingTail = s;
+        pthread_cond_signal(&pool->pendingCond);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_Submit() */
+
+
+
+/*@================================
+ * RDsM_SubmitReadTrain()
+ *================================*/
+/*
+ * Function: Four RDsM_SubmitReadTrain(RDsM_AsyncIO*, PageID*, char*, Four, void*)
+ *
+ * Description:
+ *  Start reading the train into the buffer. The buffer must not be touched
+ *  until the completion carrying 'userData' is returned by RDsM_WaitAsyncIO().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eINVALIDTRAINSIZE_RDSM
+ *    eASYNCIOQUEUEFULL_RDSM
+ */
+Four RDsM_SubmitReadTrain(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    PageID	*pid,		/* IN first page of the train to read */
+    char	*buf,		/* OUT buffer to read into */
+    Four	sizeOfTrain,	/* IN the number of pages in the train */
+    void	*userData)	/* IN returned with the completion */
+{
+    return(rdsm_Submit(aio, RDSM_AIO_READ, buf, pid, sizeOfTrain, userData));
+
+} /* RDsM_SubmitReadTrain() */
+
+
+
+/*@================================
+ * RDsM_SubmitWriteTrain()
+ *================================*/
+/*
+ * Function: Four RDsM_SubmitWriteTrain(RDsM_AsyncIO*, char*, PageID*, Four, void*)
+ *
+ * Description:
+ *  Start writing the buffer to the train. The buffer must not be modified
+ *  until the completion carrying 'userData' is returned by RDsM_WaitAsyncIO().
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eINVALIDTRAINSIZE_RDSM
+ *    eASYNCIOQUEUEFULL_RDSM
+ */
+Four RDsM_SubmitWriteTrain(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    char	*buf,		/* IN buffer to write */
+    PageID	*pid,		/* IN first page of the train to write */
+    Four	sizeOfTrain,	/* IN the number of pages in the train */
+    void	*userData)	/* IN returned with the completion */
+{
+    return(rdsm_Submit(aio, RDSM_AIO_WRITE, buf, pid, sizeOfTrain, userData));
+
+} /* RDsM_SubmitWriteTrain() */
+
+
+
+/*@================================
+ * RDsM_WaitAsyncIO()
+ *================================*/
+/*
+ * Function: Four RDsM_WaitAsyncIO(RDsM_AsyncIO*, Four, RDsM_AsyncIOCompletion*, Four)
+ *
+ * Description:
+ *  Pass the queued requests to the kernel and reap up to 'maxComplete'
+ *  completions, waiting until at least 'minComplete' of them are available
+ *  (or fewer if fewer requests are in flight).
+ *
+ * Returns:
+ *  the number of completions returned (values greater than or equal to 0)
+ *  error code
+ *    eBADPARAMETER
+ *    eREADFAIL_RDSM
+ */
+Four RDsM_WaitAsyncIO(
+    RDsM_AsyncIO *aio,		/* IN asynchronous I/O handle */
+    Four	minComplete,	/* IN the number of completions to wait for */
+    RDsM_AsyncIOCompletion *done, /* OUT completions */
+    Four	maxComplete)	/* IN size of 'done' */
+{
+    Four	n;		/* the number of completions returned */
+    Four	s;		/* slot completed */
+    rdsm_IoUring *ring;		/* io_uring backend */
+    rdsm_ThreadPool *pool;	/* thread pool backend */
+    unsigned	head;		/* head of the completion queue */
+    struct io_uring_cqe *cqe;	/* completion queue entry */
+    long	r;		/* return value of io_uring_enter */
+
+
+    if (aio == NULL || (done == NULL && maxComplete > 0) || minComplete > maxComplete) ERR(eBADPARAMETER);
+
+    if (minComplete > aio->nInFlight) minComplete = aio->nInFlight;
+
+    n = 0;
+
+    if (aio->backend == RDSM_AIO_IOURING) {
+        ring = &aio->u.uring;
+
+        for (;;) {
+            head = *ring->cqHead;
+            while (n < maxComplete && head != __atomic_load_n(ring->cqTail, __ATOMIC_ACQUIRE)) {
+                cqe = &ring->cqes[head & *ring->cqMask];
+                s = (Four)cqe->user_data;
+
+                if (cqe->res != (int)aio->slot[s].len)
+                    aio->slot[s].result = (aio->slot[s].op == RDSM_AIO_READ) ? eREADFAIL_RDSM : eWRITEFAIL_RDSM;
+
+                done[n].userData = aio->slot[s].userData;
+                done[n].result = aio->slot[s].result;
+                n++;
+
+                aio->slot[s].next = aio->freeSlot;
+                aio->freeSlot = s;
+                aio->nInFlight--;
+                head++;
+            }
+            __atomic_store_n(ring->cqHead, head, __ATOMIC_RELEASE);
+
+            if (n >= minComplete && ring->nToSubmit == 0) break;
+
+            r = syscall(__NR_io_uring_enter, ring->ringFd, ring->nToSubmit,
+                        (n < minComplete) ? minComplete - n : 0, IORING_ENTER_GETEVENTS, NULL, 0);
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                ERR(eREADFAIL_RDSM);
+            }
+            ring->nToSubmit -= r;
+        }
+    }
+    else {
+        pool = &aio->u.pool;
+
+        pthread_mutex_lock(&pool->mutex);
+        for (;;) {
+            while (n < maxComplete && pool->doneHead != NIL) {
+                s = pool->doneHead;
+                pool->doneHead = aio->slot[s].next;
+                if (pool->doneHead == NIL) pool->doneTail = NIL;
+
+                done[n].userData = aio->slot[s].userData;
+                done[n].result = aio->slot[s].result;
+                n++;
+
+                aio->slot[s].next = aio->freeSlot;
+                aio->freeSlot = s;
+                aio->nInFlight--;
+            }
+
+            if (n >= minComplete) break;
+
+            pthread_cond_wait(&pool->doneCond, &pool->mutex);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return(n);
+
+} /* RDsM_WaitAsyncIO() */
+
+
+
+/*@================================
+ * RDsM_AttachAsyncIO()
+ *================================*/
+/*
+ * Function: Four RDsM_AttachAsyncIO(VolNo, char*, Four, Four)
+ *
+ * Description:
+ *  Open an asynchronous I/O handle on the device of a mounted volume and
+ *  attach it to the volume, so that the buffer manager can use it.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eTOOMANYVOLUMES_RDSM
+ *    some errors caused by function calls
+ */
+Four RDsM_AttachAsyncIO(
+    VolNo	volNo,		/* IN volume number */
+    char	*devName,	/* IN device(file) of the volume */
+    Four	queueDepth,	/* IN maximum number of requests in flight */
+    Four	flags)		/* IN flags of RDsM_OpenAsyncIO() */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+
+
+    if (volNo < 0 || RDsM_GetAttachedAsyncIO(volNo) != NULL) ERR(eBADPARAMETER);
+
+    for (i = 0; i < RDSM_AIO_MAX_ATTACHED; i++)
+        if (rdsm_attachedAsyncIO[i].volNo == NIL) break;
+
+    if (i == RDSM_AIO_MAX_ATTACHED) ERR(eTOOMANYVOLUMES_RDSM);
+
+    e = RDsM_OpenAsyncIO(devName, queueDepth, flags, &rdsm_attachedAsyncIO[i].aio);
+    if (e < 0) ERR(e);
+
+    rdsm_attachedAsyncIO[i].volNo = volNo;
+
+    return(eNOERROR);
+
+} /* RDsM_AttachAsyncIO() */
+
+
+
+/*@================================
+ * RDsM_DetachAsyncIO()
+ *================================*/
+/*
+ * Function: Four RDsM_DetachAsyncIO(VolNo)
+ *
+ * Description:
+ *  Detach the asynchronous I/O handle from the volume and close it. This
+ *  should be called before the volume is dismounted.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    some errors caused by function calls
+ */
+Four RDsM_DetachAsyncIO(
+    VolNo	volNo)		/* IN volume number */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < RDSM_AIO_MAX_ATTACHED; i++)
+        if (rdsm_attachedAsyncIO[i].volNo == volNo) break;
+
+    if (i == RDSM_AIO_MAX_ATTACHED) ERR(eBADPARAMETER);
+
+    rdsm_attachedAsyncIO[i].volNo = NIL;
+
+    e = RDsM_CloseAsyncIO(rdsm_attachedAsyncIO[i].aio);
+    rdsm_attachedAsyncIO[i].aio = NULL;
+    if (e < 0) ERR(e);
+
+    return(eNOERROR);
+
+} /* RDsM_DetachAsyncIO() */
+
+
+
+/*@================================
+ * RDsM_GetAttachedAsyncIO()
+ *================================*/
+/*
+ * Function: RDsM_AsyncIO *RDsM_GetAttachedAsyncIO(VolNo)
+ *
+ * Description:
+ *  Return the asynchronous I/O handle attached to the volume.
+ *
+ * Returns:
+ *  the handle
+ *  NULL if no handle is attached to the volume
+ */
+RDsM_AsyncIO *RDsM_GetAttachedAsyncIO(
+    VolNo	volNo)		/* IN volume number */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < RDSM_AIO_MAX_ATTACHED; i++)
+        if (rdsm_attachedAsyncIO[i].volNo == volNo) return(rdsm_attachedAsyncIO[i].aio);
+
+    return(NULL);
+
+} /* RDsM_GetAttachedAsyncIO() */
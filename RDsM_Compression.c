@@ -0,0 +1,1440 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: RDsM_Compression.c
+ *
+ * Description:
+ *  Compressed pages. The pages of a file given compressed pages by
+ *  RDsM_SetCompressedFile() are compressed when the buffer manager writes
+ *  them back, and decompressed when it reads them on a buffer miss; the
+ *  buffer pool keeps the pages uncompressed, so the hot pages never pay for
+ *  the codec. The codec is an LZ77 one in the format of LZ4 blocks: a
+ *  sequence is a token(literal length, match length), the literals, and a
+ *  2-byte offset of the match.
+ *
+ *  The layout of a volume is fixed by the raw disk manager in cosmos.o, so a
+ *  compressed page is appended to the side store of its device, the file
+ *  '<device>.lz', and its place in the device is punched out(it reads as
+ *  zeros and takes no disk space) once the record is on the disk. A record
+ *  of the side store is either a compressed page or a tombstone telling
+ *  that the page is stored in the device again; the store is replayed into
+ *  the index of the device when the device is opened. When the replaced
+ *  records outweigh the live ones, the live records are copied to a new
+ *  store which takes the place of the old one by rename(), so that a crash
+ *  leaves one of the two; the store stays within about twice the bytes of
+ *  its pages.
+ *
+ *  Only the devices of the volumes of the registered files are tracked, and
+ *  the devices whose side store starts with a record, i.e. which were
+ *  given compressed pages by an earlier process; any other file the
+ *  process opens is left alone.
+ *
+ *  The device I/O of cosmos.o goes through the wrappers below(see
+ *  'ld --wrap' in the Makefile): the raw disk manager positions a device by
+ *  lseek() and reads or writes whole trains. Only a write of one page whose
+ *  header is that of a slotted page of a registered file is compressed; a
+ *  page is written uncompressed if it does not compress to
+ *  RDSM_LZ_MAX_LENGTH bytes.
+ *
+ *  The pages stored compressed are not in the device, so they are not read
+ *  from the mapping of the device nor by the asynchronous I/O, which use
+ *  rdsm_IsCompressedTrain() to fall back to the buffer manager. Likewise the
+ *  pages of a registered file are not written by the asynchronous I/O(see
+ *  rdsm_HoldsCompressedFilePage()), which would store them uncompressed.
+ *
+ * Exports:
+ *  Four RDsM_SetCompressedFile(FileID*, Boolean)
+ *  Four RDsM_GetCompressionStats(VolNo, RDsM_CompressionStats*)
+ *
+ * Internal:
+ *  Boolean rdsm_IsCompressedTrain(PageID*, Four)
+ *  Boolean rdsm_HoldsCompressedFilePage(char*, Four)
+ *  int __wrap_open64(const char*, int, ...)
+ *  int __wrap_close(int)
+ *  ssize_t __wrap_read(int, void*, size_t)
+ *  ssize_t __wrap_write(int, const void*, size_t)
+ */
+
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "EduOM_common.h"
+#include "RDsM_Internal.h"
+#include "BfM.h"
+#include "EduOM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define RDSM_LZ_MAX_DEVICES     64      /* devices opened at a time */
+#define RDSM_LZ_MAX_FILES       20      /* files which can be given compressed pages */
+#define RDSM_LZ_SUFFIX          ".lz"   /* the side store of a device is '<device>.lz' */
+#define RDSM_LZ_TMP_SUFFIX      ".tmp"  /* ... and '<device>.lz.tmp' while it is compacted */
+#define RDSM_LZ_MAGIC           0x4c5a5031
+
+/* a page is stored compressed only if it saves a quarter of the page */
+#define RDSM_LZ_MAX_LENGTH      (PAGESIZE - PAGESIZE/4)
+
+/* codec */
+#define RDSM_LZ_HASH_BITS       12
+#define RDSM_LZ_MIN_MATCH       4
+#define RDSM_LZ_LAST_LITERALS   5       /* the last bytes are always literals */
+#define RDSM_LZ_MAX_OFFSET      0xffff
+
+
+/*@
+ * Type Definitions
+ */
+/* header of a record of the side store; followed by 'length' bytes */
+typedef struct {
+    UFour	magic;		/* RDSM_LZ_MAGIC */
+    Four	block;		/* page number within the device */
+    Four	length;		/* length of the compressed page; 0 for a tombstone */
+    UFour	check;		/* checksum of the record */
+} rdsm_LzRecordHdr;
+
+/* entry of the index of a device */
+typedef struct {
+    off_t	offset;		/* offset of the compressed page in the side store */
+    Four	length;		/* length of the compressed page; 0 if in the device */
+} rdsm_LzBlock;
+
+/* an opened device */
+typedef struct {
+    Four	fd;		/* file descriptor; NIL if the entry is not used */
+    char	sideName[MAX_DEVICE_NAME + sizeof(RDSM_LZ_SUFFIX)]; /* name of the side store */
+    Four	sideFd;		/* file descriptor of the side store; NIL if not opened */
+    off_t	sideEnd;	/* end of the side store */
+    rdsm_LzBlock *block;	/* index of the pages */
+    Four	nBlocks;	/* the number of the entries of the index */
+    Four	nStored;	/* pages stored compressed now */
+    double	storedBytes;	/* bytes of those pages */
+    UFour	nCompressed;	/* pages written compressed */
+    UFour	nIncompressible;/* pages of the registered files written uncompressed */
+    UFour	nDecompressed;	/* pages read and decompressed */
+    UFour	nCompactions;	/* compactions of the side store */
+} rdsm_LzDevice;
+
+
+/*@
+ * Global Variables
+ */
+static rdsm_LzDevice rdsm_lzDevice[RDSM_LZ_MAX_DEVICES] = {
+    [0 ... RDSM_LZ_MAX_DEVICES-1] = { NIL, "", NIL, 0, NULL, 0, 0, 0.0, 0, 0, 0, 0 }
+};
+
+/* devices of the volumes of the files registered by this process */
+static char rdsm_lzPath[RDSM_LZ_MAX_DEVICES][MAX_DEVICE_NAME];
+static Four rdsm_nLzPaths = 0;
+
+static FileID rdsm_lzFile[RDSM_LZ_MAX_FILES] = {
+    [0 ... RDSM_LZ_MAX_FILES-1] = { NIL, NIL }
+};
+
+/* the number of registered files and of pages stored compressed; let the wrappers return at once if 0 */
+static Four rdsm_nLzFiles = 0;
+static Four rdsm_nLzStored = 0;
+
+static pthread_mutex_t rdsm_lzMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* the real functions in the C library */
+int __real_open64(const char *, int, ...);
+int __real_close(int);
+ssize_t __real_read(int, void *, size_t);
+ssize_t __real_write(int, const void *, size_t);
+
+
+static Four rdsm_LzCompress(unsigned char*, Four, unsigned char*, Four);
+static Four rdsm_LzDecompress(unsigned char*, Four, unsigned char*, Four);
+static UFour rdsm_LzChecksum(Four, unsigned char*, Four);
+static rdsm_LzDevice *rdsm_LzLookUpDevice(Four);
+static Boolean rdsm_LzIsCompressedFile(char*);
+static Boolean rdsm_LzIsTrackedPath(const char*, char*);
+static Four rdsm_LzAttachDevice(Four, const char*);
+static Four rdsm_LzSetBlock(rdsm_LzDevice*, Four, off_t, Four);
+static Four rdsm_LzAppend(rdsm_LzDevice*, Four, unsigned char*, Four);
+static Four rdsm_LzCompactSideStore(rdsm_LzDevice*);
+static Four rdsm_LzLoadSideStore(rdsm_LzDevice*);
+static Four rdsm_LzReadBlock(rdsm_LzDevice*, Four, char*);
+static Four rdsm_LzRestoreBlocks(rdsm_LzDevice*, off_t, size_t);
+
+
+
+/*@================================
+ * RDsM_SetCompressedFile()
+ *================================*/
+/*
+ * Function: Four RDsM_SetCompressedFile(FileID*, Boolean)
+ *
+ * Description:
+ *  Make the pages of the file be stored compressed(or uncompressed) from
+ *  their next write on. The file is remembered by the process, so it is
+ *  registered again after the volume is mounted by another process; the
+ *  pages already stored compressed are read back in any case. The devices
+ *  of the volume are tracked from now on, also when they are opened again.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eVOLNOTMOUNTED_RDSM
+ *    eBADVOLUMETABLE_RDSM
+ *    eTOOMANYVOLUMES_RDSM
+ *    some errors caused by function calls
+ */
+Four RDsM_SetCompressedFile(
+    FileID	*fid,		/* IN file */
+    Boolean	onOff)		/* IN TRUE to store the pages compressed */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    Four	v;		/* index of the volume table */
+    Four	d;		/* index of the device */
+    Four	freeEntry;	/* unused entry */
+    RDsM_DevInfo *devInfo;	/* device of the volume */
+
+
+    if (fid == NULL || fid->volNo == NIL) ERR(eBADPARAMETER);
+
+    for (v = 0; v < MAXNUMOFVOLS; v++)
+        if (volTable[v].volNo == fid->volNo) break;
+
+    if (v == MAXNUMOFVOLS) ERR(eVOLNOTMOUNTED_RDSM);
+    if (onOff && !rdsm_CheckVolumeEntry(&volTable[v])) ERR(eBADVOLUMETABLE_RDSM);
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    /* track the devices of the volume; their side stores are replayed if not yet */
+    for (d = 0; onOff && d < volTable[v].numDevices; d++) {
+        devInfo = &volTable[v].devInfo[d];
+
+        if (!rdsm_LzIsTrackedPath(devInfo->devName, NULL)) {
+            if (rdsm_nLzPaths == RDSM_LZ_MAX_DEVICES) {
+                pthread_mutex_unlock(&rdsm_lzMutex);
+                ERR(eTOOMANYVOLUMES_RDSM);
+            }
+            strcpy(rdsm_lzPath[rdsm_nLzPaths++], devInfo->devName);
+        }
+
+        if (rdsm_LzLookUpDevice(devInfo->devAddr) == NULL) {
+            e = rdsm_LzAttachDevice(devInfo->devAddr, devInfo->devName);
+            if (e < 0) {
+                pthread_mutex_unlock(&rdsm_lzMutex);
+                ERR(e);
+            }
+        }
+    }
+
+    for (i = 0, freeEntry = NIL; i < RDSM_LZ_MAX_FILES; i++) {
+        if (EQUAL_FILEID(rdsm_lzFile[i], *fid)) break;
+        if (rdsm_lzFile[i].volNo == NIL && freeEntry == NIL) freeEntry = i;
+    }
+
+    if (i < RDSM_LZ_MAX_FILES && !onOff) {
+        rdsm_lzFile[i].volNo = NIL;
+        rdsm_nLzFiles--;
+    } else if (i == RDSM_LZ_MAX_FILES && onOff) {
+        if (freeEntry == NIL) {
+            pthread_mutex_unlock(&rdsm_lzMutex);
+            ERR(eTOOMANYVOLUMES_RDSM);
+        }
+        rdsm_lzFile[freeEntry] = *fid;
+        rdsm_nLzFiles++;
+    }
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(eNOERROR);
+
+} /* RDsM_SetCompressedFile() */
+
+
+
+/*@================================
+ * RDsM_GetCompressionStats()
+ *================================*/
+/*
+ * Function: Four RDsM_GetCompressionStats(VolNo, RDsM_CompressionStats*)
+ *
+ * Description:
+ *  Return the counters of the compressed pages of the mounted volume,
+ *  summed over its devices.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eVOLNOTMOUNTED_RDSM
+ */
+Four RDsM_GetCompressionStats(
+    VolNo	volNo,		/* IN volume number */
+    RDsM_CompressionStats *stats) /* OUT counters */
+{
+    Four	i;		/* index of the volume table */
+    Four	d;		/* index of the device */
+    rdsm_LzDevice *dev;		/* opened device */
+
+
+    if (stats == NULL) ERR(eBADPARAMETER);
+
+    for (i = 0; i < MAXNUMOFVOLS; i++)
+        if (volTable[i].volNo == volNo) break;
+
+    if (i == MAXNUMOFVOLS) ERR(eVOLNOTMOUNTED_RDSM);
+
+    memset(stats, 0, sizeof(RDsM_CompressionStats));
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    for (d = 0; d < volTable[i].numDevices; d++) {
+        dev = rdsm_LzLookUpDevice(volTable[i].devInfo[d].devAddr);
+        if (dev == NULL) continue;
+
+        stats->nCompressed += dev->nCompressed;
+        stats->nIncompressible += dev->nIncompressible;
+        stats->nDecompressed += dev->nDecompressed;
+        stats->nStored += dev->nStored;
+        stats->storedBytes += dev->storedBytes;
+        stats->sideStoreBytes += (double)dev->sideEnd;
+        stats->nCompactions += dev->nCompactions;
+    }
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(eNOERROR);
+
+} /* RDsM_GetCompressionStats() */
+
+
+
+/*@================================
+ * rdsm_IsCompressedTrain()
+ *================================*/
+/*
+ * Function: Boolean rdsm_IsCompressedTrain(PageID*, Four)
+ *
+ * Description:
+ *  Tell whether a page of the train is stored compressed, i.e. the train
+ *  cannot be read directly from the device. For a volume of several
+ *  devices, any page stored compressed in the volume makes it TRUE.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ */
+Boolean rdsm_IsCompressedTrain(
+    PageID	*pid,		/* IN first page of the train */
+    Four	nPages)		/* IN the number of pages in the train */
+{
+    Four	i;		/* index of the volume table */
+    Four	d;		/* index of the device */
+    Four	b;		/* page number within the device */
+    Boolean	found;		/* TRUE if a page is stored compressed */
+    rdsm_LzDevice *dev;		/* opened device */
+
+
+    if (rdsm_nLzStored == 0) return(FALSE);
+
+    for (i = 0; i < MAXNUMOFVOLS; i++)
+        if (volTable[i].volNo == pid->volNo) break;
+
+    if (i == MAXNUMOFVOLS) return(FALSE);
+
+    found = FALSE;
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    for (d = 0; d < volTable[i].numDevices && !found; d++) {
+        dev = rdsm_LzLookUpDevice(volTable[i].devInfo[d].devAddr);
+        if (dev == NULL || dev->nStored == 0) continue;
+
+        if (volTable[i].numDevices > 1) {
+            found = TRUE;
+            break;
+        }
+
+        for (b = pid->pageNo; b < pid->pageNo + nPages && b < dev->nBlocks; b++)
+            if (b >= 0 && dev->block[b].length > 0) found = TRUE;
+    }
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(found);
+
+} /* rdsm_IsCompressedTrain() */
+
+
+
+/*@================================
+ * rdsm_HoldsCompressedFilePage()
+ *================================*/
+/*
+ * Function: Boolean rdsm_HoldsCompressedFilePage(char*, Four)
+ *
+ * Description:
+ *  Tell whether a page to be written is a page of a file given compressed
+ *  pages, whether it is stored compressed yet or not; such a page has to be
+ *  written through write() of cosmos.o, which compresses it.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ */
+Boolean rdsm_HoldsCompressedFilePage(
+    char	*pages,		/* IN pages to be written */
+    Four	nPages)		/* IN the number of pages */
+{
+    Four	i;		/* index variable */
+    Boolean	found;		/* TRUE if a page is of a registered file */
+
+
+    if (rdsm_nLzFiles == 0) return(FALSE);
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    for (i = 0, found = FALSE; i < nPages && !found; i++)
+        found = rdsm_LzIsCompressedFile(pages + i*PAGESIZE);
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(found);
+
+} /* rdsm_HoldsCompressedFilePage() */
+
+
+
+/*@================================
+ * __wrap_open64()
+ *================================*/
+/*
+ * Function: int __wrap_open64(const char*, int, ...)
+ *
+ * Description:
+ *  open64() of cosmos.o. A device of the volume of a registered file, or a
+ *  device whose side store starts with a record, is tracked: its side
+ *  store is replayed into the index of the device, or dropped if the device
+ *  is created by formatting its volume. Any other file is opened as it is.
+ *
+ * Returns:
+ *  file descriptor, or -1 with errno set
+ */
+int __wrap_open64(
+    const char	*path,		/* IN file name */
+    int		flags,		/* IN open flags */
+    ...)			/* IN mode if O_CREAT is given */
+{
+    va_list	ap;		/* variable arguments */
+    Four	mode;		/* mode of a created file */
+    Four	fd;		/* file descriptor */
+    Four	e;		/* error number */
+    char	sideName[MAX_DEVICE_NAME + sizeof(RDSM_LZ_SUFFIX)]; /* name of the side store */
+
+
+    mode = 0;
+    if (flags & O_CREAT) {
+        va_start(ap, flags);
+        mode = va_arg(ap, int);
+        va_end(ap);
+    }
+
+    fd = __real_open64(path, flags, mode);
+    if (fd < 0 || strlen(path) >= MAX_DEVICE_NAME) return(fd);
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    e = eNOERROR;
+    if (rdsm_LzIsTrackedPath(path, sideName)) {
+        if (flags & O_CREAT) (void)unlink(sideName);
+
+        e = rdsm_LzAttachDevice(fd, path);
+    }
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    if (e < 0) {
+        (void)__real_close(fd);
+        errno = EIO;
+        return(-1);
+    }
+
+    return(fd);
+
+} /* __wrap_open64() */
+
+
+
+/*@================================
+ * __wrap_close()
+ *================================*/
+/*
+ * Function: int __wrap_close(int)
+ *
+ * Description:
+ *  close() of cosmos.o; drops the index of the device.
+ *
+ * Returns:
+ *  0, or -1 with errno set
+ */
+int __wrap_close(
+    int		fd)		/* IN file descriptor */
+{
+    rdsm_LzDevice *dev;		/* opened device */
+
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    dev = rdsm_LzLookUpDevice(fd);
+    if (dev != NULL) {
+        if (dev->sideFd != NIL) (void)__real_close(dev->sideFd);
+        rdsm_nLzStored -= dev->nStored;
+        free(dev->block);
+        dev->block = NULL;
+        dev->fd = NIL;
+    }
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(__real_close(fd));
+
+} /* __wrap_close() */
+
+
+
+/*@================================
+ * __wrap_read()
+ *================================*/
+/*
+ * Function: ssize_t __wrap_read(int, void*, size_t)
+ *
+ * Description:
+ *  read() of cosmos.o. The pages stored compressed are read from the side
+ *  store and decompressed, the others from the device.
+ *
+ * Returns:
+ *  the number of bytes read, or -1 with errno set
+ */
+ssize_t __wrap_read(
+    int		fd,		/* IN file descriptor */
+    void	*buf,		/* OUT bytes read */
+    size_t	n)		/* IN the number of bytes to read */
+{
+    Four	e;		/* error number */
+    off_t	pos;		/* position of the device */
+    size_t	done;		/* the number of bytes read */
+    ssize_t	r;		/* result of a system call */
+    rdsm_LzDevice *dev;		/* opened device */
+
+
+    if (rdsm_nLzStored == 0 || n == 0) return(__real_read(fd, buf, n));
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    dev = rdsm_LzLookUpDevice(fd);
+    if (dev == NULL || dev->nStored == 0 || (pos = lseek(fd, 0, SEEK_CUR)) < 0) {
+        pthread_mutex_unlock(&rdsm_lzMutex);
+        return(__real_read(fd, buf, n));
+    }
+
+    /* a read not of whole pages; store the pages it touches in the device */
+    if (pos % PAGESIZE != 0 || n % PAGESIZE != 0) {
+        e = rdsm_LzRestoreBlocks(dev, pos, n);
+        pthread_mutex_unlock(&rdsm_lzMutex);
+        if (e < 0) { errno = EIO; return(-1); }
+        return(__real_read(fd, buf, n));
+    }
+
+    for (done = 0; done < n; done += PAGESIZE) {
+        e = rdsm_LzReadBlock(dev, (Four)((pos + done) / PAGESIZE), (char *)buf + done);
+        if (e == 0) break;      /* end of the device */
+        if (e < 0) {
+            pthread_mutex_unlock(&rdsm_lzMutex);
+            errno = EIO;
+            return(-1);
+        }
+    }
+
+    r = lseek(fd, pos + done, SEEK_SET);
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return((r < 0) ? -1 : (ssize_t)done);
+
+} /* __wrap_read() */
+
+
+
+/*@================================
+ * __wrap_write()
+ *================================*/
+/*
+ * Function: ssize_t __wrap_write(int, const void*, size_t)
+ *
+ * Description:
+ *  write() of cosmos.o. A page of a registered file is appended compressed
+ *  to the side store, which is synced before the place of the page in the
+ *  device is punched out; any
+ *  other write goes to the device, and a page it replaces in the side store
+ *  gets a tombstone after the write. A write of several whole pages is done
+ *  page by page so that the pages of a registered file in it are compressed.
+ *
+ * Returns:
+ *  the number of bytes written, or -1 with errno set
+ */
+ssize_t __wrap_write(
+    int		fd,		/* IN file descriptor */
+    const void	*buf,		/* IN bytes to write */
+    size_t	n)		/* IN the number of bytes to write */
+{
+    Four	e;		/* error number */
+    Four	b;		/* page number within the device */
+    Four	length;		/* length of the compressed page */
+    off_t	pos;		/* position of the device */
+    ssize_t	r;		/* result of a system call */
+    size_t	done;		/* bytes of a run of pages written */
+    Boolean	compress;	/* TRUE if the page is of a registered file */
+    unsigned char out[RDSM_LZ_MAX_LENGTH]; /* compressed page */
+    rdsm_LzDevice *dev;		/* opened device */
+
+
+    if (rdsm_nLzFiles == 0 && rdsm_nLzStored == 0) return(__real_write(fd, buf, n));
+
+    pthread_mutex_lock(&rdsm_lzMutex);
+
+    dev = rdsm_LzLookUpDevice(fd);
+    if (dev == NULL || (pos = lseek(fd, 0, SEEK_CUR)) < 0) {
+        pthread_mutex_unlock(&rdsm_lzMutex);
+        return(__real_write(fd, buf, n));
+    }
+
+    /* a run of pages(see BfM_BackgroundWriter.c); each page is compressed or not by itself */
+    if (rdsm_nLzFiles > 0 && pos % PAGESIZE == 0 && n > PAGESIZE && n % PAGESIZE == 0) {
+        pthread_mutex_unlock(&rdsm_lzMutex);
+
+        for (done = 0; done < n; done += PAGESIZE) {
+            r = __wrap_write(fd, (const char *)buf + done, PAGESIZE);
+            if (r != PAGESIZE) return((done > 0) ? (ssize_t)done : r);
+        }
+
+        return((ssize_t)n);
+    }
+
+    compress = (pos % PAGESIZE == 0 && n == PAGESIZE && rdsm_LzIsCompressedFile((char *)buf));
+
+    if (compress) {
+        b = (Four)(pos / PAGESIZE);
+        length = rdsm_LzCompress((unsigned char *)buf, PAGESIZE, out, RDSM_LZ_MAX_LENGTH);
+
+        if (length > 0) {
+            e = rdsm_LzAppend(dev, b, out, length);
+            if (e < 0) goto failed;
+
+            /* never punch out the only copy of the page on the disk */
+            if (fdatasync(dev->sideFd) < 0) goto failed;
+
+            /* the page is in the side store; a device not punched holds a stale copy of it */
+            if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, pos, PAGESIZE) < 0 &&
+                pwrite(fd, buf, PAGESIZE, pos) != PAGESIZE) goto failed;
+
+            dev->nCompressed++;
+
+            e = rdsm_LzCompactSideStore(dev);
+            if (e < 0) goto failed;
+
+            r = lseek(fd, pos + PAGESIZE, SEEK_SET);
+
+            pthread_mutex_unlock(&rdsm_lzMutex);
+
+            return((r < 0) ? -1 : PAGESIZE);
+        }
+
+        dev->nIncompressible++;
+    }
+
+    /* a write not of whole pages; store the pages it touches in the device first */
+    if (dev->nStored > 0 && (pos % PAGESIZE != 0 || n % PAGESIZE != 0)) {
+        e = rdsm_LzRestoreBlocks(dev, pos, n);
+        if (e < 0) goto failed;
+    }
+
+    r = __real_write(fd, buf, n);
+
+    /* the pages written are in the device now */
+    for (b = (Four)(pos / PAGESIZE), length = 0; r > 0 && dev->nStored > 0 && (off_t)b * PAGESIZE < pos + r; b++) {
+        if (b >= dev->nBlocks || dev->block[b].length == 0) continue;
+        e = rdsm_LzAppend(dev, b, NULL, 0);
+        if (e < 0) goto failed;
+        length++;
+    }
+
+    if (length > 0 && fdatasync(dev->sideFd) < 0) goto failed;
+
+    e = rdsm_LzCompactSideStore(dev);
+    if (e < 0) goto failed;
+
+    pthread_mutex_unlock(&rdsm_lzMutex);
+
+    return(r);
+
+failed:
+    pthread_mutex_unlock(&rdsm_lzMutex);
+    errno = EIO;
+    return(-1);
+
+} /* __wrap_write() */
+
+
+
+/*@================================
+ * rdsm_LzCompress()
+ *================================*/
+/*
+ * Function: Four rdsm_LzCompress(unsigned char*, Four, unsigned char*, Four)
+ *
+ * Description:
+ *  Compress 'n' bytes into a block of at most 'cap' bytes. A match is found
+ *  through a hash table of the last position of each 4-byte sequence.
+ *
+ * Returns:
+ *  length of the block, or NIL if the block does not fit in 'cap' bytes
+ */
+static Four rdsm_LzCompress(
+    unsigned char *src,		/* IN bytes to compress */
+    Four	n,		/* IN the number of bytes */
+    unsigned char *dst,		/* OUT compressed block */
+    Four	cap)		/* IN capacity of dst */
+{
+    Four	table[1 << RDSM_LZ_HASH_BITS]; /* last position of a hash value */
+    Four	ip;		/* position in src */
+    Four	op;		/* position in dst */
+    Four	anchor;		/* first byte not yet emitted */
+    Four	ref;		/* position of the match */
+    Four	len;		/* length of the match */
+    Four	litLen;		/* the number of literals */
+    Four	limit;		/* end of the bytes a match may cover */
+    Four	r;		/* remainder of a length */
+    UFour	seq;		/* 4-byte sequence at ip */
+    UFour	seqRef;		/* 4-byte sequence at ref */
+    unsigned char *token;	/* token of the sequence */
+
+
+    memset(table, 0xff, sizeof(table));     /* NIL */
+
+    ip = anchor = op = 0;
+    limit = n - RDSM_LZ_LAST_LITERALS;
+
+    while (ip + RDSM_LZ_MIN_MATCH <= limit) {
+        memcpy(&seq, src + ip, sizeof(UFour));
+        r = (seq * 2654435761U) >> (32 - RDSM_LZ_HASH_BITS);
+        ref = table[r];
+        table[r] = ip;
+
+        if (ref < 0 || ip - ref > RDSM_LZ_MAX_OFFSET) { ip++; continue; }
+        memcpy(&seqRef, src + ref, sizeof(UFour));
+        if (seqRef != seq) { ip++; continue; }
+
+        for (len = RDSM_LZ_MIN_MATCH; ip + len < limit && src[ref + len] == src[ip + len]; len++);
+
+        /* token, literal length, literals, offset and match length */
+        litLen = ip - anchor;
+        if (op + 1 + litLen/255 + 1 + litLen + 2 + len/255 + 1 > cap) return(NIL);
+
+        token = &dst[op++];
+        *token = ((litLen >= 15) ? 15 : litLen) << 4;
+        if (litLen >= 15) {
+            for (r = litLen - 15; r >= 255; r -= 255) dst[op++] = 255;
+            dst[op++] = r;
+        }
+        memcpy(dst + op, src + anchor, litLen);
+        op += litLen;
+
+        dst[op++] = (ip - ref) & 0xff;
+        dst[op++] = (ip - ref) >> 8;
+
+        r = len - RDSM_LZ_MIN_MATCH;
+        *token |= (r >= 15) ? 15 : r;
+        if (r >= 15) {
+            for (r -= 15; r >= 255; r -= 255) dst[op++] = 255;
+            dst[op++] = r;
+        }
+
+        ip += len;
+        anchor = ip;
+    }
+
+    /* the last sequence has literals only */
+    litLen = n - anchor;
+    if (op + 1 + litLen/255 + 1 + litLen > cap) return(NIL);
+
+    token = &dst[op++];
+    *token = ((litLen >= 15) ? 15 : litLen) << 4;
+    if (litLen >= 15) {
+        for (r = litLen - 15; r >= 255; r -= 255) dst[op++] = 255;
+        dst[op++] = r;
+    }
+    memcpy(dst + op, src + anchor, litLen);
+    op += litLen;
+
+    return(op);
+
+} /* rdsm_LzCompress() */
+
+
+
+/*@================================
+ * rdsm_LzDecompress()
+ *================================*/
+/*
+ * Function: Four rdsm_LzDecompress(unsigned char*, Four, unsigned char*, Four)
+ *
+ * Description:
+ *  Decompress a block made by rdsm_LzCompress(). Every length and offset is
+ *  checked, so a corrupted block cannot write out of dst.
+ *
+ * Returns:
+ *  the number of bytes decompressed, or NIL if the block is corrupted
+ */
+static Four rdsm_LzDecompress(
+    unsigned char *src,		/* IN compressed block */
+    Four	n,		/* IN length of the block */
+    unsigned char *dst,		/* OUT decompressed bytes */
+    Four	cap)		/* IN capacity of dst */
+{
+    Four	ip;		/* position in src */
+    Four	op;		/* position in dst */
+    Four	token;		/* token of the sequence */
+    Four	len;		/* length of the literals or the match */
+    Four	offset;		/* offset of the match */
+    Four	b;		/* byte of a length */
+
+
+    ip = op = 0;
+
+    while (ip < n) {
+        token = src[ip++];
+
+        len = token >> 4;
+        if (len == 15)
+            do {
+                if (ip >= n) return(NIL);
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+
+        if (len > n - ip || len > cap - op) return(NIL);
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+
+        if (ip == n) break;     /* the last sequence */
+
+        if (ip + 2 > n) return(NIL);
+        offset = src[ip] | (src[ip+1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return(NIL);
+
+        len = token & 15;
+        if (len == 15)
+            do {
+                if (ip >= n) return(NIL);
+                b = src[ip++];
+                len += b;
+            } while (b == 255);
+        len += RDSM_LZ_MIN_MATCH;
+
+        if (len > cap - op) return(NIL);
+
+        /* the match may overlap the bytes it produces */
+        for (; len > 0; len--, op++) dst[op] = dst[op - offset];
+    }
+
+    return(op);
+
+} /* rdsm_LzDecompress() */
+
+
+
+/*@================================
+ * rdsm_LzChecksum()
+ *================================*/
+/*
+ * Function: UFour rdsm_LzChecksum(Four, unsigned char*, Four)
+ *
+ * Description:
+ *  FNV-1a hash of a record of the side store; a torn record at the end of
+ *  the store does not match it.
+ *
+ * Returns:
+ *  checksum
+ */
+static UFour rdsm_LzChecksum(
+    Four	block,		/* IN page number within the device */
+    unsigned char *data,	/* IN compressed page */
+    Four	length)		/* IN length of the compressed page */
+{
+    UFour	h;		/* hash value */
+    Four	i;		/* index variable */
+
+
+    h = 2166136261U ^ (UFour)block ^ ((UFour)length << 16);
+    for (i = 0; i < length; i++) h = (h ^ data[i]) * 16777619U;
+
+    return(h);
+
+} /* rdsm_LzChecksum() */
+
+
+
+/*@================================
+ * rdsm_LzLookUpDevice()
+ *================================*/
+/*
+ * Function: rdsm_LzDevice *rdsm_LzLookUpDevice(Four)
+ *
+ * Description:
+ *  Find the opened device of the file descriptor. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  pointer to the device, or NULL if it is not a device
+ */
+static rdsm_LzDevice *rdsm_LzLookUpDevice(
+    Four	fd)		/* IN file descriptor */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < RDSM_LZ_MAX_DEVICES; i++)
+        if (rdsm_lzDevice[i].fd == fd) return(&rdsm_lzDevice[i]);
+
+    return(NULL);
+
+} /* rdsm_LzLookUpDevice() */
+
+
+
+/*@================================
+ * rdsm_LzIsCompressedFile()
+ *================================*/
+/*
+ * Function: Boolean rdsm_LzIsCompressedFile(char*)
+ *
+ * Description:
+ *  Tell whether the page is a slotted page of a file given compressed
+ *  pages. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ */
+static Boolean rdsm_LzIsCompressedFile(
+    char	*page)		/* IN page to be written */
+{
+    Four	i;		/* index variable */
+    SlottedPageHdr *hdr;	/* header of the page */
+
+
+    if (rdsm_nLzFiles == 0) return(FALSE);
+
+    hdr = (SlottedPageHdr *)page;
+    if ((hdr->flags & PAGE_TYPE_VECTOR_MASK) != SLOTTED_PAGE_TYPE) return(FALSE);
+
+    for (i = 0; i < RDSM_LZ_MAX_FILES; i++)
+        if (EQUAL_FILEID(rdsm_lzFile[i], hdr->fid)) return(TRUE);
+
+    return(FALSE);
+
+} /* rdsm_LzIsCompressedFile() */
+
+
+
+/*@================================
+ * rdsm_LzIsTrackedPath()
+ *================================*/
+/*
+ * Function: Boolean rdsm_LzIsTrackedPath(const char*, char*)
+ *
+ * Description:
+ *  Tell whether the file is to be tracked as a device: it is a device of
+ *  the volume of a file registered by this process, or its side store
+ *  starts with a record, i.e. an earlier process stored pages of it
+ *  compressed. The name of the side store is returned in 'sideName' if it
+ *  is not NULL. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  TRUE or FALSE
+ */
+static Boolean rdsm_LzIsTrackedPath(
+    const char	*path,		/* IN file name shorter than MAX_DEVICE_NAME */
+    char	*sideName)	/* OUT name of the side store; may be NULL */
+{
+    Four	i;		/* index variable */
+    Four	fd;		/* file descriptor of the side store */
+    Boolean	found;		/* TRUE if the side store starts with a record */
+    rdsm_LzRecordHdr hdr;	/* header of the first record */
+    char	name[MAX_DEVICE_NAME + sizeof(RDSM_LZ_SUFFIX)]; /* name of the side store */
+
+
+    strcpy(name, path);
+    strcat(name, RDSM_LZ_SUFFIX);
+    if (sideName != NULL) strcpy(sideName, name);
+
+    for (i = 0; i < rdsm_nLzPaths; i++)
+        if (strcmp(rdsm_lzPath[i], path) == 0) return(TRUE);
+
+    fd = open(name, O_RDONLY);
+    if (fd < 0) return(FALSE);
+
+    found = (pread(fd, &hdr, sizeof(hdr), 0) == sizeof(hdr) && hdr.magic == RDSM_LZ_MAGIC &&
+             hdr.block >= 0 && hdr.length >= 0 && hdr.length <= RDSM_LZ_MAX_LENGTH);
+
+    (void)__real_close(fd);
+
+    return(found);
+
+} /* rdsm_LzIsTrackedPath() */
+
+
+
+/*@================================
+ * rdsm_LzAttachDevice()
+ *================================*/
+/*
+ * Function: Four rdsm_LzAttachDevice(Four, const char*)
+ *
+ * Description:
+ *  Track the opened device and replay its side store, if any, into its
+ *  index. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eTOOMANYVOLUMES_RDSM
+ *    some errors caused by function calls
+ */
+static Four rdsm_LzAttachDevice(
+    Four	fd,		/* IN file descriptor of the device */
+    const char	*path)		/* IN name of the device shorter than MAX_DEVICE_NAME */
+{
+    Four	e;		/* error number */
+    Four	i;		/* index variable */
+    char	sideName[MAX_DEVICE_NAME + sizeof(RDSM_LZ_SUFFIX)]; /* name of the side store */
+    rdsm_LzDevice *dev;		/* device */
+
+
+    for (i = 0, dev = NULL; i < RDSM_LZ_MAX_DEVICES; i++)
+        if (rdsm_lzDevice[i].fd == NIL) { dev = &rdsm_lzDevice[i]; break; }
+
+    strcpy(sideName, path);
+    strcat(sideName, RDSM_LZ_SUFFIX);
+
+    if (dev == NULL) {
+        /* no room to track the device; never read it without its side store */
+        if (access(sideName, F_OK) == 0) ERR(eTOOMANYVOLUMES_RDSM);
+        return(eNOERROR);
+    }
+
+    memset(dev, 0, sizeof(rdsm_LzDevice));
+    dev->fd = fd;
+    dev->sideFd = NIL;
+    strcpy(dev->sideName, sideName);
+
+    e = rdsm_LzLoadSideStore(dev);
+    if (e < 0) {
+        free(dev->block);
+        dev->block = NULL;
+        dev->fd = NIL;
+        ERR(e);
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_LzAttachDevice() */
+
+
+
+/*@================================
+ * rdsm_LzSetBlock()
+ *================================*/
+/*
+ * Function: Four rdsm_LzSetBlock(rdsm_LzDevice*, Four, off_t, Four)
+ *
+ * Description:
+ *  Set the entry of the page in the index of the device, growing the index
+ *  if needed. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eMEMORYALLOCERR
+ */
+static Four rdsm_LzSetBlock(
+    rdsm_LzDevice *dev,		/* INOUT device */
+    Four	b,		/* IN page number within the device */
+    off_t	offset,		/* IN offset of the compressed page in the side store */
+    Four	length)		/* IN length of the compressed page; 0 if in the device */
+{
+    Four	nBlocks;	/* new number of the entries */
+    rdsm_LzBlock *block;	/* new index */
+
+
+    if (b >= dev->nBlocks) {
+        if (length == 0) return(eNOERROR);
+
+        nBlocks = (b + 1 > 2 * dev->nBlocks) ? b + 1 : 2 * dev->nBlocks;
+        if (nBlocks < 256) nBlocks = 256;
+
+        block = (rdsm_LzBlock *)realloc(dev->block, nBlocks * sizeof(rdsm_LzBlock));
+        if (block == NULL) ERR(eMEMORYALLOCERR);
+        memset(block + dev->nBlocks, 0, (nBlocks - dev->nBlocks) * sizeof(rdsm_LzBlock));
+
+        dev->block = block;
+        dev->nBlocks = nBlocks;
+    }
+
+    if (dev->block[b].length > 0) {
+        dev->nStored--;
+        rdsm_nLzStored--;
+        dev->storedBytes -= dev->block[b].length;
+    }
+
+    dev->block[b].offset = offset;
+    dev->block[b].length = length;
+
+    if (length > 0) {
+        dev->nStored++;
+        rdsm_nLzStored++;
+        dev->storedBytes += length;
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_LzSetBlock() */
+
+
+
+/*@================================
+ * rdsm_LzAppend()
+ *================================*/
+/*
+ * Function: Four rdsm_LzAppend(rdsm_LzDevice*, Four, unsigned char*, Four)
+ *
+ * Description:
+ *  Append a compressed page(or a tombstone if 'length' is 0) to the side
+ *  store of the device, creating the store if needed, and update the
+ *  index. The caller syncs the store(fdatasync()) before it relies on the
+ *  record being on the disk, e.g. before it punches the page out of the
+ *  device. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eWRITEFAIL_RDSM
+ *    some errors caused by function calls
+ */
+static Four rdsm_LzAppend(
+    rdsm_LzDevice *dev,		/* INOUT device */
+    Four	b,		/* IN page number within the device */
+    unsigned char *data,	/* IN compressed page */
+    Four	length)		/* IN length of the compressed page */
+{
+    Four	e;		/* error number */
+    unsigned char rec[sizeof(rdsm_LzRecordHdr) + RDSM_LZ_MAX_LENGTH]; /* record */
+    rdsm_LzRecordHdr *hdr;	/* header of the record */
+
+
+    if (dev->sideFd == NIL) {
+        dev->sideFd = open(dev->sideName, O_RDWR | O_CREAT, 0644);
+        if (dev->sideFd < 0) {
+            dev->sideFd = NIL;
+            ERR(eWRITEFAIL_RDSM);
+        }
+        dev->sideEnd = 0;
+    }
+
+    hdr = (rdsm_LzRecordHdr *)rec;
+    hdr->magic = RDSM_LZ_MAGIC;
+    hdr->block = b;
+    hdr->length = length;
+    hdr->check = rdsm_LzChecksum(b, data, length);
+    if (length > 0) memcpy(rec + sizeof(rdsm_LzRecordHdr), data, length);
+
+    if (pwrite(dev->sideFd, rec, sizeof(rdsm_LzRecordHdr) + length, dev->sideEnd) !=
+        (ssize_t)(sizeof(rdsm_LzRecordHdr) + length)) ERR(eWRITEFAIL_RDSM);
+
+    e = rdsm_LzSetBlock(dev, b, dev->sideEnd + sizeof(rdsm_LzRecordHdr), length);
+    if (e < 0) ERR(e);
+
+    dev->sideEnd += sizeof(rdsm_LzRecordHdr) + length;
+
+    return(eNOERROR);
+
+} /* rdsm_LzAppend() */
+
+
+
+/*@================================
+ * rdsm_LzCompactSideStore()
+ *================================*/
+/*
+ * Function: Four rdsm_LzCompactSideStore(rdsm_LzDevice*)
+ *
+ * Description:
+ *  Compact the side store of the device if its replaced records and
+ *  tombstones take at least RDSM_LZ_COMPACT_MIN bytes and more than the
+ *  live records. The live records are written to '<device>.lz.tmp', which
+ *  is synced and renamed to the side store; a crash leaves either store,
+ *  and both hold every page stored compressed. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eWRITEFAIL_RDSM
+ *    eREADFAIL_RDSM
+ */
+static Four rdsm_LzCompactSideStore(
+    rdsm_LzDevice *dev)		/* INOUT device */
+{
+    Four	fd;		/* file descriptor of the new store */
+    Four	dirFd;		/* file descriptor of the directory of the store */
+    Four	b;		/* page number within the device */
+    Four	length;		/* length of a compressed page */
+    off_t	live;		/* bytes of the live records */
+    off_t	pos;		/* end of the new store */
+    char	*slash;		/* last '/' of the name of the store */
+    char	tmpName[MAX_DEVICE_NAME + sizeof(RDSM_LZ_SUFFIX) + sizeof(RDSM_LZ_TMP_SUFFIX)]; /* name of the new store */
+    unsigned char rec[sizeof(rdsm_LzRecordHdr) + RDSM_LZ_MAX_LENGTH]; /* record */
+    rdsm_LzRecordHdr *hdr;	/* header of the record */
+
+
+    if (dev->sideFd == NIL) return(eNOERROR);
+
+    live = (off_t)dev->storedBytes + (off_t)dev->nStored * sizeof(rdsm_LzRecordHdr);
+    if (dev->sideEnd - live < RDSM_LZ_COMPACT_MIN || dev->sideEnd - live <= live) return(eNOERROR);
+
+    strcpy(tmpName, dev->sideName);
+    strcat(tmpName, RDSM_LZ_TMP_SUFFIX);
+
+    fd = open(tmpName, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) ERR(eWRITEFAIL_RDSM);
+
+    /* the records are written in the order of the pages, so their offsets can be recomputed */
+    hdr = (rdsm_LzRecordHdr *)rec;
+    for (b = 0, pos = 0; b < dev->nBlocks; b++) {
+        if ((length = dev->block[b].length) == 0) continue;
+
+        if (pread(dev->sideFd, rec + sizeof(rdsm_LzRecordHdr), length, dev->block[b].offset) != length) {
+            (void)__real_close(fd);
+            (void)unlink(tmpName);
+            ERR(eREADFAIL_RDSM);
+        }
+
+        hdr->magic = RDSM_LZ_MAGIC;
+        hdr->block = b;
+        hdr->length = length;
+        hdr->check = rdsm_LzChecksum(b, rec + sizeof(rdsm_LzRecordHdr), length);
+
+        if (pwrite(fd, rec, sizeof(rdsm_LzRecordHdr) + length, pos) != (ssize_t)(sizeof(rdsm_LzRecordHdr) + length)) {
+            (void)__real_close(fd);
+            (void)unlink(tmpName);
+            ERR(eWRITEFAIL_RDSM);
+        }
+
+        pos += sizeof(rdsm_LzRecordHdr) + length;
+    }
+
+    if (fdatasync(fd) < 0 || rename(tmpName, dev->sideName) < 0) {
+        (void)__real_close(fd);
+        (void)unlink(tmpName);
+        ERR(eWRITEFAIL_RDSM);
+    }
+
+    /* make the rename durable; the directory is the part of the name before the last '/' */
+    slash = strrchr(tmpName, '/');
+    if (slash == NULL) strcpy(tmpName, ".");
+    else if (slash == tmpName) tmpName[1] = '\0';
+    else *slash = '\0';
+
+    dirFd = open(tmpName, O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        (void)fsync(dirFd);
+        (void)__real_close(dirFd);
+    }
+
+    (void)__real_close(dev->sideFd);
+    dev->sideFd = fd;
+    dev->sideEnd = pos;
+    dev->nCompactions++;
+
+    for (b = 0, pos = 0; b < dev->nBlocks; b++) {
+        if (dev->block[b].length == 0) continue;
+        dev->block[b].offset = pos + sizeof(rdsm_LzRecordHdr);
+        pos += sizeof(rdsm_LzRecordHdr) + dev->block[b].length;
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_LzCompactSideStore() */
+
+
+
+/*@================================
+ * rdsm_LzLoadSideStore()
+ *================================*/
+/*
+ * Function: Four rdsm_LzLoadSideStore(rdsm_LzDevice*)
+ *
+ * Description:
+ *  Replay the side store of the device, if any, into its index. A torn
+ *  record at the end of the store(a crash while appending it) is cut off.
+ *  rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eREADFAIL_RDSM
+ *    some errors caused by function calls
+ */
+static Four rdsm_LzLoadSideStore(
+    rdsm_LzDevice *dev)		/* INOUT device */
+{
+    Four	e;		/* error number */
+    off_t	pos;		/* position in the side store */
+    rdsm_LzRecordHdr hdr;	/* header of a record */
+    unsigned char data[RDSM_LZ_MAX_LENGTH]; /* compressed page */
+
+
+    dev->sideFd = open(dev->sideName, O_RDWR);
+    if (dev->sideFd < 0) {
+        dev->sideFd = NIL;
+        if (errno == ENOENT) return(eNOERROR);
+        ERR(eREADFAIL_RDSM);
+    }
+
+    for (pos = 0; ; pos += sizeof(rdsm_LzRecordHdr) + hdr.length) {
+        if (pread(dev->sideFd, &hdr, sizeof(hdr), pos) != sizeof(hdr)) break;
+        if (hdr.magic != RDSM_LZ_MAGIC || hdr.block < 0 ||
+            hdr.length < 0 || hdr.length > RDSM_LZ_MAX_LENGTH) break;
+        if (pread(dev->sideFd, data, hdr.length, pos + sizeof(hdr)) != hdr.length) break;
+        if (hdr.check != rdsm_LzChecksum(hdr.block, data, hdr.length)) break;
+
+        e = rdsm_LzSetBlock(dev, hdr.block, pos + sizeof(hdr), hdr.length);
+        if (e < 0) {
+            (void)__real_close(dev->sideFd);
+            ERR(e);
+        }
+    }
+
+    dev->sideEnd = pos;
+    (void)ftruncate(dev->sideFd, pos);
+
+    return(eNOERROR);
+
+} /* rdsm_LzLoadSideStore() */
+
+
+
+/*@================================
+ * rdsm_LzReadBlock()
+ *================================*/
+/*
+ * Function: Four rdsm_LzReadBlock(rdsm_LzDevice*, Four, char*)
+ *
+ * Description:
+ *  Read a page of the device, decompressing it if it is stored compressed.
+ *  rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  PAGESIZE, 0 at the end of the device, or error code
+ *    eREADFAIL_RDSM
+ */
+static Four rdsm_LzReadBlock(
+    rdsm_LzDevice *dev,		/* INOUT device */
+    Four	b,		/* IN page number within the device */
+    char	*page)		/* OUT page */
+{
+    ssize_t	r;		/* result of a system call */
+    unsigned char data[RDSM_LZ_MAX_LENGTH]; /* compressed page */
+
+
+    if (b >= dev->nBlocks || dev->block[b].length == 0) {
+        r = pread(dev->fd, page, PAGESIZE, (off_t)b * PAGESIZE);
+        if (r < 0 || (r > 0 && r < PAGESIZE)) ERR(eREADFAIL_RDSM);
+        return((Four)r);
+    }
+
+    if (pread(dev->sideFd, data, dev->block[b].length, dev->block[b].offset) != dev->block[b].length ||
+        rdsm_LzDecompress(data, dev->block[b].length, (unsigned char *)page, PAGESIZE) != PAGESIZE)
+        ERR(eREADFAIL_RDSM);
+
+    dev->nDecompressed++;
+
+    return(PAGESIZE);
+
+} /* rdsm_LzReadBlock() */
+
+
+
+/*@================================
+ * rdsm_LzRestoreBlocks()
+ *================================*/
+/*
+ * Function: Four rdsm_LzRestoreBlocks(rdsm_LzDevice*, off_t, size_t)
+ *
+ * Description:
+ *  Store the pages of the byte range which are stored compressed in the
+ *  device again, so that the range can be read or written as it is. The
+ *  raw disk manager reads and writes whole pages, so this is not expected
+ *  to happen. rdsm_lzMutex is held.
+ *
+ * Returns:
+ *  error code
+ *    eWRITEFAIL_RDSM
+ *    some errors caused by function calls
+ */
+static Four rdsm_LzRestoreBlocks(
+    rdsm_LzDevice *dev,		/* INOUT device */
+    off_t	pos,		/* IN start of the range */
+    size_t	n)		/* IN length of the range */
+{
+    Four	e;		/* error number */
+    Four	b;		/* page number within the device */
+    char	page[PAGESIZE];	/* decompressed page */
+
+
+    for (b = (Four)(pos / PAGESIZE); (off_t)b * PAGESIZE < pos + (off_t)n && b < dev->nBlocks; b++) {
+        if (dev->block[b].length == 0) continue;
+
+        e = rdsm_LzReadBlock(dev, b, page);
+        if (e < 0) ERR(e);
+
+        if (pwrite(dev->fd, page, PAGESIZE, (off_t)b * PAGESIZE) != PAGESIZE) ERR(eWRITEFAIL_RDSM);
+
+        e = rdsm_LzAppend(dev, b, NULL, 0);
+        if (e < 0) ERR(e);
+
+        if (fdatasync(dev->sideFd) < 0) ERR(eWRITEFAIL_RDSM);
+    }
+
+    return(eNOERROR);
+
+} /* rdsm_LzRestoreBlocks() */
@@ -0,0 +1,156 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: RDsM_DirectIO.c
+ *
+ * Description:
+ *  Direct I/O for mounted volumes. With direct I/O the trains read and
+ *  written by the raw disk manager bypass the operating system's page cache,
+ *  so a page is cached once, in the buffer pool, instead of twice.
+ *
+ *  Direct I/O requires the buffers to be aligned to PAGESIZE. The raw disk
+ *  manager already reads into and writes from an aligned buffer of its own
+ *  (set up by rdsm_InitReadWriteBuffer()) whenever the buffer given by the
+ *  caller is not aligned, and copies the train; BfM_SetUpBufferArena()
+ *  aligns the buffer frames so that no copy is needed.
+ *
+ *  The devices are found through the volume table of cosmos.o, whose layout
+ *  in RDsM_Internal.h is inferred. Before any file descriptor is changed,
+ *  every device of the volume is checked to be the file opened as it: if
+ *  the layout is wrong, the call fails instead of changing another file.
+ *
+ * Exports:
+ *  Four RDsM_SetDirectIO(VolNo, Boolean)
+ *
+ * Internal:
+ *  Boolean rdsm_CheckVolumeEntry(RDsM_VolumeTable*)
+ */
+
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "RDsM_Internal.h"
+
+
+
+/*@================================
+ * rdsm_CheckVolumeEntry()
+ *================================*/
+/*
+ * Function: Boolean rdsm_CheckVolumeEntry(RDsM_VolumeTable*)
+ *
+ * Description:
+ *  Check that the entry of the volume table reads as RDsM_VolumeTable says:
+ *  the number of devices is sane, and the file descriptor of each device
+ *  refers to the file named by the device name.
+ *
+ * Returns:
+ *  TRUE if the entry is sane, otherwise FALSE
+ */
+Boolean rdsm_CheckVolumeEntry(
+    RDsM_VolumeTable *entry)	/* IN entry of the volume table */
+{
+    Four	d;		/* index of the device */
+    RDsM_DevInfo *dev;		/* device of the volume */
+    struct stat byName;		/* status of the file named by the device name */
+    struct stat byFd;		/* status of the file opened as the device */
+
+
+    if (entry->numDevices <= 0 || entry->numDevices > MAX_DEVICES_IN_VOLUME) return(FALSE);
+    if (entry->devInfo == NULL) return(FALSE);
+
+    for (d = 0; d < entry->numDevices; d++) {
+        dev = &entry->devInfo[d];
+
+        if (memchr(dev->devName, '\0', MAX_DEVICE_NAME) == NULL || dev->devAddr < 0) return(FALSE);
+
+        if (stat(dev->devName, &byName) < 0 || fstat(dev->devAddr, &byFd) < 0) return(FALSE);
+
+        if (byName.st_dev != byFd.st_dev || byName.st_ino != byFd.st_ino) return(FALSE);
+    }
+
+    return(TRUE);
+
+} /* rdsm_CheckVolumeEntry() */
+
+
+
+/*@================================
+ * RDsM_SetDirectIO()
+ *================================*/
+/*
+ * Function: Four RDsM_SetDirectIO(VolNo, Boolean)
+ *
+ * Description:
+ *  Turn direct I/O on or off for every device of the mounted volume. The
+ *  pages of the volume still in the page cache are dropped by the kernel
+ *  as they are written. Nothing is changed unless every device checks out
+ *  against the volume table(see rdsm_CheckVolumeEntry()).
+ *
+ * Returns:
+ *  error code
+ *    eVOLNOTMOUNTED_RDSM
+ *    eBADVOLUMETABLE_RDSM
+ *    eDIRECTIONOTSUPPORTED_RDSM
+ */
+Four RDsM_SetDirectIO(
+    VolNo	volNo,		/* IN volume number */
+    Boolean	onOff)		/* IN TRUE to turn direct I/O on */
+{
+    Four	i;		/* index of the volume table */
+    Four	d;		/* index of the device */
+    Four	flags;		/* file status flags of a device */
+
+
+    for (i = 0; i < MAXNUMOFVOLS; i++)
+        if (volTable[i].volNo == volNo) break;
+
+    if (i == MAXNUMOFVOLS) ERR(eVOLNOTMOUNTED_RDSM);
+
+    /* the layout of the volume table may be wrong; do not touch another file */
+    if (!rdsm_CheckVolumeEntry(&volTable[i])) ERR(eBADVOLUMETABLE_RDSM);
+
+    for (d = 0; d < volTable[i].numDevices; d++) {
+        flags = fcntl(volTable[i].devInfo[d].devAddr, F_GETFL);
+        if (flags < 0) ERR(eDIRECTIONOTSUPPORTED_RDSM);
+
+        flags = (onOff) ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+
+        /* the file system of the device may not support direct I/O */
+        if (fcntl(volTable[i].devInfo[d].devAddr, F_SETFL, flags) < 0) {
+            while (--d >= 0) {
+                flags = fcntl(volTable[i].devInfo[d].devAddr, F_GETFL);
+                (void)fcntl(volTable[i].devInfo[d].devAddr, F_SETFL, (onOff) ? (flags & ~O_DIRECT) : (flags | O_DIRECT));
+            }
+            ERR(eDIRECTIONOTSUPPORTED_RDSM);
+        }
+    }
+
+    return(eNOERROR);
+
+} /* RDsM_SetDirectIO() */
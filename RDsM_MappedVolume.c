@@ -0,0 +1,301 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: RDsM_MappedVolume.c
+ *
+ * Description:
+ *  Map the device of a mounted volume into memory so that pages can be read
+ *  in place, without a copy into a buffer frame and without a read system
+ *  call. This pays off for read-mostly volumes which fit in memory, e.g. the
+ *  volumes mounted by reporting replicas.
+ *
+ *  The mapping is read only and shared. Updates still go through the buffer
+ *  manager, which writes dirty buffers back to the device with write system
+ *  calls; as the mapping and those writes share the page cache, the mapping
+ *  sees every page written back. A page which is in the buffer pool may be
+ *  newer than the mapping, so the buffer manager reads such a page from the
+ *  buffer pool(see BfM_GetTrainForRead()).
+ *
+ *  A train is located at 'pageNo * PAGESIZE' on the device, which holds for
+ *  volumes consisting of one device. A page stored compressed(see
+ *  RDsM_Compression.c) is not in the device, so it is never read from the
+ *  mapping.
+ *
+ * Exports:
+ *  Four RDsM_MapVolume(VolNo, char*, Four)
+ *  Four RDsM_UnmapVolume(VolNo)
+ *  char *RDsM_GetMappedTrain(PageID*, Four)
+ *  Four RDsM_AdviseMappedTrains(PageID*, Four, Four)
+ */
+
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "EduOM_common.h"
+#include "RDsM_Internal.h"
+
+
+
+/*@
+ * Constant Definitions
+ */
+#define RDSM_MAX_MAPPED_VOLUMES 20
+
+
+/*@
+ * Type Definitions
+ */
+/* a mapped volume */
+typedef struct {
+    VolNo	volNo;		/* NIL if the entry is not used */
+    char	*base;		/* start of the mapping */
+    PageNo	nPages;		/* the number of pages mapped */
+} rdsm_MappedVolume;
+
+
+/*@
+ * Global Variables
+ */
+static rdsm_MappedVolume rdsm_mappedVolume[RDSM_MAX_MAPPED_VOLUMES] = {
+    [0 ... RDSM_MAX_MAPPED_VOLUMES-1] = { NIL, NULL, 0 }
+};
+
+/* number of mapped volumes; lets RDsM_GetMappedTrain() return at once if 0 */
+static Four rdsm_nMappedVolumes = 0;
+
+
+
+/*@================================
+ * rdsm_Advice()
+ *================================*/
+/*
+ * Function: Four rdsm_Advice(Four)
+ *
+ * Description:
+ *  Translate the advice into the madvise() one.
+ *
+ * Returns:
+ *  madvise() advice
+ *  eBADPARAMETER
+ */
+static Four rdsm_Advice(
+    Four	advice)		/* IN RDSM_ADVICE_XXX */
+{
+    switch (advice) {
+      case RDSM_ADVICE_NORMAL:   return(MADV_NORMAL);
+      case RDSM_ADVICE_SCAN:     return(MADV_SEQUENTIAL);
+      case RDSM_ADVICE_POINT:    return(MADV_RANDOM);
+      case RDSM_ADVICE_WILLNEED: return(MADV_WILLNEED);
+      default:                   return(eBADPARAMETER);
+    }
+
+} /* rdsm_Advice() */
+
+
+
+/*@================================
+ * RDsM_MapVolume()
+ *================================*/
+/*
+ * Function: Four RDsM_MapVolume(VolNo, char*, Four)
+ *
+ * Description:
+ *  Map the device of a mounted volume. 'advice' tells how the volume is
+ *  going to be accessed as a whole: RDSM_ADVICE_SCAN for sequential scans,
+ *  RDSM_ADVICE_POINT for random object reads, or RDSM_ADVICE_NORMAL.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ *    eTOOMANYVOLUMES_RDSM
+ *    eDEVICEOPENFAIL_RDSM
+ */
+Four RDsM_MapVolume(
+    VolNo	volNo,		/* IN volume number */
+    char	*devName,	/* IN device(file) of the volume */
+    Four	advice)		/* IN how the volume is accessed */
+{
+    Four	i;		/* index variable */
+    Four	fd;		/* file descriptor of the device */
+    Four	madv;		/* madvise() advice */
+    struct stat st;		/* status of the device */
+    char	*base;		/* start of the mapping */
+
+
+    if (devName == NULL || volNo < 0) ERR(eBADPARAMETER);
+
+    madv = rdsm_Advice(advice);
+    if (madv < 0 || advice == RDSM_ADVICE_WILLNEED) ERR(eBADPARAMETER);
+
+    for (i = 0; i < RDSM_MAX_MAPPED_VOLUMES; i++)
+        if (rdsm_mappedVolume[i].volNo == volNo) ERR(eBADPARAMETER);
+
+    for (i = 0; i < RDSM_MAX_MAPPED_VOLUMES; i++)
+        if (rdsm_mappedVolume[i].volNo == NIL) break;
+
+    if (i == RDSM_MAX_MAPPED_VOLUMES) ERR(eTOOMANYVOLUMES_RDSM);
+
+    fd = open(devName, O_RDONLY);
+    if (fd < 0) ERR(eDEVICEOPENFAIL_RDSM);
+
+    if (fstat(fd, &st) < 0 || st.st_size < PAGESIZE) {
+        close(fd);
+        ERR(eDEVICEOPENFAIL_RDSM);
+    }
+
+    /* the mapping stays valid after the descriptor is closed */
+    base = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == (char *)MAP_FAILED) ERR(eDEVICEOPENFAIL_RDSM);
+
+    (void)madvise(base, st.st_size, madv);
+
+    rdsm_mappedVolume[i].base = base;
+    rdsm_mappedVolume[i].nPages = st.st_size / PAGESIZE;
+    rdsm_mappedVolume[i].volNo = volNo;
+    rdsm_nMappedVolumes++;
+
+    return(eNOERROR);
+
+} /* RDsM_MapVolume() */
+
+
+
+/*@================================
+ * RDsM_UnmapVolume()
+ *================================*/
+/*
+ * Function: Four RDsM_UnmapVolume(VolNo)
+ *
+ * Description:
+ *  Unmap the volume. No pointer returned by RDsM_GetMappedTrain() for the
+ *  volume may be used afterwards.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four RDsM_UnmapVolume(
+    VolNo	volNo)		/* IN volume number */
+{
+    Four	i;		/* index variable */
+
+
+    for (i = 0; i < RDSM_MAX_MAPPED_VOLUMES; i++)
+        if (rdsm_mappedVolume[i].volNo == volNo) break;
+
+    if (i == RDSM_MAX_MAPPED_VOLUMES) ERR(eBADPARAMETER);
+
+    munmap(rdsm_mappedVolume[i].base, (size_t)rdsm_mappedVolume[i].nPages * PAGESIZE);
+
+    rdsm_mappedVolume[i].volNo = NIL;
+    rdsm_mappedVolume[i].base = NULL;
+    rdsm_mappedVolume[i].nPages = 0;
+    rdsm_nMappedVolumes--;
+
+    return(eNOERROR);
+
+} /* RDsM_UnmapVolume() */
+
+
+
+/*@================================
+ * RDsM_GetMappedTrain()
+ *================================*/
+/*
+ * Function: char *RDsM_GetMappedTrain(PageID*, Four)
+ *
+ * Description:
+ *  Return a pointer to the train in the mapping of its volume.
+ *
+ * Returns:
+ *  pointer to the train (read only)
+ *  NULL if the volume is not mapped, the train is out of the mapping or a
+ *  page of the train is stored compressed
+ */
+char *RDsM_GetMappedTrain(
+    PageID	*pid,		/* IN first page of the train */
+    Four	sizeOfTrain)	/* IN the number of pages in the train */
+{
+    Four	i;		/* index variable */
+
+
+    if (rdsm_nMappedVolumes == 0) return(NULL);
+
+    for (i = 0; i < RDSM_MAX_MAPPED_VOLUMES; i++) {
+        if (rdsm_mappedVolume[i].volNo != pid->volNo) continue;
+
+        if (pid->pageNo < 0 || pid->pageNo + sizeOfTrain > rdsm_mappedVolume[i].nPages) return(NULL);
+
+        if (rdsm_IsCompressedTrain(pid, sizeOfTrain)) return(NULL);
+
+        return(rdsm_mappedVolume[i].base + (size_t)pid->pageNo * PAGESIZE);
+    }
+
+    return(NULL);
+
+} /* RDsM_GetMappedTrain() */
+
+
+
+/*@================================
+ * RDsM_AdviseMappedTrains()
+ *================================*/
+/*
+ * Function: Four RDsM_AdviseMappedTrains(PageID*, Four, Four)
+ *
+ * Description:
+ *  Give an access hint for 'nPages' pages starting from 'pid'; e.g. a scan
+ *  gives RDSM_ADVICE_WILLNEED for the page it is going to visit next. The
+ *  call does nothing if the volume is not mapped.
+ *
+ * Returns:
+ *  error code
+ *    eBADPARAMETER
+ */
+Four RDsM_AdviseMappedTrains(
+    PageID	*pid,		/* IN first page */
+    Four	nPages,		/* IN the number of pages */
+    Four	advice)		/* IN RDSM_ADVICE_XXX */
+{
+    Four	madv;		/* madvise() advice */
+    char	*addr;		/* start of the pages in the mapping */
+
+
+    if (pid == NULL || nPages <= 0) ERR(eBADPARAMETER);
+
+    madv = rdsm_Advice(advice);
+    if (madv < 0) ERR(eBADPARAMETER);
+
+    addr = RDsM_GetMappedTrain(pid, nPages);
+    if (addr == NULL) return(eNOERROR);
+
+    (void)madvise(addr, (size_t)nPages * PAGESIZE, madv);
+
+    return(eNOERROR);
+
+} /* RDsM_AdviseMappedTrains() */
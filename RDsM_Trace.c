@@ -0,0 +1,84 @@
+/******************************************************************************/
+/*                                                                            */
+/*    ODYSSEUS/EduCOSMOS Educational-Purpose Object Storage System            */
+/*                                                                            */
+/*    Developed by Professor Kyu-Young Whang et al.                           */
+/*                                                                            */
+/*    Database and Multimedia Laboratory                                      */
+/*                                                                            */
+/*    Computer Science Department and                                         */
+/*    Advanced Information Technology Research Center (AITrc)                 */
+/*    Korea Advanced Institute of Science and Technology (KAIST)              */
+/*                                                                            */
+/*    e-mail: kywhang@cs.kaist.ac.kr                                          */
+/*    phone: +82-42-350-7722                                                  */
+/*    fax: +82-42-350-8380                                                    */
+/*                                                                            */
+/*    Copyright (c) 1995-2013 by Kyu-Young Whang                              */
+/*                                                                            */
+/*    All rights reserved. No part of this software may be reproduced,        */
+/*    stored in a retrieval system, or transmitted, in any form or by any     */
+/*    means, electronic, mechanical, photocopying, recording, or otherwise,   */
+/*    without prior written permission of the copyright owner.                */
+/*                                                                            */
+/******************************************************************************/
+/*
+ * Module: RDsM_Trace.c
+ *
+ * Description:
+ *  Tracepoints of the raw disk manager. RDsM_AllocTrains() called from this
+ *  tree is linked to the wrapper below(see 'ld --wrap' in the Makefile),
+ *  which fires rdsm:alloc_trains_entry and rdsm:alloc_trains_return(see
+ *  EduOM_Trace.h). The calls made inside cosmos.o are not traced.
+ *
+ * Internal:
+ *  Four __wrap_RDsM_AllocTrains(Four, Four, PageID*, Two, Four, Two, PageID*)
+ */
+
+
+#include "EduOM_common.h"
+#include "RDsM_Internal.h"
+#include "EduOM_Trace.h"
+
+
+/* the real function in cosmos.o */
+Four __real_RDsM_AllocTrains(Four, Four, PageID *, Two, Four, Two, PageID *);
+
+
+
+/*@================================
+ * __wrap_RDsM_AllocTrains()
+ *================================*/
+/*
+ * Function: Four __wrap_RDsM_AllocTrains(Four, Four, PageID*, Two, Four, Two, PageID*)
+ *
+ * Description:
+ *  RDsM_AllocTrains() firing the probes at its entry and return.
+ *
+ * Returns:
+ *  error code
+ *    some errors caused by function calls
+ */
+Four __wrap_RDsM_AllocTrains(
+    Four	volNo,		/* IN volume from which trains are allocated */
+    Four	firstExtNo,	/* IN first extent of the file */
+    PageID	*nearPid,	/* IN allocate near this page */
+    Two		eff,		/* IN extent fill factor */
+    Four	numTrains,	/* IN the number of trains to allocate */
+    Two		sizeOfTrain,	/* IN size of a train in pages */
+    PageID	*trainIds)	/* OUT trains allocated */
+{
+    Four	e;		/* error number */
+
+
+    EDUOM_PROBE3(rdsm, alloc_trains_entry, volNo, (nearPid != NULL) ? nearPid->pageNo : NIL, numTrains);
+
+    e = __real_RDsM_AllocTrains(volNo, firstExtNo, nearPid, eff, numTrains, sizeOfTrain, trainIds);
+
+    EDUOM_PROBE3(rdsm, alloc_trains_return, e, volNo, (e >= 0 && numTrains > 0) ? trainIds[0].pageNo : NIL);
+
+    if (e < 0) ERR(e);
+
+    return(e);
+
+} /* __wrap_RDsM_AllocTrains() */